@@ -285,6 +285,7 @@ typedef struct {
 
 #define SORT_QSORT_T              0x1
 #define SORT_SPILLED_MERGE_SORT_T 0x2
+#define SORT_TOPN_T               0x3
 typedef struct SSortExecInfo {
   int32_t sortMethod;
   int32_t sortBuffer;
@@ -243,6 +243,10 @@ SColumnInfoData* bdGetColumnInfoData(const SSDataBlock* pBlock, int32_t index);
 void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_t numOfCols, int8_t needCompress);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
 
+// expand a block encoded with compression into the layout of an uncompressed one
+int32_t blockGetDecompressedSize(const char* pData);
+int32_t blockDecompress(const char* pData, char* pOut, int32_t* pOutLen);
+
 void blockDebugShowDataBlock(SSDataBlock* pBlock, const char* flag);
 void blockDebugShowDataBlocks(const SArray* dataBlocks, const char* flag);
 // for debug
@@ -257,11 +261,28 @@ static FORCE_INLINE int32_t blockGetEncodeSize(const SSDataBlock* pBlock) {
   return blockDataGetSerialMetaSize(taosArrayGetSize(pBlock->pDataBlock)) + blockDataGetSize(pBlock);
 }
 
+static FORCE_INLINE int32_t blockGetCompressedEncodeSize(const SSDataBlock* pBlock) {
+  return blockGetEncodeSize(pBlock) + taosArrayGetSize(pBlock->pDataBlock) * (sizeof(int32_t) + COMP_OVERFLOW_BYTES);
+}
+
+// The compressed column is led by its original length, and is stored as it is if the codec does not shrink it.
 static FORCE_INLINE int32_t blockCompressColData(SColumnInfoData* pColRes, int32_t numOfRows, char* data,
                                                  int8_t compressed) {
   int32_t colSize = colDataGetLength(pColRes, numOfRows);
-  return (*(tDataTypes[pColRes->info.type].compFunc))(pColRes->pData, colSize, numOfRows, data,
-                                                      colSize + COMP_OVERFLOW_BYTES, compressed, NULL, 0);
+  *(int32_t*)data = colSize;
+  data += sizeof(int32_t);
+
+  int32_t len = -1;
+  if (colSize > 0 && tDataTypes[pColRes->info.type].compFunc != NULL) {
+    len = (*(tDataTypes[pColRes->info.type].compFunc))(pColRes->pData, colSize, numOfRows, data,
+                                                       colSize + COMP_OVERFLOW_BYTES, compressed, NULL, 0);
+  }
+
+  if (len <= 0 || len >= colSize) {
+    memcpy(data, pColRes->pData, colSize);
+    len = colSize;
+  }
+  return sizeof(int32_t) + len;
 }
 
 #ifdef __cplusplus
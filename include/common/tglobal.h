@@ -67,11 +67,14 @@ extern int32_t tsNumOfVnodeFetchThreads;
 extern int32_t tsNumOfVnodeWriteThreads;
 extern int32_t tsNumOfVnodeSyncThreads;
 extern int32_t tsNumOfVnodeRsmaThreads;
+extern int32_t tsNumOfVnodePrefetchThreads;
+extern int32_t tsNumOfVnodeCompactThreads;
 extern int32_t tsNumOfQnodeQueryThreads;
 extern int32_t tsNumOfQnodeFetchThreads;
 extern int32_t tsNumOfSnodeSharedThreads;
 extern int32_t tsNumOfSnodeUniqueThreads;
 extern int64_t tsRpcQueueMemoryAllowed;
+extern int32_t tsRpcBatchDelay;
 
 // monitor
 extern bool     tsEnableMonitor;
@@ -95,6 +98,7 @@ extern int64_t tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in
 extern int32_t tsQueryPolicy;
 extern int32_t tsQuerySmaOptimize;
 extern bool    tsQueryPlannerTrace;
+extern int32_t tsInsertTemplateCacheSize;
 
 // client
 extern int32_t tsMinSlidingTime;
@@ -119,12 +123,14 @@ extern int32_t  tsDiskCfgNum;
 extern SDiskCfg tsDiskCfg[];
 
 // udf
-extern bool tsStartUdfd;
+extern bool    tsStartUdfd;
+extern int32_t tsUdfShmSize;
 
 // schemaless
-extern char tsSmlChildTableName[];
-extern char tsSmlTagName[];
-extern bool tsSmlDataFormat;
+extern char    tsSmlChildTableName[];
+extern char    tsSmlTagName[];
+extern bool    tsSmlDataFormat;
+extern int32_t tsSmlParseAhead;
 
 // internal
 extern int32_t tsTransPullupInterval;
@@ -134,6 +140,41 @@ extern int32_t tsTtlPushInterval;
 extern int32_t tsGrantHBInterval;
 extern int32_t tsUptimeInterval;
 
+// compaction
+extern int32_t tsCompactSttTrigger;
+extern int32_t tsCompactSttSizeMB;
+extern int32_t tsCompactInterval;
+extern int32_t tsCompactIoRateMB;
+
+// tsdb page cache
+extern int32_t tsTsdbPageCacheSize;
+
+// tsdb read-ahead
+extern int32_t tsQueryPrefetchBlocks;
+extern int32_t tsQueryPrefetchMemMB;
+
+// group by/partition by spill
+extern int32_t tsQueryGroupMemMB;
+
+// hash join
+extern int32_t tsQueryJoinMemMB;
+
+// meta tag filter result cache
+extern int32_t tsTagFilterCacheSize;
+
+// meta columnar tag store
+extern bool    tsTagColumnarStore;
+extern int32_t tsTagColumnarStoreSize;
+
+// sync replication pipeline
+extern int32_t tsSyncPipelineEntries;
+extern int32_t tsSyncPipelineSize;
+extern int32_t tsSyncProposeBatch;
+
+// sync log entry cache
+extern int32_t tsSyncLogCacheEntries;
+extern int32_t tsSyncLogCacheSize;
+
 #define NEEDTO_COMPRESSS_MSG(size) (tsCompressMsgSize != -1 && (size) > tsCompressMsgSize)
 
 int32_t taosCreateLog(const char *logname, int32_t logFileNum, const char *cfgDir, const char **envCmd,
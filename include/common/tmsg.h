@@ -1067,6 +1067,9 @@ typedef struct {
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
   int64_t errors;
+  int64_t pgCacheHit;    // tsdb page cache hits since the last report
+  int64_t pgCacheMiss;   // tsdb page cache misses since the last report
+  int64_t pgCacheUsage;  // bytes held by the tsdb page caches of all vnodes
 } SVnodesStat;
 
 typedef struct {
@@ -1083,6 +1086,9 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t pgCacheHit;  // local to the dnode monitor, not sent to mnode
+  int64_t pgCacheMiss;
+  int64_t pgCacheUsage;
 } SVnodeLoad;
 
 typedef struct {
@@ -2891,6 +2897,10 @@ typedef struct {
   int64_t  timeout;
   // int64_t      currentOffset;
   STqOffsetVal reqOffset;
+  // sent as a raw struct, new fields go after the existing ones
+  int8_t  compressed;  // compress the data blocks of the response
+  int32_t batchRows;   // rows expected in one response, 0 for the vnode default
+  int32_t batchBytes;  // bytes expected in one response, 0 for the vnode default
 } SMqPollReq;
 
 typedef struct {
@@ -303,6 +303,14 @@ int32_t ctgdLaunchAsyncCall(SCatalog* pCtg, SRequestConnInfo* pConn, uint64_t re
 
 int32_t catalogClearCache(void);
 
+/**
+ * Get the epoch of the catalog cache, it's increased when the schema or vgroup of a cached table changes, when a
+ * cached table, db or vgroup list is removed, when user auth info is replaced and when the cache is cleared, so
+ * results derived from the cache can be checked for staleness.
+ * @return cache epoch
+ */
+int64_t catalogGetCacheEpoch(void);
+
 /**
  * Destroy catalog and relase all resources
  */
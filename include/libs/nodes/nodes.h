@@ -252,7 +252,9 @@ typedef enum ENodeType {
   QUERY_NODE_PHYSICAL_PLAN_QUERY_INSERT,
   QUERY_NODE_PHYSICAL_PLAN_DELETE,
   QUERY_NODE_PHYSICAL_SUBPLAN,
-  QUERY_NODE_PHYSICAL_PLAN
+  QUERY_NODE_PHYSICAL_PLAN,
+  // node types are serialized as numbers, new ones are appended here to keep the existing values
+  QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN
 } ENodeType;
 
 /**
@@ -378,6 +378,15 @@ typedef struct SSortMergeJoinPhysiNode {
   EOrder     inputTsOrder;
 } SSortMergeJoinPhysiNode;
 
+typedef struct SHashJoinPhysiNode {
+  SPhysiNode node;
+  EJoinType  joinType;
+  SNodeList* pOnLeft;   // equal keys of the left child
+  SNodeList* pOnRight;  // equal keys of the right child, pairwise with pOnLeft
+  SNode*     pOnConditions;
+  SNodeList* pTargets;
+} SHashJoinPhysiNode;
+
 typedef struct SAggPhysiNode {
   SPhysiNode node;
   SNodeList* pExprs;  // these are expression list of group_by_clause and parameter expression of aggregate function
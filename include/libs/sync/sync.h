@@ -36,7 +36,15 @@ extern bool gRaftDetailLog;
 #define SYNC_MAX_RECV_TIME_RANGE_MS  1200
 #define SYNC_ADD_QUORUM_COUNT        3
 
-#define SYNC_MAX_BATCH_SIZE 1
+#define SYNC_MAX_BATCH_SIZE 64
+#define SYNC_LOG_CACHE_COUNT 1024
+#define SYNC_LOG_CACHE_BYTES (16 * 1024 * 1024)
+
+#define SYNC_APPEND_BATCH_MAX_COUNT 64
+#define SYNC_APPEND_BATCH_MAX_BYTES (1024 * 1024)
+#define SYNC_PIPELINE_MAX_MSGS      32
+#define SYNC_PIPELINE_ENTRIES       1024
+#define SYNC_PIPELINE_BYTES         (16 * 1024 * 1024)
 #define SYNC_INDEX_BEGIN    0
 #define SYNC_INDEX_INVALID  -1
 #define SYNC_TERM_INVALID   0xFFFFFFFFFFFFFFFF
@@ -188,6 +196,7 @@ typedef struct SSyncLogStore {
   SyncTerm (*syncLogLastTerm)(struct SSyncLogStore* pLogStore);
 
   int32_t (*syncLogAppendEntry)(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry);
+  int32_t (*syncLogAppendEntryBatch)(struct SSyncLogStore* pLogStore, SSyncRaftEntry** aEntry, int32_t nEntry);
   int32_t (*syncLogGetEntry)(struct SSyncLogStore* pLogStore, SyncIndex index, SSyncRaftEntry** ppEntry);
   int32_t (*syncLogTruncate)(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
 
@@ -198,6 +207,10 @@ typedef struct SSyncInfo {
   ESyncStrategy snapshotStrategy;
   SyncGroupId   vgId;
   int32_t       batchSize;
+  int32_t       pipelineEntries;  // max entries in flight to one peer, 0 for default
+  int32_t       pipelineBytes;    // max bytes in flight to one peer, 0 for default
+  int32_t       logCacheEntries;  // recent log entries kept in memory, 0 for default
+  int64_t       logCacheBytes;    // bytes of the cached log entries, 0 for default
   SSyncCfg      syncCfg;
   char          path[TSDB_FILENAME_LEN];
   SWal*         pWal;
@@ -424,6 +424,7 @@ typedef struct SyncAppendEntriesReply {
   bool      success;
   SyncIndex matchIndex;
   int64_t   startTime;
+  SyncIndex lastSendIndex;  // the last index of the AppendEntriesBatch replied
 } SyncAppendEntriesReply;
 
 SyncAppendEntriesReply* syncAppendEntriesReplyBuild(int32_t vgId);
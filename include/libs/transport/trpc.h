@@ -81,6 +81,7 @@ typedef struct SRpcInit {
   int32_t  sessions;      // number of sessions allowed
   int8_t   connType;      // TAOS_CONN_UDP, TAOS_CONN_TCPC, TAOS_CONN_TCPS
   int32_t  idleTime;      // milliseconds, 0 means idle timer is disabled
+  int32_t  batchDelay;    // milliseconds to hold small sends for coalescing, 0 means flush once per wakeup
 
   // the following is for client app ecurity only
   char *user;  // user name
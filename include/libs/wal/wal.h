@@ -121,6 +121,13 @@ typedef struct SWal {
   SWalCkHead writeHead;
 } SWal;
 
+typedef struct {
+  tmsg_t       msgType;
+  SWalSyncInfo syncMeta;
+  const void  *body;
+  int32_t      bodyLen;
+} SWalAppendItem;
+
 typedef struct {
   int64_t refId;
   int64_t refVer;
@@ -170,6 +177,9 @@ int32_t walWriteWithSyncInfo(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo
 // Assign version automatically and return to caller,
 // -1 will be returned for failed writes
 int64_t walAppendLog(SWal *, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body, int32_t bodyLen);
+// Append a batch with one write per file, versions are assigned consecutively from the returned one,
+// -1 will be returned for failed writes
+int64_t walAppendLogBatch(SWal *, const SWalAppendItem *aItem, int32_t nItem);
 
 void walFsync(SWal *, bool force);
 
@@ -44,6 +44,12 @@ extern "C" {
 
 typedef struct TdFile *TdFilePtr;
 
+// one buffer of a vectored write
+typedef struct {
+  const void *buf;
+  int64_t     len;
+} TdFileVec;
+
 #define TD_FILE_CREATE   0x0001
 #define TD_FILE_WRITE    0x0002
 #define TD_FILE_READ     0x0004
@@ -78,6 +84,7 @@ int32_t taosFsyncFile(TdFilePtr pFile);
 int64_t taosReadFile(TdFilePtr pFile, void *buf, int64_t count);
 int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset);
 int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count);
+int64_t taosWritevFile(TdFilePtr pFile, const TdFileVec *aVec, int32_t nVec);
 void    taosFprintfFile(TdFilePtr pFile, const char *format, ...);
 
 int64_t taosGetLineFile(TdFilePtr pFile, char **__restrict ptrBuf);
@@ -51,6 +51,15 @@ extern "C" {
 #define HEAD_MODE(x) x % 2
 #define HEAD_ALGO(x) x / 2
 
+// instruction set used by the decompressors, selected at runtime from cpuid
+#define TD_SIMD_NONE   0
+#define TD_SIMD_SSE42  1
+#define TD_SIMD_AVX2   2
+#define TD_SIMD_AVX512 3
+
+int8_t tsGetSimdLevel();
+int8_t tsSetSimdLevel(int8_t level);  // capped by what the CPU supports, returns the level in effect
+
 extern int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type);
 extern int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output,
                                   const char type);
@@ -65,6 +65,7 @@ void taos_cleanup(void) {
 
   fmFuncMgtDestroy();
   qCleanupKeywordsTable();
+  qCleanupInsertTemplates();
 
   id = clientConnRefPool;
   clientConnRefPool = -1;
@@ -815,7 +816,7 @@ void doAsyncQuery(SRequestObj *pRequest, bool updateMetaForce) {
   if (!updateMetaForce) {
     STscObj            *pTscObj = pRequest->pTscObj;
     SAppClusterSummary *pActivity = &pTscObj->pAppInfo->summary;
-    if (NULL == pQuery->pRoot) {
+    if (NULL == pQuery->pRoot || QUERY_NODE_VNODE_MODIF_STMT == nodeType(pQuery->pRoot)) {
       atomic_add_fetch_64((int64_t *)&pActivity->numOfInsertsReq, 1);
     } else if (QUERY_NODE_SELECT_STMT == pQuery->pRoot->type) {
       atomic_add_fetch_64((int64_t *)&pActivity->numOfQueryReq, 1);
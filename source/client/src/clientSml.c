@@ -3,6 +3,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+// the intrinsic header uses malloc/free, so it must come before os.h poisons them
+#if defined(__SSE2__) && !defined(__SANITIZE_ADDRESS__)
+#define SML_SIMD_SCAN
+#include <emmintrin.h>
+#endif
+
 #include "cJSON.h"
 #include "catalog.h"
 #include "clientInt.h"
@@ -64,6 +70,53 @@
     }                                        \
   }
 
+// bytes with a meaning in line protocol, the scanners below skip anything else 16 bytes at a time
+#define IS_SML_SPECIAL(c) ((c) == SPACE || (c) == COMMA || (c) == EQUAL || (c) == QUOTE || (c) == SLASH)
+
+#ifdef SML_SIMD_SCAN
+static FORCE_INLINE int32_t smlSpecialMask(__m128i v) {
+  __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(SPACE)), _mm_cmpeq_epi8(v, _mm_set1_epi8(COMMA)));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(EQUAL)));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(QUOTE)));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(SLASH)));
+  return _mm_movemask_epi8(m);
+}
+#endif
+
+// the first special byte or the terminating '\0' from sql on
+static FORCE_INLINE const char *smlSkipPlainStr(const char *sql) {
+#ifdef SML_SIMD_SCAN
+  // aligned loads never cross a page, so reading beyond the terminator is harmless
+  const char *p = (const char *)((uintptr_t)sql & ~(uintptr_t)15);
+  __m128i     v = _mm_load_si128((const __m128i *)p);
+  int32_t     mask = smlSpecialMask(v) | _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+
+  mask >>= (sql - p);
+  if (mask) return sql + __builtin_ctz(mask);
+
+  for (p += 16;; p += 16) {
+    v = _mm_load_si128((const __m128i *)p);
+    mask = smlSpecialMask(v) | _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    if (mask) return p + __builtin_ctz(mask);
+  }
+#else
+  while (*sql != '\0' && !IS_SML_SPECIAL(*sql)) sql++;
+  return sql;
+#endif
+}
+
+// the first special byte in [sql, end), or end
+static FORCE_INLINE const char *smlSkipPlain(const char *sql, const char *end) {
+#ifdef SML_SIMD_SCAN
+  for (; end - sql >= 16; sql += 16) {
+    int32_t mask = smlSpecialMask(_mm_loadu_si128((const __m128i *)sql));
+    if (mask) return sql + __builtin_ctz(mask);
+  }
+#endif
+  while (sql < end && !IS_SML_SPECIAL(*sql)) sql++;
+  return sql;
+}
+
 #define IS_INVALID_COL_LEN(len)   ((len) <= 0 || (len) >= TSDB_COL_NAME_LEN)
 #define IS_INVALID_TABLE_LEN(len) ((len) <= 0 || (len) >= TSDB_TABLE_NAME_LEN)
 
@@ -152,12 +205,13 @@ typedef struct {
   SRequestObj     *request;
   tsem_t           sem;
   TdThreadSpinlock lock;
+  int32_t          total;     // number of batches
+  int32_t          finished;  // number of batches done, guarded by lock
 } Params;
 
 typedef struct {
   int64_t id;
   Params *params;
-  bool    isLast;
 
   SMLProtocolType protocol;
   int8_t          precision;
@@ -588,11 +642,40 @@ end:
   return code;
 }
 
+// Parse a plain decimal integer of at most 18 digits, which can not overflow. Anything else, i.e. a fraction, an
+// exponent, a hex number, inf or nan, is left to strtod.
+static bool smlParseInteger(const char *pVal, int32_t len, int64_t *pInt, char **endptr) {
+  const char *p = pVal;
+  const char *end = pVal + len;
+  bool        neg = false;
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    neg = (*p == '-');
+    p++;
+  }
+
+  const char *digits = p;
+  uint64_t    v = 0;
+  while (p < end && *p >= '0' && *p <= '9') {
+    v = v * 10 + (*p - '0');
+    p++;
+  }
+
+  if (p == digits || p - digits > 18) return false;
+  if (p < end && (*p == '.' || *p == 'e' || *p == 'E' || *p == 'x' || *p == 'X')) return false;
+
+  *pInt = neg ? -(int64_t)v : (int64_t)v;
+  *endptr = (char *)p;
+  return true;
+}
+
 static bool smlParseNumber(SSmlKv *kvVal, SSmlMsgBuf *msg) {
   const char *pVal = kvVal->value;
   int32_t     len = kvVal->length;
   char       *endptr = NULL;
-  double      result = taosStr2Double(pVal, &endptr);
+  int64_t     iv = 0;
+  bool        isInt = smlParseInteger(pVal, len, &iv, &endptr);
+  double      result = isInt ? (double)iv : taosStr2Double(pVal, &endptr);
   if (pVal == endptr) {
     smlBuildInvalidDataMsg(msg, "invalid data", pVal);
     return false;
@@ -622,7 +705,7 @@ static bool smlParseNumber(SSmlKv *kvVal, SSmlMsgBuf *msg) {
       return true;
     }
     kvVal->type = TSDB_DATA_TYPE_BIGINT;
-    kvVal->i = (int64_t)result;
+    kvVal->i = isInt ? iv : (int64_t)result;
   } else if ((left == 1 && *endptr == 'u') || (left == 3 && strncasecmp(endptr, "u64", left) == 0)) {
     if (result >= (double)UINT64_MAX || result < 0) {
       errno = 0;
@@ -916,6 +999,8 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
 
   // parse measure
   while (*sql != '\0') {
+    sql = smlSkipPlainStr(sql);
+    if (*sql == '\0') break;
     if ((sql != elements->measure) && IS_SLASH_LETTER(sql)) {
       MOVE_FORWARD_ONE(sql, strlen(sql) + 1);
       continue;
@@ -942,6 +1027,8 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
     if (*sql == COMMA) sql++;
     elements->tags = sql;
     while (*sql != '\0') {
+      sql = smlSkipPlainStr(sql);
+      if (*sql == '\0') break;
       if (IS_SPACE(sql)) {
         break;
       }
@@ -956,6 +1043,8 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
   elements->cols = sql;
   bool isInQuote = false;
   while (*sql != '\0') {
+    sql = smlSkipPlainStr(sql);
+    if (*sql == '\0') break;
     if (IS_QUOTE(sql)) {
       isInQuote = !isInQuote;
     }
@@ -978,7 +1067,8 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
   JUMP_SPACE(sql)
   elements->timestamp = sql;
   while (*sql != '\0') {
-    if (*sql == SPACE) {
+    sql = smlSkipPlainStr(sql);
+    if (*sql == SPACE || *sql == '\0') {
       break;
     }
     sql++;
@@ -1151,6 +1241,8 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
 
     while (sql < data + len) {
       // parse key
+      sql = smlSkipPlain(sql, data + len);
+      if (sql >= data + len) break;
       if (IS_COMMA(sql)) {
         smlBuildInvalidDataMsg(msg, "invalid data", sql);
         return TSDB_CODE_SML_INVALID_DATA;
@@ -1178,6 +1270,8 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
     bool        isInQuote = false;
     while (sql < data + len) {
       // parse value
+      sql = smlSkipPlain(sql, data + len);
+      if (sql >= data + len) break;
       if (!isTag && IS_QUOTE(sql)) {
         isInQuote = !isInQuote;
         sql++;
@@ -1554,6 +1648,8 @@ static SSmlHandle* smlBuildSmlInfo(STscObj* pTscObj, SRequestObj* request, SMLPr
 
   return info;
 cleanup:
+  // the request stays with the caller
+  info->pRequest = NULL;
   smlDestroyInfo(info);
   return NULL;
 }
@@ -2373,9 +2469,8 @@ static int32_t smlParseLine(SSmlHandle *info, char *lines[], int numLines) {
   return code;
 }
 
-static int smlProcess(SSmlHandle *info, char *lines[], int numLines) {
+static int32_t smlParseBatch(SSmlHandle *info, char *lines[], int numLines) {
   int32_t code = TSDB_CODE_SUCCESS;
-  int32_t retryNum = 0;
 
   info->cost.parseTime = taosGetTimestampUs();
 
@@ -2388,6 +2483,12 @@ static int smlProcess(SSmlHandle *info, char *lines[], int numLines) {
   info->cost.lineNum = numLines;
   info->cost.numOfSTables = taosHashGetSize(info->superTables);
   info->cost.numOfCTables = taosHashGetSize(info->childTables);
+  return code;
+}
+
+static int32_t smlInsertBatch(SSmlHandle *info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t retryNum = 0;
 
   info->cost.schemaTime = taosGetTimestampUs();
 
@@ -2411,6 +2512,68 @@ static int smlProcess(SSmlHandle *info, char *lines[], int numLines) {
   return code;
 }
 
+/*
+ * The batches of one schemaless insert are parsed by the client task queue ahead of the caller, which then alters the
+ * schemas, binds and sends the batches one by one in order. Sending is asynchronous, so batch N is on the wire while
+ * batch N + 1 is bound and later batches are being parsed. Only a window of batches is parsed ahead, to bound the
+ * memory held. A parse task never waits, so the task queue is not held up for the responses it also processes.
+ */
+typedef struct {
+  SSmlHandle *info;
+  char      **lines;
+  int32_t     numLines;
+  int32_t     code;
+  tsem_t      parsed;
+} SSmlBatch;
+
+typedef void (*__sml_send_fn_t)(SSmlBatch *pBatch);
+
+typedef struct {
+  SSmlBatch      *batches;
+  int32_t         numOfBatches;
+  __sml_send_fn_t sendFp;  // called in batch order once the batch is parsed
+} SSmlPipeline;
+
+static int32_t smlParseBatchFp(void *param) {
+  SSmlBatch *pBatch = (SSmlBatch *)param;
+  pBatch->code = smlParseBatch(pBatch->info, pBatch->lines, pBatch->numLines);
+  tsem_post(&pBatch->parsed);
+  return 0;
+}
+
+static void smlSendBatch(SSmlBatch *pBatch) {
+  // the batch may be finished and destroyed by the callback since the insert is launched
+  SSmlHandle *info = pBatch->info;
+  int32_t     code = pBatch->code;
+  if (code == TSDB_CODE_SUCCESS) {
+    code = smlInsertBatch(info);
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    info->pRequest->body.queryFp(info, info->pRequest, code);
+  }
+}
+
+static void smlRunPipeline(SSmlPipeline *pPipe) {
+  int32_t window = pPipe->numOfBatches > 1 ? tsSmlParseAhead : 0;
+  int32_t numOfIssued = 0;
+
+  for (int32_t i = 0; i < pPipe->numOfBatches; i++) {
+    SSmlBatch *pBatch = &pPipe->batches[i];
+
+    // every issued batch is waited for below, so no task refers to the pipeline after it returns
+    for (; window > 0 && numOfIssued < pPipe->numOfBatches && numOfIssued <= i + window; numOfIssued++) {
+      taosAsyncExec(smlParseBatchFp, &pPipe->batches[numOfIssued], NULL);
+    }
+
+    if (i < numOfIssued) {
+      tsem_wait(&pBatch->parsed);
+    } else {
+      pBatch->code = smlParseBatch(pBatch->info, pBatch->lines, pBatch->numLines);
+    }
+    (*pPipe->sendFp)(pBatch);
+  }
+}
+
 static int32_t isSchemalessDb(STscObj *taos, SRequestObj *request) {
 //  SCatalog *catalog = NULL;
 //  int32_t   code = catalogGetHandle(((STscObj *)taos)->pAppInfo->clusterId, &catalog);
@@ -2457,12 +2620,13 @@ static void smlInsertCallback(void *param, void *res, int32_t code) {
   }else{
     info->params->request->body.resInfo.numOfRows += info->affectedRows;
   }
+  // batches may finish in any order, the last one to finish wakes up the caller
+  bool isLast = (++info->params->finished == info->params->total);
   taosThreadSpinUnlock(&info->params->lock);
   // unlock
 
   uDebug("SML:0x%" PRIx64 " insert finished, code: %d, rows: %d, total: %d", info->id, code, rows, info->affectedRows);
   Params *pParam = info->params;
-  bool    isLast = info->isLast;
   info->cost.endTime = taosGetTimestampUs();
   info->cost.code = code;
   smlPrintStatisticInfo(info);
@@ -2506,13 +2670,14 @@ TAOS_RES* taos_schemaless_insert(TAOS* taos, char* lines[], int numLines, int pr
     return NULL;
   }
 
-  int    batchs = 0;
-  STscObj* pTscObj = request->pTscObj;
+  int          batchs = 0;
+  SSmlPipeline pipe = {.sendFp = smlSendBatch};
+  STscObj*     pTscObj = request->pTscObj;
 
   pTscObj->schemalessType = 1;
   SSmlMsgBuf msg = {ERROR_MSG_BUF_DEFAULT_SIZE, request->msgBuf};
 
-  Params params;
+  Params params = {0};
   params.request = request;
   tsem_init(&params.sem, 0, 0);
   taosThreadSpinInit(&(params.lock), 0);
@@ -2557,42 +2722,60 @@ TAOS_RES* taos_schemaless_insert(TAOS* taos, char* lines[], int numLines, int pr
   }
 
   batchs = ceil(((double)numLines) / LINE_BATCH);
+  pipe.batches = (SSmlBatch *)taosMemoryCalloc(batchs, sizeof(SSmlBatch));
+  if (!pipe.batches) {
+    request->code = TSDB_CODE_OUT_OF_MEMORY;
+    goto end;
+  }
+
   for (int i = 0; i < batchs; ++i) {
     SRequestObj* req = (SRequestObj*)createRequest(pTscObj->id, TSDB_SQL_INSERT);
     if(!req){
       request->code = TSDB_CODE_OUT_OF_MEMORY;
       uError("SML:taos_schemaless_insert error request is null");
-      goto end;
+      goto _destroy_batches;
     }
     SSmlHandle* info = smlBuildSmlInfo(pTscObj, req, (SMLProtocolType)protocol, precision);
     if(!info){
+      destroyRequest(req);
       request->code = TSDB_CODE_OUT_OF_MEMORY;
       uError("SML:taos_schemaless_insert error SSmlHandle is null");
-      goto end;
+      goto _destroy_batches;
     }
 
-    int32_t perBatch = LINE_BATCH;
-
-    if (numLines > perBatch) {
-      numLines -= perBatch;
-      info->isLast = false;
-    } else {
-      perBatch = numLines;
-      numLines = 0;
-      info->isLast = true;
-    }
+    int32_t perBatch = TMIN(numLines, LINE_BATCH);
+    numLines -= perBatch;
 
     info->params = &params;
     info->affectedRows = perBatch;
     info->pRequest->body.queryFp = smlInsertCallback;
     info->pRequest->body.param = info;
-    int32_t code = smlProcess(info, lines, perBatch);
+
+    SSmlBatch *pBatch = &pipe.batches[pipe.numOfBatches++];
+    pBatch->info = info;
+    pBatch->lines = lines;
+    pBatch->numLines = perBatch;
+    tsem_init(&pBatch->parsed, 0, 0);
     lines += perBatch;
-    if (code != TSDB_CODE_SUCCESS) {
-      info->pRequest->body.queryFp(info, req, code);
-    }
   }
+
+  params.total = batchs;
+  smlRunPipeline(&pipe);
+
+  for (int i = 0; i < pipe.numOfBatches; ++i) {
+    tsem_destroy(&pipe.batches[i].parsed);
+  }
+  taosMemoryFree(pipe.batches);
   tsem_wait(&params.sem);
+  goto end;
+
+_destroy_batches:
+  // nothing has been sent yet
+  for (int i = 0; i < pipe.numOfBatches; ++i) {
+    smlDestroyInfo(pipe.batches[i].info);
+    tsem_destroy(&pipe.batches[i].parsed);
+  }
+  taosMemoryFree(pipe.batches);
 
 end:
   taosThreadSpinDestroy(&params.lock);
@@ -58,6 +58,9 @@ struct tmq_conf_t {
   int8_t  withTbName;
   int8_t  snapEnable;
   int32_t snapBatchSize;
+  int8_t  compressed;
+  int32_t batchRows;
+  int32_t batchBytes;
 
   bool hbBgEnable;
 
@@ -77,8 +80,11 @@ struct tmq_t {
   char    clientId[256];
   int8_t  withTbName;
   int8_t  useSnapshot;
+  int8_t  compressed;
   int8_t  autoCommit;
   int32_t autoCommitInterval;
+  int32_t batchRows;
+  int32_t batchBytes;
   int32_t resetOffsetCfg;
   int64_t consumerId;
 
@@ -303,6 +309,32 @@ tmq_conf_res_t tmq_conf_set(tmq_conf_t* conf, const char* key, const char* value
     return TMQ_CONF_OK;
   }
 
+  if (strcmp(key, "msg.batch.rows") == 0) {
+    int32_t rows = atoi(value);
+    if (rows < 0) return TMQ_CONF_INVALID;
+    conf->batchRows = rows;
+    return TMQ_CONF_OK;
+  }
+
+  if (strcmp(key, "msg.batch.bytes") == 0) {
+    int32_t bytes = atoi(value);
+    if (bytes < 0) return TMQ_CONF_INVALID;
+    conf->batchBytes = bytes;
+    return TMQ_CONF_OK;
+  }
+
+  if (strcmp(key, "msg.enable.compression") == 0) {
+    if (strcmp(value, "true") == 0) {
+      conf->compressed = true;
+      return TMQ_CONF_OK;
+    } else if (strcmp(value, "false") == 0) {
+      conf->compressed = false;
+      return TMQ_CONF_OK;
+    } else {
+      return TMQ_CONF_INVALID;
+    }
+  }
+
   if (strcmp(key, "enable.heartbeat.background") == 0) {
     if (strcmp(value, "true") == 0) {
       conf->hbBgEnable = true;
@@ -902,6 +934,9 @@ tmq_t* tmq_consumer_new(tmq_conf_t* conf, char* errstr, int32_t errstrLen) {
   strcpy(pTmq->groupId, conf->groupId);
   pTmq->withTbName = conf->withTbName;
   pTmq->useSnapshot = conf->snapEnable;
+  pTmq->compressed = conf->compressed;
+  pTmq->batchRows = conf->batchRows;
+  pTmq->batchBytes = conf->batchBytes;
   pTmq->autoCommit = conf->autoCommit;
   pTmq->autoCommitInterval = conf->autoCommitInterval;
   pTmq->commitCb = conf->commitCb;
@@ -1067,6 +1102,34 @@ void tmq_conf_set_auto_commit_cb(tmq_conf_t* conf, tmq_commit_cb* cb, void* para
   conf->commitCbUserParam = param;
 }
 
+static int32_t tmqDecompressRspBlocks(SArray* blockData, SArray* blockDataLen) {
+  int32_t numOfBlocks = taosArrayGetSize(blockData);
+  for (int32_t i = 0; i < numOfBlocks; i++) {
+    SRetrieveTableRsp* pRetrieve = taosArrayGetP(blockData, i);
+    if (!pRetrieve->compressed) continue;
+
+    int32_t            len = sizeof(SRetrieveTableRsp) + blockGetDecompressedSize(pRetrieve->data);
+    SRetrieveTableRsp* pRaw = taosMemoryMalloc(len);
+    if (pRaw == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+
+    memcpy(pRaw, pRetrieve, sizeof(SRetrieveTableRsp));
+    pRaw->compressed = 0;
+    if (blockDecompress(pRetrieve->data, pRaw->data, &len) < 0) {
+      taosMemoryFree(pRaw);
+      return -1;
+    }
+
+    len += sizeof(SRetrieveTableRsp);
+    taosMemoryFree(pRetrieve);
+    taosArraySet(blockData, i, &pRaw);
+    taosArraySet(blockDataLen, i, &len);
+  }
+  return 0;
+}
+
 int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
   SMqPollCbParam* pParam = (SMqPollCbParam*)param;
   SMqClientVg*    pVg = pParam->pVg;
@@ -1143,6 +1206,14 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
     tDecoderClear(&decoder);
     memcpy(&pRspWrapper->dataRsp, pMsg->pData, sizeof(SMqRspHead));
 
+    if (tmqDecompressRspBlocks(pRspWrapper->dataRsp.blockData, pRspWrapper->dataRsp.blockDataLen) < 0) {
+      tscWarn("msg discard from vgId:%d, epoch %d since decompress failed, %s", vgId, epoch, terrstr());
+      tDeleteSMqDataRsp(&pRspWrapper->dataRsp);
+      taosFreeQitem(pRspWrapper);
+      taosMemoryFree(pMsg->pData);
+      goto CREATE_MSG_FAIL;
+    }
+
     tscDebug("consumer:%" PRId64 ", recv poll: vgId:%d, req offset %" PRId64 ", rsp offset %" PRId64 " type %d",
              tmq->consumerId, pVg->vgId, pRspWrapper->dataRsp.reqOffset.version, pRspWrapper->dataRsp.rspOffset.version,
              rspType);
@@ -1159,6 +1230,14 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
     tDecodeSTaosxRsp(&decoder, &pRspWrapper->taosxRsp);
     tDecoderClear(&decoder);
     memcpy(&pRspWrapper->taosxRsp, pMsg->pData, sizeof(SMqRspHead));
+
+    if (tmqDecompressRspBlocks(pRspWrapper->taosxRsp.blockData, pRspWrapper->taosxRsp.blockDataLen) < 0) {
+      tscWarn("msg discard from vgId:%d, epoch %d since decompress failed, %s", vgId, epoch, terrstr());
+      tDeleteSTaosxRsp(&pRspWrapper->taosxRsp);
+      taosFreeQitem(pRspWrapper);
+      taosMemoryFree(pMsg->pData);
+      goto CREATE_MSG_FAIL;
+    }
   } else {
     ASSERT(0);
   }
@@ -1428,6 +1507,9 @@ SMqPollReq* tmqBuildConsumeReqImpl(tmq_t* tmq, int64_t timeout, SMqClientTopic*
   pReq->reqId = generateRequestId();
 
   pReq->useSnapshot = tmq->useSnapshot;
+  pReq->compressed = tmq->compressed;
+  pReq->batchRows = tmq->batchRows;
+  pReq->batchBytes = tmq->batchBytes;
 
   pReq->head.vgId = htonl(pVg->vgId);
   pReq->head.contLen = htonl(sizeof(SMqPollReq));
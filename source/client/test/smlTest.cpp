@@ -15,9 +15,15 @@
 
 #include <gtest/gtest.h>
 
+// clientSml.c is included below, after os.h has poisoned malloc/free, so its intrinsic header has to come first
+#if defined(__SSE2__) && !defined(__SANITIZE_ADDRESS__)
+#include <emmintrin.h>
+#endif
+
 #include <taoserror.h>
 #include <tglobal.h>
 #include <iostream>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -741,3 +747,167 @@ TEST(testCase, sml_col_4096_Test) {
   ASSERT_NE(ret, 0);
   smlDestroyInfo(info);
 }
+
+TEST(testCase, smlSkipPlain_Test) {
+  const char  alphabet[] = "ab ,=\"\\xy";
+  char       *buf = (char *)taosMemoryCalloc(1, 256);
+  ASSERT_NE(buf, nullptr);
+
+  taosSeedRand(0);
+  for (int32_t loop = 0; loop < 10000; loop++) {
+    int32_t off = taosRand() % 32;
+    int32_t len = taosRand() % 128;
+    for (int32_t i = 0; i < len; i++) {
+      buf[off + i] = (taosRand() % 8 == 0) ? alphabet[taosRand() % (sizeof(alphabet) - 1)] : 'a' + taosRand() % 3;
+    }
+    buf[off + len] = '\0';
+
+    for (int32_t start = 0; start <= len; start++) {
+      const char *sql = buf + off + start;
+      const char *end = buf + off + start + taosRand() % (len - start + 1);
+      const char *exp = sql;
+      while (*exp != '\0' && !IS_SML_SPECIAL(*exp)) exp++;
+      ASSERT_EQ(smlSkipPlainStr(sql), exp);
+
+      exp = sql;
+      while (exp < end && !IS_SML_SPECIAL(*exp)) exp++;
+      ASSERT_EQ(smlSkipPlain(sql, end), exp);
+    }
+  }
+
+  taosMemoryFree(buf);
+}
+
+TEST(testCase, smlParseInflux_perf_Test) {
+  char       msg[256] = {0};
+  SSmlMsgBuf msgBuf;
+  msgBuf.buf = msg;
+  msgBuf.len = 256;
+
+  const char *line =
+      "cpu_usage,host=server-0042,region=ap-southeast-1,datacenter=dc7,rack=r12 usage_user=23.5,usage_system=7.25,"
+      "usage_idle=69.25,usage_iowait=0.5i64,status=\"running normally\",online=t 1626006833639000000";
+  int32_t lineLen = strlen(line);
+  int32_t numOfLines = 100000;
+
+  char     *sql = (char *)taosMemoryCalloc(1, lineLen + 1);
+  SArray   *cols = taosArrayInit(16, POINTER_BYTES);
+  SHashObj *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  ASSERT_NE(sql, nullptr);
+  ASSERT_NE(cols, nullptr);
+  ASSERT_NE(dumplicateKey, nullptr);
+
+  int64_t parseTime = 0;
+  for (int32_t i = 0; i < numOfLines; i++) {
+    memcpy(sql, line, lineLen + 1);
+
+    int64_t      st = taosGetTimestampUs();
+    SSmlLineInfo elements = {0};
+    ASSERT_EQ(smlParseInfluxString(sql, &elements, &msgBuf), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(smlParseCols(elements.tags, elements.tagsLen, cols, NULL, true, dumplicateKey, &msgBuf),
+              TSDB_CODE_SUCCESS);
+    ASSERT_EQ(smlParseCols(elements.cols, elements.colsLen, cols, NULL, false, dumplicateKey, &msgBuf),
+              TSDB_CODE_SUCCESS);
+    parseTime += taosGetTimestampUs() - st;
+
+    ASSERT_EQ(taosArrayGetSize(cols), 10);
+    for (int32_t j = 0; j < taosArrayGetSize(cols); j++) {
+      taosMemoryFree(taosArrayGetP(cols, j));
+    }
+    taosArrayClear(cols);
+    taosHashClear(dumplicateKey);
+  }
+
+  double mb = (double)lineLen * numOfLines / 1024 / 1024;
+  printf("influx line protocol parse, lines:%d, %.2f MB, %.3f s, %.2f MB/s\n", numOfLines, mb, parseTime / 1e6,
+         mb / (parseTime / 1e6));
+
+  taosArrayDestroy(cols);
+  taosHashCleanup(dumplicateKey);
+  taosMemoryFree(sql);
+}
+
+namespace {
+
+// the batches seen by the fake sender, with whether each was parsed when it was handed over
+std::vector<int32_t> sentBatches;
+std::vector<int32_t> sentCodes;
+std::vector<bool>    sentParsed;
+SSmlBatch           *firstBatch = NULL;
+
+void smlFakeSend(SSmlBatch *pBatch) {
+  sentBatches.push_back(pBatch - firstBatch);
+  sentCodes.push_back(pBatch->code);
+  sentParsed.push_back(pBatch->info->cost.lineNum == pBatch->numLines || pBatch->code != TSDB_CODE_SUCCESS);
+}
+
+void smlRunTestPipeline(char **lines, int32_t numOfBatches, int32_t linesPerBatch) {
+  SSmlPipeline pipe = {.sendFp = smlFakeSend};
+  pipe.batches = (SSmlBatch *)taosMemoryCalloc(numOfBatches, sizeof(SSmlBatch));
+  firstBatch = pipe.batches;
+  for (int32_t i = 0; i < numOfBatches; i++) {
+    SSmlBatch *pBatch = &pipe.batches[pipe.numOfBatches++];
+    pBatch->info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_TELNET_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+    pBatch->lines = lines + i * linesPerBatch;
+    pBatch->numLines = linesPerBatch;
+    tsem_init(&pBatch->parsed, 0, 0);
+  }
+
+  sentBatches.clear();
+  sentCodes.clear();
+  sentParsed.clear();
+  smlRunPipeline(&pipe);
+
+  for (int32_t i = 0; i < pipe.numOfBatches; i++) {
+    smlDestroyInfo(pipe.batches[i].info);
+    tsem_destroy(&pipe.batches[i].parsed);
+  }
+  taosMemoryFree(pipe.batches);
+}
+
+}  // namespace
+
+TEST(testCase, smlPipeline_Test) {
+  ASSERT_EQ(initTaskQueue(), 0);
+  int32_t parseAhead = tsSmlParseAhead;
+  tsSmlParseAhead = 3;
+
+  const int32_t numOfBatches = 20;
+  const int32_t linesPerBatch = 4;
+  const int32_t errorBatch = 7;
+  char        **lines = (char **)taosMemoryCalloc(numOfBatches * linesPerBatch, POINTER_BYTES);
+  for (int32_t i = 0; i < numOfBatches * linesPerBatch; i++) {
+    lines[i] = (char *)taosMemoryCalloc(1, 128);
+    if (i / linesPerBatch == errorBatch && i % linesPerBatch == 2) {
+      snprintf(lines[i], 128, "sys.procs.running erere 42 host=web01");
+    } else {
+      snprintf(lines[i], 128, "sys.procs.running %d 42 host=web%d", 1479496100 + i, i % 5);
+    }
+  }
+
+  // the batches are handed over in order once parsed, a parse error goes to the sender with its batch
+  smlRunTestPipeline(lines, numOfBatches, linesPerBatch);
+  ASSERT_EQ(sentBatches.size(), numOfBatches);
+  for (int32_t i = 0; i < numOfBatches; i++) {
+    ASSERT_EQ(sentBatches[i], i);
+    ASSERT_TRUE(sentParsed[i]);
+    if (i == errorBatch) {
+      ASSERT_NE(sentCodes[i], TSDB_CODE_SUCCESS);
+    } else {
+      ASSERT_EQ(sentCodes[i], TSDB_CODE_SUCCESS);
+    }
+  }
+
+  // a single batch is parsed by the caller
+  smlRunTestPipeline(lines, 1, linesPerBatch);
+  ASSERT_EQ(sentBatches.size(), 1);
+  ASSERT_EQ(sentCodes[0], TSDB_CODE_SUCCESS);
+  ASSERT_TRUE(sentParsed[0]);
+
+  for (int32_t i = 0; i < numOfBatches * linesPerBatch; i++) {
+    taosMemoryFree(lines[i]);
+  }
+  taosMemoryFree(lines);
+  tsSmlParseAhead = parseAhead;
+  cleanupTaskQueue();
+}
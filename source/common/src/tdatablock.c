@@ -887,6 +887,187 @@ static int32_t* createTupleIndex(size_t rows) {
 
 static void destroyTupleIndex(int32_t* index) { taosMemoryFreeClear(index); }
 
+// the normalized sort key of all order columns in one tuple, the radix sort needs one pass for each byte of it
+#define SORT_KEY_MAX_LEN      16
+#define SORT_RADIX_MIN_ROWS   256
+
+/*
+ * The order columns of one tuple are encoded into a fixed-width key that can be compared with memcmp: the null flag
+ * goes first if the column has null values, followed by the value in big-endian with the sign bit flipped, and all the
+ * bytes of a value are inverted for descending order. Floating-point columns are only allowed to be the last key,
+ * since they are compared with epsilon instead of exactly.
+ */
+static int32_t getNormalizedSortKeyLen(const SSDataBlock* pDataBlock, const SArray* pOrderInfo) {
+  int32_t len = 0;
+  size_t  numOfOrders = taosArrayGetSize(pOrderInfo);
+
+  for (int32_t i = 0; i < numOfOrders; ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pDataBlock->pDataBlock, pOrder->slotId);
+    int8_t           type = pCol->info.type;
+
+    if (!IS_INTEGER_TYPE(type) && type != TSDB_DATA_TYPE_BOOL && type != TSDB_DATA_TYPE_TIMESTAMP &&
+        !(IS_FLOAT_TYPE(type) && i == numOfOrders - 1)) {
+      return -1;
+    }
+
+    len += pCol->info.bytes + (pCol->hasNull ? 1 : 0);
+    if (len > SORT_KEY_MAX_LEN) {
+      return -1;
+    }
+  }
+
+  return len;
+}
+
+static uint64_t normalizeSortKeyValue(int8_t type, const char* pData) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return (uint8_t)(*(int8_t*)pData) ^ 0x80u;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (uint16_t)(*(int16_t*)pData) ^ 0x8000u;
+    case TSDB_DATA_TYPE_INT:
+      return (uint32_t)(*(int32_t*)pData) ^ 0x80000000u;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return (uint64_t)(*(int64_t*)pData) ^ 0x8000000000000000ull;
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return *(uint8_t*)pData;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return *(uint16_t*)pData;
+    case TSDB_DATA_TYPE_UINT:
+      return *(uint32_t*)pData;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return *(uint64_t*)pData;
+    case TSDB_DATA_TYPE_FLOAT: {
+      float    v = GET_FLOAT_VAL(pData);
+      uint32_t u = 0;
+      if (isnan(v)) {  // nan is less than any other value, as in compareFloatVal
+        return 0;
+      }
+      if (v != 0) {  // -0.0 is equal to 0.0
+        memcpy(&u, &v, sizeof(u));
+      }
+      return (u & 0x80000000u) ? ~u : (u ^ 0x80000000u);
+    }
+    case TSDB_DATA_TYPE_DOUBLE: {
+      double   v = GET_DOUBLE_VAL(pData);
+      uint64_t u = 0;
+      if (isnan(v)) {
+        return 0;
+      }
+      if (v != 0) {
+        memcpy(&u, &v, sizeof(u));
+      }
+      return (u & 0x8000000000000000ull) ? ~u : (u ^ 0x8000000000000000ull);
+    }
+    default:
+      ASSERT(0);
+      return 0;
+  }
+}
+
+static void buildNormalizedSortKeys(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, char* pRecords,
+                                    int32_t recordSize) {
+  int32_t rows = pDataBlock->info.rows;
+  int32_t offset = 0;
+
+  // the order columns are encoded one after another, so each of them is scanned sequentially
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pDataBlock->pDataBlock, pOrder->slotId);
+    int32_t          bytes = pCol->info.bytes;
+    uint64_t         mask = (pOrder->order == TSDB_ORDER_DESC) ? UINT64_MAX : 0;
+
+    for (int32_t j = 0; j < rows; ++j) {
+      char* pKey = pRecords + (int64_t)j * recordSize + offset;
+
+      if (pCol->hasNull) {
+        if (colDataIsNull_f(pCol->nullbitmap, j)) {
+          *pKey = pOrder->nullFirst ? 0 : 1;
+          memset(pKey + 1, 0, bytes);
+          continue;
+        }
+
+        *pKey = pOrder->nullFirst ? 1 : 0;
+        pKey += 1;
+      }
+
+      uint64_t v = normalizeSortKeyValue(pCol->info.type, pCol->pData + (int64_t)j * bytes) ^ mask;
+      for (int32_t k = bytes - 1; k >= 0; --k) {
+        pKey[k] = (char)(v & 0xFF);
+        v >>= 8;
+      }
+    }
+
+    offset += bytes + (pCol->hasNull ? 1 : 0);
+  }
+
+  for (int32_t j = 0; j < rows; ++j) {
+    memcpy(pRecords + (int64_t)j * recordSize + offset, &j, sizeof(int32_t));
+  }
+}
+
+/*
+ * LSD radix sort of the normalized keys, one pass for each key byte. The histograms of all bytes are collected in a
+ * single scan, and a pass is skipped if all tuples have the same value in that byte, e.g., the high bytes of timestamps.
+ * Only the tuple index is permuted here, the columns are shuffled once by blockDataAssign.
+ */
+static int32_t blockDataRadixSort(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, int32_t keyLen,
+                                  int32_t* index) {
+  int32_t rows = pDataBlock->info.rows;
+  int32_t recordSize = keyLen + sizeof(int32_t);
+
+  char*     pRecords = taosMemoryMalloc((int64_t)rows * recordSize * 2);
+  uint32_t* pHist = taosMemoryCalloc(keyLen * 256, sizeof(uint32_t));
+  if (pRecords == NULL || pHist == NULL) {
+    taosMemoryFree(pRecords);
+    taosMemoryFree(pHist);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  char* pSrc = pRecords;
+  char* pDst = pRecords + (int64_t)rows * recordSize;
+  buildNormalizedSortKeys(pDataBlock, pOrderInfo, pSrc, recordSize);
+
+  for (int32_t j = 0; j < rows; ++j) {
+    const uint8_t* pKey = (const uint8_t*)pSrc + (int64_t)j * recordSize;
+    for (int32_t b = 0; b < keyLen; ++b) {
+      pHist[b * 256 + pKey[b]] += 1;
+    }
+  }
+
+  for (int32_t b = keyLen - 1; b >= 0; --b) {
+    uint32_t* pCount = pHist + b * 256;
+    if (pCount[(uint8_t)pSrc[b]] == (uint32_t)rows) {
+      continue;
+    }
+
+    uint32_t pos = 0;
+    for (int32_t k = 0; k < 256; ++k) {
+      uint32_t c = pCount[k];
+      pCount[k] = pos;
+      pos += c;
+    }
+
+    for (int32_t j = 0; j < rows; ++j) {
+      const char* pRec = pSrc + (int64_t)j * recordSize;
+      memcpy(pDst + (int64_t)(pCount[(uint8_t)pRec[b]]++) * recordSize, pRec, recordSize);
+    }
+
+    TSWAP(pSrc, pDst);
+  }
+
+  for (int32_t j = 0; j < rows; ++j) {
+    memcpy(&index[j], pSrc + (int64_t)j * recordSize + keyLen, sizeof(int32_t));
+  }
+
+  taosMemoryFree(pRecords);
+  taosMemoryFree(pHist);
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   ASSERT(pDataBlock != NULL && pOrderInfo != NULL);
   if (pDataBlock->info.rows <= 1) {
@@ -949,9 +1130,19 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
     pInfo->pColData = taosArrayGet(pDataBlock->pDataBlock, pInfo->slotId);
   }
 
-  terrno = 0;
-  taosqsort(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
-  if (terrno) return terrno;
+  int32_t keyLen = (rows >= SORT_RADIX_MIN_ROWS) ? getNormalizedSortKeyLen(pDataBlock, pOrderInfo) : -1;
+  if (keyLen > 0) {
+    int32_t code = blockDataRadixSort(pDataBlock, pOrderInfo, keyLen, index);
+    if (code != TSDB_CODE_SUCCESS) {
+      destroyTupleIndex(index);
+      terrno = code;
+      return code;
+    }
+  } else {
+    terrno = 0;
+    taosqsort(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
+    if (terrno) return terrno;
+  }
 
   int64_t p1 = taosGetTimestampUs();
 
@@ -2280,3 +2471,73 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   return pStart;
 }
 
+
+int32_t blockGetDecompressedSize(const char* pData) {
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+
+  const char*    pSchema = pData + metaSize - numOfCols * (sizeof(int8_t) + sizeof(int32_t) * 2);
+  const int32_t* colLen = (const int32_t*)(pData + metaSize - numOfCols * sizeof(int32_t));
+  const char*    pStart = pData + metaSize;
+
+  int32_t len = metaSize;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t colMetaSize = IS_VAR_DATA_TYPE(type) ? numOfRows * sizeof(int32_t) : BitmapLen(numOfRows);
+
+    pStart += colMetaSize;
+    len += colMetaSize + *(int32_t*)pStart;
+    pStart += htonl(colLen[i]);
+  }
+
+  return len;
+}
+
+int32_t blockDecompress(const char* pData, char* pOut, int32_t* pOutLen) {
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+
+  // the header is shared by both layouts, only the column lengths differ
+  memcpy(pOut, pData, metaSize);
+
+  const char*    pSchema = pData + metaSize - numOfCols * (sizeof(int8_t) + sizeof(int32_t) * 2);
+  const int32_t* colLen = (const int32_t*)(pData + metaSize - numOfCols * sizeof(int32_t));
+  int32_t*       outColLen = (int32_t*)(pOut + metaSize - numOfCols * sizeof(int32_t));
+  const char*    pStart = pData + metaSize;
+  char*          pDst = pOut + metaSize;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t colMetaSize = IS_VAR_DATA_TYPE(type) ? numOfRows * sizeof(int32_t) : BitmapLen(numOfRows);
+
+    memcpy(pDst, pStart, colMetaSize);
+    pStart += colMetaSize;
+    pDst += colMetaSize;
+
+    int32_t rawLen = *(int32_t*)pStart;
+    int32_t compLen = htonl(colLen[i]) - sizeof(int32_t);
+    pStart += sizeof(int32_t);
+
+    if (compLen == rawLen) {
+      memcpy(pDst, pStart, rawLen);
+    } else {
+      int32_t len = (*(tDataTypes[type].decompFunc))(pStart, compLen, numOfRows, pDst, rawLen, ONE_STAGE_COMP, NULL, 0);
+      if (len != rawLen) {
+        uError("failed to decompress column %d of data block, type:%d, expect len:%d, actual len:%d", i, type, rawLen,
+               len);
+        terrno = TSDB_CODE_COMPRESS_ERROR;
+        return -1;
+      }
+    }
+
+    outColLen[i] = htonl(rawLen);
+    pStart += compLen;
+    pDst += rawLen;
+  }
+
+  *pOutLen = pDst - pOut;
+  *(int32_t*)(pOut + sizeof(int32_t)) = *pOutLen;
+  return 0;
+}
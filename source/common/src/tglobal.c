@@ -62,10 +62,13 @@ int32_t tsNumOfVnodeFetchThreads = 4;
 int32_t tsNumOfVnodeWriteThreads = 2;
 int32_t tsNumOfVnodeSyncThreads = 2;
 int32_t tsNumOfVnodeRsmaThreads = 2;
+int32_t tsNumOfVnodePrefetchThreads = 2;
+int32_t tsNumOfVnodeCompactThreads = 1;
 int32_t tsNumOfQnodeQueryThreads = 4;
 int32_t tsNumOfQnodeFetchThreads = 4;
 int32_t tsNumOfSnodeSharedThreads = 2;
 int32_t tsNumOfSnodeUniqueThreads = 2;
+int32_t tsRpcBatchDelay = 0;  // ms to hold small dnode rpc sends for coalescing, 0 to flush once per wakeup
 
 // monitor
 bool     tsEnableMonitor = true;
@@ -87,11 +90,13 @@ char tsSmlChildTableName[TSDB_TABLE_NAME_LEN] = "";  // user defined child table
                                                      // If set to empty system will generate table name using MD5 hash.
 bool tsSmlDataFormat =
     true;  // true means that the name and order of cols in each line are the same(only for influx protocol)
+int32_t tsSmlParseAhead = 8;  // batches of one schemaless insert parsed by the task queue ahead of the sender
 
 // query
 int32_t tsQueryPolicy = 1;
 int32_t tsQuerySmaOptimize = 0;
 bool    tsQueryPlannerTrace = false;
+int32_t tsInsertTemplateCacheSize = 16;  // MB, parsed templates of the tables in INSERT statements, 0 to disable
 
 /*
  * denote if the server needs to compress response message at the application layer to client, including query rsp,
@@ -154,7 +159,8 @@ uint32_t tsCurRange = 100;                      // range
 char     tsCompressor[32] = "ZSTD_COMPRESSOR";  // ZSTD_COMPRESSOR or GZIP_COMPRESSOR
 
 // udf
-bool tsStartUdfd = true;
+bool    tsStartUdfd = true;
+int32_t tsUdfShmSize = 16;  // MB, shared memory between a udf session and udfd, 0 means disabled
 
 // internal
 int32_t tsTransPullupInterval = 2;
@@ -164,6 +170,42 @@ int32_t tsTtlPushInterval = 86400;
 int32_t tsGrantHBInterval = 60;
 int32_t tsUptimeInterval = 300;  // seconds
 
+// compaction
+int32_t tsCompactSttTrigger = 4;    // compact a file set once it has this many non-empty stt files
+int32_t tsCompactSttSizeMB = 64;    // or once its stt files hold this many MB
+int32_t tsCompactInterval = 86400;  // seconds, also compact sets with 2+ stt files at this interval, 0 to disable
+int32_t tsCompactIoRateMB = 64;     // MB per second a vnode compaction reads, it sleeps when ahead of the rate
+
+// tsdb page cache
+int32_t tsTsdbPageCacheSize = 16;  // MB per vnode, 0 to disable
+
+// tsdb read-ahead
+int32_t tsQueryPrefetchBlocks = 4;  // file blocks loaded ahead of each tsdb reader, 0 to disable
+int32_t tsQueryPrefetchMemMB = 64;  // MB of read-ahead block data each tsdb reader may hold
+
+// group by/partition by spill
+int32_t tsQueryGroupMemMB = 256;  // MB of groups kept in memory by each operator before spilling, 0 to disable
+
+// hash join
+// MB of memory for each hash join, shared by the input rows kept in memory before spilling to disk and the hash table
+// on the build side. The build side is not spilled, the query fails with TSDB_CODE_QRY_NOT_ENOUGH_BUFFER if its hash
+// table does not fit.
+int32_t tsQueryJoinMemMB = 256;
+
+// meta tag filter result cache
+int32_t tsTagFilterCacheSize = 64;  // MB per vnode, 0 to disable
+
+// meta columnar tag store
+bool    tsTagColumnarStore = true;
+int32_t tsTagColumnarStoreSize = 256;  // MB per vnode, the least recently used super tables are evicted beyond it
+
+// sync replication pipeline, taken when a vnode opens its sync node
+int32_t tsSyncPipelineEntries = 1024;  // log entries in flight to each follower
+int32_t tsSyncPipelineSize = 16;       // MB in flight to each follower
+int32_t tsSyncProposeBatch = 64;       // write msgs proposed and appended to wal together, 1 to disable
+int32_t tsSyncLogCacheEntries = 1024;  // recent log entries each vnode keeps in memory
+int32_t tsSyncLogCacheSize = 16;       // MB of cached log entries per vnode
+
 #ifndef _STORAGE
 int32_t taosSetTfsCfg(SConfig *pCfg) {
   SConfigItem *pItem = cfgGetItem(pCfg, "dataDir");
@@ -284,9 +326,11 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryPolicy", tsQueryPolicy, 1, 3, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "querySmaOptimize", tsQuerySmaOptimize, 0, 1, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "queryPlannerTrace", tsQueryPlannerTrace, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "insertTemplateCacheSize", tsInsertTemplateCacheSize, 0, 1024, 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "smlParseAhead", tsSmlParseAhead, 1, 128, 1) != 0) return -1;
 
   tsNumOfTaskQueueThreads = tsNumOfCores / 2;
   tsNumOfTaskQueueThreads = TMAX(tsNumOfTaskQueueThreads, 4);
@@ -381,6 +425,14 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfVnodeRsmaThreads = TMAX(tsNumOfVnodeRsmaThreads, 4);
   if (cfgAddInt32(pCfg, "numOfVnodeRsmaThreads", tsNumOfVnodeRsmaThreads, 1, 1024, 0) != 0) return -1;
 
+  tsNumOfVnodePrefetchThreads = tsNumOfCores / 2;
+  tsNumOfVnodePrefetchThreads = TRANGE(tsNumOfVnodePrefetchThreads, 1, 16);
+  if (cfgAddInt32(pCfg, "numOfVnodePrefetchThreads", tsNumOfVnodePrefetchThreads, 0, 1024, 0) != 0) return -1;
+
+  tsNumOfVnodeCompactThreads = tsNumOfCores / 8;
+  tsNumOfVnodeCompactThreads = TRANGE(tsNumOfVnodeCompactThreads, 1, 4);
+  if (cfgAddInt32(pCfg, "numOfVnodeCompactThreads", tsNumOfVnodeCompactThreads, 1, 1024, 0) != 0) return -1;
+
   tsNumOfQnodeQueryThreads = tsNumOfCores * 2;
   tsNumOfQnodeQueryThreads = TMAX(tsNumOfQnodeQueryThreads, 4);
   if (cfgAddInt32(pCfg, "numOfQnodeQueryThreads", tsNumOfQnodeQueryThreads, 1, 1024, 0) != 0) return -1;
@@ -401,6 +453,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsRpcQueueMemoryAllowed = TRANGE(tsRpcQueueMemoryAllowed, TSDB_MAX_MSG_SIZE * 10LL, TSDB_MAX_MSG_SIZE * 10000LL);
   if (cfgAddInt64(pCfg, "rpcQueueMemoryAllowed", tsRpcQueueMemoryAllowed, TSDB_MAX_MSG_SIZE * 10L, INT64_MAX, 0) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "rpcBatchDelay", tsRpcBatchDelay, 0, 100, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "monitor", tsEnableMonitor, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "monitorInterval", tsMonitorInterval, 1, 200000, 0) != 0) return -1;
@@ -419,8 +472,26 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "ttlUnit", tsTtlUnit, 1, 86400 * 365, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "ttlPushInterval", tsTtlPushInterval, 1, 100000, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "uptimeInterval", tsUptimeInterval, 1, 100000, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compactSttTrigger", tsCompactSttTrigger, 2, 16, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compactSttSizeMB", tsCompactSttSizeMB, 1, 1024 * 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compactInterval", tsCompactInterval, 0, 86400 * 365, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compactIoRateMB", tsCompactIoRateMB, 1, 1024 * 16, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbPageCacheSize", tsTsdbPageCacheSize, 0, 1024 * 64, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryPrefetchBlocks", tsQueryPrefetchBlocks, 0, 64, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryPrefetchMemMB", tsQueryPrefetchMemMB, 1, 1024 * 16, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryGroupMemMB", tsQueryGroupMemMB, 0, 1024 * 64, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryJoinMemMB", tsQueryJoinMemMB, 1, 1024 * 64, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tagFilterCacheSize", tsTagFilterCacheSize, 0, 1024 * 16, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "tagColumnarStore", tsTagColumnarStore, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tagColumnarStoreSize", tsTagColumnarStoreSize, 1, 1024 * 16, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "syncPipelineEntries", tsSyncPipelineEntries, 1, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "syncPipelineSize", tsSyncPipelineSize, 1, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "syncProposeBatch", tsSyncProposeBatch, 1, 64, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "syncLogCacheEntries", tsSyncLogCacheEntries, 1, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "syncLogCacheSize", tsSyncLogCacheSize, 1, 1024, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "udfShmSize", tsUdfShmSize, 0, 1024, 0) != 0) return -1;
   GRANT_CFG_ADD;
   return 0;
 }
@@ -519,6 +590,22 @@ static int32_t taosUpdateServerCfg(SConfig *pCfg) {
     pItem->stype = stype;
   }
 
+  pItem = cfgGetItem(tsCfg, "numOfVnodePrefetchThreads");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsNumOfVnodePrefetchThreads = numOfCores / 2;
+    tsNumOfVnodePrefetchThreads = TRANGE(tsNumOfVnodePrefetchThreads, 1, 16);
+    pItem->i32 = tsNumOfVnodePrefetchThreads;
+    pItem->stype = stype;
+  }
+
+  pItem = cfgGetItem(tsCfg, "numOfVnodeCompactThreads");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsNumOfVnodeCompactThreads = numOfCores / 8;
+    tsNumOfVnodeCompactThreads = TRANGE(tsNumOfVnodeCompactThreads, 1, 4);
+    pItem->i32 = tsNumOfVnodeCompactThreads;
+    pItem->stype = stype;
+  }
+
   pItem = cfgGetItem(tsCfg, "numOfQnodeQueryThreads");
   if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
     tsNumOfQnodeQueryThreads = numOfCores * 2;
@@ -633,6 +720,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tstrncpy(tsSmlChildTableName, cfgGetItem(pCfg, "smlChildTableName")->str, TSDB_TABLE_NAME_LEN);
   tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
   tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
+  tsSmlParseAhead = cfgGetItem(pCfg, "smlParseAhead")->i32;
 
   tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
   tsCompressMsgSize = cfgGetItem(pCfg, "compressMsgSize")->i32;
@@ -641,6 +729,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryPolicy = cfgGetItem(pCfg, "queryPolicy")->i32;
   tsQuerySmaOptimize = cfgGetItem(pCfg, "querySmaOptimize")->i32;
   tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
+  tsInsertTemplateCacheSize = cfgGetItem(pCfg, "insertTemplateCacheSize")->i32;
   return 0;
 }
 
@@ -690,11 +779,14 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsNumOfVnodeWriteThreads = cfgGetItem(pCfg, "numOfVnodeWriteThreads")->i32;
   tsNumOfVnodeSyncThreads = cfgGetItem(pCfg, "numOfVnodeSyncThreads")->i32;
   tsNumOfVnodeRsmaThreads = cfgGetItem(pCfg, "numOfVnodeRsmaThreads")->i32;
+  tsNumOfVnodePrefetchThreads = cfgGetItem(pCfg, "numOfVnodePrefetchThreads")->i32;
+  tsNumOfVnodeCompactThreads = cfgGetItem(pCfg, "numOfVnodeCompactThreads")->i32;
   tsNumOfQnodeQueryThreads = cfgGetItem(pCfg, "numOfQnodeQueryThreads")->i32;
   tsNumOfQnodeFetchThreads = cfgGetItem(pCfg, "numOfQnodeFetchThreads")->i32;
   tsNumOfSnodeSharedThreads = cfgGetItem(pCfg, "numOfSnodeSharedThreads")->i32;
   tsNumOfSnodeUniqueThreads = cfgGetItem(pCfg, "numOfSnodeUniqueThreads")->i32;
   tsRpcQueueMemoryAllowed = cfgGetItem(pCfg, "rpcQueueMemoryAllowed")->i64;
+  tsRpcBatchDelay = cfgGetItem(pCfg, "rpcBatchDelay")->i32;
 
   tsEnableMonitor = cfgGetItem(pCfg, "monitor")->bval;
   tsMonitorInterval = cfgGetItem(pCfg, "monitorInterval")->i32;
@@ -713,8 +805,26 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsTtlUnit = cfgGetItem(pCfg, "ttlUnit")->i32;
   tsTtlPushInterval = cfgGetItem(pCfg, "ttlPushInterval")->i32;
   tsUptimeInterval = cfgGetItem(pCfg, "uptimeInterval")->i32;
+  tsCompactSttTrigger = cfgGetItem(pCfg, "compactSttTrigger")->i32;
+  tsCompactSttSizeMB = cfgGetItem(pCfg, "compactSttSizeMB")->i32;
+  tsCompactInterval = cfgGetItem(pCfg, "compactInterval")->i32;
+  tsCompactIoRateMB = cfgGetItem(pCfg, "compactIoRateMB")->i32;
+  tsTsdbPageCacheSize = cfgGetItem(pCfg, "tsdbPageCacheSize")->i32;
+  tsQueryPrefetchBlocks = cfgGetItem(pCfg, "queryPrefetchBlocks")->i32;
+  tsQueryPrefetchMemMB = cfgGetItem(pCfg, "queryPrefetchMemMB")->i32;
+  tsQueryGroupMemMB = cfgGetItem(pCfg, "queryGroupMemMB")->i32;
+  tsQueryJoinMemMB = cfgGetItem(pCfg, "queryJoinMemMB")->i32;
+  tsTagFilterCacheSize = cfgGetItem(pCfg, "tagFilterCacheSize")->i32;
+  tsTagColumnarStore = cfgGetItem(pCfg, "tagColumnarStore")->bval;
+  tsTagColumnarStoreSize = cfgGetItem(pCfg, "tagColumnarStoreSize")->i32;
+  tsSyncPipelineEntries = cfgGetItem(pCfg, "syncPipelineEntries")->i32;
+  tsSyncPipelineSize = cfgGetItem(pCfg, "syncPipelineSize")->i32;
+  tsSyncProposeBatch = cfgGetItem(pCfg, "syncProposeBatch")->i32;
+  tsSyncLogCacheEntries = cfgGetItem(pCfg, "syncLogCacheEntries")->i32;
+  tsSyncLogCacheSize = cfgGetItem(pCfg, "syncLogCacheSize")->i32;
 
   tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
+  tsUdfShmSize = cfgGetItem(pCfg, "udfShmSize")->i32;
 
   if (tsQueryBufferSize >= 0) {
     tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
@@ -767,6 +877,14 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsCompressColData = cfgGetItem(pCfg, "compressColData")->i32;
       } else if (strcasecmp("countAlwaysReturnValue", name) == 0) {
         tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
+      } else if (strcasecmp("compactSttTrigger", name) == 0) {
+        tsCompactSttTrigger = cfgGetItem(pCfg, "compactSttTrigger")->i32;
+      } else if (strcasecmp("compactSttSizeMB", name) == 0) {
+        tsCompactSttSizeMB = cfgGetItem(pCfg, "compactSttSizeMB")->i32;
+      } else if (strcasecmp("compactInterval", name) == 0) {
+        tsCompactInterval = cfgGetItem(pCfg, "compactInterval")->i32;
+      } else if (strcasecmp("compactIoRateMB", name) == 0) {
+        tsCompactIoRateMB = cfgGetItem(pCfg, "compactIoRateMB")->i32;
       } else if (strcasecmp("cDebugFlag", name) == 0) {
         cDebugFlag = cfgGetItem(pCfg, "cDebugFlag")->i32;
       }
@@ -820,6 +938,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
     case 'i': {
       if (strcasecmp("idxDebugFlag", name) == 0) {
         idxDebugFlag = cfgGetItem(pCfg, "idxDebugFlag")->i32;
+      } else if (strcasecmp("insertTemplateCacheSize", name) == 0) {
+        tsInsertTemplateCacheSize = cfgGetItem(pCfg, "insertTemplateCacheSize")->i32;
       }
       break;
     }
@@ -937,6 +1057,10 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsNumOfVnodeSyncThreads = cfgGetItem(pCfg, "numOfVnodeSyncThreads")->i32;
       } else if (strcasecmp("numOfVnodeRsmaThreads", name) == 0) {
         tsNumOfVnodeRsmaThreads = cfgGetItem(pCfg, "numOfVnodeRsmaThreads")->i32;
+      } else if (strcasecmp("numOfVnodePrefetchThreads", name) == 0) {
+        tsNumOfVnodePrefetchThreads = cfgGetItem(pCfg, "numOfVnodePrefetchThreads")->i32;
+      } else if (strcasecmp("numOfVnodeCompactThreads", name) == 0) {
+        tsNumOfVnodeCompactThreads = cfgGetItem(pCfg, "numOfVnodeCompactThreads")->i32;
       } else if (strcasecmp("numOfQnodeQueryThreads", name) == 0) {
         tsNumOfQnodeQueryThreads = cfgGetItem(pCfg, "numOfQnodeQueryThreads")->i32;
       } else if (strcasecmp("numOfQnodeFetchThreads", name) == 0) {
@@ -972,12 +1096,22 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         qDebugFlag = cfgGetItem(pCfg, "qDebugFlag")->i32;
       } else if (strcasecmp("queryPlannerTrace", name) == 0) {
         tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
+      } else if (strcasecmp("queryPrefetchBlocks", name) == 0) {
+        tsQueryPrefetchBlocks = cfgGetItem(pCfg, "queryPrefetchBlocks")->i32;
+      } else if (strcasecmp("queryPrefetchMemMB", name) == 0) {
+        tsQueryPrefetchMemMB = cfgGetItem(pCfg, "queryPrefetchMemMB")->i32;
+      } else if (strcasecmp("queryGroupMemMB", name) == 0) {
+        tsQueryGroupMemMB = cfgGetItem(pCfg, "queryGroupMemMB")->i32;
+      } else if (strcasecmp("queryJoinMemMB", name) == 0) {
+        tsQueryJoinMemMB = cfgGetItem(pCfg, "queryJoinMemMB")->i32;
       }
       break;
     }
     case 'r': {
       if (strcasecmp("rpcQueueMemoryAllowed", name) == 0) {
         tsRpcQueueMemoryAllowed = cfgGetItem(pCfg, "rpcQueueMemoryAllowed")->i64;
+      } else if (strcasecmp("rpcBatchDelay", name) == 0) {
+        tsRpcBatchDelay = cfgGetItem(pCfg, "rpcBatchDelay")->i32;
       } else if (strcasecmp("rpcDebugFlag", name) == 0) {
         rpcDebugFlag = cfgGetItem(pCfg, "rpcDebugFlag")->i32;
       }
@@ -994,8 +1128,12 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tstrncpy(tsSmlChildTableName, cfgGetItem(pCfg, "smlChildTableName")->str, TSDB_TABLE_NAME_LEN);
       } else if (strcasecmp("smlTagName", name) == 0) {
         tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
+      } else if (strcasecmp("syncProposeBatch", name) == 0) {
+        tsSyncProposeBatch = cfgGetItem(pCfg, "syncProposeBatch")->i32;
       } else if (strcasecmp("smlDataFormat", name) == 0) {
         tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
+      } else if (strcasecmp("smlParseAhead", name) == 0) {
+        tsSmlParseAhead = cfgGetItem(pCfg, "smlParseAhead")->i32;
       } else if (strcasecmp("shellActivityTimer", name) == 0) {
         tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
       } else if (strcasecmp("supportVnodes", name) == 0) {
@@ -1065,6 +1203,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
     case 'u': {
       if (strcasecmp("udf", name) == 0) {
         tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
+      } else if (strcasecmp("udfShmSize", name) == 0) {
+        tsUdfShmSize = cfgGetItem(pCfg, "udfShmSize")->i32;
       } else if (strcasecmp("uDebugFlag", name) == 0) {
         uDebugFlag = cfgGetItem(pCfg, "uDebugFlag")->i32;
       }
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -15,7 +17,189 @@
 #include "tvariant.h"
 
 namespace {
-//
+typedef struct {
+  int8_t  type;
+  int32_t order;
+  bool    nullFirst;
+} SSortTestKey;
+
+uint64_t sortTestRand(uint64_t* pSeed) {
+  uint64_t x = *pSeed;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *pSeed = x;
+  return x;
+}
+
+// small values around zero and values with the high bit set, so both the sign flip and the unsigned path are hit
+void genSortKeyValue(int8_t type, uint64_t r, char* buf) {
+  if (type == TSDB_DATA_TYPE_BOOL) {
+    buf[0] = (char)(r & 1);
+  } else if (IS_FLOAT_TYPE(type)) {
+    double v = 0;
+    switch (r % 8) {
+      case 0:
+        v = NAN;
+        break;
+      case 1:
+        v = -0.0;
+        break;
+      case 2:
+        v = 0.0;
+        break;
+      default:
+        v = ((int64_t)((r >> 8) % 41) - 20) * 0.25;
+        break;
+    }
+
+    if (type == TSDB_DATA_TYPE_FLOAT) {
+      float f = (float)v;
+      memcpy(buf, &f, sizeof(f));
+    } else {
+      memcpy(buf, &v, sizeof(v));
+    }
+  } else {
+    int64_t v = (r & 1) ? (int64_t)((r >> 8) % 17) - 8 : (int64_t)(r >> 1);
+    memcpy(buf, &v, tDataTypes[type].bytes);  // little-endian, the low bytes of v
+  }
+}
+
+std::string printSortKey(const SColumnInfoData* pCol, int32_t row) {
+  if (colDataIsNull_s(pCol, row)) {
+    return "null";
+  }
+
+  char        buf[64] = {0};
+  const char* p = colDataGetData(pCol, row);
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      sprintf(buf, "%d", *(int8_t*)p);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      sprintf(buf, "%d", *(int16_t*)p);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      sprintf(buf, "%d", *(int32_t*)p);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      sprintf(buf, "%" PRId64, *(int64_t*)p);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      sprintf(buf, "%u", *(uint8_t*)p);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      sprintf(buf, "%u", *(uint16_t*)p);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      sprintf(buf, "%u", *(uint32_t*)p);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      sprintf(buf, "%" PRIu64, *(uint64_t*)p);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE: {
+      double v = (pCol->info.type == TSDB_DATA_TYPE_FLOAT) ? GET_FLOAT_VAL(p) : GET_DOUBLE_VAL(p);
+      if (isnan(v)) {
+        return "nan";
+      }
+      sprintf(buf, "%.2f", (v == 0) ? 0.0 : v);  // -0.0 is equal to 0.0
+      break;
+    }
+    default:
+      return std::string(varDataVal(p), varDataLen(p));
+  }
+
+  return buf;
+}
+
+std::string printSortRow(const SSDataBlock* pBlock, int32_t numOfKeys, int32_t row) {
+  std::string s;
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    s += printSortKey((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, i), row);
+    s += "|";
+  }
+  return s;
+}
+
+// the key columns go first, followed by an INT payload column with the original row number
+SSDataBlock* createSortTestBlock(const std::vector<SSortTestKey>& keys, int32_t numOfRows, uint64_t seed) {
+  SSDataBlock* pBlock = createDataBlock();
+  for (int32_t i = 0; i < keys.size(); ++i) {
+    SColumnInfoData infoData = createColumnInfoData(keys[i].type, tDataTypes[keys[i].type].bytes, i + 1);
+    blockDataAppendColInfo(pBlock, &infoData);
+  }
+
+  SColumnInfoData payload = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, keys.size() + 1);
+  blockDataAppendColInfo(pBlock, &payload);
+  blockDataEnsureCapacity(pBlock, numOfRows);
+
+  char buf[16] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    for (int32_t j = 0; j < keys.size(); ++j) {
+      SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, j);
+      uint64_t         r = sortTestRand(&seed);
+      genSortKeyValue(keys[j].type, r, buf);
+      colDataAppend(pCol, i, buf, (r % 10) == 9);
+    }
+
+    colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, keys.size()), i, (const char*)&i, false);
+    pBlock->info.rows++;
+  }
+
+  return pBlock;
+}
+
+/*
+ * Sort a copy of pSrc and return the order keys of the sorted rows. With byCompar a constant BINARY column is appended
+ * as the last order key, which keeps blockDataSort off the radix path without changing the order.
+ */
+void sortTestBlock(const SSDataBlock* pSrc, const std::vector<SSortTestKey>& keys, bool byCompar,
+                   std::vector<std::string>* pRes) {
+  int32_t      numOfRows = pSrc->info.rows;
+  int32_t      numOfKeys = keys.size();
+  SSDataBlock* pBlock = createOneDataBlock(pSrc, true);
+  SArray*      pOrderInfo = taosArrayInit(numOfKeys + 1, sizeof(SBlockOrderInfo));
+
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    SBlockOrderInfo order = {keys[i].nullFirst, keys[i].order, i, NULL};
+    taosArrayPush(pOrderInfo, &order);
+  }
+
+  if (byCompar) {
+    SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 8, numOfKeys + 2);
+    blockDataAppendColInfo(pBlock, &infoData);
+
+    SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGetLast(pBlock->pDataBlock);
+    colInfoDataEnsureCapacity(pCol, numOfRows);
+
+    char varbuf[8] = {0};
+    STR_WITH_SIZE_TO_VARSTR(varbuf, "x", 1);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      colDataAppend(pCol, i, varbuf, false);
+    }
+
+    SBlockOrderInfo order = {false, TSDB_ORDER_ASC, numOfKeys + 1, NULL};
+    taosArrayPush(pOrderInfo, &order);
+  }
+
+  ASSERT_EQ(blockDataSort(pBlock, pOrderInfo), 0);
+  ASSERT_EQ(blockDataGetNumOfRows(pBlock), numOfRows);
+
+  // the payload column has to be moved together with the order columns
+  SColumnInfoData* pPayload = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, numOfKeys);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t     src = *(int32_t*)colDataGetData(pPayload, i);
+    std::string row = printSortRow(pBlock, numOfKeys, i);
+    ASSERT_EQ(row, printSortRow(pSrc, numOfKeys, src));
+    pRes->push_back(row);
+  }
+
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pOrderInfo);
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -154,6 +338,225 @@ TEST(testCase, Datablock_test) {
   taosArrayDestroy(pOrderInfo);
 }
 
+TEST(testCase, Datablock_multi_key_sort_test) {
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, 8, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  SColumnInfoData infoData2 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 3);
+  blockDataAppendColInfo(b, &infoData2);
+
+  int32_t numOfRows = 4000;
+  blockDataEnsureCapacity(b, numOfRows);
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  SColumnInfoData* p2 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 2);
+
+  char buf[128] = {0};
+  char varbuf[128] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t v0 = (i * 7919) % 97 - 48;
+    int64_t v1 = ((int64_t)(i * 104729) % 1000 - 500) * 1000000007LL;
+
+    colDataAppend(p0, i, (const char*)&v0, (i % 13) == 0);
+    colDataAppend(p1, i, (const char*)&v1, false);
+
+    int32_t len = sprintf(buf, "%d:%" PRId64, v0, v1);
+    STR_WITH_SIZE_TO_VARSTR(varbuf, buf, len);
+    colDataAppend(p2, i, (const char*)varbuf, false);
+    b->info.rows++;
+  }
+
+  SArray*         pOrderInfo = taosArrayInit(2, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo order0 = {true, TSDB_ORDER_DESC, 0, NULL};
+  SBlockOrderInfo order1 = {false, TSDB_ORDER_ASC, 1, NULL};
+  taosArrayPush(pOrderInfo, &order0);
+  taosArrayPush(pOrderInfo, &order1);
+
+  ASSERT_EQ(blockDataSort(b, pOrderInfo), 0);
+  ASSERT_EQ(blockDataGetNumOfRows(b), numOfRows);
+
+  p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  p2 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 2);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    bool    isNull = colDataIsNull_f(p0->nullbitmap, i);
+    int32_t v0 = isNull ? 0 : *(int32_t*)colDataGetData(p0, i);
+    int64_t v1 = *(int64_t*)colDataGetData(p1, i);
+
+    // the payload column has to be moved together with the order columns
+    char* pData = colDataGetData(p2, i);
+    if (isNull) {
+      sprintf(buf, ":%" PRId64, v1);
+      ASSERT_NE(strstr(varDataVal(pData), buf), nullptr);
+    } else {
+      int32_t len = sprintf(buf, "%d:%" PRId64, v0, v1);
+      ASSERT_EQ(varDataLen(pData), len);
+      ASSERT_EQ(strncmp(varDataVal(pData), buf, len), 0);
+    }
+
+    if (i == 0) {
+      continue;
+    }
+
+    bool    prevNull = colDataIsNull_f(p0->nullbitmap, i - 1);
+    int32_t prev0 = prevNull ? 0 : *(int32_t*)colDataGetData(p0, i - 1);
+    int64_t prev1 = *(int64_t*)colDataGetData(p1, i - 1);
+    if (prevNull != isNull) {
+      ASSERT_TRUE(prevNull);  // nulls first
+    } else if (!isNull && prev0 != v0) {
+      ASSERT_GT(prev0, v0);
+    } else {
+      ASSERT_LE(prev1, v1);
+    }
+  }
+
+  blockDataDestroy(b);
+  taosArrayDestroy(pOrderInfo);
+}
+
+TEST(testCase, Datablock_radix_sort_vs_compar_test) {
+  // every key set fits in the normalized key, floating-point keys are only allowed to be the last one
+  std::vector<std::vector<SSortTestKey>> cases = {
+      {{TSDB_DATA_TYPE_UTINYINT, TSDB_ORDER_ASC, true},
+       {TSDB_DATA_TYPE_USMALLINT, TSDB_ORDER_DESC, false},
+       {TSDB_DATA_TYPE_BOOL, TSDB_ORDER_ASC, true},
+       {TSDB_DATA_TYPE_UINT, TSDB_ORDER_DESC, true}},
+      {{TSDB_DATA_TYPE_UBIGINT, TSDB_ORDER_ASC, false},
+       {TSDB_DATA_TYPE_TINYINT, TSDB_ORDER_DESC, true},
+       {TSDB_DATA_TYPE_SMALLINT, TSDB_ORDER_ASC, false}},
+      {{TSDB_DATA_TYPE_INT, TSDB_ORDER_DESC, true}, {TSDB_DATA_TYPE_DOUBLE, TSDB_ORDER_ASC, false}},
+      {{TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC, false}, {TSDB_DATA_TYPE_FLOAT, TSDB_ORDER_DESC, true}},
+      {{TSDB_DATA_TYPE_TIMESTAMP, TSDB_ORDER_DESC, false}, {TSDB_DATA_TYPE_FLOAT, TSDB_ORDER_ASC, true}},
+  };
+
+  for (int32_t i = 0; i < cases.size(); ++i) {
+    SSDataBlock* pBlock = createSortTestBlock(cases[i], 3000, 0x2545F4914F6CDD1DULL + i);
+
+    std::vector<std::string> radix;
+    std::vector<std::string> compar;
+    sortTestBlock(pBlock, cases[i], false, &radix);
+    sortTestBlock(pBlock, cases[i], true, &compar);
+    ASSERT_EQ(radix.size(), compar.size());
+    for (int32_t j = 0; j < radix.size(); ++j) {
+      ASSERT_EQ(radix[j], compar[j]) << "case:" << i << " row:" << j;
+    }
+
+    blockDataDestroy(pBlock);
+  }
+}
+
+TEST(testCase, Datablock_radix_sort_double_test) {
+  std::vector<SSortTestKey> keys = {{TSDB_DATA_TYPE_DOUBLE, TSDB_ORDER_ASC, false}};
+  SSDataBlock*              pBlock = createSortTestBlock(keys, 2000, 0x9E3779B97F4A7C15ULL);
+
+  SSDataBlock* b = createOneDataBlock(pBlock, true);
+  SArray*      pOrderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo order = {false, TSDB_ORDER_ASC, 0, NULL};
+  taosArrayPush(pOrderInfo, &order);
+  ASSERT_EQ(blockDataSort(b, pOrderInfo), 0);
+
+  // nan is less than any other value, -0.0 is equal to 0.0 and the nulls go last
+  SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  int32_t          state = 0;  // 0: nan, 1: values, 2: nulls
+  double           prev = 0;
+  int32_t          numOfNegZero = 0;
+  for (int32_t i = 0; i < b->info.rows; ++i) {
+    if (colDataIsNull_s(pCol, i)) {
+      state = 2;
+      continue;
+    }
+
+    ASSERT_LT(state, 2);
+    double v = GET_DOUBLE_VAL(colDataGetData(pCol, i));
+    if (isnan(v)) {
+      ASSERT_EQ(state, 0);
+      continue;
+    }
+
+    if (state == 1) {
+      ASSERT_LE(prev, v);
+    }
+    if (v == 0 && signbit(v)) {
+      numOfNegZero++;
+    }
+    state = 1;
+    prev = v;
+  }
+
+  ASSERT_EQ(state, 2);
+  ASSERT_GT(numOfNegZero, 0);
+
+  blockDataDestroy(b);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pOrderInfo);
+}
+
+TEST(testCase, Datablock_var_key_desc_sort_test) {
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 16, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  int32_t numOfRows = 3000;
+  blockDataEnsureCapacity(b, numOfRows);
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+
+  // prefixes of each other, so the length decides the order when the common part is equal
+  const char* strs[] = {"", "a", "ab", "abc", "abd", "b", "ba", "zz"};
+  char        varbuf[32] = {0};
+  uint64_t    seed = 0xDEADBEEFCAFEULL;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    uint64_t    r = sortTestRand(&seed);
+    const char* s = strs[r % tListLen(strs)];
+    STR_WITH_SIZE_TO_VARSTR(varbuf, s, strlen(s));
+    colDataAppend(p0, i, varbuf, (r >> 8) % 10 == 0);
+
+    int32_t v1 = (int32_t)((r >> 16) % 1000) - 500;
+    colDataAppend(p1, i, (const char*)&v1, false);
+    b->info.rows++;
+  }
+
+  SArray*         pOrderInfo = taosArrayInit(2, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo order0 = {false, TSDB_ORDER_DESC, 0, NULL};
+  SBlockOrderInfo order1 = {false, TSDB_ORDER_ASC, 1, NULL};
+  taosArrayPush(pOrderInfo, &order0);
+  taosArrayPush(pOrderInfo, &order1);
+  ASSERT_EQ(blockDataSort(b, pOrderInfo), 0);
+
+  p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 1; i < numOfRows; ++i) {
+    bool prevNull = colDataIsNull_s(p0, i - 1);
+    bool isNull = colDataIsNull_s(p0, i);
+    if (prevNull || isNull) {
+      ASSERT_TRUE(isNull);  // nulls last
+      continue;
+    }
+
+    std::string prev = printSortKey(p0, i - 1);
+    std::string cur = printSortKey(p0, i);
+    if (prev != cur) {
+      ASSERT_GT(prev, cur);
+    } else {
+      ASSERT_LE(*(int32_t*)colDataGetData(p1, i - 1), *(int32_t*)colDataGetData(p1, i));
+    }
+  }
+
+  blockDataDestroy(b);
+  taosArrayDestroy(pOrderInfo);
+}
+
 #if 0
 TEST(testCase, non_var_dataBlock_split_test) {
   SSDataBlock* b = static_cast<SSDataBlock*>(taosMemoryCalloc(1, sizeof(SSDataBlock)));
@@ -260,4 +663,81 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, compressed_dataBlock_encode_test) {
+  int32_t numOfRows = 10000;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  SColumnInfoData infoData2 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 3);
+  blockDataAppendColInfo(b, &infoData2);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char buf1[100] = {0};
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+    SColumnInfoData* p2 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 2);
+
+    int64_t ts = 1600000000000 + i;
+    colDataAppend(p0, i, (const char*)&ts, false);
+
+    int32_t v = i % 100;
+    colDataAppend(p1, i, (const char*)&v, (i % 7) == 0);
+
+    sprintf(buf, "the number of row:%d", i % 10);
+    STR_TO_VARSTR(buf1, buf)
+    colDataAppend(p2, i, buf1, false);
+    b->info.rows++;
+  }
+
+  int32_t numOfCols = taosArrayGetSize(b->pDataBlock);
+  char*   pCompressed = (char*)taosMemoryCalloc(1, blockGetCompressedEncodeSize(b));
+
+  int32_t len = 0;
+  blockEncode(b, pCompressed, &len, numOfCols, ONE_STAGE_COMP);
+  ASSERT_LT(len, blockGetEncodeSize(b));
+
+  int32_t rawLen = blockGetDecompressedSize(pCompressed);
+  ASSERT_EQ(rawLen, blockGetEncodeSize(b));
+
+  char* pRaw = (char*)taosMemoryCalloc(1, rawLen);
+  ASSERT_EQ(blockDecompress(pCompressed, pRaw, &len), 0);
+  ASSERT_EQ(len, rawLen);
+
+  SSDataBlock* pDecoded = (SSDataBlock*)taosMemoryCalloc(1, sizeof(SSDataBlock));
+  blockDecode(pDecoded, pRaw);
+  ASSERT_EQ(pDecoded->info.rows, numOfRows);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(pDecoded->pDataBlock, 0);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pDecoded->pDataBlock, 1);
+    SColumnInfoData* p2 = (SColumnInfoData*)taosArrayGet(pDecoded->pDataBlock, 2);
+
+    ASSERT_EQ(*(int64_t*)colDataGetData(p0, i), 1600000000000 + i);
+    ASSERT_EQ(colDataIsNull_f(p1->nullbitmap, i), (i % 7) == 0);
+    if ((i % 7) != 0) {
+      ASSERT_EQ(*(int32_t*)colDataGetData(p1, i), i % 100);
+    }
+
+    sprintf(buf, "the number of row:%d", i % 10);
+    char* p = colDataGetData(p2, i);
+    ASSERT_EQ(varDataLen(p), strlen(buf));
+    ASSERT_EQ(strncmp(varDataVal(p), buf, varDataLen(p)), 0);
+  }
+
+  taosMemoryFree(pCompressed);
+  taosMemoryFree(pRaw);
+  blockDataDestroy(pDecoded);
+  blockDataDestroy(b);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
@@ -51,6 +51,9 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   int64_t numOfInsertSuccessReqs = 0;
   int64_t numOfBatchInsertReqs = 0;
   int64_t numOfBatchInsertSuccessReqs = 0;
+  int64_t pgCacheHit = 0;
+  int64_t pgCacheMiss = 0;
+  int64_t pgCacheUsage = 0;
 
   for (int32_t i = 0; i < taosArrayGetSize(pVloads); ++i) {
     SVnodeLoad *pLoad = taosArrayGet(pVloads, i);
@@ -59,6 +62,9 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
     numOfInsertSuccessReqs += pLoad->numOfInsertSuccessReqs;
     numOfBatchInsertReqs += pLoad->numOfBatchInsertReqs;
     numOfBatchInsertSuccessReqs += pLoad->numOfBatchInsertSuccessReqs;
+    pgCacheHit += pLoad->pgCacheHit;
+    pgCacheMiss += pLoad->pgCacheMiss;
+    pgCacheUsage += pLoad->pgCacheUsage;
     if (pLoad->syncState == TAOS_SYNC_STATE_LEADER) masterNum++;
     totalVnodes++;
   }
@@ -70,6 +76,9 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pInfo->vstat.numOfInsertSuccessReqs = numOfInsertSuccessReqs - pMgmt->state.numOfInsertSuccessReqs;
   pInfo->vstat.numOfBatchInsertReqs = numOfBatchInsertReqs - pMgmt->state.numOfBatchInsertReqs;
   pInfo->vstat.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs - pMgmt->state.numOfBatchInsertSuccessReqs;
+  pInfo->vstat.pgCacheHit = pgCacheHit - pMgmt->state.pgCacheHit;
+  pInfo->vstat.pgCacheMiss = pgCacheMiss - pMgmt->state.pgCacheMiss;
+  pInfo->vstat.pgCacheUsage = pgCacheUsage;
   pMgmt->state.totalVnodes = totalVnodes;
   pMgmt->state.masterNum = masterNum;
   pMgmt->state.numOfSelectReqs = numOfSelectReqs;
@@ -77,6 +86,8 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pMgmt->state.numOfInsertSuccessReqs = numOfInsertSuccessReqs;
   pMgmt->state.numOfBatchInsertReqs = numOfBatchInsertReqs;
   pMgmt->state.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs;
+  pMgmt->state.pgCacheHit = pgCacheHit;
+  pMgmt->state.pgCacheMiss = pgCacheMiss;
 
   tfsGetMonitorInfo(pMgmt->pTfs, &pInfo->tfs);
   taosArrayDestroy(pVloads);
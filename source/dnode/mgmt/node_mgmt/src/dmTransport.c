@@ -275,6 +275,7 @@ int32_t dmInitClient(SDnode *pDnode) {
   rpcInit.sessions = 1024;
   rpcInit.connType = TAOS_CONN_CLIENT;
   rpcInit.idleTime = tsShellActivityTimer * 1000;
+  rpcInit.batchDelay = tsRpcBatchDelay;
   rpcInit.parent = pDnode;
   rpcInit.rfp = rpcRfp;
 
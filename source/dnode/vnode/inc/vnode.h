@@ -47,7 +47,7 @@ typedef struct SVSnapWriter SVSnapWriter;
 
 extern const SVnodeCfg vnodeCfgDefault;
 
-int32_t vnodeInit(int32_t nthreads);
+int32_t vnodeInit(int32_t nthreads, int32_t nReadThreads, int32_t nCompactThreads);
 void    vnodeCleanup();
 int32_t vnodeCreate(const char *path, SVnodeCfg *pCfg, STfs *pTfs);
 void    vnodeDestroy(const char *path, STfs *pTfs);
@@ -93,6 +93,7 @@ void        metaReaderInit(SMetaReader *pReader, SMeta *pMeta, int32_t flags);
 void        metaReaderClear(SMetaReader *pReader);
 int32_t     metaGetTableEntryByUid(SMetaReader *pReader, tb_uid_t uid);
 int32_t     metaGetTableTags(SMeta *pMeta, uint64_t suid, SArray *uidList, SHashObj *tags);
+int32_t     metaGetTableTagColumns(SMeta *pMeta, uint64_t suid, SArray *uidList, SSDataBlock *pBlock);
 int32_t     metaReadNext(SMetaReader *pReader);
 const void *metaGetTableTagVal(void *tag, int16_t type, STagVal *tagVal);
 int         metaGetTableNameByUid(void *meta, uint64_t uid, char *tbName);
@@ -110,6 +111,11 @@ typedef struct SMetaFltParam {
 
 int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *results);
 
+int32_t metaGetCachedTableList(SMeta *pMeta, tb_uid_t suid, const uint8_t *pKey, int32_t keyLen, SArray *pList,
+                               int64_t *pVersion);
+int32_t metaPutCachedTableList(SMeta *pMeta, tb_uid_t suid, const uint8_t *pKey, int32_t keyLen, int64_t version,
+                               const SArray *pList);
+
 #if 1  // refact APIs below (TODO)
 typedef SVCreateTbReq   STbCfg;
 typedef SVCreateTSmaReq SSmaCfg;
@@ -156,6 +162,7 @@ int32_t tsdbGetTableSchema(SVnode *pVnode, int64_t uid, STSchema **pSchema, int6
 void   tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t tsdbCacheGetCapacity(SVnode *pVnode);
 size_t tsdbCacheGetUsage(SVnode *pVnode);
+void   tsdbPgCacheGetStat(SVnode *pVnode, int64_t *nHit, int64_t *nMiss, size_t *usage);
 
 // tq
 typedef struct SMetaTableInfo {
@@ -23,9 +23,10 @@
 extern "C" {
 #endif
 
-typedef struct SMetaIdx   SMetaIdx;
-typedef struct SMetaDB    SMetaDB;
-typedef struct SMetaCache SMetaCache;
+typedef struct SMetaIdx      SMetaIdx;
+typedef struct SMetaDB       SMetaDB;
+typedef struct SMetaCache    SMetaCache;
+typedef struct SMetaTagStore SMetaTagStore;
 
 // metaDebug ==================
 // clang-format off
@@ -66,6 +67,18 @@ int32_t metaCacheOpen(SMeta* pMeta);
 void    metaCacheClose(SMeta* pMeta);
 int32_t metaCacheUpsert(SMeta* pMeta, SMetaInfo* pInfo);
 int32_t metaCacheDrop(SMeta* pMeta, int64_t uid);
+void    metaTagFilterCacheClear(SMeta* pMeta, tb_uid_t suid);
+int32_t metaSchemaCacheGet(SMeta* pMeta, tb_uid_t uid, int32_t sver, STSchema** ppTSchema);
+void    metaSchemaCachePut(SMeta* pMeta, tb_uid_t uid, const STSchema* pTSchema);
+void    metaSchemaCacheDrop(SMeta* pMeta, tb_uid_t uid, int32_t sver);
+
+// metaTagStore ==================
+int32_t metaTagStoreOpen(SMeta* pMeta);
+void    metaTagStoreClose(SMeta* pMeta);
+void    metaTagStoreUpsert(SMeta* pMeta, const SMetaEntry* pEntry);
+void    metaTagStoreDelete(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid);
+void    metaTagStoreDrop(SMeta* pMeta, tb_uid_t suid);
+int64_t metaTagStoreMemSize(SMeta* pMeta, tb_uid_t suid);
 
 struct SMeta {
   TdThreadRwlock lock;
@@ -92,7 +105,8 @@ struct SMeta {
 
   SMetaIdx* pIdx;
 
-  SMetaCache* pCache;
+  SMetaCache*    pCache;
+  SMetaTagStore* pTagStore;
 };
 
 typedef struct {
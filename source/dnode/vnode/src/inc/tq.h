@@ -134,18 +134,62 @@ typedef struct {
   tmr_h  timer;
 } STqMgmt;
 
+#define TQ_POLL_BATCH_ROWS  4096
+#define TQ_POLL_BATCH_BYTES (1024 * 1024)
+
+// the size of the data collected for one poll rsp
+typedef struct {
+  int8_t  compressed;
+  int32_t maxRows;
+  int32_t maxBytes;
+  int32_t rows;
+  int32_t bytes;
+} STqPollBatch;
+
+// a poll req field is only read when the msg covers it, an older consumer sends a shorter struct
+#define TQ_POLL_REQ_HAS(contLen, field) \
+  ((contLen) >= (int32_t)(offsetof(SMqPollReq, field) + sizeof(((SMqPollReq*)0)->field)))
+
+static FORCE_INLINE void tqPollBatchInit(STqPollBatch* pBatch, const SMqPollReq* pReq, int32_t contLen) {
+  int32_t batchRows = TQ_POLL_REQ_HAS(contLen, batchRows) ? pReq->batchRows : 0;
+  int32_t batchBytes = TQ_POLL_REQ_HAS(contLen, batchBytes) ? pReq->batchBytes : 0;
+
+  pBatch->compressed = TQ_POLL_REQ_HAS(contLen, compressed) ? pReq->compressed : 0;
+  pBatch->maxRows = (batchRows > 0) ? batchRows : TQ_POLL_BATCH_ROWS;
+  pBatch->maxBytes = (batchBytes > 0) ? batchBytes : TQ_POLL_BATCH_BYTES;
+  pBatch->rows = 0;
+  pBatch->bytes = 0;
+}
+
+static FORCE_INLINE bool tqPollBatchIsFull(const STqPollBatch* pBatch) {
+  return pBatch->rows >= pBatch->maxRows || pBatch->bytes >= pBatch->maxBytes;
+}
+
+static FORCE_INLINE void tqPollBatchAdd(STqPollBatch* pBatch, int32_t rows, int32_t bytes) {
+  pBatch->rows += rows;
+  pBatch->bytes += bytes;
+}
+
+// the data collected before the meta msg at fetchVer is sent first, the next poll resumes from the meta msg
+static FORCE_INLINE bool tqPollBatchFlushBeforeMeta(STaosxRsp* pRsp, int64_t fetchVer) {
+  if (pRsp->blockNum <= 0) return false;
+  tqOffsetResetToLog(&pRsp->rspOffset, fetchVer - 1);
+  return true;
+}
+
 static STqMgmt tqMgmt = {0};
 
 int32_t tEncodeSTqHandle(SEncoder* pEncoder, const STqHandle* pHandle);
 int32_t tDecodeSTqHandle(SDecoder* pDecoder, STqHandle* pHandle);
 
 // tqRead
-int32_t tqScan(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp* pMetaRsp, STqOffsetVal* offset);
-int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset);
+int32_t tqScan(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp* pMetaRsp, STqOffsetVal* offset,
+               STqPollBatch* pBatch);
+int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset, STqPollBatch* pBatch);
 int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHead** pHeadWithCkSum);
 
 // tqExec
-int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp);
+int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp, STqPollBatch* pBatch);
 int32_t tqSendDataRsp(STQ* pTq, const SRpcMsg* pMsg, const SMqPollReq* pReq, const SMqDataRsp* pRsp);
 
 // tqMeta
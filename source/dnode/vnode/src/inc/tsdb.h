@@ -66,6 +66,7 @@ typedef struct SSmaInfo      SSmaInfo;
 typedef struct SBlockCol     SBlockCol;
 typedef struct SVersionRange SVersionRange;
 typedef struct SLDataIter    SLDataIter;
+typedef struct SBlockPrefetcher SBlockPrefetcher;
 
 #define TSDB_FILE_DLMT         ((uint32_t)0xF00AFA0F)
 #define TSDB_MAX_SUBBLOCKS     8
@@ -291,6 +292,22 @@ int32_t tsdbReadDelIdx(SDelFReader *pReader, SArray *aDelIdx);
 // tsdbRead.c ==============================================================================================
 int32_t tsdbTakeReadSnap(STsdb *pTsdb, STsdbReadSnap **ppSnap);
 void    tsdbUntakeReadSnap(STsdb *pTsdb, STsdbReadSnap *pSnap);
+// tsdbPrefetch.c ==============================================================================================
+typedef int32_t (*FBlockPrefetchLoad)(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet, SDataBlk *pBlock,
+                                      SBlockData *pBlockData);
+
+int32_t    tsdbPrefetcherOpen(STsdb *pTsdb, int32_t nSlot, int64_t memBudget, FBlockPrefetchLoad fpLoad,
+                              SBlockPrefetcher **ppPrefetcher);
+void       tsdbPrefetcherClose(SBlockPrefetcher **ppPrefetcher);
+void       tsdbPrefetcherReset(SBlockPrefetcher *pPrefetcher, SDFileSet *pSet);
+SDFileSet *tsdbPrefetcherGetFSet(SBlockPrefetcher *pPrefetcher);
+bool       tsdbPrefetcherPut(SBlockPrefetcher *pPrefetcher, TABLEID id, int32_t tbBlockIdx, int32_t index,
+                             SDataBlk *pBlock, STSchema *pTSchema, int64_t size);
+void       tsdbPrefetcherStart(SBlockPrefetcher *pPrefetcher);
+void       tsdbPrefetcherSkip(SBlockPrefetcher *pPrefetcher, int32_t index, int32_t step);
+bool       tsdbPrefetcherTake(SBlockPrefetcher *pPrefetcher, uint64_t uid, int32_t tbBlockIdx, SBlockData *pBlockData);
+// tsdbCompact.c ==============================================================================================
+bool tsdbShouldCompactFSet(SDFileSet *pSet, int64_t commitID, int8_t all);
 // tsdbMerge.c ==============================================================================================
 int32_t tsdbMerge(STsdb *pTsdb);
 
@@ -314,6 +331,9 @@ int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 void   tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t tsdbCacheGetCapacity(SVnode *pVnode);
 
+int32_t tsdbOpenPgCache(STsdb *pTsdb);
+void    tsdbClosePgCache(STsdb *pTsdb);
+
 int32_t tsdbCacheLastArray2Row(SArray *pLastArray, STSRow **ppRow, STSchema *pSchema);
 
 // structs =======================
@@ -332,6 +352,11 @@ struct STsdb {
   STsdbFS        fs;
   SLRUCache     *lruCache;
   TdThreadMutex  lruMutex;
+  int64_t        compactTs;  // last compaction time in ms
+  int8_t         compactForce;
+  SLRUCache     *pgCache;  // checksum-verified file pages, keyed by (pgno, path)
+  int64_t        pgCacheHit;
+  int64_t        pgCacheMiss;
 };
 
 struct TSDBKEY {
@@ -595,6 +620,8 @@ typedef struct {
   int64_t   pgno;
   uint8_t  *pBuf;
   int64_t   szFile;
+  STsdb    *pTsdb;     // set if pages are served through the tsdb page cache
+  int64_t   szSealed;  // pages [1, szSealed] are never rewritten and may be cached
 } STsdbFD;
 
 struct SDelFWriter {
@@ -61,6 +61,8 @@ struct SVBufPoolNode {
   uint8_t         data[];
 };
 
+#define VNODE_BUF_POOL_NCLASS 97
+
 struct SVBufPool {
   SVBufPool*       next;
   SVnode*          pVnode;
@@ -69,6 +71,9 @@ struct SVBufPool {
   int64_t          size;
   uint8_t*         ptr;
   SVBufPoolNode*   pTail;
+  int64_t          gen;                           // changed by each reset, invalidates thread-local chunks
+  int64_t          szFree;                        // bytes cached in aFree
+  SVBufPoolNode*   aFree[VNODE_BUF_POOL_NCLASS];  // recycled large nodes by size class
   SVBufPoolNode    node;
 };
 
@@ -86,7 +91,6 @@ int32_t vnodeGetBatchMeta(SVnode* pVnode, SRpcMsg* pMsg);
 // vnodeCommit.c
 int32_t vnodeBegin(SVnode* pVnode);
 int32_t vnodeShouldCommit(SVnode* pVnode);
-int32_t vnodeCommit(SVnode* pVnode);
 int32_t vnodeSaveInfo(const char* dir, const SVnodeInfo* pCfg);
 int32_t vnodeCommitInfo(const char* dir, const SVnodeInfo* pInfo);
 int32_t vnodeLoadInfo(const char* dir, SVnodeInfo* pInfo);
@@ -90,6 +90,8 @@ void* vnodeBufPoolMalloc(SVBufPool* pPool, int size);
 void  vnodeBufPoolFree(SVBufPool* pPool, void* p);
 void  vnodeBufPoolRef(SVBufPool* pPool);
 void  vnodeBufPoolUnRef(SVBufPool* pPool);
+int   vnodeScheduleReadTask(int (*execute)(void*), void* arg);
+int   vnodeScheduleCompactTask(int (*execute)(void*), void* arg);
 
 // meta
 typedef struct SMCtbCursor SMCtbCursor;
@@ -143,8 +145,12 @@ int32_t metaGetInfo(SMeta* pMeta, int64_t uid, SMetaInfo* pInfo);
 int         tsdbOpen(SVnode* pVnode, STsdb** ppTsdb, const char* dir, STsdbKeepCfg* pKeepCfg);
 int         tsdbClose(STsdb** pTsdb);
 int32_t     tsdbBegin(STsdb* pTsdb);
-int32_t     tsdbCommit(STsdb* pTsdb);
+int32_t     tsdbPrepareCommit(STsdb* pTsdb);
+int32_t     tsdbCommit(STsdb* pTsdb, int64_t commitID);
 int32_t     tsdbDoRetention(STsdb* pTsdb, int64_t now);
+bool        tsdbShouldCompact(STsdb* pTsdb, int64_t commitID);
+int32_t     tsdbCompact(STsdb* pTsdb, int64_t commitID);
+void        tsdbScheduleCompact(STsdb* pTsdb);
 int         tsdbScanAndConvertSubmitMsg(STsdb* pTsdb, SSubmitReq* pMsg);
 int         tsdbInsertData(STsdb* pTsdb, int64_t version, SSubmitReq* pMsg, SSubmitRsp* pRsp);
 int32_t     tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock,
@@ -319,6 +325,10 @@ struct SVnode {
   STQ*          pTq;
   SSink*        pSink;
   tsem_t        canCommit;
+  int8_t        committing;     // a background commit is flushing the frozen memtable
+  int32_t       commitWaiting;  // commits waiting on canCommit, a compaction holding it gives way to them
+  int8_t        compacting;     // a compaction round is queued or running
+  int8_t        compactStop;    // the vnode is closing, the compaction round ends at its next check
   int64_t       sync;
   TdThreadMutex lock;
   bool          blocked;
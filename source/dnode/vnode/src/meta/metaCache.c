@@ -29,13 +29,42 @@ struct SMetaCache {
   int32_t           nEntry;
   int32_t           nBucket;
   SMetaCacheEntry** aBucket;
+
+  // (suid, version of suid, digest of tag filter) : SArray<STableKeyInfo>
+  struct {
+    TdThreadMutex lock;
+    SHashObj*     pVersion;  // suid : version, bumped once a child table is created, dropped or its tags are altered
+    SLRUCache*    pResCache;
+    int64_t       nHit;
+    int64_t       nMiss;
+  } sTagFilter;
+
+  // (uid of super or normal table, sver) : STSchema
+  struct {
+    SLRUCache* pCache;
+    int64_t    nHit;
+    int64_t    nMiss;
+  } sSchema;
 };
 
+typedef struct {
+  int32_t       num;
+  STableKeyInfo info[];
+} STagFilterRes;
+
+#define META_TAG_FILTER_KEY_MAX 64
+#define META_SCHEMA_CACHE_SIZE  (16 * 1024 * 1024)
+
+static int32_t metaTagFilterCacheOpen(SMeta* pMeta);
+static void    metaTagFilterCacheClose(SMeta* pMeta);
+static int32_t metaSchemaCacheOpen(SMeta* pMeta);
+static void    metaSchemaCacheClose(SMeta* pMeta);
+
 int32_t metaCacheOpen(SMeta* pMeta) {
   int32_t     code = 0;
   SMetaCache* pCache = NULL;
 
-  pCache = (SMetaCache*)taosMemoryMalloc(sizeof(SMetaCache));
+  pCache = (SMetaCache*)taosMemoryCalloc(1, sizeof(SMetaCache));
   if (pCache == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err;
@@ -52,6 +81,18 @@ int32_t metaCacheOpen(SMeta* pMeta) {
 
   pMeta->pCache = pCache;
 
+  code = metaTagFilterCacheOpen(pMeta);
+  if (code) {
+    metaCacheClose(pMeta);
+    goto _err;
+  }
+
+  code = metaSchemaCacheOpen(pMeta);
+  if (code) {
+    metaCacheClose(pMeta);
+    goto _err;
+  }
+
 _exit:
   return code;
 
@@ -71,6 +112,8 @@ void metaCacheClose(SMeta* pMeta) {
       }
     }
     taosMemoryFree(pMeta->pCache->aBucket);
+    metaTagFilterCacheClose(pMeta);
+    metaSchemaCacheClose(pMeta);
     taosMemoryFree(pMeta->pCache);
     pMeta->pCache = NULL;
   }
@@ -204,3 +247,238 @@ int32_t metaCacheGet(SMeta* pMeta, int64_t uid, SMetaInfo* pInfo) {
 
   return code;
 }
+
+static int32_t metaTagFilterCacheOpen(SMeta* pMeta) {
+  SMetaCache* pCache = pMeta->pCache;
+  size_t      capacity = (size_t)tsTagFilterCacheSize * 1024 * 1024;
+
+  // a disabled cache is told apart by a NULL pResCache, on close and on every lookup
+  memset(&pCache->sTagFilter, 0, sizeof(pCache->sTagFilter));
+  if (capacity == 0) return 0;
+
+  pCache->sTagFilter.pVersion = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pCache->sTagFilter.pVersion == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pCache->sTagFilter.pResCache = taosLRUCacheInit(capacity, -1, .5);
+  if (pCache->sTagFilter.pResCache == NULL) {
+    taosHashCleanup(pCache->sTagFilter.pVersion);
+    pCache->sTagFilter.pVersion = NULL;
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache->sTagFilter.pResCache, true);
+  taosThreadMutexInit(&pCache->sTagFilter.lock, NULL);
+  return 0;
+}
+
+static void metaTagFilterCacheClose(SMeta* pMeta) {
+  SMetaCache* pCache = pMeta->pCache;
+  if (pCache->sTagFilter.pResCache == NULL) return;
+
+  metaDebug("vgId:%d tag filter cache closed, hit:%" PRId64 " miss:%" PRId64, TD_VID(pMeta->pVnode),
+            pCache->sTagFilter.nHit, pCache->sTagFilter.nMiss);
+
+  taosLRUCacheEraseUnrefEntries(pCache->sTagFilter.pResCache);
+  taosLRUCacheCleanup(pCache->sTagFilter.pResCache);
+  taosHashCleanup(pCache->sTagFilter.pVersion);
+  taosThreadMutexDestroy(&pCache->sTagFilter.lock);
+  pCache->sTagFilter.pResCache = NULL;
+  pCache->sTagFilter.pVersion = NULL;
+}
+
+static void metaTagFilterResDeleter(const void* key, size_t keyLen, void* value) { taosMemoryFree(value); }
+
+static int32_t metaTagFilterKey(tb_uid_t suid, int64_t version, const uint8_t* pKey, int32_t keyLen, uint8_t* pBuf) {
+  ASSERT(keyLen <= META_TAG_FILTER_KEY_MAX - sizeof(tb_uid_t) - sizeof(int64_t));
+
+  memcpy(pBuf, &suid, sizeof(tb_uid_t));
+  memcpy(pBuf + sizeof(tb_uid_t), &version, sizeof(int64_t));
+  memcpy(pBuf + sizeof(tb_uid_t) + sizeof(int64_t), pKey, keyLen);
+  return sizeof(tb_uid_t) + sizeof(int64_t) + keyLen;
+}
+
+/*
+ * Get the cached result of the tag filter identified by pKey, i.e. the qualified child tables of suid, and the group id
+ * of each table if the result is of a group by. The current version of suid is returned in any case, and the result
+ * computed by the caller is put into cache with this version, so that it can never be hit if the child tables of suid
+ * are changed in the meanwhile.
+ */
+int32_t metaGetCachedTableList(SMeta* pMeta, tb_uid_t suid, const uint8_t* pKey, int32_t keyLen, SArray* pList,
+                               int64_t* pVersion) {
+  SMetaCache* pCache = pMeta->pCache;
+  uint8_t     key[META_TAG_FILTER_KEY_MAX];
+
+  *pVersion = -1;
+  if (pCache == NULL || pCache->sTagFilter.pResCache == NULL) {
+    return TSDB_CODE_NOT_FOUND;
+  }
+
+  taosThreadMutexLock(&pCache->sTagFilter.lock);
+  int64_t* pVer = taosHashGet(pCache->sTagFilter.pVersion, &suid, sizeof(tb_uid_t));
+  *pVersion = pVer ? *pVer : 0;
+  taosThreadMutexUnlock(&pCache->sTagFilter.lock);
+
+  int32_t    len = metaTagFilterKey(suid, *pVersion, pKey, keyLen, key);
+  LRUHandle* h = taosLRUCacheLookup(pCache->sTagFilter.pResCache, key, len);
+  if (h == NULL) {
+    atomic_add_fetch_64(&pCache->sTagFilter.nMiss, 1);
+    return TSDB_CODE_NOT_FOUND;
+  }
+
+  STagFilterRes* pRes = taosLRUCacheValue(pCache->sTagFilter.pResCache, h);
+  taosArrayAddBatch(pList, pRes->info, pRes->num);
+  taosLRUCacheRelease(pCache->sTagFilter.pResCache, h, false);
+
+  int64_t nHit = atomic_add_fetch_64(&pCache->sTagFilter.nHit, 1);
+  metaDebug("vgId:%d tag filter cache hit, suid:%" PRId64 " tables:%d hit:%" PRId64 " miss:%" PRId64,
+            TD_VID(pMeta->pVnode), suid, pRes->num, nHit, atomic_load_64(&pCache->sTagFilter.nMiss));
+  return 0;
+}
+
+int32_t metaPutCachedTableList(SMeta* pMeta, tb_uid_t suid, const uint8_t* pKey, int32_t keyLen, int64_t version,
+                               const SArray* pList) {
+  SMetaCache* pCache = pMeta->pCache;
+  uint8_t     key[META_TAG_FILTER_KEY_MAX];
+
+  if (version < 0 || pCache == NULL || pCache->sTagFilter.pResCache == NULL) {
+    return 0;
+  }
+
+  int32_t num = taosArrayGetSize(pList);
+  size_t  size = sizeof(STagFilterRes) + sizeof(STableKeyInfo) * num;
+  if (size > taosLRUCacheGetCapacity(pCache->sTagFilter.pResCache) / 4) {
+    return 0;
+  }
+
+  STagFilterRes* pRes = taosMemoryMalloc(size);
+  if (pRes == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pRes->num = num;
+  if (num > 0) {
+    memcpy(pRes->info, taosArrayGet(pList, 0), sizeof(STableKeyInfo) * num);
+  }
+
+  int32_t   len = metaTagFilterKey(suid, version, pKey, keyLen, key);
+  LRUStatus status = taosLRUCacheInsert(pCache->sTagFilter.pResCache, key, len, pRes, size, metaTagFilterResDeleter,
+                                        NULL, TAOS_LRU_PRIORITY_LOW);
+  if (status == TAOS_LRU_STATUS_FAIL) {
+    taosMemoryFree(pRes);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return 0;
+}
+
+// the cached tag filter results of suid are out of date since now
+void metaTagFilterCacheClear(SMeta* pMeta, tb_uid_t suid) {
+  SMetaCache* pCache = pMeta->pCache;
+  if (pCache == NULL || pCache->sTagFilter.pResCache == NULL) {
+    return;
+  }
+
+  taosThreadMutexLock(&pCache->sTagFilter.lock);
+  int64_t* pVer = taosHashGet(pCache->sTagFilter.pVersion, &suid, sizeof(tb_uid_t));
+  int64_t  version = pVer ? *pVer + 1 : 1;
+  taosHashPut(pCache->sTagFilter.pVersion, &suid, sizeof(tb_uid_t), &version, sizeof(int64_t));
+  taosThreadMutexUnlock(&pCache->sTagFilter.lock);
+}
+
+static int32_t metaSchemaCacheOpen(SMeta* pMeta) {
+  SMetaCache* pCache = pMeta->pCache;
+
+  pCache->sSchema.pCache = taosLRUCacheInit(META_SCHEMA_CACHE_SIZE, -1, .5);
+  if (pCache->sSchema.pCache == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache->sSchema.pCache, true);
+  return 0;
+}
+
+static void metaSchemaCacheClose(SMeta* pMeta) {
+  SMetaCache* pCache = pMeta->pCache;
+  if (pCache->sSchema.pCache == NULL) return;
+
+  metaDebug("vgId:%d schema cache closed, hit:%" PRId64 " miss:%" PRId64, TD_VID(pMeta->pVnode),
+            pCache->sSchema.nHit, pCache->sSchema.nMiss);
+
+  taosLRUCacheEraseUnrefEntries(pCache->sSchema.pCache);
+  taosLRUCacheCleanup(pCache->sSchema.pCache);
+  pCache->sSchema.pCache = NULL;
+}
+
+static void metaSchemaDeleter(const void* key, size_t keyLen, void* value) { taosMemoryFree(value); }
+
+static STSchema* metaSchemaDup(const STSchema* pTSchema) {
+  size_t    size = sizeof(STSchema) + sizeof(STColumn) * pTSchema->numOfCols;
+  STSchema* pDup = taosMemoryMalloc(size);
+  if (pDup) memcpy(pDup, pTSchema, size);
+  return pDup;
+}
+
+/*
+ * The schema of a (uid, sver) never changes once created, so the decoded schema is shared by all readers through the
+ * cache. The entry is pinned while being copied out, and the caller owns the copy as it owns a schema built from TDB.
+ */
+int32_t metaSchemaCacheGet(SMeta* pMeta, tb_uid_t uid, int32_t sver, STSchema** ppTSchema) {
+  SMetaCache* pCache = pMeta->pCache;
+  SSkmDbKey   key = {.uid = uid, .sver = sver};
+
+  if (pCache == NULL || pCache->sSchema.pCache == NULL) {
+    return TSDB_CODE_NOT_FOUND;
+  }
+
+  LRUHandle* h = taosLRUCacheLookup(pCache->sSchema.pCache, &key, sizeof(key));
+  if (h == NULL) {
+    atomic_add_fetch_64(&pCache->sSchema.nMiss, 1);
+    return TSDB_CODE_NOT_FOUND;
+  }
+
+  *ppTSchema = metaSchemaDup(taosLRUCacheValue(pCache->sSchema.pCache, h));
+  taosLRUCacheRelease(pCache->sSchema.pCache, h, false);
+  if (*ppTSchema == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  atomic_add_fetch_64(&pCache->sSchema.nHit, 1);
+  return 0;
+}
+
+void metaSchemaCachePut(SMeta* pMeta, tb_uid_t uid, const STSchema* pTSchema) {
+  SMetaCache* pCache = pMeta->pCache;
+  SSkmDbKey   key = {.uid = uid, .sver = pTSchema->version};
+
+  if (pCache == NULL || pCache->sSchema.pCache == NULL) {
+    return;
+  }
+
+  STSchema* pDup = metaSchemaDup(pTSchema);
+  if (pDup == NULL) {
+    return;
+  }
+
+  size_t    charge = sizeof(STSchema) + sizeof(STColumn) * pTSchema->numOfCols;
+  LRUStatus status = taosLRUCacheInsert(pCache->sSchema.pCache, &key, sizeof(key), pDup, charge, metaSchemaDeleter,
+                                        NULL, TAOS_LRU_PRIORITY_LOW);
+  if (status == TAOS_LRU_STATUS_FAIL) {
+    taosMemoryFree(pDup);
+  }
+}
+
+// drop the cached schemas of uid up to sver once the table is dropped. An ALTER keeps them, a (uid, sver) schema never
+// changes and the latest sver is resolved through the entry cache
+void metaSchemaCacheDrop(SMeta* pMeta, tb_uid_t uid, int32_t sver) {
+  SMetaCache* pCache = pMeta->pCache;
+  if (pCache == NULL || pCache->sSchema.pCache == NULL) {
+    return;
+  }
+
+  for (int32_t v = 1; v <= sver; v++) {
+    SSkmDbKey key = {.uid = uid, .sver = v};
+    taosLRUCacheErase(pCache->sSchema.pCache, &key, sizeof(key));
+  }
+}
@@ -530,12 +530,34 @@ tb_uid_t metaStbCursorNext(SMStbCursor *pStbCur) {
   return *(tb_uid_t *)pStbCur->pKey;
 }
 
+// the schema cache key of a table: schemas of child tables are kept by their super tables
+static int32_t metaGetSkmKey(SMeta *pMeta, tb_uid_t uid, int32_t sver, SSkmDbKey *pKey) {
+  SMetaInfo info;
+
+  if (metaGetInfo(pMeta, uid, &info) < 0) return TSDB_CODE_NOT_FOUND;
+
+  if (info.suid && info.suid != uid) {
+    uid = info.suid;
+    if (sver <= 0 && metaGetInfo(pMeta, uid, &info) < 0) return TSDB_CODE_NOT_FOUND;
+  }
+
+  pKey->uid = uid;
+  pKey->sver = sver <= 0 ? info.skmVer : sver;
+  return pKey->sver > 0 ? 0 : TSDB_CODE_NOT_FOUND;
+}
+
 STSchema *metaGetTbTSchema(SMeta *pMeta, tb_uid_t uid, int32_t sver) {
   // SMetaReader     mr = {0};
   STSchema       *pTSchema = NULL;
   SSchemaWrapper *pSW = NULL;
   STSchemaBuilder sb = {0};
   SSchema        *pSchema;
+  SSkmDbKey       skmKey = {0};
+
+  bool cached = metaGetSkmKey(pMeta, uid, sver, &skmKey) == 0;
+  if (cached && metaSchemaCacheGet(pMeta, skmKey.uid, skmKey.sver, &pTSchema) == 0) {
+    return pTSchema;
+  }
 
   pSW = metaGetTableSchema(pMeta, uid, sver, 0);
   if (!pSW) return NULL;
@@ -549,6 +571,10 @@ STSchema *metaGetTbTSchema(SMeta *pMeta, tb_uid_t uid, int32_t sver) {
 
   tdDestroyTSchemaBuilder(&sb);
 
+  if (cached && pTSchema && pTSchema->version == skmKey.sver) {
+    metaSchemaCachePut(pMeta, skmKey.uid, pTSchema);
+  }
+
   taosMemoryFree(pSW->pSchema);
   taosMemoryFree(pSW);
   return pTSchema;
@@ -609,6 +635,11 @@ int32_t metaGetTbTSchemaEx(SMeta *pMeta, tb_uid_t suid, tb_uid_t uid, int32_t sv
 
   skmDbKey.uid = suid ? suid : uid;
   skmDbKey.sver = sver;
+
+  if (metaSchemaCacheGet(pMeta, skmDbKey.uid, skmDbKey.sver, ppTSchema) == 0) {
+    goto _exit;
+  }
+
   metaRLock(pMeta);
   if (tdbTbGet(pMeta->pSkmDb, &skmDbKey, sizeof(SSkmDbKey), &pData, &nData) < 0) {
     metaULock(pMeta);
@@ -638,6 +669,10 @@ int32_t metaGetTbTSchemaEx(SMeta *pMeta, tb_uid_t suid, tb_uid_t uid, int32_t sv
   STSchema *pTSchema = tdGetSchemaFromBuilder(&sb);
   tdDestroyTSchemaBuilder(&sb);
 
+  if (pTSchema) {
+    metaSchemaCachePut(pMeta, skmDbKey.uid, pTSchema);
+  }
+
   *ppTSchema = pTSchema;
   taosMemoryFree(pSchemaWrapper->pSchema);
 
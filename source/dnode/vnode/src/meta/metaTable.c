@@ -290,6 +290,9 @@ _drop_super_table:
   tdbTbDelete(pMeta->pUidIdx, &pReq->suid, sizeof(tb_uid_t), &pMeta->txn);
   tdbTbDelete(pMeta->pSuidIdx, &pReq->suid, sizeof(tb_uid_t), &pMeta->txn);
 
+  metaTagStoreDrop(pMeta, pReq->suid);
+  metaSchemaCacheDrop(pMeta, pReq->suid, ((SUidIdxVal *)pData)[0].skmVer);
+
   metaULock(pMeta);
 
 _exit:
@@ -361,6 +364,11 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
   // update uid index
   metaUpdateUidIdx(pMeta, &nStbEntry);
 
+  // the tags may be added, dropped or renamed
+  metaTagFilterCacheClear(pMeta, pReq->suid);
+  metaTagStoreDrop(pMeta, pReq->suid);
+  // the cached schema versions stay valid, the new one is found through the uid index updated above
+
   if (oStbEntry.pBuf) taosMemoryFree(oStbEntry.pBuf);
   metaULock(pMeta);
   tDecoderClear(&dc);
@@ -616,6 +624,17 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
 
   metaCacheDrop(pMeta, uid);
 
+  if (e.type == TSDB_CHILD_TABLE) {
+    metaTagFilterCacheClear(pMeta, e.ctbEntry.suid);
+    metaTagStoreDelete(pMeta, e.ctbEntry.suid, uid);
+  } else if (e.type == TSDB_SUPER_TABLE) {
+    metaTagFilterCacheClear(pMeta, uid);
+    metaTagStoreDrop(pMeta, uid);
+    metaSchemaCacheDrop(pMeta, uid, e.stbEntry.schemaRow.version);
+  } else if (e.type == TSDB_NORMAL_TABLE) {
+    metaSchemaCacheDrop(pMeta, uid, e.ntbEntry.schemaRow.version);
+  }
+
   tDecoderClear(&dc);
   tdbFree(pData);
 
@@ -933,6 +952,9 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
   tdbTbUpsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), ctbEntry.ctbEntry.pTags,
               ((STag *)(ctbEntry.ctbEntry.pTags))->len, &pMeta->txn);
 
+  metaTagFilterCacheClear(pMeta, ctbEntry.ctbEntry.suid);
+  metaTagStoreUpsert(pMeta, &ctbEntry);
+
   tDecoderClear(&dc1);
   tDecoderClear(&dc2);
   if (ctbEntry.ctbEntry.pTags) taosMemoryFree((void *)ctbEntry.ctbEntry.pTags);
@@ -1314,6 +1336,11 @@ int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
     if (metaUpdateTtlIdx(pMeta, pME) < 0) goto _err;
   }
 
+  if (pME->type == TSDB_CHILD_TABLE) {
+    metaTagFilterCacheClear(pMeta, pME->ctbEntry.suid);
+    metaTagStoreUpsert(pMeta, pME);
+  }
+
   metaULock(pMeta);
   return 0;
 
@@ -0,0 +1,789 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "meta.h"
+#include "tdatablock.h"
+
+// Tags of the child tables of a super table, kept column by column so that tag filters, tag scans and group by tags
+// read contiguous arrays instead of decoding the tags of each child table. Values of var-length tags are dictionary
+// encoded. The store of a super table is built on first use and kept in sync by metaTable.c afterwards; it is dropped
+// once the super table is altered or dropped and rebuilt on the next use.
+//
+// The stores of a vnode are bounded by tagColumnarStoreSize, the least recently used ones are evicted once it is
+// exceeded. A super table whose store alone is over the bound keeps an empty, unsupported store, so that its queries
+// read the tags table by table without building the store again.
+//
+// lock order: meta lock -> tag store lock
+
+#define TAG_STORE_INIT_ROWS 64
+
+typedef struct {
+  int16_t   cid;
+  int8_t    type;
+  int32_t   bytes;
+  int32_t   itemSize;  // bytes of one row in pData
+  int8_t*   pNull;
+  char*     pData;     // value of each row, or dictionary code of each row for var-length tags
+  SHashObj* pDict;     // value : code
+  SArray*   pDictVal;  // code : value in var data format
+} STagStoreCol;
+
+typedef struct {
+  tb_uid_t      suid;
+  bool          supported;  // false for super tables with json tag, or with a store over the bound
+  bool          hasName;
+  int64_t       lastUse;
+  int64_t       memSize;
+  int64_t       varBytes;  // of the dictionary values and the table names
+  int32_t       numOfRows;
+  int32_t       capacity;
+  tb_uid_t*     aUid;
+  char**        aName;    // table name of each row in var data format, loaded on first use
+  SHashObj*     pUidIdx;  // uid : row
+  int32_t       nCols;
+  STagStoreCol* aCol;
+} STagStoreTable;
+
+struct SMetaTagStore {
+  TdThreadRwlock lock;
+  SHashObj*      pTables;  // suid : STagStoreTable*
+  int64_t        memSize;
+  int64_t        tick;
+};
+
+static int32_t tagStoreNameBytes(const char* pName) { return pName ? varDataTLen(pName) : 0; }
+
+// free the rows and columns, the table is left empty and unsupported
+static void tagStoreTableClear(STagStoreTable* pTable) {
+  for (int32_t i = 0; i < pTable->nCols; i++) {
+    STagStoreCol* pCol = &pTable->aCol[i];
+    taosMemoryFree(pCol->pNull);
+    taosMemoryFree(pCol->pData);
+    taosHashCleanup(pCol->pDict);
+    taosArrayDestroyP(pCol->pDictVal, taosMemoryFree);
+  }
+  taosMemoryFree(pTable->aCol);
+
+  if (pTable->aName) {
+    for (int32_t i = 0; i < pTable->numOfRows; i++) {
+      taosMemoryFree(pTable->aName[i]);
+    }
+    taosMemoryFree(pTable->aName);
+  }
+  taosMemoryFree(pTable->aUid);
+  taosHashCleanup(pTable->pUidIdx);
+
+  pTable->supported = false;
+  pTable->hasName = false;
+  pTable->numOfRows = 0;
+  pTable->capacity = 0;
+  pTable->aUid = NULL;
+  pTable->aName = NULL;
+  pTable->pUidIdx = NULL;
+  pTable->nCols = 0;
+  pTable->aCol = NULL;
+  pTable->varBytes = 0;
+}
+
+static void tagStoreTableDestroy(STagStoreTable* pTable) {
+  if (pTable == NULL) return;
+
+  tagStoreTableClear(pTable);
+  taosMemoryFree(pTable);
+}
+
+static int64_t tagStoreTableMemSize(const STagStoreTable* pTable) {
+  int64_t size = sizeof(STagStoreTable) + pTable->nCols * sizeof(STagStoreCol) + pTable->varBytes +
+                 (int64_t)pTable->capacity * (sizeof(tb_uid_t) + POINTER_BYTES) + taosHashGetMemSize(pTable->pUidIdx);
+
+  for (int32_t i = 0; i < pTable->nCols; i++) {
+    const STagStoreCol* pCol = &pTable->aCol[i];
+    size += (int64_t)pTable->capacity * (1 + pCol->itemSize);
+    if (pCol->pDict) {
+      size += taosHashGetMemSize(pCol->pDict) + taosArrayGetSize(pCol->pDictVal) * POINTER_BYTES;
+    }
+  }
+
+  return size;
+}
+
+static void tagStoreTableFree(void* p) { tagStoreTableDestroy(*(STagStoreTable**)p); }
+
+static STagStoreTable* tagStoreTableCreate(tb_uid_t suid, const SSchemaWrapper* pTagSchema) {
+  STagStoreTable* pTable = taosMemoryCalloc(1, sizeof(STagStoreTable));
+  if (pTable == NULL) return NULL;
+
+  pTable->suid = suid;
+  pTable->supported = !(pTagSchema->nCols == 1 && pTagSchema->pSchema[0].type == TSDB_DATA_TYPE_JSON);
+  if (!pTable->supported) return pTable;
+
+  pTable->pUidIdx = taosHashInit(TAG_STORE_INIT_ROWS, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false,
+                                 HASH_NO_LOCK);
+  pTable->aCol = taosMemoryCalloc(pTagSchema->nCols, sizeof(STagStoreCol));
+  if (pTable->pUidIdx == NULL || pTable->aCol == NULL) goto _err;
+
+  pTable->nCols = pTagSchema->nCols;
+  for (int32_t i = 0; i < pTagSchema->nCols; i++) {
+    STagStoreCol*  pCol = &pTable->aCol[i];
+    const SSchema* pSchema = &pTagSchema->pSchema[i];
+
+    pCol->cid = pSchema->colId;
+    pCol->type = pSchema->type;
+    pCol->bytes = pSchema->bytes;
+    if (IS_VAR_DATA_TYPE(pSchema->type)) {
+      pCol->itemSize = sizeof(int32_t);
+      pCol->pDict = taosHashInit(TAG_STORE_INIT_ROWS, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false,
+                                 HASH_NO_LOCK);
+      pCol->pDictVal = taosArrayInit(TAG_STORE_INIT_ROWS, POINTER_BYTES);
+      if (pCol->pDict == NULL || pCol->pDictVal == NULL) goto _err;
+    } else {
+      pCol->itemSize = pSchema->bytes;
+    }
+  }
+
+  return pTable;
+
+_err:
+  tagStoreTableDestroy(pTable);
+  return NULL;
+}
+
+static int32_t tagStoreTableEnsure(STagStoreTable* pTable, int32_t numOfRows) {
+  if (numOfRows <= pTable->capacity) return 0;
+
+  int32_t capacity = TMAX(pTable->capacity * 2, TAG_STORE_INIT_ROWS);
+  while (capacity < numOfRows) capacity *= 2;
+
+  void* p = taosMemoryRealloc(pTable->aUid, sizeof(tb_uid_t) * capacity);
+  if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pTable->aUid = p;
+
+  p = taosMemoryRealloc(pTable->aName, POINTER_BYTES * capacity);
+  if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pTable->aName = p;
+
+  for (int32_t i = 0; i < pTable->nCols; i++) {
+    STagStoreCol* pCol = &pTable->aCol[i];
+
+    p = taosMemoryRealloc(pCol->pNull, capacity);
+    if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    pCol->pNull = p;
+
+    p = taosMemoryRealloc(pCol->pData, (int64_t)pCol->itemSize * capacity);
+    if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    pCol->pData = p;
+  }
+
+  pTable->capacity = capacity;
+  return 0;
+}
+
+static int32_t tagStoreDictCode(STagStoreTable* pTable, STagStoreCol* pCol, const uint8_t* pData, uint32_t nData,
+                                int32_t* pCode) {
+  int32_t* pFound = taosHashGet(pCol->pDict, pData, nData);
+  if (pFound) {
+    *pCode = *pFound;
+    return 0;
+  }
+
+  char* pVal = taosMemoryMalloc(VARSTR_HEADER_SIZE + nData);
+  if (pVal == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  STR_WITH_SIZE_TO_VARSTR(pVal, pData, nData);
+
+  int32_t code = taosArrayGetSize(pCol->pDictVal);
+  if (taosArrayPush(pCol->pDictVal, &pVal) == NULL) {
+    taosMemoryFree(pVal);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  if (taosHashPut(pCol->pDict, pData, nData, &code, sizeof(code)) != 0) {
+    taosArrayPop(pCol->pDictVal);
+    taosMemoryFree(pVal);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pTable->varBytes += VARSTR_HEADER_SIZE + nData;
+  *pCode = code;
+  return 0;
+}
+
+static char* tagStoreCopyName(const char* name) {
+  int32_t len = strlen(name);
+  char*   pName = taosMemoryMalloc(VARSTR_HEADER_SIZE + len);
+  if (pName) STR_WITH_SIZE_TO_VARSTR(pName, name, len);
+  return pName;
+}
+
+static int32_t tagStoreTableUpsert(STagStoreTable* pTable, tb_uid_t uid, const STag* pTag, const char* name) {
+  int32_t  code = 0;
+  int32_t  row;
+  int32_t* pRow = taosHashGet(pTable->pUidIdx, &uid, sizeof(uid));
+
+  if (pRow) {
+    row = *pRow;
+  } else {
+    code = tagStoreTableEnsure(pTable, pTable->numOfRows + 1);
+    if (code) return code;
+
+    row = pTable->numOfRows;
+    if (taosHashPut(pTable->pUidIdx, &uid, sizeof(uid), &row, sizeof(row)) != 0) return TSDB_CODE_OUT_OF_MEMORY;
+
+    pTable->aUid[row] = uid;
+    pTable->aName[row] = NULL;
+    for (int32_t i = 0; i < pTable->nCols; i++) {
+      pTable->aCol[i].pNull[row] = 1;
+    }
+    pTable->numOfRows++;
+  }
+
+  for (int32_t i = 0; i < pTable->nCols; i++) {
+    STagStoreCol* pCol = &pTable->aCol[i];
+    STagVal       tagVal = {.cid = pCol->cid};
+
+    if (!tTagGet(pTag, &tagVal)) {
+      pCol->pNull[row] = 1;
+      continue;
+    }
+
+    if (IS_VAR_DATA_TYPE(pCol->type)) {
+      int32_t dictCode = 0;
+      code = tagStoreDictCode(pTable, pCol, tagVal.pData, tagVal.nData, &dictCode);
+      if (code) return code;
+      ((int32_t*)pCol->pData)[row] = dictCode;
+    } else {
+      memcpy(pCol->pData + (int64_t)row * pCol->itemSize, &tagVal.i64, pCol->itemSize);
+    }
+    pCol->pNull[row] = 0;
+  }
+
+  if (pTable->hasName && name) {
+    char* pName = tagStoreCopyName(name);
+    if (pName == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    pTable->varBytes += tagStoreNameBytes(pName) - tagStoreNameBytes(pTable->aName[row]);
+    taosMemoryFree(pTable->aName[row]);
+    pTable->aName[row] = pName;
+  }
+
+  return 0;
+}
+
+static void tagStoreTableRemove(STagStoreTable* pTable, tb_uid_t uid) {
+  int32_t* pRow = taosHashGet(pTable->pUidIdx, &uid, sizeof(uid));
+  if (pRow == NULL) return;
+
+  int32_t row = *pRow;
+  int32_t last = pTable->numOfRows - 1;
+
+  taosHashRemove(pTable->pUidIdx, &uid, sizeof(uid));
+  pTable->varBytes -= tagStoreNameBytes(pTable->aName[row]);
+  taosMemoryFree(pTable->aName[row]);
+
+  // move the last row into the hole
+  if (row != last) {
+    pTable->aUid[row] = pTable->aUid[last];
+    pTable->aName[row] = pTable->aName[last];
+    for (int32_t i = 0; i < pTable->nCols; i++) {
+      STagStoreCol* pCol = &pTable->aCol[i];
+      pCol->pNull[row] = pCol->pNull[last];
+      memcpy(pCol->pData + (int64_t)row * pCol->itemSize, pCol->pData + (int64_t)last * pCol->itemSize,
+             pCol->itemSize);
+    }
+    taosHashPut(pTable->pUidIdx, &pTable->aUid[row], sizeof(tb_uid_t), &row, sizeof(row));
+  }
+
+  pTable->numOfRows--;
+}
+
+// read an entry from table.db without taking the meta lock, the caller holds it
+static int32_t tagStoreGetEntry(SMeta* pMeta, tb_uid_t uid, void** ppBuf, int* nBuf, SDecoder* pCoder,
+                                SMetaEntry* pEntry) {
+  if (tdbTbGet(pMeta->pUidIdx, &uid, sizeof(uid), ppBuf, nBuf) < 0) {
+    return TSDB_CODE_PAR_TABLE_NOT_EXIST;
+  }
+
+  STbDbKey tbDbKey = {.version = ((SUidIdxVal*)*ppBuf)[0].version, .uid = uid};
+  if (tdbTbGet(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), ppBuf, nBuf) < 0) {
+    return TSDB_CODE_PAR_TABLE_NOT_EXIST;
+  }
+
+  tDecoderInit(pCoder, *ppBuf, *nBuf);
+  if (metaDecodeEntry(pCoder, pEntry) < 0) {
+    tDecoderClear(pCoder);
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  return 0;
+}
+
+static int32_t tagStoreTableBuild(SMeta* pMeta, tb_uid_t suid, STagStoreTable** ppTable) {
+  int32_t         code = 0;
+  void*           pBuf = NULL;
+  int             nBuf = 0;
+  SDecoder        coder = {0};
+  SMetaEntry      me = {0};
+  STagStoreTable* pTable = NULL;
+  TBC*            pCur = NULL;
+  void*           pKey = NULL;
+  void*           pVal = NULL;
+  int             kLen = 0;
+  int             vLen = 0;
+
+  code = tagStoreGetEntry(pMeta, suid, &pBuf, &nBuf, &coder, &me);
+  if (code) goto _exit;
+
+  if (me.type != TSDB_SUPER_TABLE) {
+    tDecoderClear(&coder);
+    code = TSDB_CODE_PAR_TABLE_NOT_EXIST;
+    goto _exit;
+  }
+
+  pTable = tagStoreTableCreate(suid, &me.stbEntry.schemaTag);
+  tDecoderClear(&coder);
+  if (pTable == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  if (!pTable->supported) goto _exit;
+
+  if (tdbTbcOpen(pMeta->pCtbIdx, &pCur, NULL) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  int        c = 0;
+  SCtbIdxKey ctbIdxKey = {.suid = suid, .uid = INT64_MIN};
+  tdbTbcMoveTo(pCur, &ctbIdxKey, sizeof(ctbIdxKey), &c);
+  if (c > 0) {
+    tdbTbcMoveToNext(pCur);
+  }
+
+  while (tdbTbcNext(pCur, &pKey, &kLen, &pVal, &vLen) >= 0) {
+    SCtbIdxKey* pCtbIdxKey = pKey;
+    if (pCtbIdxKey->suid > suid) break;
+
+    code = tagStoreTableUpsert(pTable, pCtbIdxKey->uid, pVal, NULL);
+    if (code) goto _exit;
+  }
+
+_exit:
+  if (pCur) tdbTbcClose(pCur);
+  tdbFree(pKey);
+  tdbFree(pVal);
+  tdbFree(pBuf);
+  if (code) {
+    tagStoreTableDestroy(pTable);
+    pTable = NULL;
+  }
+  *ppTable = pTable;
+  return code;
+}
+
+static int32_t tagStoreTableLoadName(SMeta* pMeta, STagStoreTable* pTable) {
+  int32_t code = 0;
+  void*   pBuf = NULL;
+  int     nBuf = 0;
+
+  for (int32_t i = 0; i < pTable->numOfRows; i++) {
+    if (pTable->aName[i]) continue;
+
+    SDecoder   coder = {0};
+    SMetaEntry me = {0};
+    code = tagStoreGetEntry(pMeta, pTable->aUid[i], &pBuf, &nBuf, &coder, &me);
+    if (code) goto _exit;
+
+    pTable->aName[i] = tagStoreCopyName(me.name);
+    tDecoderClear(&coder);
+    if (pTable->aName[i] == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    pTable->varBytes += tagStoreNameBytes(pTable->aName[i]);
+  }
+
+  pTable->hasName = true;
+
+_exit:
+  tdbFree(pBuf);
+  return code;
+}
+
+// refresh the memory size of a table after it is changed
+static void tagStoreAccount(SMetaTagStore* pStore, STagStoreTable* pTable) {
+  int64_t memSize = tagStoreTableMemSize(pTable);
+  pStore->memSize += memSize - pTable->memSize;
+  pTable->memSize = memSize;
+}
+
+static void tagStoreRemoveTable(SMetaTagStore* pStore, tb_uid_t suid) {
+  STagStoreTable** ppTable = taosHashGet(pStore->pTables, &suid, sizeof(suid));
+  if (ppTable == NULL) return;
+
+  pStore->memSize -= (*ppTable)->memSize;
+  taosHashRemove(pStore->pTables, &suid, sizeof(suid));
+}
+
+// evict the least recently used tables other than pKeep until the stores fit in the bound, the caller holds the write
+// lock
+static void tagStoreEvict(SMeta* pMeta, SMetaTagStore* pStore, STagStoreTable* pKeep) {
+  int64_t bound = (int64_t)tsTagColumnarStoreSize * 1024 * 1024;
+
+  while (pStore->memSize > bound) {
+    STagStoreTable* pVictim = NULL;
+    void*           p = taosHashIterate(pStore->pTables, NULL);
+    while (p) {
+      STagStoreTable* pTable = *(STagStoreTable**)p;
+      if (pTable != pKeep && pTable->supported && (pVictim == NULL || pTable->lastUse < pVictim->lastUse)) {
+        pVictim = pTable;
+      }
+      p = taosHashIterate(pStore->pTables, p);
+    }
+    if (pVictim == NULL) break;
+
+    metaDebug("vgId:%d, tag store of super table %" PRId64 " is evicted, size:%" PRId64, TD_VID(pMeta->pVnode),
+              pVictim->suid, pVictim->memSize);
+    tagStoreRemoveTable(pStore, pVictim->suid);
+  }
+
+  if (pStore->memSize > bound && pKeep->supported) {
+    metaDebug("vgId:%d, tag store of super table %" PRId64 " is over the bound, size:%" PRId64 ", bound:%" PRId64,
+              TD_VID(pMeta->pVnode), pKeep->suid, pKeep->memSize, bound);
+    tagStoreTableClear(pKeep);
+    tagStoreAccount(pStore, pKeep);
+  }
+}
+
+int32_t metaTagStoreOpen(SMeta* pMeta) {
+  SMetaTagStore* pStore = taosMemoryCalloc(1, sizeof(SMetaTagStore));
+  if (pStore == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  pStore->pTables = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+  if (pStore->pTables == NULL) {
+    taosMemoryFree(pStore);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosHashSetFreeFp(pStore->pTables, tagStoreTableFree);
+  taosThreadRwlockInit(&pStore->lock, NULL);
+
+  pMeta->pTagStore = pStore;
+  return 0;
+}
+
+void metaTagStoreClose(SMeta* pMeta) {
+  SMetaTagStore* pStore = pMeta->pTagStore;
+  if (pStore == NULL) return;
+
+  taosHashCleanup(pStore->pTables);
+  taosThreadRwlockDestroy(&pStore->lock);
+  taosMemoryFree(pStore);
+  pMeta->pTagStore = NULL;
+}
+
+void metaTagStoreUpsert(SMeta* pMeta, const SMetaEntry* pEntry) {
+  SMetaTagStore* pStore = pMeta->pTagStore;
+  if (pStore == NULL || pEntry->type != TSDB_CHILD_TABLE) return;
+
+  tb_uid_t suid = pEntry->ctbEntry.suid;
+
+  taosThreadRwlockWrlock(&pStore->lock);
+  STagStoreTable** ppTable = taosHashGet(pStore->pTables, &suid, sizeof(suid));
+  if (ppTable && (*ppTable)->supported) {
+    int32_t code = tagStoreTableUpsert(*ppTable, pEntry->uid, (const STag*)pEntry->ctbEntry.pTags, pEntry->name);
+    if (code) {
+      // the store can not be trusted anymore, rebuild it on next use
+      metaError("vgId:%d, failed to upsert table %" PRId64 " into tag store since %s", TD_VID(pMeta->pVnode),
+                pEntry->uid, tstrerror(code));
+      tagStoreRemoveTable(pStore, suid);
+    } else {
+      tagStoreAccount(pStore, *ppTable);
+      tagStoreEvict(pMeta, pStore, *ppTable);
+    }
+  }
+  taosThreadRwlockUnlock(&pStore->lock);
+}
+
+void metaTagStoreDelete(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid) {
+  SMetaTagStore* pStore = pMeta->pTagStore;
+  if (pStore == NULL) return;
+
+  taosThreadRwlockWrlock(&pStore->lock);
+  STagStoreTable** ppTable = taosHashGet(pStore->pTables, &suid, sizeof(suid));
+  if (ppTable && (*ppTable)->supported) {
+    tagStoreTableRemove(*ppTable, uid);
+    tagStoreAccount(pStore, *ppTable);
+  }
+  taosThreadRwlockUnlock(&pStore->lock);
+}
+
+void metaTagStoreDrop(SMeta* pMeta, tb_uid_t suid) {
+  SMetaTagStore* pStore = pMeta->pTagStore;
+  if (pStore == NULL) return;
+
+  taosThreadRwlockWrlock(&pStore->lock);
+  tagStoreRemoveTable(pStore, suid);
+  taosThreadRwlockUnlock(&pStore->lock);
+}
+
+// memory size of the store of a super table, 0 if it is not kept, or of all stores if suid is 0
+int64_t metaTagStoreMemSize(SMeta* pMeta, tb_uid_t suid) {
+  SMetaTagStore* pStore = pMeta->pTagStore;
+  int64_t        memSize = 0;
+  if (pStore == NULL) return 0;
+
+  taosThreadRwlockRdlock(&pStore->lock);
+  if (suid == 0) {
+    memSize = pStore->memSize;
+  } else {
+    STagStoreTable** ppTable = taosHashGet(pStore->pTables, &suid, sizeof(suid));
+    memSize = ppTable ? (*ppTable)->memSize : 0;
+  }
+  taosThreadRwlockUnlock(&pStore->lock);
+
+  return memSize;
+}
+
+static int32_t metaTagStorePrepare(SMeta* pMeta, tb_uid_t suid, bool needName) {
+  SMetaTagStore* pStore = pMeta->pTagStore;
+  int32_t        code = 0;
+
+  taosThreadRwlockRdlock(&pStore->lock);
+  STagStoreTable** ppTable = taosHashGet(pStore->pTables, &suid, sizeof(suid));
+  bool             ready = ppTable && (!needName || !(*ppTable)->supported || (*ppTable)->hasName);
+  taosThreadRwlockUnlock(&pStore->lock);
+  if (ready) return 0;
+
+  metaRLock(pMeta);
+  taosThreadRwlockWrlock(&pStore->lock);
+
+  ppTable = taosHashGet(pStore->pTables, &suid, sizeof(suid));
+  STagStoreTable* pTable = ppTable ? *ppTable : NULL;
+  if (pTable == NULL) {
+    code = tagStoreTableBuild(pMeta, suid, &pTable);
+    if (code) goto _exit;
+
+    if (taosHashPut(pStore->pTables, &suid, sizeof(suid), &pTable, POINTER_BYTES) != 0) {
+      tagStoreTableDestroy(pTable);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    metaDebug("vgId:%d, tag store of super table %" PRId64 " is built, rows:%d", TD_VID(pMeta->pVnode), suid,
+              pTable->numOfRows);
+  }
+
+  if (needName && pTable->supported && !pTable->hasName) {
+    code = tagStoreTableLoadName(pMeta, pTable);
+  }
+
+  pTable->lastUse = atomic_add_fetch_64(&pStore->tick, 1);
+  tagStoreAccount(pStore, pTable);
+  tagStoreEvict(pMeta, pStore, pTable);
+
+_exit:
+  taosThreadRwlockUnlock(&pStore->lock);
+  metaULock(pMeta);
+  return code;
+}
+
+// aRow maps each output row to a row of the store, -1 for tables not in the store, NULL to read all rows in order
+static void tagStoreFillColumn(const STagStoreTable* pTable, const STagStoreCol* pCol, const int32_t* aRow,
+                               int32_t numOfRows, SColumnInfoData* pDst) {
+  if (pCol == NULL) {  // table name
+    for (int32_t i = 0; i < numOfRows; i++) {
+      int32_t     row = aRow ? aRow[i] : i;
+      const char* pName = row < 0 ? NULL : pTable->aName[row];
+      colDataAppend(pDst, i, pName, pName == NULL);
+    }
+  } else if (IS_VAR_DATA_TYPE(pCol->type)) {
+    for (int32_t i = 0; i < numOfRows; i++) {
+      int32_t row = aRow ? aRow[i] : i;
+      if (row < 0 || pCol->pNull[row]) {
+        colDataAppendNULL(pDst, i);
+      } else {
+        colDataAppend(pDst, i, taosArrayGetP(pCol->pDictVal, ((int32_t*)pCol->pData)[row]), false);
+      }
+    }
+  } else if (aRow == NULL) {
+    memcpy(pDst->pData, pCol->pData, (int64_t)pCol->itemSize * numOfRows);
+    for (int32_t i = 0; i < numOfRows; i++) {
+      if (pCol->pNull[i]) colDataAppendNULL(pDst, i);
+    }
+  } else {
+    for (int32_t i = 0; i < numOfRows; i++) {
+      int32_t row = aRow[i];
+      if (row < 0 || pCol->pNull[row]) {
+        colDataAppendNULL(pDst, i);
+      } else {
+        memcpy(pDst->pData + (int64_t)i * pCol->itemSize, pCol->pData + (int64_t)row * pCol->itemSize,
+               pCol->itemSize);
+      }
+    }
+  }
+}
+
+// fill the rows of the tables not in the store from their entries, tables dropped in the meantime keep NULL tags
+static int32_t tagStoreFillMissed(SMeta* pMeta, tb_uid_t suid, SArray* uidList, const int32_t* aRow, int32_t numOfRows,
+                                  SSDataBlock* pBlock) {
+  int32_t code = 0;
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  void*   pBuf = NULL;
+  int     nBuf = 0;
+
+  metaRLock(pMeta);
+
+  for (int32_t i = 0; i < numOfRows; i++) {
+    if (aRow[i] >= 0) continue;
+
+    SDecoder   coder = {0};
+    SMetaEntry me = {0};
+    tb_uid_t   uid = *(tb_uid_t*)taosArrayGet(uidList, i);
+    code = tagStoreGetEntry(pMeta, uid, &pBuf, &nBuf, &coder, &me);
+    if (code == TSDB_CODE_PAR_TABLE_NOT_EXIST) {
+      code = 0;
+      continue;
+    } else if (code) {
+      goto _exit;
+    }
+
+    for (int32_t j = 0; j < numOfCols && me.type == TSDB_CHILD_TABLE && me.ctbEntry.suid == suid; j++) {
+      SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, j);
+
+      if (pDst->info.colId == -1) {
+        char name[TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
+        STR_TO_VARSTR(name, me.name);
+        code = colDataAppend(pDst, i, name, false);
+      } else {
+        STagVal tagVal = {.cid = pDst->info.colId};
+        if (!tTagGet((const STag*)me.ctbEntry.pTags, &tagVal)) continue;
+
+        if (IS_VAR_DATA_TYPE(pDst->info.type)) {
+          char* pVal = taosMemoryMalloc(VARSTR_HEADER_SIZE + tagVal.nData);
+          if (pVal == NULL) {
+            code = TSDB_CODE_OUT_OF_MEMORY;
+            break;
+          }
+          STR_WITH_SIZE_TO_VARSTR(pVal, tagVal.pData, tagVal.nData);
+          code = colDataAppend(pDst, i, pVal, false);
+          taosMemoryFree(pVal);
+        } else {
+          colDataSetNotNull_f(pDst->nullbitmap, i);
+          code = colDataAppend(pDst, i, (const char*)&tagVal.i64, false);
+        }
+      }
+      if (code) break;
+    }
+
+    tDecoderClear(&coder);
+    if (code) goto _exit;
+  }
+
+_exit:
+  metaULock(pMeta);
+  tdbFree(pBuf);
+  return code;
+}
+
+int32_t metaGetTableTagColumns(SMeta* pMeta, uint64_t suid, SArray* uidList, SSDataBlock* pBlock) {
+  SMetaTagStore* pStore = pMeta->pTagStore;
+  int32_t        code = 0;
+  int32_t        numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  int32_t*       aRow = NULL;
+  STagStoreCol** aCol = NULL;
+  bool           needName = false;
+  int32_t        numOfMissed = 0;
+
+  if (!tsTagColumnarStore || pStore == NULL) return TSDB_CODE_NOT_FOUND;
+
+  for (int32_t i = 0; i < numOfCols; i++) {
+    SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, i);
+    if (pDst->info.colId == -1) needName = true;
+  }
+
+  code = metaTagStorePrepare(pMeta, suid, needName);
+  if (code) {
+    metaDebug("vgId:%d, tag store of super table %" PRId64 " is not available since %s", TD_VID(pMeta->pVnode), suid,
+              tstrerror(code));
+    return TSDB_CODE_NOT_FOUND;
+  }
+
+  taosThreadRwlockRdlock(&pStore->lock);
+
+  STagStoreTable** ppTable = taosHashGet(pStore->pTables, &suid, sizeof(suid));
+  STagStoreTable*  pTable = ppTable ? *ppTable : NULL;
+  if (pTable == NULL || !pTable->supported || (needName && !pTable->hasName)) {
+    code = TSDB_CODE_NOT_FOUND;
+    goto _exit;
+  }
+  atomic_store_64(&pTable->lastUse, atomic_add_fetch_64(&pStore->tick, 1));
+
+  // map the output columns to the store, give up if any of them does not match the current tag schema
+  aCol = taosMemoryCalloc(numOfCols, POINTER_BYTES);
+  if (aCol == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  for (int32_t i = 0; i < numOfCols; i++) {
+    SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, i);
+    if (pDst->info.colId == -1) continue;
+
+    for (int32_t j = 0; j < pTable->nCols; j++) {
+      if (pTable->aCol[j].cid == pDst->info.colId) {
+        aCol[i] = &pTable->aCol[j];
+        break;
+      }
+    }
+    if (aCol[i] == NULL || aCol[i]->type != pDst->info.type ||
+        (!IS_VAR_DATA_TYPE(aCol[i]->type) && aCol[i]->bytes != pDst->info.bytes)) {
+      code = TSDB_CODE_NOT_FOUND;
+      goto _exit;
+    }
+  }
+
+  int32_t numOfRows = taosArrayGetSize(uidList);
+  if (numOfRows == 0) {
+    numOfRows = pTable->numOfRows;
+    if (taosArrayAddBatch(uidList, pTable->aUid, numOfRows) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  } else {
+    aRow = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+    if (aRow == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    for (int32_t i = 0; i < numOfRows; i++) {
+      int32_t* pRow = taosHashGet(pTable->pUidIdx, taosArrayGet(uidList, i), sizeof(tb_uid_t));
+      aRow[i] = pRow ? *pRow : -1;
+      if (pRow == NULL) numOfMissed++;
+    }
+  }
+
+  code = blockDataEnsureCapacity(pBlock, numOfRows);
+  if (code) goto _exit;
+
+  for (int32_t i = 0; i < numOfCols; i++) {
+    tagStoreFillColumn(pTable, aCol[i], aRow, numOfRows, taosArrayGet(pBlock->pDataBlock, i));
+  }
+  pBlock->info.rows = numOfRows;
+
+_exit:
+  taosThreadRwlockUnlock(&pStore->lock);
+  if (code == 0 && numOfMissed > 0) {
+    // never give NULL tags for a table the store does not know, read it from meta as the fallback path does
+    metaDebug("vgId:%d, %d tables not in tag store of super table %" PRId64 ", read from meta", TD_VID(pMeta->pVnode),
+              numOfMissed, suid);
+    code = tagStoreFillMissed(pMeta, suid, uidList, aRow, numOfRows, pBlock);
+  }
+  taosMemoryFree(aRow);
+  taosMemoryFree(aCol);
+  return code;
+}
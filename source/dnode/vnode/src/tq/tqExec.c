@@ -15,25 +15,28 @@
 
 #include "tq.h"
 
-static int32_t tqAddBlockDataToRsp(const SSDataBlock* pBlock, SMqDataRsp* pRsp, int32_t numOfCols) {
-  int32_t dataStrLen = sizeof(SRetrieveTableRsp) + blockGetEncodeSize(pBlock);
+static int32_t tqAddBlockDataToRsp(const SSDataBlock* pBlock, SMqDataRsp* pRsp, int32_t numOfCols,
+                                   STqPollBatch* pBatch) {
+  int32_t encodeSize = pBatch->compressed ? blockGetCompressedEncodeSize(pBlock) : blockGetEncodeSize(pBlock);
+  int32_t dataStrLen = sizeof(SRetrieveTableRsp) + encodeSize;
   void*   buf = taosMemoryCalloc(1, dataStrLen);
   if (buf == NULL) return -1;
 
   SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*)buf;
   pRetrieve->useconds = 0;
   pRetrieve->precision = TSDB_DEFAULT_PRECISION;
-  pRetrieve->compressed = 0;
+  pRetrieve->compressed = pBatch->compressed ? 1 : 0;
   pRetrieve->completed = 1;
   pRetrieve->numOfRows = htonl(pBlock->info.rows);
 
-  // TODO enable compress
   int32_t actualLen = 0;
-  blockEncode(pBlock, pRetrieve->data, &actualLen, numOfCols, false);
+  blockEncode(pBlock, pRetrieve->data, &actualLen, numOfCols, pBatch->compressed ? ONE_STAGE_COMP : 0);
   actualLen += sizeof(SRetrieveTableRsp);
   ASSERT(actualLen <= dataStrLen);
   taosArrayPush(pRsp->blockDataLen, &actualLen);
   taosArrayPush(pRsp->blockData, &buf);
+
+  tqPollBatchAdd(pBatch, pBlock->info.rows, actualLen);
   return 0;
 }
 
@@ -60,7 +63,7 @@ static int32_t tqAddTbNameToRsp(const STQ* pTq, int64_t uid, SMqDataRsp* pRsp) {
   return 0;
 }
 
-int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset) {
+int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset, STqPollBatch* pBatch) {
   const STqExecHandle* pExec = &pHandle->execHandle;
   ASSERT(pExec->subType == TOPIC_SUB_TYPE__COLUMN);
 
@@ -81,7 +84,8 @@ int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffs
     }
   }
 
-  int32_t rowCnt = 0;
+  int64_t lastVer = pOffset->version;
+  int32_t idleCnt = 0;
   while (1) {
     SSDataBlock* pDataBlock = NULL;
     uint64_t     ts = 0;
@@ -92,15 +96,38 @@ int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffs
     tqDebug("tmq task executed, get %p", pDataBlock);
 
     if (pDataBlock == NULL) {
-      break;
+      // the log scan stops at the end of each submit msg, go on with the following ones until the batch is full.
+      // One empty round is allowed since the root operator reports its completion once before being reopened.
+      if (pOffset->type != TMQ_OFFSET__LOG || tqPollBatchIsFull(pBatch)) {
+        break;
+      }
+
+      STqOffsetVal offset = {0};
+      if (qStreamExtractOffset(task, &offset) < 0 || offset.type != TMQ_OFFSET__LOG) {
+        break;
+      }
+      if (offset.version > lastVer) {
+        lastVer = offset.version;
+        idleCnt = 0;
+      } else if (++idleCnt > 1) {
+        break;
+      }
+      continue;
     }
 
-    tqAddBlockDataToRsp(pDataBlock, pRsp, pExec->numOfCols);
+    idleCnt = 0;
+    if (tqAddBlockDataToRsp(pDataBlock, pRsp, pExec->numOfCols, pBatch) < 0) {
+      break;
+    }
     pRsp->blockNum++;
 
-    if (pOffset->type == TMQ_OFFSET__SNAPSHOT_DATA) {
-      rowCnt += pDataBlock->info.rows;
-      if (rowCnt >= 4096) break;
+    if (pRsp->withTbName && pOffset->type == TMQ_OFFSET__LOG) {
+      int64_t uid = pExec->pExecReader->msgIter.uid;
+      tqAddTbNameToRsp(pTq, uid, pRsp);
+    }
+
+    if (pOffset->type == TMQ_OFFSET__SNAPSHOT_DATA && tqPollBatchIsFull(pBatch)) {
+      break;
     }
   }
 
@@ -110,20 +137,18 @@ int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffs
   }
   ASSERT(pRsp->rspOffset.type != 0);
 
-  if (pRsp->withTbName) {
-    if (pRsp->rspOffset.type == TMQ_OFFSET__LOG) {
-      int64_t uid = pExec->pExecReader->msgIter.uid;
-      tqAddTbNameToRsp(pTq, uid, pRsp);
-    } else {
-      pRsp->withTbName = false;
-    }
+  // a table name is required for each block
+  if (pRsp->withTbName && taosArrayGetSize(pRsp->blockTbName) != pRsp->blockNum) {
+    taosArrayClearP(pRsp->blockTbName, (FDelete)taosMemoryFree);
+    pRsp->withTbName = false;
   }
   ASSERT(pRsp->withSchema == false);
 
   return 0;
 }
 
-int32_t tqScan(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp* pMetaRsp, STqOffsetVal* pOffset) {
+int32_t tqScan(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp* pMetaRsp, STqOffsetVal* pOffset,
+               STqPollBatch* pBatch) {
   const STqExecHandle* pExec = &pHandle->execHandle;
   qTaskInfo_t          task = pExec->task;
 
@@ -142,7 +167,6 @@ int32_t tqScan(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp*
     }
   }
 
-  int32_t rowCnt = 0;
   while (1) {
     SSDataBlock* pDataBlock = NULL;
     uint64_t     ts = 0;
@@ -174,13 +198,10 @@ int32_t tqScan(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp*
         }
       }
 
-      tqAddBlockDataToRsp(pDataBlock, (SMqDataRsp*)pRsp, taosArrayGetSize(pDataBlock->pDataBlock));
+      tqAddBlockDataToRsp(pDataBlock, (SMqDataRsp*)pRsp, taosArrayGetSize(pDataBlock->pDataBlock), pBatch);
       pRsp->blockNum++;
-      if (pOffset->type == TMQ_OFFSET__LOG) {
+      if (pOffset->type == TMQ_OFFSET__LOG || !tqPollBatchIsFull(pBatch)) {
         continue;
-      } else {
-        rowCnt += pDataBlock->info.rows;
-        if (rowCnt <= 4096) continue;
       }
     }
 
@@ -222,7 +243,7 @@ int32_t tqScan(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp*
   return 0;
 }
 
-int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp) {
+int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp, STqPollBatch* pBatch) {
   STqExecHandle* pExec = &pHandle->execHandle;
   ASSERT(pExec->subType != TOPIC_SUB_TYPE__COLUMN);
 
@@ -255,7 +276,7 @@ int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp
           pRsp->createTableNum++;
         }
       }
-      tqAddBlockDataToRsp(&block, (SMqDataRsp*)pRsp, taosArrayGetSize(block.pDataBlock));
+      tqAddBlockDataToRsp(&block, (SMqDataRsp*)pRsp, taosArrayGetSize(block.pDataBlock), pBatch);
       blockDataFreeRes(&block);
       tqAddBlockSchemaToRsp(pExec, (SMqDataRsp*)pRsp);
       pRsp->blockNum++;
@@ -289,7 +310,7 @@ int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp
           pRsp->createTableNum++;
         }
       }
-      tqAddBlockDataToRsp(&block, (SMqDataRsp*)pRsp, taosArrayGetSize(block.pDataBlock));
+      tqAddBlockDataToRsp(&block, (SMqDataRsp*)pRsp, taosArrayGetSize(block.pDataBlock), pBatch);
       blockDataFreeRes(&block);
       tqAddBlockSchemaToRsp(pExec, (SMqDataRsp*)pRsp);
       pRsp->blockNum++;
@@ -1338,3 +1338,47 @@ void tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity) {
 size_t tsdbCacheGetCapacity(SVnode *pVnode) { return taosLRUCacheGetCapacity(pVnode->pTsdb->lruCache); }
 
 size_t tsdbCacheGetUsage(SVnode *pVnode) { return taosLRUCacheGetUsage(pVnode->pTsdb->lruCache); }
+
+// page cache ====================================================
+int32_t tsdbOpenPgCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = NULL;
+  size_t     cfgCapacity = (size_t)tsTsdbPageCacheSize * 1024 * 1024;
+
+  if (cfgCapacity == 0) goto _err;
+
+  pCache = taosLRUCacheInit(cfgCapacity, -1, .5);
+  if (pCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, true);
+
+_err:
+  pTsdb->pgCache = pCache;
+  return code;
+}
+
+void tsdbClosePgCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->pgCache;
+  if (pCache) {
+    tsdbDebug("vgId:%d, tsdb page cache closed, hit:%" PRId64 " miss:%" PRId64 " usage:%" PRIu64,
+              TD_VID(pTsdb->pVnode), pTsdb->pgCacheHit, pTsdb->pgCacheMiss,
+              (uint64_t)taosLRUCacheGetUsage(pCache));
+
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    pTsdb->pgCache = NULL;
+  }
+}
+
+void tsdbPgCacheGetStat(SVnode *pVnode, int64_t *nHit, int64_t *nMiss, size_t *usage) {
+  STsdb *pTsdb = pVnode->pTsdb;
+
+  *nHit = atomic_load_64(&pTsdb->pgCacheHit);
+  *nMiss = atomic_load_64(&pTsdb->pgCacheMiss);
+  *usage = pTsdb->pgCache ? taosLRUCacheGetUsage(pTsdb->pgCache) : 0;
+}
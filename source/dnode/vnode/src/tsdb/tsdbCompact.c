@@ -15,13 +15,1077 @@
 
 #include "tsdb.h"
 
+typedef enum { COMPACT_DATA_ITER = 0, COMPACT_STT_ITER } ECompactIterT;
+
+// Each iterator keeps two block buffers and loads them in turn, so the row it returned last stays valid after
+// one more step. That is all the row merging below needs.
+typedef struct {
+  SRBTreeNode   n;
+  SRowInfo      r;
+  ECompactIterT type;
+  SBlockData    aBData[2];
+  int8_t        iBData;
+  int32_t       iRow;
+  union {
+    struct {
+      int32_t   iBlockIdx;
+      SMapData  mDataBlk;  // SMapData<SDataBlk>
+      int32_t   iDataBlk;
+      STSchema *pTSchema;
+    };  // data file iter
+    struct {
+      int32_t iStt;
+      SArray *aSttBlk;  // SArray<SSttBlk>
+      int32_t iSttBlk;
+    };  // stt file iter
+  };
+} SCompactIter;
+
 typedef struct {
   STsdb  *pTsdb;
   STsdbFS fs;
+  int64_t commitID;
+  int32_t minRow;
+  int32_t maxRow;
+  int8_t  cmprAlg;
+  // reader
+  SDataFReader *pReader;
+  SArray       *aBlockIdx;  // SArray<SBlockIdx>
+  SCompactIter  dataIter;
+  SCompactIter  aSttIter[TSDB_MAX_STT_FILE];
+  SRBTree       rbt;
+  SCompactIter *pIter;
+  // del
+  SDelFReader *pDelFReader;
+  SArray      *aDelIdx;   // SArray<SDelIdx>
+  SArray      *aDelData;  // SArray<SDelData>
+  SArray      *aSkyline;  // SArray<TSDBKEY>
+  int32_t      iSkyline;
+  // writer
+  SDataFWriter *pWriter;
+  SArray       *aBlockIdxW;  // SArray<SBlockIdx>
+  SArray       *aSttBlkW;    // SArray<SSttBlk>
+  SMapData      mDataBlkW;   // SMapData<SDataBlk>
+  SBlockData    bData;
+  SBlockData    bDatal;
+  // table schema
+  int64_t   suid;
+  int64_t   uid;
+  STSchema *pTSchema;
+  // io throttle
+  int64_t startTs;
+  int64_t nByteRead;
+  int8_t  yield;  // the set was given up for a waiting commit or a closing vnode
+  // stat
+  int64_t nRowRead;
+  int64_t nRowWrite;
+  int64_t nRowDrop;
 } STsdbCompactor;
 
-int32_t tsdbCompact(STsdb *pTsdb) {
+static int32_t tsdbCompactIterCmprFn(const void *p1, const void *p2) {
+  SRowInfo *pInfo1 = (SRowInfo *)p1;
+  SRowInfo *pInfo2 = (SRowInfo *)p2;
+
+  if (pInfo1->suid < pInfo2->suid) {
+    return -1;
+  } else if (pInfo1->suid > pInfo2->suid) {
+    return 1;
+  }
+
+  if (pInfo1->uid < pInfo2->uid) {
+    return -1;
+  } else if (pInfo1->uid > pInfo2->uid) {
+    return 1;
+  }
+
+  int32_t c = tsdbRowCmprFn(&pInfo1->row, &pInfo2->row);
+  if (c) return c;
+
+  // the same row may exist in more than one file, keep both iterators in the tree
+  SCompactIter *pIter1 = (SCompactIter *)((SRBTreeNode *)p1 - 1);
+  SCompactIter *pIter2 = (SCompactIter *)((SRBTreeNode *)p2 - 1);
+  if (pIter1 < pIter2) {
+    return -1;
+  } else if (pIter1 > pIter2) {
+    return 1;
+  }
+  return 0;
+}
+
+static int32_t tsdbFSetNonEmptyStt(SDFileSet *pSet) {
+  int32_t nStt = 0;
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    if (pSet->aSttF[iStt]->size > pSet->aSttF[iStt]->offset) nStt++;
+  }
+  return nStt;
+}
+
+static int64_t tsdbFSetSttSize(SDFileSet *pSet) {
+  int64_t size = 0;
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    size += pSet->aSttF[iStt]->size;
+  }
+  return size;
+}
+
+static int64_t tsdbFSetSize(SDFileSet *pSet) {
+  return pSet->pHeadF->size + pSet->pDataF->size + pSet->pSmaF->size + tsdbFSetSttSize(pSet);
+}
+
+bool tsdbShouldCompactFSet(SDFileSet *pSet, int64_t commitID, int8_t all) {
+  // a set holding any file of the compaction's commit ID was written by that commit or compacted already, the new
+  // files would collide with it
+  if (pSet->pHeadF->commitID == commitID || pSet->pDataF->commitID == commitID || pSet->pSmaF->commitID == commitID) {
+    return false;
+  }
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    if (pSet->aSttF[iStt]->commitID == commitID) return false;
+  }
+
+  int32_t nStt = tsdbFSetNonEmptyStt(pSet);
+  if (nStt >= tsCompactSttTrigger) return true;
+  if (nStt > 0 && tsdbFSetSttSize(pSet) >= (int64_t)tsCompactSttSizeMB * 1024 * 1024) return true;
+
+  // a single stt file costs readers little, rewriting the whole set for it is not worth the io
+  if (all && nStt > 1) return true;
+
+  return false;
+}
+
+// ================================================================================
+// sleep while the set is read faster than compactIoRateMB, the disk is shared with commits and queries
+static void tsdbCompactThrottle(STsdbCompactor *pCompactor, int64_t nByte) {
+  int64_t rate = (int64_t)tsCompactIoRateMB * 1024 * 1024;
+
+  pCompactor->nByteRead += nByte;
+
+  int64_t elapsed = taosGetTimestampMs() - pCompactor->startTs;
+  int64_t expected = pCompactor->nByteRead * 1000 / rate;
+  if (expected > elapsed) {
+    taosMsleep(expected - elapsed);
+  }
+}
+
+static bool tsdbCompactShouldYield(STsdbCompactor *pCompactor) {
+  SVnode *pVnode = pCompactor->pTsdb->pVnode;
+  return atomic_load_32(&pVnode->commitWaiting) > 0 || atomic_load_8(&pVnode->compactStop);
+}
+
+static int32_t tsdbCompactIterLoadBlock(STsdbCompactor *pCompactor, SCompactIter *pIter) {
+  int32_t code = 0;
+
+  pIter->iBData = (pIter->iBData + 1) % 2;
+  SBlockData *pBData = &pIter->aBData[pIter->iBData];
+
+  if (pIter->type == COMPACT_DATA_ITER) {
+    SBlockIdx *pBlockIdx = (SBlockIdx *)taosArrayGet(pCompactor->aBlockIdx, pIter->iBlockIdx);
+    SDataBlk   dataBlk;
+
+    tMapDataGetItemByIdx(&pIter->mDataBlk, pIter->iDataBlk, &dataBlk, tGetDataBlk);
+
+    code = tBlockDataInit(pBData, pBlockIdx->suid, pBlockIdx->uid, pIter->pTSchema);
+    if (code) goto _exit;
+
+    code = tsdbReadDataBlock(pCompactor->pReader, &dataBlk, pBData);
+    if (code) goto _exit;
+
+    int64_t nByte = 0;
+    for (int32_t iSubBlock = 0; iSubBlock < dataBlk.nSubBlock; iSubBlock++) {
+      nByte += dataBlk.aSubBlock[iSubBlock].szBlock;
+    }
+    tsdbCompactThrottle(pCompactor, nByte);
+  } else {
+    SSttBlk *pSttBlk = (SSttBlk *)taosArrayGet(pIter->aSttBlk, pIter->iSttBlk);
+
+    code = tsdbReadSttBlock(pCompactor->pReader, pIter->iStt, pSttBlk, pBData);
+    if (code) goto _exit;
+
+    tsdbCompactThrottle(pCompactor, pSttBlk->bInfo.szBlock);
+  }
+
+  pIter->iRow = 0;
+  pIter->r.suid = pBData->suid;
+  pIter->r.uid = pBData->uid ? pBData->uid : pBData->aUid[0];
+  pIter->r.row = tsdbRowFromBlockData(pBData, 0);
+
+_exit:
+  return code;
+}
+
+// move the data file iterator to the next table still in meta, return 0 with iBlockIdx past the end if none
+static int32_t tsdbCompactIterNextTable(STsdbCompactor *pCompactor, SCompactIter *pIter) {
   int32_t code = 0;
-  // TODO
+  SMeta  *pMeta = pCompactor->pTsdb->pVnode->pMeta;
+
+  for (pIter->iBlockIdx++; pIter->iBlockIdx < taosArrayGetSize(pCompactor->aBlockIdx); pIter->iBlockIdx++) {
+    SBlockIdx *pBlockIdx = (SBlockIdx *)taosArrayGet(pCompactor->aBlockIdx, pIter->iBlockIdx);
+    SMetaInfo  info;
+
+    // data of a dropped table is never read again, leave it behind
+    if (metaGetInfo(pMeta, pBlockIdx->uid, &info) < 0) continue;
+
+    tTSchemaDestroy(pIter->pTSchema);
+    pIter->pTSchema = NULL;
+    code = metaGetTbTSchemaEx(pMeta, pBlockIdx->suid, pBlockIdx->uid, -1, &pIter->pTSchema);
+    if (code) goto _exit;
+
+    code = tsdbReadBlock(pCompactor->pReader, pBlockIdx, &pIter->mDataBlk);
+    if (code) goto _exit;
+
+    if (pIter->mDataBlk.nItem > 0) break;
+  }
+
+_exit:
+  return code;
+}
+
+static int32_t tsdbCompactIterNext(STsdbCompactor *pCompactor, SCompactIter *pIter, bool *hasRow) {
+  int32_t     code = 0;
+  SBlockData *pBData = &pIter->aBData[pIter->iBData];
+
+  *hasRow = true;
+
+  pIter->iRow++;
+  if (pIter->iRow < pBData->nRow) {
+    pIter->r.uid = pBData->uid ? pBData->uid : pBData->aUid[pIter->iRow];
+    pIter->r.row = tsdbRowFromBlockData(pBData, pIter->iRow);
+    goto _exit;
+  }
+
+  if (pIter->type == COMPACT_DATA_ITER) {
+    pIter->iDataBlk++;
+    if (pIter->iDataBlk >= pIter->mDataBlk.nItem) {
+      code = tsdbCompactIterNextTable(pCompactor, pIter);
+      if (code) goto _exit;
+
+      if (pIter->iBlockIdx >= taosArrayGetSize(pCompactor->aBlockIdx)) {
+        *hasRow = false;
+        goto _exit;
+      }
+      pIter->iDataBlk = 0;
+    }
+  } else {
+    pIter->iSttBlk++;
+    if (pIter->iSttBlk >= taosArrayGetSize(pIter->aSttBlk)) {
+      *hasRow = false;
+      goto _exit;
+    }
+  }
+
+  code = tsdbCompactIterLoadBlock(pCompactor, pIter);
+  if (code) goto _exit;
+
+_exit:
+  return code;
+}
+
+static FORCE_INLINE SRowInfo *tsdbCompactGetRow(STsdbCompactor *pCompactor) {
+  return (pCompactor->pIter) ? &pCompactor->pIter->r : NULL;
+}
+
+static int32_t tsdbCompactNextRow(STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+
+  if (pCompactor->pIter) {
+    bool hasRow;
+
+    code = tsdbCompactIterNext(pCompactor, pCompactor->pIter, &hasRow);
+    if (code) goto _exit;
+
+    if (hasRow) {
+      SCompactIter *pIter = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+      if (pIter && tsdbCompactIterCmprFn(&pCompactor->pIter->r, &pIter->r) > 0) {
+        tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pCompactor->pIter);
+        pCompactor->pIter = NULL;
+      }
+    } else {
+      pCompactor->pIter = NULL;
+    }
+  }
+
+  if (pCompactor->pIter == NULL) {
+    pCompactor->pIter = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+    if (pCompactor->pIter) {
+      tRBTreeDrop(&pCompactor->rbt, (SRBTreeNode *)pCompactor->pIter);
+    }
+  }
+
+  if (pCompactor->pIter) pCompactor->nRowRead++;
+
+_exit:
+  return code;
+}
+
+static int32_t tsdbCompactOpenIter(STsdbCompactor *pCompactor) {
+  int32_t       code = 0;
+  SDataFReader *pReader = pCompactor->pReader;
+  SCompactIter *pIter;
+
+  pCompactor->pIter = NULL;
+  tRBTreeCreate(&pCompactor->rbt, tsdbCompactIterCmprFn);
+
+  // data file
+  code = tsdbReadBlockIdx(pReader, pCompactor->aBlockIdx);
+  if (code) goto _exit;
+
+  pIter = &pCompactor->dataIter;
+  pIter->type = COMPACT_DATA_ITER;
+  pIter->iBlockIdx = -1;
+  code = tsdbCompactIterNextTable(pCompactor, pIter);
+  if (code) goto _exit;
+
+  if (pIter->iBlockIdx < taosArrayGetSize(pCompactor->aBlockIdx)) {
+    pIter->iDataBlk = 0;
+    code = tsdbCompactIterLoadBlock(pCompactor, pIter);
+    if (code) goto _exit;
+
+    tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pIter);
+  }
+
+  // stt files
+  for (int32_t iStt = 0; iStt < pReader->pSet->nSttF; iStt++) {
+    pIter = &pCompactor->aSttIter[iStt];
+    pIter->type = COMPACT_STT_ITER;
+    pIter->iStt = iStt;
+
+    code = tsdbReadSttBlk(pReader, iStt, pIter->aSttBlk);
+    if (code) goto _exit;
+
+    if (taosArrayGetSize(pIter->aSttBlk) == 0) continue;
+
+    pIter->iSttBlk = 0;
+    code = tsdbCompactIterLoadBlock(pCompactor, pIter);
+    if (code) goto _exit;
+
+    tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pIter);
+  }
+
+  code = tsdbCompactNextRow(pCompactor);
+  if (code) goto _exit;
+
+_exit:
+  return code;
+}
+
+// ================================================================================
+static int32_t tsdbCompactUpdateTable(STsdbCompactor *pCompactor, TABLEID id, bool *dropped) {
+  int32_t   code = 0;
+  SMeta    *pMeta = pCompactor->pTsdb->pVnode->pMeta;
+  SMetaInfo info;
+
+  *dropped = (metaGetInfo(pMeta, id.uid, &info) < 0);
+  if (*dropped) goto _exit;
+
+  // schema
+  if (pCompactor->pTSchema == NULL || pCompactor->suid != id.suid || (id.suid == 0 && pCompactor->uid != id.uid)) {
+    tTSchemaDestroy(pCompactor->pTSchema);
+    pCompactor->pTSchema = NULL;
+    code = metaGetTbTSchemaEx(pMeta, id.suid, id.uid, -1, &pCompactor->pTSchema);
+    if (code) goto _exit;
+  }
+  pCompactor->suid = id.suid;
+  pCompactor->uid = id.uid;
+
+  // del skyline
+  taosArrayClear(pCompactor->aSkyline);
+  pCompactor->iSkyline = 0;
+  if (pCompactor->pDelFReader) {
+    SDelIdx  delIdx = {.suid = id.suid, .uid = id.uid};
+    SDelIdx *pDelIdx = (SDelIdx *)taosArraySearch(pCompactor->aDelIdx, &delIdx, tCmprDelIdx, TD_EQ);
+
+    if (pDelIdx) {
+      code = tsdbReadDelData(pCompactor->pDelFReader, pDelIdx, pCompactor->aDelData);
+      if (code) goto _exit;
+
+      if (taosArrayGetSize(pCompactor->aDelData) > 0) {
+        code = tsdbBuildDeleteSkyline(pCompactor->aDelData, 0, taosArrayGetSize(pCompactor->aDelData) - 1,
+                                      pCompactor->aSkyline);
+        if (code) goto _exit;
+      }
+    }
+  }
+
+_exit:
+  return code;
+}
+
+// rows of one table arrive in ascending key order, so the skyline cursor only moves forward
+static bool tsdbCompactRowIsDeleted(STsdbCompactor *pCompactor, TSDBKEY *pKey) {
+  SArray *aSkyline = pCompactor->aSkyline;
+  int32_t nSkyline = taosArrayGetSize(aSkyline);
+
+  while (pCompactor->iSkyline + 1 < nSkyline &&
+         ((TSDBKEY *)taosArrayGet(aSkyline, pCompactor->iSkyline + 1))->ts < pKey->ts) {
+    pCompactor->iSkyline++;
+  }
+
+  if (pCompactor->iSkyline + 1 >= nSkyline) return false;
+
+  TSDBKEY *pCurrent = (TSDBKEY *)taosArrayGet(aSkyline, pCompactor->iSkyline);
+  TSDBKEY *pNext = (TSDBKEY *)taosArrayGet(aSkyline, pCompactor->iSkyline + 1);
+
+  if (pKey->ts < pCurrent->ts) return false;
+  if (pCurrent->version >= pKey->version) return true;
+  if (pKey->ts == pNext->ts && pCompactor->iSkyline + 2 < nSkyline && pNext->version >= pKey->version) return true;
+
+  return false;
+}
+
+static int32_t tsdbCompactWriteDataBlock(STsdbCompactor *pCompactor) {
+  int32_t     code = 0;
+  SBlockData *pBlockData = &pCompactor->bData;
+  SDataBlk    dataBlk;
+
+  ASSERT(pBlockData->nRow > 0);
+
+  tDataBlkReset(&dataBlk);
+  dataBlk.nRow = pBlockData->nRow;
+  dataBlk.minKey = tBlockDataFirstKey(pBlockData);
+  dataBlk.maxKey = tBlockDataLastKey(pBlockData);
+  for (int32_t iRow = 0; iRow < pBlockData->nRow; iRow++) {
+    dataBlk.minVer = TMIN(dataBlk.minVer, pBlockData->aVersion[iRow]);
+    dataBlk.maxVer = TMAX(dataBlk.maxVer, pBlockData->aVersion[iRow]);
+  }
+
+  dataBlk.nSubBlock++;
+  code = tsdbWriteBlockData(pCompactor->pWriter, pBlockData, &dataBlk.aSubBlock[0], &dataBlk.smaInfo,
+                            pCompactor->cmprAlg, 0);
+  if (code) goto _exit;
+
+  code = tMapDataPutItem(&pCompactor->mDataBlkW, &dataBlk, tPutDataBlk);
+  if (code) goto _exit;
+
+  pCompactor->nRowWrite += pBlockData->nRow;
+  tBlockDataClear(pBlockData);
+
+_exit:
+  return code;
+}
+
+static int32_t tsdbCompactWriteSttBlock(STsdbCompactor *pCompactor) {
+  int32_t     code = 0;
+  SBlockData *pBlockData = &pCompactor->bDatal;
+  SSttBlk     sttBlk;
+
+  ASSERT(pBlockData->nRow > 0);
+
+  sttBlk.suid = pBlockData->suid;
+  sttBlk.nRow = pBlockData->nRow;
+  sttBlk.minKey = TSKEY_MAX;
+  sttBlk.maxKey = TSKEY_MIN;
+  sttBlk.minVer = VERSION_MAX;
+  sttBlk.maxVer = VERSION_MIN;
+  for (int32_t iRow = 0; iRow < pBlockData->nRow; iRow++) {
+    sttBlk.minKey = TMIN(sttBlk.minKey, pBlockData->aTSKEY[iRow]);
+    sttBlk.maxKey = TMAX(sttBlk.maxKey, pBlockData->aTSKEY[iRow]);
+    sttBlk.minVer = TMIN(sttBlk.minVer, pBlockData->aVersion[iRow]);
+    sttBlk.maxVer = TMAX(sttBlk.maxVer, pBlockData->aVersion[iRow]);
+  }
+  sttBlk.minUid = pBlockData->uid ? pBlockData->uid : pBlockData->aUid[0];
+  sttBlk.maxUid = pBlockData->uid ? pBlockData->uid : pBlockData->aUid[pBlockData->nRow - 1];
+
+  code = tsdbWriteBlockData(pCompactor->pWriter, pBlockData, &sttBlk.bInfo, NULL, pCompactor->cmprAlg, 1);
+  if (code) goto _exit;
+
+  if (taosArrayPush(pCompactor->aSttBlkW, &sttBlk) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  pCompactor->nRowWrite += pBlockData->nRow;
+  tBlockDataClear(pBlockData);
+
+_exit:
+  return code;
+}
+
+// a table with less than minRow rows left goes to the stt file, shared with the tables around it
+static int32_t tsdbCompactAppendSttBlock(STsdbCompactor *pCompactor, TABLEID id) {
+  int32_t     code = 0;
+  SBlockData *pBData = &pCompactor->bData;
+  SBlockData *pBDatal = &pCompactor->bDatal;
+
+  if (pBDatal->suid || pBDatal->uid) {
+    if (pBDatal->suid != id.suid || id.suid == 0) {
+      if (pBDatal->nRow) {
+        code = tsdbCompactWriteSttBlock(pCompactor);
+        if (code) goto _exit;
+      }
+      tBlockDataReset(pBDatal);
+    }
+  }
+
+  if (!pBDatal->suid && !pBDatal->uid) {
+    code = tBlockDataInit(pBDatal, id.suid, id.suid ? 0 : id.uid, pCompactor->pTSchema);
+    if (code) goto _exit;
+  }
+
+  for (int32_t iRow = 0; iRow < pBData->nRow; iRow++) {
+    TSDBROW row = tsdbRowFromBlockData(pBData, iRow);
+    code = tBlockDataAppendRow(pBDatal, &row, NULL, id.uid);
+    if (code) goto _exit;
+
+    if (pBDatal->nRow >= pCompactor->maxRow) {
+      code = tsdbCompactWriteSttBlock(pCompactor);
+      if (code) goto _exit;
+    }
+  }
+  tBlockDataClear(pBData);
+
+_exit:
+  return code;
+}
+
+static int32_t tsdbCompactAppendRow(STsdbCompactor *pCompactor, TSDBROW *pRow, STSchema *pTSchema, int64_t uid) {
+  int32_t code = 0;
+
+  code = tBlockDataAppendRow(&pCompactor->bData, pRow, pTSchema, uid);
+  if (code) goto _exit;
+
+  if (pCompactor->bData.nRow >= pCompactor->maxRow) {
+    code = tsdbCompactWriteDataBlock(pCompactor);
+    if (code) goto _exit;
+  }
+
+_exit:
+  return code;
+}
+
+static FORCE_INLINE bool tsdbCompactSameKey(SRowInfo *pRowInfo, TABLEID id, TSKEY ts) {
+  return pRowInfo && pRowInfo->suid == id.suid && pRowInfo->uid == id.uid && TSDBROW_TS(&pRowInfo->row) == ts;
+}
+
+// merge all versions of one timestamp into a single row the way a reader would see it
+static int32_t tsdbCompactMergeRow(STsdbCompactor *pCompactor, TABLEID id, TSDBROW *pFirst) {
+  int32_t    code = 0;
+  TSKEY      ts = TSDBROW_TS(pFirst);
+  STSRow    *pTSRow = NULL;
+  int64_t    version = 0;
+  SRowMerger merger = {0};
+  SRowInfo  *pRowInfo;
+
+  // pFirst is still valid here since its iterator moved at most one step since
+  if (!tsdbCompactRowIsDeleted(pCompactor, &TSDBROW_KEY(pFirst))) {
+    code = tRowMergerInit(&merger, pFirst, pCompactor->pTSchema);
+    if (code) goto _exit;
+    code = tRowMergerGetRow(&merger, &pTSRow);
+    if (code) goto _exit;
+    tRowMergerClear(&merger);
+    merger.pArray = NULL;
+    version = TSDBROW_VERSION(pFirst);
+  } else {
+    pCompactor->nRowDrop++;
+  }
+
+  while (tsdbCompactSameKey((pRowInfo = tsdbCompactGetRow(pCompactor)), id, ts)) {
+    TSDBKEY key = TSDBROW_KEY(&pRowInfo->row);
+
+    if (pTSRow && key.version == version) {
+      // the same version in two files, keep the one already merged
+      pCompactor->nRowDrop++;
+    } else if (!tsdbCompactRowIsDeleted(pCompactor, &key)) {
+      STSRow *pTSRowNew = NULL;
+
+      if (pTSRow) {
+        code = tRowMergerInit(&merger, &tsdbRowFromTSRow(version, pTSRow), pCompactor->pTSchema);
+        if (code) goto _exit;
+        code = tRowMerge(&merger, &pRowInfo->row);
+        if (code) goto _exit;
+      } else {
+        code = tRowMergerInit(&merger, &pRowInfo->row, pCompactor->pTSchema);
+        if (code) goto _exit;
+      }
+
+      // materialize before moving on, the merger may point into the block of the current iterator
+      code = tRowMergerGetRow(&merger, &pTSRowNew);
+      if (code) goto _exit;
+      tRowMergerClear(&merger);
+      merger.pArray = NULL;
+
+      taosMemoryFree(pTSRow);
+      pTSRow = pTSRowNew;
+      version = key.version;
+    } else {
+      pCompactor->nRowDrop++;
+    }
+
+    code = tsdbCompactNextRow(pCompactor);
+    if (code) goto _exit;
+  }
+
+  if (pTSRow) {
+    code = tsdbCompactAppendRow(pCompactor, &tsdbRowFromTSRow(version, pTSRow), pCompactor->pTSchema, id.uid);
+    if (code) goto _exit;
+  }
+
+_exit:
+  if (merger.pArray) tRowMergerClear(&merger);
+  taosMemoryFree(pTSRow);
+  return code;
+}
+
+static int32_t tsdbCompactTableData(STsdbCompactor *pCompactor, TABLEID id) {
+  int32_t   code = 0;
+  SRowInfo *pRowInfo;
+  bool      dropped;
+
+  code = tsdbCompactUpdateTable(pCompactor, id, &dropped);
+  if (code) goto _exit;
+
+  if (dropped) {
+    while ((pRowInfo = tsdbCompactGetRow(pCompactor)) && pRowInfo->suid == id.suid && pRowInfo->uid == id.uid) {
+      pCompactor->nRowDrop++;
+      code = tsdbCompactNextRow(pCompactor);
+      if (code) goto _exit;
+    }
+    goto _exit;
+  }
+
+  tMapDataReset(&pCompactor->mDataBlkW);
+  code = tBlockDataInit(&pCompactor->bData, id.suid, id.uid, pCompactor->pTSchema);
+  if (code) goto _exit;
+
+  while ((pRowInfo = tsdbCompactGetRow(pCompactor)) && pRowInfo->suid == id.suid && pRowInfo->uid == id.uid) {
+    TSDBROW row = pRowInfo->row;
+    TSKEY   ts = TSDBROW_TS(&row);
+
+    code = tsdbCompactNextRow(pCompactor);
+    if (code) goto _exit;
+
+    if (tsdbCompactSameKey(tsdbCompactGetRow(pCompactor), id, ts)) {
+      code = tsdbCompactMergeRow(pCompactor, id, &row);
+      if (code) goto _exit;
+    } else if (tsdbCompactRowIsDeleted(pCompactor, &TSDBROW_KEY(&row))) {
+      pCompactor->nRowDrop++;
+    } else {
+      code = tsdbCompactAppendRow(pCompactor, &row, NULL, id.uid);
+      if (code) goto _exit;
+    }
+  }
+
+  if (pCompactor->bData.nRow > 0) {
+    if (pCompactor->bData.nRow >= pCompactor->minRow) {
+      code = tsdbCompactWriteDataBlock(pCompactor);
+      if (code) goto _exit;
+    } else {
+      code = tsdbCompactAppendSttBlock(pCompactor, id);
+      if (code) goto _exit;
+    }
+  }
+
+  if (pCompactor->mDataBlkW.nItem > 0) {
+    SBlockIdx blockIdx = {.suid = id.suid, .uid = id.uid};
+
+    code = tsdbWriteBlock(pCompactor->pWriter, &pCompactor->mDataBlkW, &blockIdx);
+    if (code) goto _exit;
+
+    if (taosArrayPush(pCompactor->aBlockIdxW, &blockIdx) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+
+_exit:
+  return code;
+}
+
+// close the writer and remove the files it created, none of them is in any fs yet
+static int32_t tsdbCompactDiscardWriter(STsdbCompactor *pCompactor) {
+  int32_t       code = 0;
+  STsdb        *pTsdb = pCompactor->pTsdb;
+  SDataFWriter *pWriter = pCompactor->pWriter;
+  char          aFName[4][TSDB_FILENAME_LEN];
+
+  if (pWriter == NULL) return code;
+
+  SDFileSet *wSet = &pWriter->wSet;
+  tsdbHeadFileName(pTsdb, wSet->diskId, wSet->fid, wSet->pHeadF, aFName[0]);
+  tsdbDataFileName(pTsdb, wSet->diskId, wSet->fid, wSet->pDataF, aFName[1]);
+  tsdbSmaFileName(pTsdb, wSet->diskId, wSet->fid, wSet->pSmaF, aFName[2]);
+  tsdbSttFileName(pTsdb, wSet->diskId, wSet->fid, wSet->aSttF[0], aFName[3]);
+
+  code = tsdbDataFWriterClose(&pCompactor->pWriter, 0);
+
+  for (int32_t iFile = 0; iFile < 4; iFile++) {
+    taosRemoveFile(aFName[iFile]);
+  }
+  return code;
+}
+
+// remove the files the writer created and take pSet out of the new fs, the old files go with the fs commit
+static int32_t tsdbCompactDropFileSet(STsdbCompactor *pCompactor, SDFileSet *pSet) {
+  int32_t code = 0;
+
+  code = tsdbCompactDiscardWriter(pCompactor);
+  if (code) goto _exit;
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pCompactor->fs.aDFileSet); iSet++) {
+    SDFileSet *pSetNew = (SDFileSet *)taosArrayGet(pCompactor->fs.aDFileSet, iSet);
+    if (pSetNew->fid != pSet->fid) continue;
+
+    taosMemoryFree(pSetNew->pHeadF);
+    taosMemoryFree(pSetNew->pDataF);
+    taosMemoryFree(pSetNew->pSmaF);
+    for (int32_t iStt = 0; iStt < pSetNew->nSttF; iStt++) {
+      taosMemoryFree(pSetNew->aSttF[iStt]);
+    }
+    taosArrayRemove(pCompactor->fs.aDFileSet, iSet);
+    break;
+  }
+
+  code = tsdbDataFReaderClose(&pCompactor->pReader);
+  if (code) goto _exit;
+
+_exit:
+  return code;
+}
+
+static int32_t tsdbCompactFileSet(STsdbCompactor *pCompactor, SDFileSet *pSet) {
+  int32_t code = 0;
+  STsdb  *pTsdb = pCompactor->pTsdb;
+
+  pCompactor->startTs = taosGetTimestampMs();
+  pCompactor->nByteRead = 0;
+  pCompactor->yield = 0;
+  pCompactor->nRowRead = 0;
+  pCompactor->nRowWrite = 0;
+  pCompactor->nRowDrop = 0;
+
+  // reader
+  code = tsdbDataFReaderOpen(&pCompactor->pReader, pTsdb, pSet);
+  if (code) goto _err;
+
+  // writer, all rows go to brand new head/data/sma files and a single stt file
+  SHeadFile fHead = {.commitID = pCompactor->commitID};
+  SDataFile fData = {.commitID = pCompactor->commitID};
+  SSmaFile  fSma = {.commitID = pCompactor->commitID};
+  SSttFile  fStt = {.commitID = pCompactor->commitID};
+  SDFileSet wSet = {.diskId = pSet->diskId,
+                    .fid = pSet->fid,
+                    .pHeadF = &fHead,
+                    .pDataF = &fData,
+                    .pSmaF = &fSma,
+                    .nSttF = 1,
+                    .aSttF[0] = &fStt};
+
+  code = tsdbDataFWriterOpen(&pCompactor->pWriter, pTsdb, &wSet);
+  if (code) goto _err;
+
+  taosArrayClear(pCompactor->aBlockIdxW);
+  taosArrayClear(pCompactor->aSttBlkW);
+  tBlockDataReset(&pCompactor->bData);
+  tBlockDataReset(&pCompactor->bDatal);
+
+  // merge
+  code = tsdbCompactOpenIter(pCompactor);
+  if (code) goto _err;
+
+  SRowInfo *pRowInfo;
+  while ((pRowInfo = tsdbCompactGetRow(pCompactor)) != NULL) {
+    TABLEID id = {.suid = pRowInfo->suid, .uid = pRowInfo->uid};
+
+    // a commit may rewrite this set, so the work so far is thrown away and the set is compacted again after it
+    if (tsdbCompactShouldYield(pCompactor)) {
+      code = tsdbCompactDiscardWriter(pCompactor);
+      if (code) goto _err;
+
+      code = tsdbDataFReaderClose(&pCompactor->pReader);
+      if (code) goto _err;
+
+      pCompactor->yield = 1;
+      tsdbInfo("vgId:%d, file set %d compaction yields, nRowRead:%" PRId64, TD_VID(pTsdb->pVnode), pSet->fid,
+               pCompactor->nRowRead);
+      return code;
+    }
+
+    code = tsdbCompactTableData(pCompactor, id);
+    if (code) goto _err;
+  }
+
+  if (pCompactor->bDatal.nRow > 0) {
+    code = tsdbCompactWriteSttBlock(pCompactor);
+    if (code) goto _err;
+  }
+
+  // nothing survived, drop the set instead of committing empty files
+  if (pCompactor->nRowWrite == 0) {
+    code = tsdbCompactDropFileSet(pCompactor, pSet);
+    if (code) goto _err;
+
+    tsdbInfo("vgId:%d, file set %d compacted to nothing, nStt:%d nRowRead:%" PRId64 " nRowDrop:%" PRId64,
+             TD_VID(pTsdb->pVnode), pSet->fid, pSet->nSttF, pCompactor->nRowRead, pCompactor->nRowDrop);
+    return code;
+  }
+
+  // end
+  code = tsdbWriteBlockIdx(pCompactor->pWriter, pCompactor->aBlockIdxW);
+  if (code) goto _err;
+
+  code = tsdbWriteSttBlk(pCompactor->pWriter, pCompactor->aSttBlkW);
+  if (code) goto _err;
+
+  code = tsdbUpdateDFileSetHeader(pCompactor->pWriter);
+  if (code) goto _err;
+
+  code = tsdbFSUpsertFSet(&pCompactor->fs, &pCompactor->pWriter->wSet);
+  if (code) goto _err;
+
+  code = tsdbDataFWriterClose(&pCompactor->pWriter, 1);
+  if (code) goto _err;
+
+  code = tsdbDataFReaderClose(&pCompactor->pReader);
+  if (code) goto _err;
+
+  tsdbInfo("vgId:%d, file set %d compacted, nStt:%d nRowRead:%" PRId64 " nRowWrite:%" PRId64 " nRowDrop:%" PRId64,
+           TD_VID(pTsdb->pVnode), pSet->fid, pSet->nSttF, pCompactor->nRowRead, pCompactor->nRowWrite,
+           pCompactor->nRowDrop);
+  return code;
+
+_err:
+  tsdbError("vgId:%d, compact file set %d failed since %s", TD_VID(pTsdb->pVnode), pSet->fid, tstrerror(code));
+  tsdbDataFReaderClose(&pCompactor->pReader);
+  tsdbCompactDiscardWriter(pCompactor);
+  return code;
+}
+
+// ================================================================================
+static int32_t tsdbCompactorInit(STsdbCompactor *pCompactor, STsdb *pTsdb, int64_t commitID) {
+  int32_t code = 0;
+
+  memset(pCompactor, 0, sizeof(*pCompactor));
+  pCompactor->pTsdb = pTsdb;
+  pCompactor->commitID = commitID;
+  pCompactor->minRow = pTsdb->pVnode->config.tsdbCfg.minRows;
+  pCompactor->maxRow = pTsdb->pVnode->config.tsdbCfg.maxRows;
+  pCompactor->cmprAlg = pTsdb->pVnode->config.tsdbCfg.compression;
+
+  if ((pCompactor->aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx))) == NULL ||
+      (pCompactor->aDelIdx = taosArrayInit(0, sizeof(SDelIdx))) == NULL ||
+      (pCompactor->aDelData = taosArrayInit(0, sizeof(SDelData))) == NULL ||
+      (pCompactor->aSkyline = taosArrayInit(0, sizeof(TSDBKEY))) == NULL ||
+      (pCompactor->aBlockIdxW = taosArrayInit(0, sizeof(SBlockIdx))) == NULL ||
+      (pCompactor->aSttBlkW = taosArrayInit(0, sizeof(SSttBlk))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int32_t iBData = 0; iBData < 2; iBData++) {
+    code = tBlockDataCreate(&pCompactor->dataIter.aBData[iBData]);
+    if (code) goto _exit;
+  }
+  for (int32_t iStt = 0; iStt < TSDB_MAX_STT_FILE; iStt++) {
+    SCompactIter *pIter = &pCompactor->aSttIter[iStt];
+
+    pIter->aSttBlk = taosArrayInit(0, sizeof(SSttBlk));
+    if (pIter->aSttBlk == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+
+    for (int32_t iBData = 0; iBData < 2; iBData++) {
+      code = tBlockDataCreate(&pIter->aBData[iBData]);
+      if (code) goto _exit;
+    }
+  }
+
+  code = tBlockDataCreate(&pCompactor->bData);
+  if (code) goto _exit;
+
+  code = tBlockDataCreate(&pCompactor->bDatal);
+  if (code) goto _exit;
+
+  code = tsdbFSCopy(pTsdb, &pCompactor->fs);
+  if (code) goto _exit;
+
+  if (pCompactor->fs.pDelFile) {
+    code = tsdbDelFReaderOpen(&pCompactor->pDelFReader, pCompactor->fs.pDelFile, pTsdb);
+    if (code) goto _exit;
+
+    code = tsdbReadDelIdx(pCompactor->pDelFReader, pCompactor->aDelIdx);
+    if (code) goto _exit;
+  }
+
+_exit:
+  return code;
+}
+
+static void tsdbCompactorClear(STsdbCompactor *pCompactor) {
+  if (pCompactor->pDelFReader) tsdbDelFReaderClose(&pCompactor->pDelFReader);
+
+  taosArrayDestroy(pCompactor->aBlockIdx);
+  taosArrayDestroy(pCompactor->aDelIdx);
+  taosArrayDestroy(pCompactor->aDelData);
+  taosArrayDestroy(pCompactor->aSkyline);
+  taosArrayDestroy(pCompactor->aBlockIdxW);
+  taosArrayDestroy(pCompactor->aSttBlkW);
+
+  for (int32_t iBData = 0; iBData < 2; iBData++) {
+    tBlockDataDestroy(&pCompactor->dataIter.aBData[iBData], 1);
+  }
+  tMapDataClear(&pCompactor->dataIter.mDataBlk);
+  tTSchemaDestroy(pCompactor->dataIter.pTSchema);
+  for (int32_t iStt = 0; iStt < TSDB_MAX_STT_FILE; iStt++) {
+    SCompactIter *pIter = &pCompactor->aSttIter[iStt];
+    taosArrayDestroy(pIter->aSttBlk);
+    for (int32_t iBData = 0; iBData < 2; iBData++) {
+      tBlockDataDestroy(&pIter->aBData[iBData], 1);
+    }
+  }
+
+  tMapDataClear(&pCompactor->mDataBlkW);
+  tBlockDataDestroy(&pCompactor->bData, 1);
+  tBlockDataDestroy(&pCompactor->bDatal, 1);
+  tTSchemaDestroy(pCompactor->pTSchema);
+  tsdbFSDestroy(&pCompactor->fs);
+}
+
+void tsdbScheduleCompact(STsdb *pTsdb) {
+  if (pTsdb) pTsdb->compactForce = 1;
+}
+
+static int8_t tsdbCompactAll(STsdb *pTsdb, int64_t now) {
+  return pTsdb->compactForce || (tsCompactInterval > 0 && now - pTsdb->compactTs >= tsCompactInterval * 1000ll);
+}
+
+/**
+ * @brief Check if any file set needs a compaction after the commit with commitID, so the caller only schedules a
+ * compaction task when there is work for it. A due periodic or requested round with nothing to do is marked done here.
+ *
+ * @param pTsdb
+ * @param commitID
+ * @return bool
+ */
+bool tsdbShouldCompact(STsdb *pTsdb, int64_t commitID) {
+  int64_t now = taosGetTimestampMs();
+  int8_t  all;
+
+  if (!pTsdb) return false;
+
+  all = tsdbCompactAll(pTsdb, now);
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pTsdb->fs.aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, iSet);
+    if (tsdbShouldCompactFSet(pSet, commitID, all)) return true;
+  }
+
+  if (all) {
+    pTsdb->compactForce = 0;
+    pTsdb->compactTs = now;
+  }
+  return false;
+}
+
+// compact the first due file set and commit it to the fs, *pDone is set once no set is due
+static int32_t tsdbCompactNextFileSet(STsdb *pTsdb, int64_t commitID, int8_t all, int64_t *pNByte, bool *pDone,
+                                      bool *pYield) {
+  int32_t        code = 0;
+  SDFileSet     *pSet = NULL;
+  int64_t        nByte;
+  STsdbCompactor compactor;
+
+  *pDone = false;
+  *pYield = false;
+
+  code = tsdbCompactorInit(&compactor, pTsdb, commitID);
+  if (code) goto _exit;
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pTsdb->fs.aDFileSet); iSet++) {
+    SDFileSet *pSetT = (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, iSet);
+    if (tsdbShouldCompactFSet(pSetT, commitID, all)) {
+      pSet = pSetT;
+      break;
+    }
+  }
+  if (pSet == NULL) {
+    *pDone = true;
+    goto _exit;
+  }
+
+  nByte = tsdbFSetSize(pSet);
+  code = tsdbCompactFileSet(&compactor, pSet);
+  if (code) goto _exit;
+
+  if (compactor.yield) {
+    *pYield = true;
+    goto _exit;
+  }
+
+  // do change fs
+  code = tsdbFSCommit1(pTsdb, &compactor.fs);
+  if (code) goto _exit;
+
+  taosThreadRwlockWrlock(&pTsdb->rwLock);
+  code = tsdbFSCommit2(pTsdb, &compactor.fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  if (code) goto _exit;
+
+  *pNByte += nByte;
+
+_exit:
+  tsdbCompactorClear(&compactor);
+  return code;
+}
+
+/**
+ * @brief Rewrite fragmented file sets into non-overlapping full-size blocks. Versions of the same timestamp are
+ * merged, rows hidden by the delete skyline and rows of dropped tables are left out, then the new file sets replace
+ * the old ones through the FS commit path. A set with no row left is removed rather than rewritten.
+ *
+ * Runs on the vnode compact queue after a commit and takes the commit slot for one file set at a time, so it never
+ * races a commit and a commit waits for at most a single table. A commit asking for the slot makes the set in work be
+ * discarded and compacted again once the commit is done; sets holding files of the compaction's commit ID are
+ * skipped. A set is compacted once it has compactSttTrigger non-empty stt files or compactSttSizeMB of stt data, or
+ * when it has more than one non-empty stt file and compactInterval has elapsed (or a compaction was requested).
+ * Reads are throttled to compactIoRateMB per second.
+ *
+ * @param pTsdb
+ * @param commitID
+ * @return int32_t
+ */
+int32_t tsdbCompact(STsdb *pTsdb, int64_t commitID) {
+  int32_t code = 0;
+  int64_t now = taosGetTimestampMs();
+  int8_t  all;
+  int64_t nByte = 0;
+  int32_t nSet = 0;
+  int32_t nYield = 0;
+  bool    done = false;
+  bool    yield = false;
+  SVnode *pVnode;
+
+  if (!pTsdb) return code;
+
+  pVnode = pTsdb->pVnode;
+  all = tsdbCompactAll(pTsdb, now);
+
+  while (!done && !atomic_load_8(&pVnode->compactStop)) {
+    // let the waiting commit take the slot first, the semaphore does not hand it over in order
+    while (atomic_load_32(&pVnode->commitWaiting) > 0 && !atomic_load_8(&pVnode->compactStop)) {
+      taosMsleep(1);
+    }
+
+    tsem_wait(&pVnode->canCommit);
+    code = tsdbCompactNextFileSet(pTsdb, commitID, all, &nByte, &done, &yield);
+    tsem_post(&pVnode->canCommit);
+    if (code) goto _err;
+
+    if (yield) {
+      nYield++;
+    } else if (!done) {
+      nSet++;
+    }
+  }
+
+  // a round ended by a closing vnode is not done, the due sets are found again after the next open
+  if (done && all) {
+    pTsdb->compactForce = 0;
+    pTsdb->compactTs = now;
+  }
+
+  tsdbInfo("vgId:%d, tsdb compact %s, nSet:%d nYield:%d size:%" PRId64 " elapsed:%" PRId64 "ms",
+           TD_VID(pVnode), done ? "done" : "stopped", nSet, nYield, nByte, taosGetTimestampMs() - now);
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb compact failed since %s", TD_VID(pVnode), tstrerror(code));
   return code;
 }
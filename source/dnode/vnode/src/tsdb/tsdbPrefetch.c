@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdb.h"
+
+typedef enum {
+  BLOCK_PREFETCH_IDLE = 0,
+  BLOCK_PREFETCH_LOADING = 1,
+  BLOCK_PREFETCH_READY = 2,
+} EBlockPrefetchState;
+
+typedef struct {
+  int8_t     state;  // EBlockPrefetchState
+  int32_t    code;   // load result, valid once the slot is ready
+  uint64_t   uid;    // the block is identified by (uid, tbBlockIdx) in current file set
+  int32_t    tbBlockIdx;
+  int32_t    index;  // position in the block iterator when the load was issued
+  int64_t    seq;    // issue order, the loader takes the slots in this order
+  int64_t    size;   // estimated size of the decompressed block data
+  SDataBlk   block;
+  SBlockData data;
+} SBlockPrefetchSlot;
+
+// All slot states and the fields below the mutex are protected by it. The loader task only touches the block and
+// data of the slot it loads, which nobody else does while the slot is loading.
+struct SBlockPrefetcher {
+  STsdb              *pTsdb;
+  FBlockPrefetchLoad  fpLoad;
+  int64_t             memBudget;
+  int32_t             nSlot;
+  SBlockPrefetchSlot *aSlot;
+  SDataFReader       *pFileReader;  // used by the loader only, the reader of the consumer is not thread safe
+  TdThreadMutex       mutex;
+  TdThreadCond        cond;
+  SDFileSet          *pSet;     // file set that the slots are loaded from
+  int8_t              loading;  // the loader task is scheduled or running
+  SBlockPrefetchSlot *pLoad;    // slot being loaded
+  int64_t             seq;
+  int64_t             memSize;  // estimated memory held by loading and ready slots
+};
+
+static int32_t tsdbPrefetchLoadBlock(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet, SDataBlk *pBlock,
+                                     SBlockData *pBlockData) {
+  int32_t code = 0;
+
+  if (*ppReader == NULL) {
+    code = tsdbDataFReaderOpen(ppReader, pTsdb, pSet);
+    if (code) goto _exit;
+  }
+
+  code = tsdbReadDataBlock(*ppReader, pBlock, pBlockData);
+
+_exit:
+  return code;
+}
+
+static void tsdbPrefetcherReleaseSlot(SBlockPrefetcher *pPrefetcher, SBlockPrefetchSlot *pSlot) {
+  pSlot->state = BLOCK_PREFETCH_IDLE;
+  pPrefetcher->memSize -= pSlot->size;
+}
+
+static SBlockPrefetchSlot *tsdbPrefetcherGetSlot(SBlockPrefetcher *pPrefetcher, uint64_t uid, int32_t tbBlockIdx) {
+  for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+    SBlockPrefetchSlot *pSlot = &pPrefetcher->aSlot[iSlot];
+    if (pSlot->state != BLOCK_PREFETCH_IDLE && pSlot->uid == uid && pSlot->tbBlockIdx == tbBlockIdx) {
+      return pSlot;
+    }
+  }
+
+  return NULL;
+}
+
+// a single loader task per prefetcher, so the blocks share one file reader and come in the order they are consumed
+static int32_t tsdbPrefetcherLoad(void *arg) {
+  SBlockPrefetcher *pPrefetcher = (SBlockPrefetcher *)arg;
+
+  taosThreadMutexLock(&pPrefetcher->mutex);
+  for (;;) {
+    SBlockPrefetchSlot *pSlot = NULL;
+    for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+      SBlockPrefetchSlot *pSlotT = &pPrefetcher->aSlot[iSlot];
+      if (pSlotT->state == BLOCK_PREFETCH_LOADING && (pSlot == NULL || pSlotT->seq < pSlot->seq)) {
+        pSlot = pSlotT;
+      }
+    }
+    if (pSlot == NULL) break;
+
+    pPrefetcher->pLoad = pSlot;
+    taosThreadMutexUnlock(&pPrefetcher->mutex);
+
+    int32_t code = pPrefetcher->fpLoad(&pPrefetcher->pFileReader, pPrefetcher->pTsdb, pPrefetcher->pSet,
+                                       &pSlot->block, &pSlot->data);
+
+    taosThreadMutexLock(&pPrefetcher->mutex);
+    pPrefetcher->pLoad = NULL;
+    pSlot->code = code;
+    pSlot->state = BLOCK_PREFETCH_READY;
+    taosThreadCondBroadcast(&pPrefetcher->cond);
+  }
+
+  pPrefetcher->loading = 0;
+  taosThreadCondBroadcast(&pPrefetcher->cond);
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+
+  return 0;
+}
+
+int32_t tsdbPrefetcherOpen(STsdb *pTsdb, int32_t nSlot, int64_t memBudget, FBlockPrefetchLoad fpLoad,
+                           SBlockPrefetcher **ppPrefetcher) {
+  int32_t           code = 0;
+  SBlockPrefetcher *pPrefetcher = NULL;
+
+  pPrefetcher = (SBlockPrefetcher *)taosMemoryCalloc(1, sizeof(*pPrefetcher));
+  if (pPrefetcher == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  pPrefetcher->aSlot = (SBlockPrefetchSlot *)taosMemoryCalloc(nSlot, sizeof(SBlockPrefetchSlot));
+  if (pPrefetcher->aSlot == NULL) {
+    taosMemoryFree(pPrefetcher);
+    pPrefetcher = NULL;
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  pPrefetcher->pTsdb = pTsdb;
+  pPrefetcher->fpLoad = fpLoad ? fpLoad : tsdbPrefetchLoadBlock;
+  pPrefetcher->memBudget = memBudget;
+  taosThreadMutexInit(&pPrefetcher->mutex, NULL);
+  taosThreadCondInit(&pPrefetcher->cond, NULL);
+
+  for (; pPrefetcher->nSlot < nSlot; pPrefetcher->nSlot++) {
+    code = tBlockDataCreate(&pPrefetcher->aSlot[pPrefetcher->nSlot].data);
+    if (code) goto _err;
+  }
+
+  *ppPrefetcher = pPrefetcher;
+  return code;
+
+_err:
+  tsdbPrefetcherClose(&pPrefetcher);
+  *ppPrefetcher = NULL;
+  return code;
+}
+
+void tsdbPrefetcherClose(SBlockPrefetcher **ppPrefetcher) {
+  SBlockPrefetcher *pPrefetcher = *ppPrefetcher;
+  if (pPrefetcher == NULL) return;
+
+  tsdbPrefetcherReset(pPrefetcher, NULL);
+  for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+    tBlockDataDestroy(&pPrefetcher->aSlot[iSlot].data, 1);
+  }
+
+  taosThreadCondDestroy(&pPrefetcher->cond);
+  taosThreadMutexDestroy(&pPrefetcher->mutex);
+  taosMemoryFree(pPrefetcher->aSlot);
+  taosMemoryFree(pPrefetcher);
+  *ppPrefetcher = NULL;
+}
+
+/**
+ * @brief Drop all slots and close the file reader, then load from pSet. Slots not picked by the loader yet are
+ * dropped right away, only the block being loaded is waited for.
+ */
+void tsdbPrefetcherReset(SBlockPrefetcher *pPrefetcher, SDFileSet *pSet) {
+  taosThreadMutexLock(&pPrefetcher->mutex);
+  for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+    SBlockPrefetchSlot *pSlot = &pPrefetcher->aSlot[iSlot];
+    if (pSlot->state != BLOCK_PREFETCH_IDLE && pSlot != pPrefetcher->pLoad) {
+      tsdbPrefetcherReleaseSlot(pPrefetcher, pSlot);
+    }
+  }
+  while (pPrefetcher->loading) {
+    taosThreadCondWait(&pPrefetcher->cond, &pPrefetcher->mutex);
+  }
+
+  for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+    SBlockPrefetchSlot *pSlot = &pPrefetcher->aSlot[iSlot];
+    pSlot->state = BLOCK_PREFETCH_IDLE;
+    tBlockDataReset(&pSlot->data);
+  }
+  pPrefetcher->pSet = pSet;
+  pPrefetcher->memSize = 0;
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+
+  tsdbDataFReaderClose(&pPrefetcher->pFileReader);
+}
+
+SDFileSet *tsdbPrefetcherGetFSet(SBlockPrefetcher *pPrefetcher) { return pPrefetcher->pSet; }
+
+/**
+ * @brief Issue the load of a block at position index of the block iterator, the block is skipped if it is already
+ * issued. At least one block is always allowed, otherwise a large block would never be loaded ahead.
+ *
+ * @return false if no slot or memory is left for it
+ */
+bool tsdbPrefetcherPut(SBlockPrefetcher *pPrefetcher, TABLEID id, int32_t tbBlockIdx, int32_t index, SDataBlk *pBlock,
+                       STSchema *pTSchema, int64_t size) {
+  bool                put = false;
+  SBlockPrefetchSlot *pSlot = NULL;
+
+  taosThreadMutexLock(&pPrefetcher->mutex);
+
+  if (tsdbPrefetcherGetSlot(pPrefetcher, id.uid, tbBlockIdx) != NULL) {
+    put = true;
+    goto _exit;
+  }
+
+  if (pPrefetcher->memSize > 0 && pPrefetcher->memSize + size > pPrefetcher->memBudget) goto _exit;
+
+  for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+    if (pPrefetcher->aSlot[iSlot].state == BLOCK_PREFETCH_IDLE) {
+      pSlot = &pPrefetcher->aSlot[iSlot];
+      break;
+    }
+  }
+  if (pSlot == NULL) goto _exit;
+
+  tBlockDataReset(&pSlot->data);
+  if (tBlockDataInit(&pSlot->data, id.suid, id.uid, pTSchema) != 0) goto _exit;
+
+  pSlot->uid = id.uid;
+  pSlot->tbBlockIdx = tbBlockIdx;
+  pSlot->index = index;
+  pSlot->seq = pPrefetcher->seq++;
+  pSlot->size = size;
+  pSlot->block = *pBlock;
+  pSlot->code = 0;
+  pSlot->state = BLOCK_PREFETCH_LOADING;
+  pPrefetcher->memSize += size;
+  put = true;
+
+_exit:
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+  return put;
+}
+
+// schedule the loader for the slots put so far, they are dropped if the read queue does not take it
+void tsdbPrefetcherStart(SBlockPrefetcher *pPrefetcher) {
+  taosThreadMutexLock(&pPrefetcher->mutex);
+  if (!pPrefetcher->loading) {
+    pPrefetcher->loading = 1;
+    if (vnodeScheduleReadTask(tsdbPrefetcherLoad, pPrefetcher) < 0) {
+      pPrefetcher->loading = 0;
+      for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+        SBlockPrefetchSlot *pSlot = &pPrefetcher->aSlot[iSlot];
+        if (pSlot->state == BLOCK_PREFETCH_LOADING) {
+          tsdbPrefetcherReleaseSlot(pPrefetcher, pSlot);
+        }
+      }
+    }
+  }
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+}
+
+// blocks at or before position index that the consumer passed without taking them are not required any more
+void tsdbPrefetcherSkip(SBlockPrefetcher *pPrefetcher, int32_t index, int32_t step) {
+  taosThreadMutexLock(&pPrefetcher->mutex);
+  for (int32_t iSlot = 0; iSlot < pPrefetcher->nSlot; iSlot++) {
+    SBlockPrefetchSlot *pSlot = &pPrefetcher->aSlot[iSlot];
+    if (pSlot->state == BLOCK_PREFETCH_READY && (pSlot->index - index) * step <= 0) {
+      tsdbPrefetcherReleaseSlot(pPrefetcher, pSlot);
+    }
+  }
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+}
+
+/**
+ * @brief Take the loaded data of a block by swapping it into pBlockData, waiting for the load if it is in flight.
+ *
+ * @return false if the block was not issued or failed to load, the caller loads it again and reports the error
+ */
+bool tsdbPrefetcherTake(SBlockPrefetcher *pPrefetcher, uint64_t uid, int32_t tbBlockIdx, SBlockData *pBlockData) {
+  bool taken = false;
+
+  taosThreadMutexLock(&pPrefetcher->mutex);
+
+  SBlockPrefetchSlot *pSlot = tsdbPrefetcherGetSlot(pPrefetcher, uid, tbBlockIdx);
+  if (pSlot == NULL) goto _exit;
+
+  while (pSlot->state == BLOCK_PREFETCH_LOADING) {
+    taosThreadCondWait(&pPrefetcher->cond, &pPrefetcher->mutex);
+  }
+
+  if (pSlot->code == 0) {
+    SBlockData tmp = *pBlockData;
+    *pBlockData = pSlot->data;
+    pSlot->data = tmp;
+    taken = true;
+  }
+  tsdbPrefetcherReleaseSlot(pPrefetcher, pSlot);
+
+_exit:
+  taosThreadMutexUnlock(&pPrefetcher->mutex);
+  return taken;
+}
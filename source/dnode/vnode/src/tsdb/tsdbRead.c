@@ -70,6 +70,8 @@ typedef struct SIOCostSummary {
   double  smaLoadTime;
   int64_t lastBlockLoad;
   double  lastBlockLoadTime;
+  int64_t prefetchBlocks;
+  double  prefetchWaitTime;
 } SIOCostSummary;
 
 typedef struct SBlockLoadSuppInfo {
@@ -135,6 +137,7 @@ typedef struct SReaderStatus {
   SBlockData           fileBlockData;
   SFilesetIter         fileIter;
   SDataBlockIter       blockIter;
+  SBlockPrefetcher*    pPrefetcher;  // load the following file blocks ahead of the consumer
 } SReaderStatus;
 
 struct STsdbReader {
@@ -190,6 +193,7 @@ static SVersionRange getQueryVerRange(SVnode* pVnode, SQueryTableDataCond* pCond
 static int64_t       getCurrentKeyInLastBlock(SLastBlockReader* pLastBlockReader);
 static bool          hasDataInLastBlock(SLastBlockReader* pLastBlockReader);
 static int32_t       doBuildDataBlock(STsdbReader* pReader);
+static void          resetBlockPrefetcher(SBlockPrefetcher* pPrefetcher);
 
 static int32_t setColumnIdSlotList(STsdbReader* pReader, SSDataBlock* pBlock) {
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
@@ -368,6 +372,7 @@ static bool filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader) {
   pIter->pLastBlockReader->uid = 0;
   tMergeTreeClose(&pIter->pLastBlockReader->mergeTree);
   resetLastBlockLoadInfo(pIter->pLastBlockReader->pInfo);
+  resetBlockPrefetcher(pReader->status.pPrefetcher);
 
   // check file the time range of coverage
   STimeWindow win = {0};
@@ -761,6 +766,73 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
   return TSDB_CODE_SUCCESS;
 }
 
+static void resetBlockPrefetcher(SBlockPrefetcher* pPrefetcher) {
+  if (pPrefetcher != NULL) {
+    tsdbPrefetcherReset(pPrefetcher, NULL);
+  }
+}
+
+// take the block data loaded by the prefetch task, if the block has been issued
+static bool takePrefetchedBlock(STsdbReader* pReader, SFileDataBlockInfo* pBlockInfo, SBlockData* pBlockData) {
+  SBlockPrefetcher* pPrefetcher = pReader->status.pPrefetcher;
+  if (pPrefetcher == NULL) {
+    return false;
+  }
+
+  int64_t st = taosGetTimestampUs();
+  bool    taken = tsdbPrefetcherTake(pPrefetcher, pBlockInfo->uid, pBlockInfo->tbBlockIdx, pBlockData);
+  pReader->cost.prefetchWaitTime += (taosGetTimestampUs() - st) / 1000.0;
+
+  if (taken) {
+    pReader->cost.prefetchBlocks += 1;
+  }
+  return taken;
+}
+
+// issue the load of the following blocks in access order, bounded by the number of slots and the memory budget
+static void issueBlockPrefetch(STsdbReader* pReader, SDataBlockIter* pBlockIter) {
+  SReaderStatus* pStatus = &pReader->status;
+  if (tsQueryPrefetchBlocks <= 0 || pBlockIter->numOfBlocks <= 1) {
+    return;
+  }
+
+  if (pStatus->pPrefetcher == NULL) {
+    if (tsdbPrefetcherOpen(pReader->pTsdb, tsQueryPrefetchBlocks, tsQueryPrefetchMemMB * 1048576LL, NULL,
+                           &pStatus->pPrefetcher) != TSDB_CODE_SUCCESS) {
+      return;
+    }
+  }
+
+  SBlockPrefetcher* pPrefetcher = pStatus->pPrefetcher;
+  bool              asc = ASCENDING_TRAVERSE(pReader->order);
+  int32_t           step = asc ? 1 : -1;
+
+  if (tsdbPrefetcherGetFSet(pPrefetcher) != pStatus->pCurrentFileset) {
+    tsdbPrefetcherReset(pPrefetcher, pStatus->pCurrentFileset);
+  }
+
+  tsdbPrefetcherSkip(pPrefetcher, pBlockIter->index, step);
+
+  int32_t rowSize = (pReader->pSchema != NULL) ? pReader->pSchema->tlen : 0;
+  int32_t index = pBlockIter->index + step;
+
+  for (int32_t i = 0; i < tsQueryPrefetchBlocks && index >= 0 && index < pBlockIter->numOfBlocks; ++i, index += step) {
+    SFileDataBlockInfo*  pBlockInfo = taosArrayGet(pBlockIter->blockList, index);
+    STableBlockScanInfo* pScanInfo = taosHashGet(pStatus->pTableMap, &pBlockInfo->uid, sizeof(pBlockInfo->uid));
+    int32_t*             mapDataIndex = taosArrayGet(pScanInfo->pBlockList, pBlockInfo->tbBlockIdx);
+    SDataBlk             block;
+    tMapDataGetItemByIdx(&pScanInfo->mapData, *mapDataIndex, &block, tGetDataBlk);
+
+    TABLEID id = {.suid = pReader->suid, .uid = pBlockInfo->uid};
+    int64_t size = block.aSubBlock[0].szBlock + (int64_t)block.nRow * (rowSize + sizeof(int64_t));
+    if (!tsdbPrefetcherPut(pPrefetcher, id, pBlockInfo->tbBlockIdx, index, &block, pReader->pSchema, size)) {
+      break;
+    }
+  }
+
+  tsdbPrefetcherStart(pPrefetcher);
+}
+
 static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData) {
   int64_t st = taosGetTimestampUs();
 
@@ -769,7 +841,11 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   ASSERT(pBlockInfo != NULL);
 
   SDataBlk* pBlock = getCurrentBlock(pBlockIter);
-  int32_t   code = tsdbReadDataBlock(pReader->pFileReader, pBlock, pBlockData);
+  int32_t   code = TSDB_CODE_SUCCESS;
+  if (!takePrefetchedBlock(pReader, pBlockInfo, pBlockData)) {
+    code = tsdbReadDataBlock(pReader->pFileReader, pBlock, pBlockData);
+  }
+
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
               ", rows:%d, code:%s %s",
@@ -788,6 +864,7 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   pReader->cost.blockLoadTime += elapsedTime;
   pDumpInfo->allDumped = false;
 
+  issueBlockPrefetch(pReader, pBlockIter);
   return TSDB_CODE_SUCCESS;
 }
 
@@ -3292,6 +3369,7 @@ void tsdbReaderClose(STsdbReader* pReader) {
   }
 
   taosMemoryFree(pSupInfo->buildBuf);
+  tsdbPrefetcherClose(&pReader->status.pPrefetcher);
   tBlockDataDestroy(&pReader->status.fileBlockData, true);
 
   cleanupDataBlockIterator(&pReader->status.blockIter);
@@ -3321,10 +3399,12 @@ void tsdbReaderClose(STsdbReader* pReader) {
             " SMA-time:%.2f ms, fileBlocks:%" PRId64
             ", fileBlocks-time:%.2f ms, "
             "build in-memory-block-time:%.2f ms, lastBlocks:%" PRId64
-            ", lastBlocks-time:%.2f ms, STableBlockScanInfo size:%.2f Kb %s",
+            ", lastBlocks-time:%.2f ms, prefetchBlocks:%" PRId64
+            ", prefetch-wait-time:%.2f ms, STableBlockScanInfo size:%.2f Kb %s",
             pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime,
             pCost->numOfBlocks, pCost->blockLoadTime, pCost->buildmemBlock, pCost->lastBlockLoad,
-            pCost->lastBlockLoadTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pReader->idStr);
+            pCost->lastBlockLoadTime, pCost->prefetchBlocks, pCost->prefetchWaitTime,
+            numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
   taosMemoryFree(pReader->pSchema);
@@ -3552,6 +3632,7 @@ int32_t tsdbReaderReset(STsdbReader* pReader, SQueryTableDataCond* pCond) {
   memset(pReader->suppInfo.plist, 0, POINTER_BYTES);
 
   pReader->suppInfo.tsColAgg.colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+  resetBlockPrefetcher(pReader->status.pPrefetcher);
   tsdbDataFReaderClose(&pReader->pFileReader);
 
   int32_t numOfTables = taosHashGetSize(pReader->status.pTableMap);
@@ -93,11 +93,70 @@ _exit:
   return code;
 }
 
+// only readers use the page cache. Head, stt and del files are written once, so all their pages are sealed; data
+// and sma files get appended by later commits, which rewrite the last page, so it is never cached.
+static void tsdbSetFilePgCache(STsdbFD *pFD, STsdb *pTsdb, bool sealed) {
+  if (pTsdb->pgCache == NULL) return;
+
+  pFD->pTsdb = pTsdb;
+  pFD->szSealed = sealed ? pFD->szFile : pFD->szFile - 1;
+}
+
+static int32_t tsdbPgCacheKey(STsdbFD *pFD, int64_t pgno, uint8_t *key) {
+  int32_t len = strlen(pFD->path);
+
+  memcpy(key, &pgno, sizeof(pgno));
+  memcpy(key + sizeof(pgno), pFD->path, len);
+  return sizeof(pgno) + len;
+}
+
+static void tsdbPgCacheDeleter(const void *key, size_t keyLen, void *value) { taosMemoryFree(value); }
+
+static bool tsdbReadFilePageFromCache(STsdbFD *pFD, int64_t pgno) {
+  STsdb     *pTsdb = pFD->pTsdb;
+  uint8_t    key[sizeof(int64_t) + TSDB_FILENAME_LEN];
+  int32_t    keyLen = tsdbPgCacheKey(pFD, pgno, key);
+  LRUHandle *h = taosLRUCacheLookup(pTsdb->pgCache, key, keyLen);
+
+  if (h == NULL) {
+    atomic_add_fetch_64(&pTsdb->pgCacheMiss, 1);
+    return false;
+  }
+
+  memcpy(pFD->pBuf, taosLRUCacheValue(pTsdb->pgCache, h), pFD->szPage);
+  taosLRUCacheRelease(pTsdb->pgCache, h, false);
+  atomic_add_fetch_64(&pTsdb->pgCacheHit, 1);
+
+  return true;
+}
+
+static void tsdbPutFilePageToCache(STsdbFD *pFD, int64_t pgno) {
+  STsdb   *pTsdb = pFD->pTsdb;
+  uint8_t  key[sizeof(int64_t) + TSDB_FILENAME_LEN];
+  int32_t  keyLen = tsdbPgCacheKey(pFD, pgno, key);
+  uint8_t *pPage = taosMemoryMalloc(pFD->szPage);
+
+  // the cache is best effort, a failure here only costs a disk read later
+  if (pPage == NULL) return;
+
+  memcpy(pPage, pFD->pBuf, pFD->szPage);
+  if (taosLRUCacheInsert(pTsdb->pgCache, key, keyLen, pPage, pFD->szPage, tsdbPgCacheDeleter, NULL,
+                         TAOS_LRU_PRIORITY_LOW) == TAOS_LRU_STATUS_FAIL) {
+    taosMemoryFree(pPage);
+  }
+}
+
 static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
   int32_t code = 0;
+  bool    cached = (pFD->pTsdb && pgno <= pFD->szSealed);
 
   ASSERT(pgno <= pFD->szFile);
 
+  if (cached && tsdbReadFilePageFromCache(pFD, pgno)) {
+    pFD->pgno = pgno;
+    goto _exit;
+  }
+
   // seek
   int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
   int64_t n = taosLSeekFile(pFD->pFD, offset, SEEK_SET);
@@ -122,6 +181,8 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
     goto _exit;
   }
 
+  if (cached) tsdbPutFilePageToCache(pFD, pgno);
+
   pFD->pgno = pgno;
 
 _exit:
@@ -739,22 +800,26 @@ int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pS
   tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pHeadFD);
   if (code) goto _err;
+  tsdbSetFilePgCache(pReader->pHeadFD, pTsdb, true);
 
   // data
   tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pDataFD);
   if (code) goto _err;
+  tsdbSetFilePgCache(pReader->pDataFD, pTsdb, false);
 
   // sma
   tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
   code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->pSmaFD);
   if (code) goto _err;
+  tsdbSetFilePgCache(pReader->pSmaFD, pTsdb, false);
 
   // stt
   for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
     tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
     code = tsdbOpenFile(fname, szPage, TD_FILE_READ, &pReader->aSttFD[iStt]);
     if (code) goto _err;
+    tsdbSetFilePgCache(pReader->aSttFD[iStt], pTsdb, true);
   }
 
   *ppReader = pReader;
@@ -1317,6 +1382,7 @@ int32_t tsdbDelFReaderOpen(SDelFReader **ppReader, SDelFile *pFile, STsdb *pTsdb
   tsdbDelFileName(pTsdb, pFile, fname);
   code = tsdbOpenFile(fname, TSDB_DEFAULT_PAGE_SIZE, TD_FILE_READ, &pDelFReader->pReadH);
   if (code) goto _err;
+  tsdbSetFilePgCache(pDelFReader->pReadH, pTsdb, true);
 
   *ppReader = pDelFReader;
   return code;
@@ -16,9 +16,26 @@
 #include "vnd.h"
 
 /* ------------------------ STRUCTURES ------------------------ */
+#define VNODE_BUF_CHUNK_SIZE  (64 * 1024)                 // bytes a thread carves from the anchor node at a time
+#define VNODE_BUF_CHUNK_ALLOC (VNODE_BUF_CHUNK_SIZE / 8)  // larger allocations go to the pool directly
+#define VNODE_BUF_CHUNK_SLOTS 4
+#define VNODE_BUF_CHUNK_MARK  ((int64_t)-1)  // header of an allocation carved from a heap node, never freed alone
 
-static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool);
-static int vnodeBufPoolDestroy(SVBufPool *pPool);
+typedef struct {
+  SVBufPool *pPool;
+  int64_t    gen;
+  uint8_t   *ptr;
+  uint8_t   *end;
+  int32_t    szHdr;  // 0 for a chunk of the anchor, sizeof(int64_t) for one of a heap node
+} SVBufChunk;
+
+static threadlocal SVBufChunk vnodeBufChunks[VNODE_BUF_CHUNK_SLOTS];
+static threadlocal int32_t    vnodeBufChunkNext;
+static int64_t                vnodeBufPoolGen = 0;
+
+static int  vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool);
+static int  vnodeBufPoolDestroy(SVBufPool *pPool);
+static void vnodeBufPoolRecycleNode(SVBufPool *pPool, SVBufPoolNode *pNode);
 
 int vnodeOpenBufPool(SVnode *pVnode, int64_t size) {
   SVBufPool *pPool = NULL;
@@ -66,41 +83,169 @@ void vnodeBufPoolReset(SVBufPool *pPool) {
     pNode->prev->pnext = &pPool->pTail;
     pPool->pTail = pNode->prev;
     pPool->size = pPool->size - sizeof(*pNode) - pNode->size;
-    taosMemoryFree(pNode);
+    vnodeBufPoolRecycleNode(pPool, pNode);
   }
 
-  ASSERT(pPool->size == pPool->ptr - pPool->node.data);
+  // the unused tails of retired chunks were taken out already
+  ASSERT(pPool->size <= pPool->ptr - pPool->node.data);
 
   pPool->size = 0;
   pPool->ptr = pPool->node.data;
+  pPool->gen = atomic_add_fetch_64(&vnodeBufPoolGen, 1);
 }
 
-void *vnodeBufPoolMalloc(SVBufPool *pPool, int size) {
+// the chunk this thread bumps from for the pool, a chunk carved before the last reset is dropped
+static FORCE_INLINE SVBufChunk *vnodeBufPoolGetChunk(SVBufPool *pPool) {
+  SVBufChunk *pChunk;
+
+  for (int32_t i = 0; i < VNODE_BUF_CHUNK_SLOTS; i++) {
+    pChunk = &vnodeBufChunks[i];
+    if (pChunk->pPool == pPool) {
+      if (pChunk->gen != pPool->gen) {
+        pChunk->gen = pPool->gen;
+        pChunk->ptr = pChunk->end = NULL;
+      }
+      return pChunk;
+    }
+  }
+
+  pChunk = &vnodeBufChunks[vnodeBufChunkNext];
+  vnodeBufChunkNext = (vnodeBufChunkNext + 1) % VNODE_BUF_CHUNK_SLOTS;
+  pChunk->pPool = pPool;
+  pChunk->gen = pPool->gen;
+  pChunk->ptr = pChunk->end = NULL;
+  return pChunk;
+}
+
+static FORCE_INLINE void *vnodeBufChunkAlloc(SVBufChunk *pChunk, int size) {
+  uint8_t *p;
+
+  if (pChunk->end - pChunk->ptr < size + pChunk->szHdr) return NULL;
+
+  p = pChunk->ptr + pChunk->szHdr;
+  if (pChunk->szHdr) ((int64_t *)p)[-1] = VNODE_BUF_CHUNK_MARK;
+  pChunk->ptr = p + size;
+  return p;
+}
+
+/**
+ * @brief Map a node size to its free list, sizes are rounded up to 4 classes per power of two.
+ *
+ * @return the class index, or -1 if the node is too large to be cached
+ */
+static int32_t vnodeBufPoolSizeClass(int64_t size, int64_t *cap) {
+  int32_t lg = 6;
+  int64_t step;
+  int64_t k;
+
+  if (size <= (1ll << lg)) {
+    *cap = (1ll << lg);
+    return 0;
+  }
+
+  while ((1ll << (lg + 1)) < size) lg++;
+  if (lg >= 30) {
+    *cap = size;
+    return -1;
+  }
+
+  step = 1ll << (lg - 2);
+  k = (size - (1ll << lg) + step - 1) / step;
+  *cap = (1ll << lg) + k * step;
+  return 1 + (lg - 6) * 4 + (int32_t)(k - 1);
+}
+
+static void vnodeBufPoolRecycleNode(SVBufPool *pPool, SVBufPoolNode *pNode) {
+  int64_t cap;
+  int32_t iClass = vnodeBufPoolSizeClass(pNode->size, &cap);
+
+  if (iClass < 0 || cap != pNode->size || pPool->szFree + sizeof(*pNode) + cap > pPool->pVnode->config.szBuf / 3) {
+    taosMemoryFree(pNode);
+    return;
+  }
+
+  pNode->prev = pPool->aFree[iClass];
+  pNode->pnext = NULL;
+  pPool->aFree[iClass] = pNode;
+  pPool->szFree = pPool->szFree + sizeof(*pNode) + cap;
+}
+
+// allocate a node out of the anchor, reuse a recycled one of the same class if any, called with the lock held
+static void *vnodeBufPoolNewNode(SVBufPool *pPool, int size) {
   SVBufPoolNode *pNode;
-  void          *p;
-  taosThreadSpinLock(&pPool->lock);
-  if (pPool->node.size >= pPool->ptr - pPool->node.data + size) {
-    // allocate from the anchor node
-    p = pPool->ptr;
-    pPool->ptr = pPool->ptr + size;
-    pPool->size += size;
+  int64_t        cap;
+  int32_t        iClass = vnodeBufPoolSizeClass(size, &cap);
+
+  if (iClass >= 0 && pPool->aFree[iClass]) {
+    pNode = pPool->aFree[iClass];
+    pPool->aFree[iClass] = pNode->prev;
+    pPool->szFree = pPool->szFree - sizeof(*pNode) - cap;
   } else {
-    // allocate a new node
-    pNode = taosMemoryMalloc(sizeof(*pNode) + size);
+    pNode = taosMemoryMalloc(sizeof(*pNode) + cap);
     if (pNode == NULL) {
       terrno = TSDB_CODE_OUT_OF_MEMORY;
-      taosThreadSpinUnlock(&pPool->lock);
       return NULL;
     }
+    pNode->size = cap;
+  }
+
+  pNode->prev = pPool->pTail;
+  pNode->pnext = &pPool->pTail;
+  pPool->pTail->pnext = &pNode->prev;
+  pPool->pTail = pNode;
+
+  pPool->size = pPool->size + sizeof(*pNode) + cap;
+
+  return pNode->data;
+}
+
+/**
+ * @brief Allocate from the pool of the memtable. Small allocations bump from a chunk the thread carves from the
+ * anchor node, or from a heap node once the anchor is used up, so they take the lock only once per chunk. The pool
+ * size counts a chunk as it is carved and drops its unused tail when the thread moves to the next one.
+ */
+void *vnodeBufPoolMalloc(SVBufPool *pPool, int size) {
+  SVBufChunk *pChunk = NULL;
+  uint8_t    *p;
+  int64_t     nLeft;
+  int64_t     nCarve;
+
+  // small allocations bump from the thread's own chunk without locking
+  if (size <= VNODE_BUF_CHUNK_ALLOC) {
+    pChunk = vnodeBufPoolGetChunk(pPool);
+    p = vnodeBufChunkAlloc(pChunk, size);
+    if (p) return p;
+  }
 
-    p = pNode->data;
-    pNode->size = size;
-    pNode->prev = pPool->pTail;
-    pNode->pnext = &pPool->pTail;
-    pPool->pTail->pnext = &pNode->prev;
-    pPool->pTail = pNode;
+  taosThreadSpinLock(&pPool->lock);
+  if (pChunk) {
+    pPool->size -= pChunk->end - pChunk->ptr;
+  }
 
-    pPool->size = pPool->size + sizeof(*pNode) + size;
+  nLeft = pPool->node.size - (pPool->ptr - pPool->node.data);
+  if (nLeft >= size) {
+    // allocate from the anchor node, carving a new chunk for small allocations
+    nCarve = pChunk ? TMIN(nLeft, VNODE_BUF_CHUNK_SIZE) : size;
+    p = pPool->ptr;
+    pPool->ptr = pPool->ptr + nCarve;
+    pPool->size += nCarve;
+    if (pChunk) {
+      pChunk->ptr = p + size;
+      pChunk->end = p + nCarve;
+      pChunk->szHdr = 0;
+    }
+  } else if (pChunk) {
+    // the anchor is used up, carve the chunk from a heap node rather than a node per allocation
+    p = vnodeBufPoolNewNode(pPool, VNODE_BUF_CHUNK_SIZE);
+    if (p) {
+      pChunk->ptr = p;
+      pChunk->end = p + VNODE_BUF_CHUNK_SIZE;
+      pChunk->szHdr = sizeof(int64_t);
+      p = vnodeBufChunkAlloc(pChunk, size);
+    }
+  } else {
+    // allocate a new node
+    p = vnodeBufPoolNewNode(pPool, size);
   }
   taosThreadSpinUnlock(&pPool->lock);
   return p;
@@ -111,12 +256,18 @@ void vnodeBufPoolFree(SVBufPool *pPool, void *p) {
   SVBufPoolNode *pNode;
 
   if (ptr < pPool->node.data || ptr >= pPool->node.data + pPool->node.size) {
+    // a part of a chunk node goes with the node on reset
+    if (((int64_t *)p)[-1] == VNODE_BUF_CHUNK_MARK) return;
+
     pNode = &((SVBufPoolNode *)p)[-1];
+
+    taosThreadSpinLock(&pPool->lock);
     *pNode->pnext = pNode->prev;
     pNode->prev->pnext = pNode->pnext;
 
     pPool->size = pPool->size - sizeof(*pNode) - pNode->size;
-    taosMemoryFree(pNode);
+    vnodeBufPoolRecycleNode(pPool, pNode);
+    taosThreadSpinUnlock(&pPool->lock);
   }
 }
 
@@ -145,13 +296,24 @@ static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool)
   pPool->node.prev = NULL;
   pPool->node.pnext = &pPool->pTail;
   pPool->node.size = size;
+  pPool->gen = atomic_add_fetch_64(&vnodeBufPoolGen, 1);
+  pPool->szFree = 0;
+  memset(pPool->aFree, 0, sizeof(pPool->aFree));
 
   *ppPool = pPool;
   return 0;
 }
 
 static int vnodeBufPoolDestroy(SVBufPool *pPool) {
+  SVBufPoolNode *pNode;
+
   vnodeBufPoolReset(pPool);
+  for (int32_t iClass = 0; iClass < VNODE_BUF_POOL_NCLASS; iClass++) {
+    while ((pNode = pPool->aFree[iClass]) != NULL) {
+      pPool->aFree[iClass] = pNode->prev;
+      taosMemoryFree(pNode);
+    }
+  }
   taosThreadSpinDestroy(&pPool->lock);
   taosMemoryFree(pPool);
   return 0;
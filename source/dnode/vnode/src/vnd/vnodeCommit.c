@@ -18,11 +18,18 @@
 #define VND_INFO_FNAME     "vnode.json"
 #define VND_INFO_FNAME_TMP "vnode_tmp.json"
 
+typedef struct {
+  SVnode    *pVnode;
+  SVnodeInfo info;
+  char       dir[TSDB_FILENAME_LEN];
+} SCommitInfo;
+
 static int  vnodeEncodeInfo(const SVnodeInfo *pInfo, char **ppData);
 static int  vnodeDecodeInfo(uint8_t *pData, SVnodeInfo *pInfo);
-static int  vnodeStartCommit(SVnode *pVnode);
-static int  vnodeEndCommit(SVnode *pVnode);
-static int  vnodeCommitImpl(void *arg);
+static int  vnodePrepareCommit(SVnode *pVnode, SCommitInfo *pInfo);
+static int  vnodeCommitImpl(SCommitInfo *pInfo);
+static int  vnodeCommitTask(void *arg);
+static int  vnodeCompactTask(void *arg);
 static void vnodeWaitCommit(SVnode *pVnode);
 
 int vnodeBegin(SVnode *pVnode) {
@@ -72,10 +79,22 @@ int vnodeBegin(SVnode *pVnode) {
 }
 
 int vnodeShouldCommit(SVnode *pVnode) {
-  if (pVnode->inUse) {
-    return pVnode->inUse->size > pVnode->config.szBuf / 3;
+  if (pVnode->inUse == NULL) {
+    return false;
+  }
+
+  int64_t size = pVnode->inUse->size;
+  if (size <= pVnode->config.szBuf / 3) {
+    return false;
   }
-  return false;
+
+  // tsdb keeps only one frozen memtable, so a new commit has to wait for the flush in flight. Keep writing to the
+  // working pool instead, it grows on the heap, and only block when it holds twice its share.
+  if (atomic_load_8(&pVnode->committing) && size <= pVnode->config.szBuf / 3 * 2) {
+    return false;
+  }
+
+  return true;
 }
 
 int vnodeSaveInfo(const char *dir, const SVnodeInfo *pInfo) {
@@ -196,39 +215,78 @@ _err:
 }
 
 int vnodeAsyncCommit(SVnode *pVnode) {
+  SCommitInfo *pInfo;
+
+  // rsma levels share the pool and are committed together with the sma state, keep them synchronous
+  if (VND_IS_RSMA(pVnode)) {
+    return vnodeSyncCommit(pVnode);
+  }
+
+  // at most one commit in flight, vnodeShouldCommit() defers the next one while the previous memtable is flushed and
+  // it only waits here once the working pool is full
   vnodeWaitCommit(pVnode);
+  atomic_store_8(&pVnode->committing, 1);
 
-  // vnodeBufPoolSwitch(pVnode);
-  // tsdbPrepareCommit(pVnode->pTsdb);
+  pInfo = (SCommitInfo *)taosMemoryCalloc(1, sizeof(*pInfo));
+  if (pInfo == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
 
-  vnodeScheduleTask(vnodeCommitImpl, pVnode);
+  if (vnodePrepareCommit(pVnode, pInfo) < 0) {
+    goto _err;
+  }
+
+  if (vnodeScheduleTask(vnodeCommitTask, pInfo) < 0) {
+    vError("vgId:%d, failed to schedule commit task, commit in place", TD_VID(pVnode));
+    vnodeCommitTask(pInfo);
+  }
 
   return 0;
+
+_err:
+  taosMemoryFree(pInfo);
+  atomic_store_8(&pVnode->committing, 0);
+  tsem_post(&(pVnode->canCommit));
+  ASSERT(0);
+  return -1;
 }
 
 int vnodeSyncCommit(SVnode *pVnode) {
-  vnodeAsyncCommit(pVnode);
+  SCommitInfo info = {0};
+  int         ret;
+
   vnodeWaitCommit(pVnode);
+
+  ret = vnodePrepareCommit(pVnode, &info);
+  if (ret == 0) {
+    ret = vnodeCommitImpl(&info);
+  }
+
   tsem_post(&(pVnode->canCommit));
-  return 0;
+  return ret;
 }
 
-int vnodeCommit(SVnode *pVnode) {
-  SVnodeInfo info = {0};
-  char       dir[TSDB_FILENAME_LEN];
-
+/**
+ * @brief Freeze the working buffer pool and memtables, runs in the write thread.
+ *
+ * Meta and tq are committed here since they are small, the tsdb memtable is only switched to imem and is flushed
+ * later by vnodeCommitImpl(). The next vnodeBegin() picks a free pool right away so ingestion is not blocked.
+ */
+static int vnodePrepareCommit(SVnode *pVnode, SCommitInfo *pInfo) {
   vInfo("vgId:%d, start to commit, commit ID:%" PRId64 " version:%" PRId64, TD_VID(pVnode), pVnode->state.commitID,
         pVnode->state.applied);
 
   pVnode->state.commitTerm = pVnode->state.applyTerm;
 
   // save info
-  info.config = pVnode->config;
-  info.state.committed = pVnode->state.applied;
-  info.state.commitTerm = pVnode->state.applyTerm;
-  info.state.commitID = pVnode->state.commitID;
-  snprintf(dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
-  if (vnodeSaveInfo(dir, &info) < 0) {
+  pInfo->pVnode = pVnode;
+  pInfo->info.config = pVnode->config;
+  pInfo->info.state.committed = pVnode->state.applied;
+  pInfo->info.state.commitTerm = pVnode->state.applyTerm;
+  pInfo->info.state.commitID = pVnode->state.commitID;
+  snprintf(pInfo->dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
+  if (vnodeSaveInfo(pInfo->dir, &pInfo->info) < 0) {
     ASSERT(0);
     return -1;
   }
@@ -236,11 +294,12 @@ int vnodeCommit(SVnode *pVnode) {
 
   // preCommit
   // smaSyncPreCommit(pVnode->pSma);
-  if(smaAsyncPreCommit(pVnode->pSma) < 0){
+  if (smaAsyncPreCommit(pVnode->pSma) < 0) {
     ASSERT(0);
     return -1;
   }
 
+  // the frozen memtables keep a reference to the pool until they are flushed
   vnodeBufPoolUnRef(pVnode->inUse);
   pVnode->inUse = NULL;
 
@@ -250,44 +309,68 @@ int vnodeCommit(SVnode *pVnode) {
     return -1;
   }
 
+  if (tqCommit(pVnode->pTq) < 0) {
+    ASSERT(0);
+    return -1;
+  }
+
+  if (VND_IS_RSMA(pVnode)) {
+    if (tsdbPrepareCommit(VND_RSMA0(pVnode)) < 0 || tsdbPrepareCommit(VND_RSMA1(pVnode)) < 0 ||
+        tsdbPrepareCommit(VND_RSMA2(pVnode)) < 0) {
+      ASSERT(0);
+      return -1;
+    }
+  } else {
+    if (tsdbPrepareCommit(pVnode->pTsdb) < 0) {
+      ASSERT(0);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Flush the frozen memtables and finish the commit, may run in the vnode-commit thread.
+ */
+static int vnodeCommitImpl(SCommitInfo *pInfo) {
+  SVnode *pVnode = pInfo->pVnode;
+  int64_t commitID = pInfo->info.state.commitID;
+
   if (VND_IS_RSMA(pVnode)) {
     if (smaAsyncCommit(pVnode->pSma) < 0) {
       ASSERT(0);
       return -1;
     }
 
-    if (tsdbCommit(VND_RSMA0(pVnode)) < 0) {
+    if (tsdbCommit(VND_RSMA0(pVnode), commitID) < 0) {
       ASSERT(0);
       return -1;
     }
-    if (tsdbCommit(VND_RSMA1(pVnode)) < 0) {
+    if (tsdbCommit(VND_RSMA1(pVnode), commitID) < 0) {
       ASSERT(0);
       return -1;
     }
-    if (tsdbCommit(VND_RSMA2(pVnode)) < 0) {
+    if (tsdbCommit(VND_RSMA2(pVnode), commitID) < 0) {
       ASSERT(0);
       return -1;
     }
   } else {
-    if (tsdbCommit(pVnode->pTsdb) < 0) {
+    if (tsdbCommit(pVnode->pTsdb, commitID) < 0) {
       ASSERT(0);
       return -1;
     }
   }
 
-  if (tqCommit(pVnode->pTq) < 0) {
-    ASSERT(0);
-    return -1;
-  }
   // walCommit (TODO)
 
   // commit info
-  if (vnodeCommitInfo(dir, &info) < 0) {
+  if (vnodeCommitInfo(pInfo->dir, &pInfo->info) < 0) {
     ASSERT(0);
     return -1;
   }
 
-  pVnode->state.committed = info.state.committed;
+  pVnode->state.committed = pInfo->info.state.committed;
 
   // postCommit
   // smaSyncPostCommit(pVnode->pSma);
@@ -299,34 +382,60 @@ int vnodeCommit(SVnode *pVnode) {
   // apply the commit (TODO)
   walEndSnapshot(pVnode->pWal);
 
-  vInfo("vgId:%d, commit end", TD_VID(pVnode));
+  vInfo("vgId:%d, commit end, commit ID:%" PRId64, TD_VID(pVnode), commitID);
 
   return 0;
 }
 
-static int vnodeCommitImpl(void *arg) {
-  SVnode *pVnode = (SVnode *)arg;
+static int vnodeCommitTask(void *arg) {
+  SCommitInfo *pInfo = (SCommitInfo *)arg;
+  SVnode      *pVnode = pInfo->pVnode;
+  bool         compact = false;
+
+  if (vnodeCommitImpl(pInfo) < 0) {
+    // the file sets may be half written, leave them alone until a commit goes through
+    vError("vgId:%d, failed to commit since %s, skip compaction", TD_VID(pVnode), tstrerror(terrno));
+  } else if (!VND_IS_RSMA(pVnode) && !atomic_load_8(&pVnode->compactStop) &&
+             tsdbShouldCompact(pVnode->pTsdb, pInfo->info.state.commitID)) {
+    // claimed under the slot so a closing vnode either sees the round or the round sees the stop
+    compact = (atomic_val_compare_exchange_8(&pVnode->compacting, 0, 1) == 0);
+  }
 
-  // metaCommit(pVnode->pMeta);
-  tqCommit(pVnode->pTq);
-  // tsdbCommit(pVnode->pTsdb, );
+  // the compaction runs on its own queue and takes the commit slot one file set at a time, a round already queued or
+  // running picks up the sets this commit left
+  if (compact && vnodeScheduleCompactTask(vnodeCompactTask, pInfo) < 0) {
+    vError("vgId:%d, failed to schedule compact task, skip it", TD_VID(pVnode));
+    atomic_store_8(&pVnode->compacting, 0);
+    compact = false;
+  }
 
-  // vnodeBufPoolRecycle(pVnode);
+  if (!compact) taosMemoryFree(pInfo);
+  atomic_store_8(&pVnode->committing, 0);
   tsem_post(&(pVnode->canCommit));
   return 0;
 }
 
-static int vnodeStartCommit(SVnode *pVnode) {
-  // TODO
-  return 0;
-}
+static int vnodeCompactTask(void *arg) {
+  SCommitInfo *pInfo = (SCommitInfo *)arg;
+  SVnode      *pVnode = pInfo->pVnode;
 
-static int vnodeEndCommit(SVnode *pVnode) {
-  // TODO
+  // a failure here leaves the committed data intact
+  int32_t code = tsdbCompact(pVnode->pTsdb, pInfo->info.state.commitID);
+  if (code) {
+    vError("vgId:%d, failed to compact tsdb since %s", TD_VID(pVnode), tstrerror(code));
+  }
+
+  taosMemoryFree(pInfo);
+  atomic_store_8(&pVnode->compacting, 0);
   return 0;
 }
 
-static FORCE_INLINE void vnodeWaitCommit(SVnode *pVnode) { tsem_wait(&pVnode->canCommit); }
+// commitWaiting tells a compaction holding the slot to give it up at its next check
+static FORCE_INLINE void vnodeWaitCommit(SVnode *pVnode) {
+  atomic_add_fetch_32(&pVnode->commitWaiting, 1);
+  tsem_wait(&pVnode->canCommit);
+  atomic_sub_fetch_32(&pVnode->commitWaiting, 1);
+}
 
 static int vnodeEncodeState(const void *pObj, SJson *pJson) {
   const SVState *pState = (SVState *)pObj;
@@ -23,21 +23,31 @@ struct SVnodeTask {
   void* arg;
 };
 
-struct SVnodeGlobal {
-  int8_t        init;
-  int8_t        stop;
+typedef struct {
+  const char*   name;
   int           nthreads;
   TdThread*     threads;
   TdThreadMutex mutex;
   TdThreadCond  hasTask;
   SVnodeTask    queue;
+} SVnodeTaskQueue;
+
+struct SVnodeGlobal {
+  int8_t          init;
+  int8_t          stop;
+  SVnodeTaskQueue commitQ;
+  SVnodeTaskQueue readQ;     // read-ahead of tsdb file blocks for queries
+  SVnodeTaskQueue compactQ;  // tsdb compaction, kept off the commit threads
 };
 
 struct SVnodeGlobal vnodeGlobal;
 
 static void* loop(void* arg);
+static int   vnodeTaskQueueOpen(SVnodeTaskQueue* pQueue, const char* name, int nthreads);
+static void  vnodeTaskQueueClose(SVnodeTaskQueue* pQueue);
+static int   vnodeTaskQueuePut(SVnodeTaskQueue* pQueue, int (*execute)(void*), void* arg);
 
-int vnodeInit(int nthreads) {
+int vnodeInit(int nthreads, int nReadThreads, int nCompactThreads) {
   int8_t init;
   int    ret;
 
@@ -48,22 +58,19 @@ int vnodeInit(int nthreads) {
 
   vnodeGlobal.stop = 0;
 
-  vnodeGlobal.queue.next = &vnodeGlobal.queue;
-  vnodeGlobal.queue.prev = &vnodeGlobal.queue;
-
-  vnodeGlobal.nthreads = nthreads;
-  vnodeGlobal.threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
-  if (vnodeGlobal.threads == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
+  if (vnodeTaskQueueOpen(&vnodeGlobal.commitQ, "vnode-commit", nthreads) < 0) {
     vError("failed to init vnode module since:%s", tstrerror(terrno));
     return -1;
   }
 
-  taosThreadMutexInit(&vnodeGlobal.mutex, NULL);
-  taosThreadCondInit(&vnodeGlobal.hasTask, NULL);
+  if (vnodeTaskQueueOpen(&vnodeGlobal.readQ, "vnode-prefetch", nReadThreads) < 0) {
+    vError("failed to init vnode module since:%s", tstrerror(terrno));
+    return -1;
+  }
 
-  for (int i = 0; i < nthreads; i++) {
-    taosThreadCreate(&(vnodeGlobal.threads[i]), NULL, loop, NULL);
+  if (vnodeTaskQueueOpen(&vnodeGlobal.compactQ, "vnode-compact", nCompactThreads) < 0) {
+    vError("failed to init vnode module since:%s", tstrerror(terrno));
+    return -1;
   }
 
   if (walInit() < 0) {
@@ -83,20 +90,10 @@ void vnodeCleanup() {
   if (init == 0) return;
 
   // set stop
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
   vnodeGlobal.stop = 1;
-  taosThreadCondBroadcast(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
-
-  // wait for threads
-  for (int i = 0; i < vnodeGlobal.nthreads; i++) {
-    taosThreadJoin(vnodeGlobal.threads[i], NULL);
-  }
-
-  // clear source
-  taosMemoryFreeClear(vnodeGlobal.threads);
-  taosThreadCondDestroy(&(vnodeGlobal.hasTask));
-  taosThreadMutexDestroy(&(vnodeGlobal.mutex));
+  vnodeTaskQueueClose(&vnodeGlobal.commitQ);
+  vnodeTaskQueueClose(&vnodeGlobal.readQ);
+  vnodeTaskQueueClose(&vnodeGlobal.compactQ);
 
   walCleanUp();
   tqCleanUp();
@@ -104,9 +101,75 @@ void vnodeCleanup() {
 }
 
 int vnodeScheduleTask(int (*execute)(void*), void* arg) {
-  SVnodeTask* pTask;
-
   ASSERT(!vnodeGlobal.stop);
+  return vnodeTaskQueuePut(&vnodeGlobal.commitQ, execute, arg);
+}
+
+int vnodeScheduleReadTask(int (*execute)(void*), void* arg) {
+  if (!vnodeGlobal.init || vnodeGlobal.stop || vnodeGlobal.readQ.nthreads <= 0) {
+    terrno = TSDB_CODE_APP_ERROR;
+    return -1;
+  }
+
+  return vnodeTaskQueuePut(&vnodeGlobal.readQ, execute, arg);
+}
+
+int vnodeScheduleCompactTask(int (*execute)(void*), void* arg) {
+  if (!vnodeGlobal.init || vnodeGlobal.stop || vnodeGlobal.compactQ.nthreads <= 0) {
+    terrno = TSDB_CODE_APP_ERROR;
+    return -1;
+  }
+
+  return vnodeTaskQueuePut(&vnodeGlobal.compactQ, execute, arg);
+}
+
+/* ------------------------ STATIC METHODS ------------------------ */
+static int vnodeTaskQueueOpen(SVnodeTaskQueue* pQueue, const char* name, int nthreads) {
+  pQueue->name = name;
+  pQueue->queue.next = &pQueue->queue;
+  pQueue->queue.prev = &pQueue->queue;
+  pQueue->nthreads = 0;
+
+  taosThreadMutexInit(&pQueue->mutex, NULL);
+  taosThreadCondInit(&pQueue->hasTask, NULL);
+
+  if (nthreads <= 0) {
+    return 0;
+  }
+
+  pQueue->threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
+  if (pQueue->threads == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  pQueue->nthreads = nthreads;
+  for (int i = 0; i < nthreads; i++) {
+    taosThreadCreate(&(pQueue->threads[i]), NULL, loop, pQueue);
+  }
+
+  return 0;
+}
+
+static void vnodeTaskQueueClose(SVnodeTaskQueue* pQueue) {
+  taosThreadMutexLock(&(pQueue->mutex));
+  taosThreadCondBroadcast(&(pQueue->hasTask));
+  taosThreadMutexUnlock(&(pQueue->mutex));
+
+  // wait for threads
+  for (int i = 0; i < pQueue->nthreads; i++) {
+    taosThreadJoin(pQueue->threads[i], NULL);
+  }
+
+  // clear source
+  taosMemoryFreeClear(pQueue->threads);
+  pQueue->nthreads = 0;
+  taosThreadCondDestroy(&(pQueue->hasTask));
+  taosThreadMutexDestroy(&(pQueue->mutex));
+}
+
+static int vnodeTaskQueuePut(SVnodeTaskQueue* pQueue, int (*execute)(void*), void* arg) {
+  SVnodeTask* pTask;
 
   pTask = taosMemoryMalloc(sizeof(*pTask));
   if (pTask == NULL) {
@@ -117,35 +180,35 @@ int vnodeScheduleTask(int (*execute)(void*), void* arg) {
   pTask->execute = execute;
   pTask->arg = arg;
 
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
-  pTask->next = &vnodeGlobal.queue;
-  pTask->prev = vnodeGlobal.queue.prev;
-  vnodeGlobal.queue.prev->next = pTask;
-  vnodeGlobal.queue.prev = pTask;
-  taosThreadCondSignal(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+  taosThreadMutexLock(&(pQueue->mutex));
+  pTask->next = &pQueue->queue;
+  pTask->prev = pQueue->queue.prev;
+  pQueue->queue.prev->next = pTask;
+  pQueue->queue.prev = pTask;
+  taosThreadCondSignal(&(pQueue->hasTask));
+  taosThreadMutexUnlock(&(pQueue->mutex));
 
   return 0;
 }
 
-/* ------------------------ STATIC METHODS ------------------------ */
 static void* loop(void* arg) {
-  SVnodeTask* pTask;
-  int         ret;
+  SVnodeTaskQueue* pQueue = (SVnodeTaskQueue*)arg;
+  SVnodeTask*      pTask;
+  int              ret;
 
-  setThreadName("vnode-commit");
+  setThreadName(pQueue->name);
 
   for (;;) {
-    taosThreadMutexLock(&(vnodeGlobal.mutex));
+    taosThreadMutexLock(&(pQueue->mutex));
     for (;;) {
-      pTask = vnodeGlobal.queue.next;
-      if (pTask == &vnodeGlobal.queue) {
+      pTask = pQueue->queue.next;
+      if (pTask == &pQueue->queue) {
         // no task
         if (vnodeGlobal.stop) {
-          taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+          taosThreadMutexUnlock(&(pQueue->mutex));
           return NULL;
         } else {
-          taosThreadCondWait(&(vnodeGlobal.hasTask), &(vnodeGlobal.mutex));
+          taosThreadCondWait(&(pQueue->hasTask), &(pQueue->mutex));
         }
       } else {
         // has task
@@ -155,7 +218,7 @@ static void* loop(void* arg) {
       }
     }
 
-    taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+    taosThreadMutexUnlock(&(pQueue->mutex));
 
     pTask->execute(pTask->arg);
     taosMemoryFree(pTask);
@@ -186,7 +186,12 @@ void vnodePreClose(SVnode *pVnode) {
 
 void vnodeClose(SVnode *pVnode) {
   if (pVnode) {
-    vnodeCommit(pVnode);
+    // a compaction round ends at its next check, wait for it to let go of the vnode
+    atomic_store_8(&pVnode->compactStop, 1);
+    while (atomic_load_8(&pVnode->compacting)) {
+      taosMsleep(10);
+    }
+    vnodeSyncCommit(pVnode);
     vnodeSyncClose(pVnode);
     vnodeQueryClose(pVnode);
     walClose(pVnode->pWal);
@@ -379,6 +379,10 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->numOfInsertSuccessReqs = 2;
   pLoad->numOfBatchInsertReqs = 5;
   pLoad->numOfBatchInsertSuccessReqs = 4;
+
+  size_t pgCacheUsage = 0;
+  tsdbPgCacheGetStat(pVnode, &pLoad->pgCacheHit, &pLoad->pgCacheMiss, &pgCacheUsage);
+  pLoad->pgCacheUsage = pgCacheUsage;
   return 0;
 }
 
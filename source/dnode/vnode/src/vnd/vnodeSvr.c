@@ -28,6 +28,7 @@ static int32_t vnodeProcessAlterHashRangeReq(SVnode *pVnode, int64_t version, vo
 static int32_t vnodeProcessAlterConfigReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessDropTtlTbReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessTrimReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
+static int32_t vnodeProcessCompactReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessDeleteReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 static int32_t vnodeProcessBatchDeleteReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp);
 
@@ -246,6 +247,9 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
       break;
     case TDMT_VND_COMMIT:
       goto _do_commit;
+    case TDMT_VND_COMPACT:
+      if (vnodeProcessCompactReq(pVnode, version, pReq, len, pRsp) < 0) goto _err;
+      goto _do_commit;
     default:
       ASSERT(0);
       break;
@@ -264,8 +268,8 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
   if (vnodeShouldCommit(pVnode)) {
   _do_commit:
     vInfo("vgId:%d, commit at version %" PRId64, TD_VID(pVnode), version);
-    // commit current change
-    vnodeCommit(pVnode);
+    // freeze current change, the flush runs in background
+    vnodeAsyncCommit(pVnode);
 
     // start a new one
     vnodeBegin(pVnode);
@@ -390,12 +394,37 @@ static int32_t vnodeProcessTrimReq(SVnode *pVnode, int64_t version, void *pReq,
 
   vInfo("vgId:%d, trim vnode request will be processed, time:%d", pVnode->config.vgId, trimReq.timestamp);
 
+  // retention rewrites the file sets, wait for the background commit
+  tsem_wait(&pVnode->canCommit);
+
   // process
   code = tsdbDoRetention(pVnode->pTsdb, trimReq.timestamp);
-  if (code) goto _exit;
+  if (code) goto _post;
 
   code = smaDoRetention(pVnode->pSma, trimReq.timestamp);
-  if (code) goto _exit;
+  if (code) goto _post;
+
+_post:
+  tsem_post(&pVnode->canCommit);
+
+_exit:
+  return code;
+}
+
+static int32_t vnodeProcessCompactReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
+  int32_t          code = 0;
+  SCompactVnodeReq compactReq = {0};
+
+  // decode
+  if (tDeserializeSCompactVnodeReq(pReq, len, &compactReq) != 0) {
+    code = TSDB_CODE_INVALID_MSG;
+    goto _exit;
+  }
+
+  vInfo("vgId:%d, compact vnode request will be processed, db:%s", pVnode->config.vgId, compactReq.db);
+
+  // process, the compaction itself is scheduled once the commit right after is done
+  tsdbScheduleCompact(pVnode->pTsdb);
 
 _exit:
   return code;
@@ -16,8 +16,6 @@
 #define _DEFAULT_SOURCE
 #include "vnd.h"
 
-#define BATCH_DISABLE 1
-
 static inline bool vnodeIsMsgBlock(tmsg_t type) {
   return (type == TDMT_VND_CREATE_TABLE) || (type == TDMT_VND_ALTER_TABLE) || (type == TDMT_VND_DROP_TABLE) ||
          (type == TDMT_VND_UPDATE_TAG_VAL) || (type == TDMT_VND_ALTER_REPLICA);
@@ -190,11 +188,12 @@ static void vnodeHandleAlterReplicaReq(SVnode *pVnode, SRpcMsg *pMsg) {
 static void inline vnodeProposeBatchMsg(SVnode *pVnode, SRpcMsg **pMsgArr, bool *pIsWeakArr, int32_t *arrSize) {
   if (*arrSize <= 0) return;
 
-#if BATCH_DISABLE
-  int32_t code = syncPropose(pVnode->sync, pMsgArr[0], pIsWeakArr[0]);
-#else
-  int32_t code = syncProposeBatch(pVnode->sync, pMsgArr, pIsWeakArr, *arrSize);
-#endif
+  int32_t code = 0;
+  if (*arrSize == 1) {
+    code = syncPropose(pVnode->sync, pMsgArr[0], pIsWeakArr[0]);
+  } else {
+    code = syncProposeBatch(pVnode->sync, pMsgArr, pIsWeakArr, *arrSize);
+  }
 
   if (code > 0) {
     for (int32_t i = 0; i < *arrSize; ++i) {
@@ -209,6 +208,7 @@ static void inline vnodeProposeBatchMsg(SVnode *pVnode, SRpcMsg **pMsgArr, bool
     }
   }
 
+  // the contents of an enqueued batch moved to the sync queue, pCont is NULL for them
   for (int32_t i = 0; i < *arrSize; ++i) {
     SRpcMsg        *pMsg = pMsgArr[i];
     const STraceId *trace = &pMsg->info.traceId;
@@ -226,6 +226,7 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
   int32_t   code = 0;
   SRpcMsg  *pMsg = NULL;
   int32_t   arrayPos = 0;
+  int32_t   batchSize = TMAX(1, TMIN(tsSyncProposeBatch, SYNC_MAX_BATCH_SIZE));
   SRpcMsg **pMsgArr = taosMemoryCalloc(numOfMsgs, sizeof(SRpcMsg *));
   bool     *pIsWeakArr = taosMemoryCalloc(numOfMsgs, sizeof(bool));
   vTrace("vgId:%d, get %d msgs from vnode-write queue", vgId, numOfMsgs);
@@ -265,24 +266,28 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
       continue;
     }
 
+    // a block msg is proposed alone, after the msgs before it
+    if (isBlock) {
+      vnodeProposeBatchMsg(pVnode, pMsgArr, pIsWeakArr, &arrayPos);
+    }
+
     if (pMsg->msgType == TDMT_VND_ALTER_REPLICA) {
       vnodeHandleAlterReplicaReq(pVnode, pMsg);
       continue;
     }
 
-    if (isBlock || BATCH_DISABLE) {
-      vnodeProposeBatchMsg(pVnode, pMsgArr, pIsWeakArr, &arrayPos);
-    }
-
     pMsgArr[arrayPos] = pMsg;
     pIsWeakArr[arrayPos] = isWeak;
     arrayPos++;
 
-    if (isBlock || msg == numOfMsgs - 1 || BATCH_DISABLE) {
+    if (isBlock || arrayPos >= batchSize) {
       vnodeProposeBatchMsg(pVnode, pMsgArr, pIsWeakArr, &arrayPos);
     }
   }
 
+  // the last msgs may be skipped above, propose what is left
+  vnodeProposeBatchMsg(pVnode, pMsgArr, pIsWeakArr, &arrayPos);
+
   taosMemoryFree(pMsgArr);
   taosMemoryFree(pIsWeakArr);
 }
@@ -424,7 +429,7 @@ int32_t vnodeProcessSyncMsg(SVnode *pVnode, SRpcMsg *pMsg, SRpcMsg **pRsp) {
       SyncClientRequestBatch *pSyncMsg = syncClientRequestBatchFromRpcMsg(pMsg);
       ASSERT(pSyncMsg != NULL);
       code = syncNodeOnClientRequestBatchCb(pSyncNode, pSyncMsg);
-      syncClientRequestBatchDestroy(pSyncMsg);
+      syncClientRequestBatchDestroyDeep(pSyncMsg);
     } else if (pMsg->msgType == TDMT_SYNC_REQUEST_VOTE) {
       SyncRequestVote *pSyncMsg = syncRequestVoteFromRpcMsg2(pMsg);
       ASSERT(pSyncMsg != NULL);
@@ -733,6 +738,10 @@ int32_t vnodeSyncOpen(SVnode *pVnode, char *path) {
       .snapshotStrategy = SYNC_STRATEGY_WAL_FIRST,
       //.snapshotStrategy = SYNC_STRATEGY_NO_SNAPSHOT,
       .batchSize = 1,
+      .pipelineEntries = tsSyncPipelineEntries,
+      .pipelineBytes = tsSyncPipelineSize * 1024 * 1024,
+      .logCacheEntries = tsSyncLogCacheEntries,
+      .logCacheBytes = (int64_t)tsSyncLogCacheSize * 1024 * 1024,
       .vgId = pVnode->config.vgId,
       .isStandBy = pVnode->config.standby,
       .syncCfg = pVnode->config.syncCfg,
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <taoserror.h>
+#include <tglobal.h>
+
+#include "meta.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+const char   *TEST_DIR = "metaTagStoreTest";
+const int32_t NULL_TAG = INT32_MIN;
+const int64_t MB = 1024 * 1024;
+
+// the same key orders as metaOpen.c
+int tbDbKeyCmpr(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  const STbDbKey *pKey1_ = (const STbDbKey *)pKey1;
+  const STbDbKey *pKey2_ = (const STbDbKey *)pKey2;
+  if (pKey1_->version != pKey2_->version) return pKey1_->version > pKey2_->version ? 1 : -1;
+  if (pKey1_->uid != pKey2_->uid) return pKey1_->uid > pKey2_->uid ? 1 : -1;
+  return 0;
+}
+
+int uidIdxKeyCmpr(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  tb_uid_t uid1 = *(const tb_uid_t *)pKey1;
+  tb_uid_t uid2 = *(const tb_uid_t *)pKey2;
+  if (uid1 != uid2) return uid1 > uid2 ? 1 : -1;
+  return 0;
+}
+
+int ctbIdxKeyCmpr(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  const SCtbIdxKey *pKey1_ = (const SCtbIdxKey *)pKey1;
+  const SCtbIdxKey *pKey2_ = (const SCtbIdxKey *)pKey2;
+  if (pKey1_->suid != pKey2_->suid) return pKey1_->suid > pKey2_->suid ? 1 : -1;
+  if (pKey1_->uid != pKey2_->uid) return pKey1_->uid > pKey2_->uid ? 1 : -1;
+  return 0;
+}
+
+// the tags of a child table, t1 is an int tag and t2 a varchar tag
+struct STestTags {
+  int32_t     t1;
+  std::string t2;
+  std::string name;
+
+  bool operator==(const STestTags &o) const { return t1 == o.t1 && t2 == o.t2 && name == o.name; }
+};
+
+class MetaTagStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    storeSize = tsTagColumnarStoreSize;
+    taosRemoveDir(TEST_DIR);
+    taosMkDir(TEST_DIR);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pMeta = (SMeta *)taosMemoryCalloc(1, sizeof(SMeta));
+    pMeta->pVnode = pVnode;
+    taosThreadRwlockInit(&pMeta->lock, NULL);
+
+    ASSERT_EQ(tdbOpen(TEST_DIR, 4096, 4096, &pMeta->pEnv), 0);
+    ASSERT_EQ(tdbTbOpen("table.db", sizeof(STbDbKey), -1, tbDbKeyCmpr, pMeta->pEnv, &pMeta->pTbDb), 0);
+    ASSERT_EQ(tdbTbOpen("uid.idx", sizeof(tb_uid_t), sizeof(SUidIdxVal), uidIdxKeyCmpr, pMeta->pEnv, &pMeta->pUidIdx),
+              0);
+    ASSERT_EQ(tdbTbOpen("ctb.idx", sizeof(SCtbIdxKey), -1, ctbIdxKeyCmpr, pMeta->pEnv, &pMeta->pCtbIdx), 0);
+    ASSERT_EQ(metaBegin(pMeta, 1), 0);
+    ASSERT_EQ(metaTagStoreOpen(pMeta), 0);
+  }
+
+  void TearDown() override {
+    metaTagStoreClose(pMeta);
+    metaCommit(pMeta);
+    tdbTbClose(pMeta->pCtbIdx);
+    tdbTbClose(pMeta->pUidIdx);
+    tdbTbClose(pMeta->pTbDb);
+    tdbClose(pMeta->pEnv);
+    taosThreadRwlockDestroy(&pMeta->lock);
+    taosMemoryFree(pMeta);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(TEST_DIR);
+    tsTagColumnarStoreSize = storeSize;
+  }
+
+  void putEntry(const SMetaEntry *pEntry, tb_uid_t suid) {
+    int32_t vLen = 0;
+    int32_t ret = 0;
+    tEncodeSize(metaEncodeEntry, pEntry, vLen, ret);
+    ASSERT_EQ(ret, 0);
+
+    std::vector<uint8_t> buf(vLen);
+    SEncoder             coder = {0};
+    tEncoderInit(&coder, buf.data(), vLen);
+    ASSERT_EQ(metaEncodeEntry(&coder, pEntry), 0);
+    tEncoderClear(&coder);
+
+    STbDbKey   tbDbKey = {.version = pEntry->version, .uid = pEntry->uid};
+    SUidIdxVal uidIdxVal = {.suid = suid, .version = pEntry->version, .skmVer = 0};
+    ASSERT_EQ(tdbTbUpsert(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), buf.data(), vLen, &pMeta->txn), 0);
+    ASSERT_EQ(tdbTbUpsert(pMeta->pUidIdx, &pEntry->uid, sizeof(tb_uid_t), &uidIdxVal, sizeof(uidIdxVal), &pMeta->txn),
+              0);
+  }
+
+  void createStb(tb_uid_t suid, int32_t t2Bytes = 32) {
+    SSchema aRow[2] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .flags = 0, .colId = 1, .bytes = 8},
+                       {.type = TSDB_DATA_TYPE_INT, .flags = 0, .colId = 2, .bytes = 4}};
+    SSchema aTag[2] = {{.type = TSDB_DATA_TYPE_INT, .flags = 0, .colId = 3, .bytes = 4},
+                       {.type = TSDB_DATA_TYPE_VARCHAR, .flags = 0, .colId = 4, .bytes = t2Bytes + VARSTR_HEADER_SIZE}};
+    std::string name = "stb" + std::to_string(suid);
+
+    SMetaEntry me = {0};
+    me.version = 1;
+    me.type = TSDB_SUPER_TABLE;
+    me.uid = suid;
+    me.name = (char *)name.c_str();
+    me.stbEntry.schemaRow = {.nCols = 2, .version = 1, .pSchema = aRow};
+    me.stbEntry.schemaTag = {.nCols = 2, .version = 1, .pSchema = aTag};
+    putEntry(&me, suid);
+  }
+
+  // the entry goes to the store as metaTable.c does if toStore is set, or only to the meta tables
+  void createCtb(tb_uid_t suid, tb_uid_t uid, int32_t t1, const std::string &t2, bool toStore = true) {
+    SArray *pTagVals = taosArrayInit(2, sizeof(STagVal));
+    if (t1 != NULL_TAG) {
+      STagVal tagVal = {.cid = 3, .type = TSDB_DATA_TYPE_INT};
+      tagVal.i64 = t1;
+      taosArrayPush(pTagVals, &tagVal);
+    }
+    STagVal tagVal = {.cid = 4, .type = TSDB_DATA_TYPE_VARCHAR};
+    tagVal.pData = (uint8_t *)t2.c_str();
+    tagVal.nData = t2.size();
+    taosArrayPush(pTagVals, &tagVal);
+
+    STag *pTag = NULL;
+    ASSERT_EQ(tTagNew(pTagVals, 1, 0, &pTag), 0);
+    taosArrayDestroy(pTagVals);
+
+    std::string name = "ctb" + std::to_string(uid);
+    SMetaEntry  me = {0};
+    me.version = 1;
+    me.type = TSDB_CHILD_TABLE;
+    me.uid = uid;
+    me.name = (char *)name.c_str();
+    me.ctbEntry.suid = suid;
+    me.ctbEntry.pTags = (uint8_t *)pTag;
+    putEntry(&me, suid);
+
+    SCtbIdxKey ctbIdxKey = {.suid = suid, .uid = uid};
+    ASSERT_EQ(tdbTbUpsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), pTag, pTag->len, &pMeta->txn), 0);
+    if (toStore) {
+      metaTagStoreUpsert(pMeta, &me);
+    }
+    tTagFree(pTag);
+  }
+
+  // read t1, t2 and the table name of the tables in aUid, or of all child tables if aUid is empty
+  int32_t getTags(tb_uid_t suid, const std::vector<tb_uid_t> &aUid, std::vector<STestTags> &res) {
+    SSDataBlock    *pBlock = createDataBlock();
+    SColumnInfoData t1 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 3);
+    SColumnInfoData t2 = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 256, 4);
+    SColumnInfoData name = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE, -1);
+    blockDataAppendColInfo(pBlock, &t1);
+    blockDataAppendColInfo(pBlock, &t2);
+    blockDataAppendColInfo(pBlock, &name);
+
+    SArray *uidList = taosArrayInit(aUid.size(), sizeof(tb_uid_t));
+    for (tb_uid_t uid : aUid) {
+      taosArrayPush(uidList, &uid);
+    }
+
+    res.clear();
+    int32_t code = metaGetTableTagColumns(pMeta, suid, uidList, pBlock);
+    for (int32_t i = 0; code == 0 && i < pBlock->info.rows; i++) {
+      SColumnInfoData *pT1 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+      SColumnInfoData *pT2 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+      SColumnInfoData *pName = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2);
+
+      STestTags tags = {NULL_TAG, "NULL", "NULL"};
+      if (!colDataIsNull_s(pT1, i)) tags.t1 = *(int32_t *)colDataGetData(pT1, i);
+      if (!colDataIsNull_s(pT2, i)) {
+        char *p = colDataGetData(pT2, i);
+        tags.t2.assign(varDataVal(p), varDataLen(p));
+      }
+      if (!colDataIsNull_s(pName, i)) {
+        char *p = colDataGetData(pName, i);
+        tags.name.assign(varDataVal(p), varDataLen(p));
+      }
+      res.push_back(tags);
+    }
+
+    taosArrayDestroy(uidList);
+    blockDataDestroy(pBlock);
+    return code;
+  }
+
+  // a super table with numOfCtb child tables, each with its own t2 of t2Len chars
+  void createStbWithCtbs(tb_uid_t suid, int32_t numOfCtb, int32_t t2Len) {
+    createStb(suid, t2Len);
+    for (int32_t i = 0; i < numOfCtb; i++) {
+      std::string t2 = std::to_string(i);
+      t2.insert(0, t2Len - t2.size(), 'x');
+      createCtb(suid, suid + 1 + i, i, t2, false);
+    }
+  }
+
+  SVnode *pVnode = NULL;
+  SMeta  *pMeta = NULL;
+
+ private:
+  int32_t storeSize;
+};
+
+}  // namespace
+
+TEST_F(MetaTagStoreTest, tagColumns) {
+  createStb(100);
+  createCtb(100, 101, 1, "a");
+  createCtb(100, 102, NULL_TAG, "b");
+  createCtb(100, 103, 3, "a");
+
+  std::vector<STestTags> res;
+  ASSERT_EQ(getTags(100, {103, 101, 102}, res), 0);
+  std::vector<STestTags> expect = {{3, "a", "ctb103"}, {1, "a", "ctb101"}, {NULL_TAG, "b", "ctb102"}};
+  ASSERT_EQ(res, expect);
+
+  // the store is kept in sync once built
+  createCtb(100, 104, 4, "c");
+  ASSERT_EQ(getTags(100, {}, res), 0);
+  ASSERT_EQ(res.size(), 4);
+  ASSERT_EQ(res[3], (STestTags{4, "c", "ctb104"}));
+}
+
+TEST_F(MetaTagStoreTest, missedTable) {
+  createStb(100);
+  createCtb(100, 101, 1, "a");
+
+  std::vector<STestTags> res;
+  ASSERT_EQ(getTags(100, {101}, res), 0);
+
+  // a table the store does not know is read from meta, a table not in meta has NULL tags
+  createCtb(100, 102, 2, "b", false);
+  ASSERT_EQ(getTags(100, {102, 101, 999}, res), 0);
+  std::vector<STestTags> expect = {{2, "b", "ctb102"}, {1, "a", "ctb101"}, {NULL_TAG, "NULL", "NULL"}};
+  ASSERT_EQ(res, expect);
+}
+
+TEST_F(MetaTagStoreTest, evictLeastRecentlyUsed) {
+  tsTagColumnarStoreSize = 1;
+  const int32_t  numOfCtb = 1000;
+  const tb_uid_t base = 100000;  // the same number of digits in all table names, so that the stores are of one size
+
+  std::vector<STestTags> res;
+  createStbWithCtbs(base, numOfCtb, 16);
+  ASSERT_EQ(getTags(base, {}, res), 0);
+  ASSERT_EQ(res.size(), numOfCtb);
+
+  // fill the bound with super tables of the same shape
+  int64_t size = metaTagStoreMemSize(pMeta, base);
+  int32_t numOfStb = MB / size;
+  ASSERT_GE(numOfStb, 2);
+  ASSERT_LE(numOfStb, 8);
+  for (int32_t i = 1; i < numOfStb; i++) {
+    tb_uid_t suid = base * (i + 1);
+    createStbWithCtbs(suid, numOfCtb, 16);
+    ASSERT_EQ(getTags(suid, {}, res), 0);
+    ASSERT_EQ(metaTagStoreMemSize(pMeta, suid), size);
+  }
+  ASSERT_EQ(metaTagStoreMemSize(pMeta, 0), size * numOfStb);
+
+  // the first one is used again, the second one is the least recently used
+  ASSERT_EQ(getTags(base, {base + 1}, res), 0);
+  tb_uid_t suid = base * (numOfStb + 1);
+  createStbWithCtbs(suid, numOfCtb, 16);
+  ASSERT_EQ(getTags(suid, {}, res), 0);
+
+  ASSERT_EQ(metaTagStoreMemSize(pMeta, base * 2), 0);
+  ASSERT_EQ(metaTagStoreMemSize(pMeta, base), size);
+  ASSERT_EQ(metaTagStoreMemSize(pMeta, suid), size);
+  ASSERT_LE(metaTagStoreMemSize(pMeta, 0), MB);
+
+  // the evicted one is built again on the next use
+  ASSERT_EQ(getTags(base * 2, {base * 2 + 1, base * 2 + 2}, res), 0);
+  std::vector<STestTags> expect = {{0, "xxxxxxxxxxxxxxx0", "ctb200001"}, {1, "xxxxxxxxxxxxxxx1", "ctb200002"}};
+  ASSERT_EQ(res, expect);
+}
+
+TEST_F(MetaTagStoreTest, overBound) {
+  tsTagColumnarStoreSize = 1;
+
+  // the dictionary of t2 alone is over the bound
+  std::vector<STestTags> res;
+  createStbWithCtbs(1000000, 6000, 200);
+  ASSERT_EQ(getTags(1000000, {1000001}, res), TSDB_CODE_NOT_FOUND);
+  ASSERT_GT(metaTagStoreMemSize(pMeta, 1000000), 0);
+  ASSERT_LT(metaTagStoreMemSize(pMeta, 1000000), 1024);
+
+  // not built again, until the super table is altered
+  ASSERT_EQ(getTags(1000000, {1000001}, res), TSDB_CODE_NOT_FOUND);
+  metaTagStoreDrop(pMeta, 1000000);
+  ASSERT_EQ(metaTagStoreMemSize(pMeta, 0), 0);
+}
+
+#pragma GCC diagnostic pop
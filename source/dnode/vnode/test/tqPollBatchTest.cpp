@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stddef.h>
+
+#include <taoserror.h>
+#include <tglobal.h>
+
+#include "tq.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST(TqPollBatchTest, pollReqLayout) {
+  // old consumers send the struct without the batch fields, the fields before them must not move
+  ASSERT_GT(offsetof(SMqPollReq, compressed), offsetof(SMqPollReq, reqOffset));
+  ASSERT_GT(offsetof(SMqPollReq, batchRows), offsetof(SMqPollReq, reqOffset));
+  ASSERT_GT(offsetof(SMqPollReq, batchBytes), offsetof(SMqPollReq, reqOffset));
+}
+
+TEST(TqPollBatchTest, defaultLimits) {
+  SMqPollReq   req = {0};
+  STqPollBatch batch;
+  tqPollBatchInit(&batch, &req, sizeof(req));
+
+  ASSERT_EQ(batch.compressed, 0);
+  ASSERT_EQ(batch.maxRows, TQ_POLL_BATCH_ROWS);
+  ASSERT_EQ(batch.maxBytes, TQ_POLL_BATCH_BYTES);
+  ASSERT_EQ(batch.rows, 0);
+  ASSERT_EQ(batch.bytes, 0);
+  ASSERT_FALSE(tqPollBatchIsFull(&batch));
+
+  req.batchRows = -1;
+  req.batchBytes = -1;
+  tqPollBatchInit(&batch, &req, sizeof(req));
+  ASSERT_EQ(batch.maxRows, TQ_POLL_BATCH_ROWS);
+  ASSERT_EQ(batch.maxBytes, TQ_POLL_BATCH_BYTES);
+}
+
+TEST(TqPollBatchTest, oldLayoutReq) {
+  // an old consumer's msg ends at reqOffset, whatever follows it in the buffer is not part of the request
+  SMqPollReq *pReq = (SMqPollReq *)taosMemoryMalloc(sizeof(SMqPollReq));
+  ASSERT_NE(pReq, nullptr);
+  memset(pReq, 0xff, sizeof(SMqPollReq));
+
+  STqPollBatch batch;
+  tqPollBatchInit(&batch, pReq, offsetof(SMqPollReq, compressed));
+  ASSERT_EQ(batch.compressed, 0);
+  ASSERT_EQ(batch.maxRows, TQ_POLL_BATCH_ROWS);
+  ASSERT_EQ(batch.maxBytes, TQ_POLL_BATCH_BYTES);
+
+  // a msg cut inside the batch fields keeps the ones it covers
+  pReq->compressed = 1;
+  pReq->batchRows = 100;
+  tqPollBatchInit(&batch, pReq, offsetof(SMqPollReq, batchBytes));
+  ASSERT_EQ(batch.compressed, 1);
+  ASSERT_EQ(batch.maxRows, 100);
+  ASSERT_EQ(batch.maxBytes, TQ_POLL_BATCH_BYTES);
+
+  pReq->batchBytes = 4096;
+  tqPollBatchInit(&batch, pReq, sizeof(SMqPollReq));
+  ASSERT_EQ(batch.maxBytes, 4096);
+
+  taosMemoryFree(pReq);
+}
+
+TEST(TqPollBatchTest, rowsLimit) {
+  SMqPollReq req = {0};
+  req.compressed = 1;
+  req.batchRows = 100;
+
+  STqPollBatch batch;
+  tqPollBatchInit(&batch, &req, sizeof(req));
+  ASSERT_EQ(batch.compressed, 1);
+  ASSERT_EQ(batch.maxRows, 100);
+
+  tqPollBatchAdd(&batch, 60, 1024);
+  ASSERT_FALSE(tqPollBatchIsFull(&batch));
+  tqPollBatchAdd(&batch, 39, 1024);
+  ASSERT_FALSE(tqPollBatchIsFull(&batch));
+  tqPollBatchAdd(&batch, 1, 1024);
+  ASSERT_TRUE(tqPollBatchIsFull(&batch));
+
+  // a new poll starts empty
+  tqPollBatchInit(&batch, &req, sizeof(req));
+  ASSERT_FALSE(tqPollBatchIsFull(&batch));
+}
+
+TEST(TqPollBatchTest, bytesLimit) {
+  SMqPollReq req = {0};
+  req.batchBytes = 4096;
+
+  STqPollBatch batch;
+  tqPollBatchInit(&batch, &req, sizeof(req));
+  ASSERT_EQ(batch.maxRows, TQ_POLL_BATCH_ROWS);
+  ASSERT_EQ(batch.maxBytes, 4096);
+
+  tqPollBatchAdd(&batch, 1, 4000);
+  ASSERT_FALSE(tqPollBatchIsFull(&batch));
+  tqPollBatchAdd(&batch, 1, 96);
+  ASSERT_TRUE(tqPollBatchIsFull(&batch));
+  ASSERT_EQ(batch.rows, 2);
+}
+
+TEST(TqPollBatchTest, flushBeforeMeta) {
+  STaosxRsp rsp = {0};
+  tqOffsetResetToLog(&rsp.rspOffset, 10);
+
+  // nothing collected, the meta msg is sent by this poll
+  ASSERT_FALSE(tqPollBatchFlushBeforeMeta(&rsp, 20));
+  ASSERT_EQ(rsp.rspOffset.type, TMQ_OFFSET__LOG);
+  ASSERT_EQ(rsp.rspOffset.version, 10);
+
+  // the data goes first and ends right before the meta msg
+  rsp.blockNum = 3;
+  const int64_t metaVer = 20;
+  ASSERT_TRUE(tqPollBatchFlushBeforeMeta(&rsp, metaVer));
+  ASSERT_EQ(rsp.rspOffset.type, TMQ_OFFSET__LOG);
+  ASSERT_EQ(rsp.rspOffset.version, metaVer - 1);
+
+  // the next poll fetches from the offset + 1, which is the meta msg
+  STqOffsetVal next = rsp.rspOffset;
+  ASSERT_EQ(next.version + 1, metaVer);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <taoserror.h>
+#include <tglobal.h>
+
+#include "tsdb.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+const int64_t TEST_COMMIT_ID = 10;
+const int64_t MB = 1024 * 1024;
+
+// a file set last written by commit 1 with one stt file per entry of aSttSize, a size of 0 is a header-only stt
+class SCompactFSet {
+ public:
+  SCompactFSet(const std::vector<int64_t> &aSttSize, int64_t commitID = 1) {
+    memset(&fSet, 0, sizeof(fSet));
+    memset(&fHead, 0, sizeof(fHead));
+    memset(&fData, 0, sizeof(fData));
+    memset(&fSma, 0, sizeof(fSma));
+    memset(aStt, 0, sizeof(aStt));
+
+    fHead.commitID = commitID;
+    fHead.size = MB;
+    fData.size = 64 * MB;
+    fSma.size = MB;
+
+    fSet.fid = 1;
+    fSet.pHeadF = &fHead;
+    fSet.pDataF = &fData;
+    fSet.pSmaF = &fSma;
+    fSet.nSttF = aSttSize.size();
+    for (int32_t iStt = 0; iStt < fSet.nSttF; iStt++) {
+      aStt[iStt].offset = TSDB_FHDR_SIZE;
+      aStt[iStt].size = TSDB_FHDR_SIZE + aSttSize[iStt];
+      fSet.aSttF[iStt] = &aStt[iStt];
+    }
+  }
+
+  SDFileSet *get() { return &fSet; }
+
+ private:
+  SDFileSet fSet;
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  SSttFile  aStt[TSDB_MAX_STT_FILE];
+};
+
+class TsdbCompactTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sttTrigger = tsCompactSttTrigger;
+    sttSizeMB = tsCompactSttSizeMB;
+    tsCompactSttTrigger = 4;
+    tsCompactSttSizeMB = 64;
+  }
+
+  void TearDown() override {
+    tsCompactSttTrigger = sttTrigger;
+    tsCompactSttSizeMB = sttSizeMB;
+  }
+
+ private:
+  int32_t sttTrigger;
+  int32_t sttSizeMB;
+};
+
+}  // namespace
+
+TEST_F(TsdbCompactTest, sttCountTrigger) {
+  SCompactFSet below({MB, MB, MB});
+  EXPECT_FALSE(tsdbShouldCompactFSet(below.get(), TEST_COMMIT_ID, 0));
+
+  SCompactFSet reach({MB, MB, MB, MB});
+  EXPECT_TRUE(tsdbShouldCompactFSet(reach.get(), TEST_COMMIT_ID, 0));
+
+  // header-only stt files do not count
+  SCompactFSet empty({MB, 0, MB, 0, MB});
+  EXPECT_FALSE(tsdbShouldCompactFSet(empty.get(), TEST_COMMIT_ID, 0));
+}
+
+TEST_F(TsdbCompactTest, sttSizeTrigger) {
+  SCompactFSet below({32 * MB, 31 * MB});
+  EXPECT_FALSE(tsdbShouldCompactFSet(below.get(), TEST_COMMIT_ID, 0));
+
+  SCompactFSet reach({32 * MB, 32 * MB});
+  EXPECT_TRUE(tsdbShouldCompactFSet(reach.get(), TEST_COMMIT_ID, 0));
+
+  // the data file size alone never triggers a rewrite
+  SCompactFSet noStt({0});
+  noStt.get()->pDataF->size = 1024 * MB;
+  EXPECT_FALSE(tsdbShouldCompactFSet(noStt.get(), TEST_COMMIT_ID, 0));
+}
+
+TEST_F(TsdbCompactTest, periodicRound) {
+  // a due round only picks up sets fragmented over more than one stt file
+  SCompactFSet one({MB});
+  EXPECT_FALSE(tsdbShouldCompactFSet(one.get(), TEST_COMMIT_ID, 1));
+
+  SCompactFSet two({MB, MB});
+  EXPECT_FALSE(tsdbShouldCompactFSet(two.get(), TEST_COMMIT_ID, 0));
+  EXPECT_TRUE(tsdbShouldCompactFSet(two.get(), TEST_COMMIT_ID, 1));
+
+  SCompactFSet none({0});
+  EXPECT_FALSE(tsdbShouldCompactFSet(none.get(), TEST_COMMIT_ID, 1));
+}
+
+TEST_F(TsdbCompactTest, skipCurrentCommit) {
+  // the files of the commit that scheduled the compaction carry its ID, rewriting them would collide
+  SCompactFSet current({MB, MB, MB, MB, 64 * MB}, TEST_COMMIT_ID);
+  EXPECT_FALSE(tsdbShouldCompactFSet(current.get(), TEST_COMMIT_ID, 1));
+  EXPECT_TRUE(tsdbShouldCompactFSet(current.get(), TEST_COMMIT_ID + 1, 0));
+}
+
+TEST_F(TsdbCompactTest, skipAnyFileOfCommit) {
+  // a set gets files of the compaction's commit ID from the commit or from an earlier set of the same round
+  SCompactFSet stt({MB, MB, MB, MB, 64 * MB});
+  stt.get()->aSttF[4]->commitID = TEST_COMMIT_ID;
+  EXPECT_FALSE(tsdbShouldCompactFSet(stt.get(), TEST_COMMIT_ID, 1));
+
+  SCompactFSet data({MB, MB, MB, MB});
+  data.get()->pDataF->commitID = TEST_COMMIT_ID;
+  EXPECT_FALSE(tsdbShouldCompactFSet(data.get(), TEST_COMMIT_ID, 1));
+  EXPECT_TRUE(tsdbShouldCompactFSet(data.get(), TEST_COMMIT_ID + 1, 0));
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <tglobal.h>
+
+#include "tsdb.h"
+#include "vnode.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  if (vnodeInit(1, 2, 1) != 0) {
+    return -1;
+  }
+  int ret = RUN_ALL_TESTS();
+  vnodeCleanup();
+  return ret;
+}
+
+namespace {
+
+const uint64_t TEST_UID = 100;
+const int32_t  FAIL_ROWS = -1;
+const int32_t  MAX_LOAD = 64;
+
+// the fake loader marks the data with the row count of the block, so a taken block can be matched to its load
+int32_t nLoad = 0;
+int32_t aLoad[MAX_LOAD];
+int32_t loadDelayMs = 0;
+
+int32_t fakeLoadBlock(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet, SDataBlk *pBlock,
+                      SBlockData *pBlockData) {
+  if (loadDelayMs > 0) taosMsleep(loadDelayMs);
+
+  int32_t n = atomic_fetch_add_32(&nLoad, 1);
+  if (n < MAX_LOAD) aLoad[n] = pBlock->nRow;
+
+  if (pBlock->nRow == FAIL_ROWS) return TSDB_CODE_FILE_CORRUPTED;
+  pBlockData->nRow = pBlock->nRow;
+  return 0;
+}
+
+class TsdbPrefetchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SSchema aSchema[2] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .flags = 0, .colId = 1, .bytes = 8},
+                          {.type = TSDB_DATA_TYPE_INT, .flags = 0, .colId = 2, .bytes = 4}};
+    ASSERT_EQ(tTSchemaCreate(0, aSchema, 2, &pTSchema), 0);
+    ASSERT_EQ(tBlockDataCreate(&data), 0);
+
+    nLoad = 0;
+    loadDelayMs = 0;
+  }
+
+  void TearDown() override {
+    tsdbPrefetcherClose(&pPrefetcher);
+    tBlockDataDestroy(&data, 1);
+    tTSchemaDestroy(pTSchema);
+  }
+
+  void open(int32_t nSlot, int64_t memBudget) {
+    ASSERT_EQ(tsdbPrefetcherOpen(NULL, nSlot, memBudget, fakeLoadBlock, &pPrefetcher), 0);
+  }
+
+  // block tbBlockIdx of the test table at position index, nRow marks its data
+  bool put(int32_t tbBlockIdx, int32_t nRow, int64_t size = 1) {
+    SDataBlk block;
+    tDataBlkReset(&block);
+    block.nRow = nRow;
+
+    TABLEID id = {.suid = 0, .uid = TEST_UID};
+    return tsdbPrefetcherPut(pPrefetcher, id, tbBlockIdx, tbBlockIdx, &block, pTSchema, size);
+  }
+
+  bool take(int32_t tbBlockIdx) { return tsdbPrefetcherTake(pPrefetcher, TEST_UID, tbBlockIdx, &data); }
+
+  void waitLoad(int32_t n) {
+    for (int32_t i = 0; i < 500 && atomic_load_32(&nLoad) < n; i++) {
+      taosMsleep(10);
+    }
+    ASSERT_EQ(atomic_load_32(&nLoad), n);
+  }
+
+  SBlockPrefetcher *pPrefetcher = NULL;
+  STSchema         *pTSchema = NULL;
+  SBlockData        data;
+};
+
+}  // namespace
+
+TEST_F(TsdbPrefetchTest, loadInOrder) {
+  open(4, 1024);
+
+  for (int32_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(put(i, 10 + i));
+  }
+  // issued twice, loaded once
+  ASSERT_TRUE(put(2, 12));
+  tsdbPrefetcherStart(pPrefetcher);
+
+  for (int32_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(take(i));
+    ASSERT_EQ(data.nRow, 10 + i);
+  }
+  ASSERT_EQ(atomic_load_32(&nLoad), 4);
+  for (int32_t i = 0; i < 4; i++) {
+    ASSERT_EQ(aLoad[i], 10 + i);
+  }
+
+  // taken blocks leave the prefetcher
+  ASSERT_FALSE(take(0));
+}
+
+TEST_F(TsdbPrefetchTest, takeWhileLoading) {
+  open(2, 1024);
+  loadDelayMs = 20;
+
+  ASSERT_TRUE(put(0, 10));
+  ASSERT_TRUE(put(1, 11));
+  tsdbPrefetcherStart(pPrefetcher);
+
+  ASSERT_TRUE(take(1));
+  ASSERT_EQ(data.nRow, 11);
+  ASSERT_TRUE(take(0));
+  ASSERT_EQ(data.nRow, 10);
+
+  // the freed slots are reused by the next round
+  ASSERT_TRUE(put(2, 12));
+  tsdbPrefetcherStart(pPrefetcher);
+  ASSERT_TRUE(take(2));
+  ASSERT_EQ(data.nRow, 12);
+}
+
+TEST_F(TsdbPrefetchTest, slotAndMemoryBound) {
+  open(2, 100);
+
+  // a block over the budget is still allowed when nothing is held
+  ASSERT_TRUE(put(0, 10, 200));
+  ASSERT_FALSE(put(1, 11, 1));
+  tsdbPrefetcherReset(pPrefetcher, NULL);
+
+  ASSERT_TRUE(put(0, 10, 60));
+  ASSERT_FALSE(put(1, 11, 60));
+  ASSERT_TRUE(put(1, 11, 40));
+  ASSERT_FALSE(put(2, 12, 0));
+
+  tsdbPrefetcherStart(pPrefetcher);
+  ASSERT_TRUE(take(0));
+  ASSERT_TRUE(put(2, 12, 60));
+}
+
+TEST_F(TsdbPrefetchTest, loadError) {
+  open(2, 1024);
+
+  ASSERT_TRUE(put(0, FAIL_ROWS));
+  ASSERT_TRUE(put(1, 11));
+  tsdbPrefetcherStart(pPrefetcher);
+
+  // the caller loads the failed block itself
+  ASSERT_FALSE(take(0));
+  ASSERT_TRUE(take(1));
+  ASSERT_EQ(data.nRow, 11);
+}
+
+TEST_F(TsdbPrefetchTest, skip) {
+  open(4, 1024);
+
+  for (int32_t i = 0; i < 3; i++) {
+    ASSERT_TRUE(put(i, 10 + i));
+  }
+  tsdbPrefetcherStart(pPrefetcher);
+  waitLoad(3);
+
+  // the consumer moved to position 1, blocks 0 and 1 are dropped
+  tsdbPrefetcherSkip(pPrefetcher, 1, 1);
+  ASSERT_FALSE(take(0));
+  ASSERT_FALSE(take(1));
+  ASSERT_TRUE(take(2));
+  ASSERT_EQ(data.nRow, 12);
+}
+
+TEST_F(TsdbPrefetchTest, reset) {
+  open(4, 1024);
+  loadDelayMs = 50;
+
+  for (int32_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(put(i, 10 + i));
+  }
+  tsdbPrefetcherStart(pPrefetcher);
+
+  // blocks not picked by the loader are dropped, only the one in flight is waited for
+  tsdbPrefetcherReset(pPrefetcher, NULL);
+  ASSERT_LE(atomic_load_32(&nLoad), 1);
+  for (int32_t i = 0; i < 4; i++) {
+    ASSERT_FALSE(take(i));
+  }
+
+  loadDelayMs = 0;
+  ASSERT_TRUE(put(0, 20));
+  tsdbPrefetcherStart(pPrefetcher);
+  ASSERT_TRUE(take(0));
+  ASSERT_EQ(data.nRow, 20);
+}
+
+#pragma GCC diagnostic pop
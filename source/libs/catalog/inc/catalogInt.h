@@ -479,6 +479,7 @@ typedef struct SCatalogMgmt {
   SHashObj             *pCluster;     //key: clusterId, value: SCatalog*
   SCatalogStat          stat;
   SCatalogCfg           cfg;
+  int64_t               cacheEpoch;
 } SCatalogMgmt;
 
 typedef uint32_t (*tableNameHashFp)(const char *, uint32_t);
@@ -490,6 +491,7 @@ typedef struct SCtgOperation {
   ctgOpFunc func;
 } SCtgOperation;
 
+#define CTG_CACHE_EPOCH_INC() atomic_add_fetch_64(&gCtgMgmt.cacheEpoch, 1)
 #define CTG_QUEUE_INC() atomic_add_fetch_64(&gCtgMgmt.queue.qRemainNum, 1)
 #define CTG_QUEUE_DEC() atomic_sub_fetch_64(&gCtgMgmt.queue.qRemainNum, 1)
 
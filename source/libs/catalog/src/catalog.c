@@ -1304,6 +1304,8 @@ int32_t catalogClearCache(void) {
 }
 
 
+int64_t catalogGetCacheEpoch(void) { return atomic_load_64(&gCtgMgmt.cacheEpoch); }
+
 void catalogDestroy(void) {
   qInfo("start to destroy catalog");
 
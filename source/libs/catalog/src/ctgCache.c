@@ -1325,6 +1325,7 @@ int32_t ctgRemoveDBFromCache(SCatalog* pCtg, SCtgDBCache *dbCache, const char* d
   CTG_LOCK(CTG_WRITE, &dbCache->dbLock);
 
   atomic_store_8(&dbCache->deleted, 1);
+  CTG_CACHE_EPOCH_INC();
   ctgRemoveStbRent(pCtg, dbCache);
   ctgFreeDbCache(dbCache);
 
@@ -1421,6 +1422,7 @@ int32_t ctgWriteTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNam
   STableMeta *orig = (pCache ? pCache->pMeta : NULL);
   int8_t origType = 0;
   uint64_t origSuid = 0;
+  bool schemaChanged = false;
   
   if (orig) {
     origType = orig->tableType;
@@ -1441,6 +1443,10 @@ int32_t ctgWriteTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNam
       
       origSuid = orig->suid;
     }
+
+    // a new tag version alone keeps the columns and the vgroup of the table
+    schemaChanged = (origType != meta->tableType || orig->uid != meta->uid || orig->sversion != meta->sversion ||
+                     orig->vgId != meta->vgId);
   }
 
   if (NULL == pCache) {
@@ -1460,6 +1466,8 @@ int32_t ctgWriteTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNam
 
   if (NULL == orig) {
     CTG_CACHE_STAT_INC(numOfTbl, 1);
+  } else if (schemaChanged) {
+    CTG_CACHE_EPOCH_INC();
   }
 
   ctgDebug("tbmeta updated to cache, dbFName:%s, tbName:%s, tbType:%d", dbFName, tbName, meta->tableType);
@@ -1630,6 +1638,11 @@ int32_t ctgOpUpdateVgroup(SCtgCacheOperation *operation) {
       goto _return;
     }
 
+    // only the table count changed, the vgroups and their hash ranges are the same
+    if (dbInfo->vgVersion != vgInfo->vgVersion) {
+      CTG_CACHE_EPOCH_INC();
+    }
+
     ctgFreeVgInfo(vgInfo);
   }
 
@@ -1691,6 +1704,9 @@ int32_t ctgOpDropDbVgroup(SCtgCacheOperation *operation) {
   
   CTG_ERR_RET(ctgWLockVgInfo(pCtg, dbCache));
   
+  if (dbCache->vgCache.vgInfo) {
+    CTG_CACHE_EPOCH_INC();
+  }
   ctgFreeVgInfo(dbCache->vgCache.vgInfo);
   dbCache->vgCache.vgInfo = NULL;
 
@@ -1794,6 +1810,7 @@ int32_t ctgOpDropStbMeta(SCtgCacheOperation *operation) {
     ctgError("stb not exist in cache, dbFName:%s, stb:%s, suid:0x%"PRIx64, msg->dbFName, msg->stbName, msg->suid);
   } else {
     CTG_CACHE_STAT_DEC(numOfTbl, 1);
+    CTG_CACHE_EPOCH_INC();
   }
   
   ctgInfo("stb removed from cache, dbFName:%s, stbName:%s, suid:0x%"PRIx64, msg->dbFName, msg->stbName, msg->suid);
@@ -1840,6 +1857,7 @@ int32_t ctgOpDropTbMeta(SCtgCacheOperation *operation) {
     CTG_ERR_JRET(TSDB_CODE_CTG_INTERNAL_ERROR);
   } else {
     CTG_CACHE_STAT_DEC(numOfTbl, 1);
+    CTG_CACHE_EPOCH_INC();
   }
 
   ctgDebug("table %s removed from cache, dbFName:%s", msg->tbName, msg->dbFName);
@@ -1878,6 +1896,9 @@ int32_t ctgOpUpdateUser(SCtgCacheOperation *operation) {
 
   pUser->version = msg->userAuth.version;
 
+  // results derived from the cache skip the auth check, revoked privileges must outdate them
+  CTG_CACHE_EPOCH_INC();
+
   CTG_LOCK(CTG_WRITE, &pUser->lock);
 
   taosHashCleanup(pUser->createdDbs);
@@ -2014,6 +2035,8 @@ int32_t ctgOpClearCache(SCtgCacheOperation *operation) {
 
   CTG_LOCK(CTG_WRITE, &gCtgMgmt.lock);
 
+  CTG_CACHE_EPOCH_INC();
+
   if (pCtg) {
     if (msg->freeCtg) {
       ctgFreeHandle(pCtg);
@@ -391,6 +391,8 @@ typedef struct STagScanInfo {
   int32_t         curPos;
   SReadHandle     readHandle;
   STableListInfo* pTableList;
+  SSDataBlock*    pTagBlock;   // tags read from the columnar tag store of meta
+  bool            noTagStore;  // the tag store is not available, read the tags table by table
 } STagScanInfo;
 
 typedef struct SLastrowScanInfo {
@@ -689,19 +691,24 @@ typedef struct SFillOperatorInfo {
   int32_t           numOfNotFillExpr;
 } SFillOperatorInfo;
 
+typedef struct SGroupKeyTable SGroupKeyTable;
+typedef struct SGroupSpiller  SGroupSpiller;
+
 typedef struct SGroupbyOperatorInfo {
   // SOptrBasicInfo should be first, SAggSupporter should be second for stream encode
   SOptrBasicInfo binfo;
   SAggSupporter  aggSup;
 
-  SArray*       pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*       pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  SNode*        pCondition;
-  bool          isInit;       // denote if current val is initialized or not
-  char*         keyBuf;       // group by keys for hash
-  int32_t       groupKeyLen;  // total group by column width
-  SGroupResInfo groupResInfo;
-  SExprSupp     scalarSup;
+  SArray*         pGroupCols;     // group by columns, SArray<SColumn>
+  SArray*         pGroupColVals;  // current group column values, SArray<SGroupKeys>
+  SNode*          pCondition;
+  bool            isInit;       // denote if current val is initialized or not
+  char*           keyBuf;       // group by keys for hash
+  int32_t         groupKeyLen;  // total group by column width
+  SGroupResInfo   groupResInfo;
+  SExprSupp       scalarSup;
+  SGroupKeyTable* pKeyTable;  // open addressing table of fixed-width group keys, NULL if any key is var-length
+  SGroupSpiller*  pSpiller;   // rows of the groups that do not fit in the memory budget
 } SGroupbyOperatorInfo;
 
 typedef struct SDataGroupInfo {
@@ -726,6 +733,7 @@ typedef struct SPartitionOperatorInfo {
   int32_t        groupIndex;        // group index
   int32_t        pageIndex;         // page index of current group
   SExprSupp      scalarSup;
+  SGroupSpiller* pSpiller;          // rows of the groups that do not fit in the memory budget
 } SPartitionOperatorInfo;
 
 typedef struct SWindowRowsSup {
@@ -897,6 +905,39 @@ typedef struct SJoinOperatorInfo {
   SNode*       pCondAfterMerge;
 } SJoinOperatorInfo;
 
+typedef struct SHJoinOutputCol {
+  int32_t child;   // the child that the output column comes from
+  int32_t slotId;
+} SHJoinOutputCol;
+
+typedef struct SHashJoinOperatorInfo {
+  SSDataBlock*     pRes;
+  int32_t          joinType;
+  SArray*          pKeyCols[2];  // SArray<SColumnInfo>, the equal keys of the left and right child
+  SHJoinOutputCol* pOutputCols;
+  SNode*           pCondAfterJoin;
+  char*            keyBuf;
+  int32_t          buildIdx;     // the child that is read out first, whose rows are put into the hash table
+  SHashObj*        pKeyHash;     // key -> index of the first row with the key in pRowRefs
+  SArray*          pRowRefs;     // SArray<SHJoinRowRef>
+  int64_t          keyBytes;     // total length of the keys in pKeyHash
+  SDiskbasedBuf*   pBuf;         // input blocks of both children, spilled to disk when out of memory
+  int32_t          pageSize;
+  int64_t          memLimit;     // bytes shared by the in-memory pages of pBuf and the hash table
+  SArray*          pPageIds[2];  // pages of the blocks read from each child before the build side is known
+  SSDataBlock*     pSchema[2];
+  SArray*          pPageView;    // SArray<SColumnInfoData>, columns of a build page without copy
+  SSDataBlock*     pProbeBlock;
+  SSDataBlock*     pProbeCopy;   // the probe block restored from the pages
+  int32_t          probePageIndex;
+  bool             probeDone;
+  int32_t*         pHeads;       // the first matched row of each probe row
+  int32_t          headsCap;
+  int32_t          probeRow;
+  int32_t          curRef;
+  SArray*          pMatches;     // SArray<SHJoinMatch>
+} SHashJoinOperatorInfo;
+
 #define OPTR_IS_OPENED(_optr)  (((_optr)->status & OP_OPENED) == OP_OPENED)
 #define OPTR_SET_OPENED(_optr) ((_optr)->status |= OP_OPENED)
 
@@ -1016,6 +1057,8 @@ SOperatorInfo* createStreamPartitionOperatorInfo(SOperatorInfo* downstream, SPar
 SOperatorInfo* createTimeSliceOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pNode, SExecTaskInfo* pTaskInfo);
 SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                            SSortMergeJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
 
 SOperatorInfo* createStreamSessionAggOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pPhyNode,
                                                   SExecTaskInfo* pTaskInfo);
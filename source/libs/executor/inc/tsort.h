@@ -100,6 +100,14 @@ int32_t tsortSetFetchRawDataFp(SSortHandle* pHandle, _sort_fetch_block_fn_t fetc
  */
 int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp);
 
+/**
+ * only the first maxRows tuples will be fetched, which allows a bounded top-n sort in memory
+ * @param pHandle
+ * @param maxRows  0 means all tuples are required, a bound beyond INT32_MAX / 2 is ignored
+ * @return
+ */
+int32_t tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows);
+
 /**
  *
  */
@@ -359,60 +359,27 @@ static int32_t createResultData(SDataType* pType, int32_t numOfRows, SScalarPara
   return TSDB_CODE_SUCCESS;
 }
 
-static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray* uidList, SNode* pTagCond) {
-  int32_t      code = TSDB_CODE_SUCCESS;
-  SArray*      pBlockList = NULL;
-  SSDataBlock* pResBlock = NULL;
-  SHashObj*    tags = NULL;
-  SScalarParam output = {0};
-
-  tagFilterAssist ctx = {0};
-
-  ctx.colHash = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT), false, HASH_NO_LOCK);
-  if (ctx.colHash == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    goto end;
-  }
-  ctx.index = 0;
-  ctx.cInfoList = taosArrayInit(4, sizeof(SColumnInfo));
-  if (ctx.cInfoList == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    goto end;
-  }
-
-  nodesRewriteExprPostOrder(&pTagCond, getColumn, (void*)&ctx);
-
-  pResBlock = createDataBlock();
-  if (pResBlock == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    goto end;
+// Fill the tag columns of pResBlock for the tables in uidList, or for all child tables of suid if uidList is empty.
+static int32_t fillTableTagsBlock(void* metaHandle, uint64_t suid, SArray* uidList, SSDataBlock* pResBlock) {
+  int32_t code = metaGetTableTagColumns(metaHandle, suid, uidList, pResBlock);
+  if (code != TSDB_CODE_NOT_FOUND) {
+    return code;
   }
 
-  for (int32_t i = 0; i < taosArrayGetSize(ctx.cInfoList); ++i) {
-    SColumnInfoData colInfo = {{0}, 0};
-    colInfo.info = *(SColumnInfo*)taosArrayGet(ctx.cInfoList, i);
-    blockDataAppendColInfo(pResBlock, &colInfo);
+  // the columnar tag store is not available, decode the tags of each table
+  SHashObj* tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (tags == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
   }
 
-  //  int64_t stt = taosGetTimestampUs();
-  tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
   code = metaGetTableTags(metaHandle, suid, uidList, tags);
   if (code != TSDB_CODE_SUCCESS) {
-    qError("failed to get table tags from meta, reason:%s, suid:%" PRIu64, tstrerror(code), suid);
-    terrno = code;
     goto end;
   }
 
   int32_t rows = taosArrayGetSize(uidList);
-  if (rows == 0) {
-    goto end;
-  }
-  //  int64_t stt1 = taosGetTimestampUs();
-  //  qDebug("generate tag meta rows:%d, cost:%ld us", rows, stt1-stt);
-
   code = blockDataEnsureCapacity(pResBlock, rows);
   if (code != TSDB_CODE_SUCCESS) {
-    terrno = code;
     goto end;
   }
 
@@ -464,6 +431,57 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray
   }
   pResBlock->info.rows = rows;
 
+end:
+  taosHashCleanup(tags);
+  return code;
+}
+
+static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray* uidList, SNode* pTagCond) {
+  int32_t      code = TSDB_CODE_SUCCESS;
+  SArray*      pBlockList = NULL;
+  SSDataBlock* pResBlock = NULL;
+  SScalarParam output = {0};
+
+  tagFilterAssist ctx = {0};
+
+  ctx.colHash = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT), false, HASH_NO_LOCK);
+  if (ctx.colHash == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto end;
+  }
+  ctx.index = 0;
+  ctx.cInfoList = taosArrayInit(4, sizeof(SColumnInfo));
+  if (ctx.cInfoList == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto end;
+  }
+
+  nodesRewriteExprPostOrder(&pTagCond, getColumn, (void*)&ctx);
+
+  pResBlock = createDataBlock();
+  if (pResBlock == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto end;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(ctx.cInfoList); ++i) {
+    SColumnInfoData colInfo = {{0}, 0};
+    colInfo.info = *(SColumnInfo*)taosArrayGet(ctx.cInfoList, i);
+    blockDataAppendColInfo(pResBlock, &colInfo);
+  }
+
+  code = fillTableTagsBlock(metaHandle, suid, uidList, pResBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("failed to get table tags from meta, reason:%s, suid:%" PRIu64, tstrerror(code), suid);
+    terrno = code;
+    goto end;
+  }
+
+  int32_t rows = pResBlock->info.rows;
+  if (rows == 0) {
+    goto end;
+  }
+
   //  int64_t st1 = taosGetTimestampUs();
   //  qDebug("generate tag block rows:%d, cost:%ld us", rows, st1-st);
 
@@ -489,7 +507,6 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray
   //  qDebug("calculate tag block rows:%d, cost:%ld us", rows, st2-st1);
 
 end:
-  taosHashCleanup(tags);
   taosHashCleanup(ctx.colHash);
   taosArrayDestroy(ctx.cInfoList);
   blockDataDestroy(pResBlock);
@@ -497,6 +514,57 @@ end:
   return output.columnData;
 }
 
+/*
+ * The qualified child tables of a tag filter, and the group ids of the child tables of a group by, are cached in meta
+ * with the digest of the serialized filter or group by as the key.
+ */
+#define TAG_FILTER_DIGEST_LEN 16
+
+static int32_t genTagFilterDigest(const SNode* pTagCond, const SNodeList* pGroup, uint8_t* pDigest) {
+  char*   payload = NULL;
+  int32_t len = 0;
+  int32_t code = (pTagCond != NULL) ? nodesNodeToString(pTagCond, false, &payload, &len)
+                                    : nodesListToString(pGroup, false, &payload, &len);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  uint8_t   kind = (pTagCond != NULL) ? 'F' : 'G';
+  T_MD5_CTX context;
+  tMD5Init(&context);
+  tMD5Update(&context, &kind, sizeof(kind));
+  tMD5Update(&context, (uint8_t*)payload, (uint32_t)len);
+  tMD5Final(&context);
+
+  memcpy(pDigest, context.digest, TAG_FILTER_DIGEST_LEN);
+  taosMemoryFree(payload);
+  return TSDB_CODE_SUCCESS;
+}
+
+// the cached group ids can be used only if they are generated for exactly the same tables
+static bool setCachedTableGroupId(STableListInfo* pTableListInfo, const SArray* pCached) {
+  int32_t rows = taosArrayGetSize(pTableListInfo->pTableList);
+  if (taosArrayGetSize(pCached) != rows) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    STableKeyInfo* info = taosArrayGet(pTableListInfo->pTableList, i);
+    STableKeyInfo* pCachedInfo = taosArrayGet(pCached, i);
+    if (info->uid != pCachedInfo->uid) {
+      return false;
+    }
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    STableKeyInfo* info = taosArrayGet(pTableListInfo->pTableList, i);
+    info->groupId = ((STableKeyInfo*)taosArrayGet(pCached, i))->groupId;
+    taosHashPut(pTableListInfo->map, &(info->uid), sizeof(uint64_t), &info->groupId, sizeof(uint64_t));
+  }
+
+  return true;
+}
+
 static void releaseColInfoData(void* pCol) {
   if (pCol) {
     SColumnInfoData* col = (SColumnInfoData*)pCol;
@@ -509,7 +577,6 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
   int32_t      code = TSDB_CODE_SUCCESS;
   SArray*      pBlockList = NULL;
   SSDataBlock* pResBlock = NULL;
-  SHashObj*    tags = NULL;
   SArray*      uidList = NULL;
   void*        keyBuf = NULL;
   SArray*      groupData = NULL;
@@ -519,6 +586,21 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
     return TDB_CODE_SUCCESS;
   }
 
+  uint8_t digest[TAG_FILTER_DIGEST_LEN] = {0};
+  int64_t cacheVer = -1;
+  bool    canCache = (pTableListInfo->suid != 0) && (genTagFilterDigest(NULL, group, digest) == TSDB_CODE_SUCCESS);
+  if (canCache) {
+    SArray* pCached = taosArrayInit(rows, sizeof(STableKeyInfo));
+    if (pCached != NULL &&
+        metaGetCachedTableList(metaHandle, pTableListInfo->suid, digest, TAG_FILTER_DIGEST_LEN, pCached, &cacheVer) ==
+            TSDB_CODE_SUCCESS &&
+        setCachedTableGroupId(pTableListInfo, pCached)) {
+      taosArrayDestroy(pCached);
+      return TDB_CODE_SUCCESS;
+    }
+    taosArrayDestroy(pCached);
+  }
+
   tagFilterAssist ctx = {0};
   ctx.colHash = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT), false, HASH_NO_LOCK);
   if (ctx.colHash == NULL) {
@@ -556,69 +638,11 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
     taosArrayPush(uidList, &pkeyInfo->uid);
   }
 
-  //  int64_t stt = taosGetTimestampUs();
-  tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
-  code = metaGetTableTags(metaHandle, pTableListInfo->suid, uidList, tags);
-  if (code != TSDB_CODE_SUCCESS) {
-    goto end;
-  }
-
-  //  int64_t stt1 = taosGetTimestampUs();
-  //  qDebug("generate tag meta rows:%d, cost:%ld us", rows, stt1-stt);
-
-  code = blockDataEnsureCapacity(pResBlock, rows);
+  code = fillTableTagsBlock(metaHandle, pTableListInfo->suid, uidList, pResBlock);
   if (code != TSDB_CODE_SUCCESS) {
     goto end;
   }
 
-  //  int64_t st = taosGetTimestampUs();
-  for (int32_t i = 0; i < rows; i++) {
-    int64_t* uid = taosArrayGet(uidList, i);
-    for (int32_t j = 0; j < taosArrayGetSize(pResBlock->pDataBlock); j++) {
-      SColumnInfoData* pColInfo = (SColumnInfoData*)taosArrayGet(pResBlock->pDataBlock, j);
-
-      if (pColInfo->info.colId == -1) {  // tbname
-        char str[TSDB_TABLE_FNAME_LEN + VARSTR_HEADER_SIZE] = {0};
-        metaGetTableNameByUid(metaHandle, *uid, str);
-        colDataAppend(pColInfo, i, str, false);
-#if TAG_FILTER_DEBUG
-        qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
-#endif
-      } else {
-        void* tag = taosHashGet(tags, uid, sizeof(int64_t));
-        ASSERT(tag);
-        STagVal tagVal = {0};
-        tagVal.cid = pColInfo->info.colId;
-        const char* p = metaGetTableTagVal(tag, pColInfo->info.type, &tagVal);
-
-        if (p == NULL || (pColInfo->info.type == TSDB_DATA_TYPE_JSON && ((STag*)p)->nTag == 0)) {
-          colDataAppend(pColInfo, i, p, true);
-        } else if (pColInfo->info.type == TSDB_DATA_TYPE_JSON) {
-          colDataAppend(pColInfo, i, p, false);
-        } else if (IS_VAR_DATA_TYPE(pColInfo->info.type)) {
-          char* tmp = taosMemoryCalloc(tagVal.nData + VARSTR_HEADER_SIZE + 1, 1);
-          varDataSetLen(tmp, tagVal.nData);
-          memcpy(tmp + VARSTR_HEADER_SIZE, tagVal.pData, tagVal.nData);
-          colDataAppend(pColInfo, i, tmp, false);
-#if TAG_FILTER_DEBUG
-          qDebug("tagfilter varch:%s", tmp + 2);
-#endif
-          taosMemoryFree(tmp);
-        } else {
-          colDataAppend(pColInfo, i, (const char*)&tagVal.i64, false);
-#if TAG_FILTER_DEBUG
-          if (pColInfo->info.type == TSDB_DATA_TYPE_INT) {
-            qDebug("tagfilter int:%d", *(int*)(&tagVal.i64));
-          } else if (pColInfo->info.type == TSDB_DATA_TYPE_DOUBLE) {
-            qDebug("tagfilter double:%f", *(double*)(&tagVal.i64));
-          }
-#endif
-        }
-      }
-    }
-  }
-  pResBlock->info.rows = rows;
-
   //  int64_t st1 = taosGetTimestampUs();
   //  qDebug("generate tag block rows:%d, cost:%ld us", rows, st1-st);
 
@@ -717,12 +741,16 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
     taosHashPut(pTableListInfo->map, &(info->uid), sizeof(uint64_t), &info->groupId, sizeof(uint64_t));
   }
 
+  if (canCache) {
+    metaPutCachedTableList(metaHandle, pTableListInfo->suid, digest, TAG_FILTER_DIGEST_LEN, cacheVer,
+                           pTableListInfo->pTableList);
+  }
+
   //  int64_t st2 = taosGetTimestampUs();
   //  qDebug("calculate tag block rows:%d, cost:%ld us", rows, st2-st1);
 
 end:
   taosMemoryFreeClear(keyBuf);
-  taosHashCleanup(tags);
   taosHashCleanup(ctx.colHash);
   taosArrayDestroy(ctx.cInfoList);
   blockDataDestroy(pResBlock);
@@ -743,6 +771,18 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
 
   uint64_t tableUid = pScanNode->uid;
   pListInfo->suid = pScanNode->suid;
+
+  uint8_t digest[TAG_FILTER_DIGEST_LEN] = {0};
+  int64_t cacheVer = -1;
+  bool    canCache = (pScanNode->tableType == TSDB_SUPER_TABLE) && (pTagCond != NULL) &&
+                  (genTagFilterDigest(pTagCond, NULL, digest) == TSDB_CODE_SUCCESS);
+  if (canCache && metaGetCachedTableList(metaHandle, pListInfo->suid, digest, TAG_FILTER_DIGEST_LEN,
+                                         pListInfo->pTableList, &cacheVer) == TSDB_CODE_SUCCESS) {
+    qDebug("tagfilter get %d tables from cache, suid:%" PRIu64, (int32_t)taosArrayGetSize(pListInfo->pTableList),
+           pListInfo->suid);
+    goto _end;
+  }
+
   SArray* res = taosArrayInit(8, sizeof(uint64_t));
 
   if (pScanNode->tableType == TSDB_SUPER_TABLE) {
@@ -808,6 +848,12 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
 
   taosArrayDestroy(res);
 
+  if (canCache) {
+    metaPutCachedTableList(metaHandle, pListInfo->suid, digest, TAG_FILTER_DIGEST_LEN, cacheVer,
+                           pListInfo->pTableList);
+  }
+
+_end:
   pListInfo->pGroupList = taosArrayInit(4, POINTER_BYTES);
   if (pListInfo->pGroupList == NULL) {
     return TSDB_CODE_OUT_OF_MEMORY;
@@ -25,12 +25,16 @@
 #include "thash.h"
 #include "ttypes.h"
 #include "executorInt.h"
+#include "tglobal.h"
 
 static void*    getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, int32_t len);
 static int32_t* setupColumnOffset(const SSDataBlock* pBlock, int32_t rowCapacity);
 static int32_t  setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo* binfo, int32_t numOfCols, char* pData, int16_t bytes,
                                         uint64_t groupId, SDiskbasedBuf* pBuf, SAggSupporter* pAggSup);
 
+static void destroyGroupKeyTable(SGroupKeyTable* pTable);
+static void destroyGroupSpiller(SGroupSpiller* pSpiller);
+
 static void freeGroupKey(void* param) {
   SGroupKeys* pKey = (SGroupKeys*) param;
   taosMemoryFree(pKey->pData);
@@ -44,6 +48,8 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupBasicInfo(&pInfo->binfo);
   taosMemoryFreeClear(pInfo->keyBuf);
+  destroyGroupKeyTable(pInfo->pKeyTable);
+  destroyGroupSpiller(pInfo->pSpiller);
   taosArrayDestroy(pInfo->pGroupCols);
   taosArrayDestroyEx(pInfo->pGroupColVals, freeGroupKey);
   cleanupExprSupp(&pInfo->scalarSup);
@@ -230,10 +236,341 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
+/*
+ * Group keys that consist of fixed-width columns only are hashed column by column for a whole data block, and then
+ * probed in an open addressing table that keeps the keys inline together with the position of the result row. The
+ * aggregate functions are applied to each run of consecutive rows that fall into the same bucket. The SSHashObj in
+ * SAggSupporter is still the owner of all result rows, since the results are built from it.
+ */
+#define GROUP_KEY_TABLE_INIT_SIZE 1024
+#define GROUP_KEY_NULL_HASH       0x9E3779B97F4A7C15ULL
+
+struct SGroupKeyTable {
+  int32_t   numOfCols;
+  int32_t   keyLen;       // groupId, null flag of each column and then the value of each column
+  int32_t   entrySize;    // SResultRowPosition followed by the key
+  uint32_t  capacity;     // number of buckets, power of 2
+  uint32_t  size;         // number of used buckets
+  uint64_t* pBucketHash;  // hash of the key in each bucket, 0 means empty bucket
+  char*     pEntries;
+  int32_t   rowCapacity;
+  uint64_t* pRowHash;     // hash of each row in current data block
+  char*     pRowKeys;     // packed key of each row in current data block
+  uint32_t* pRowBucket;   // bucket of each row in current data block
+};
+
+#define GROUP_KEY_ENTRY(_t, _i)  ((_t)->pEntries + (size_t)(_i) * (_t)->entrySize)
+#define GROUP_KEY_ENTRY_KEY(_e)  ((_e) + sizeof(SResultRowPosition))
+#define GROUP_KEY_ROW_KEY(_t, _j) ((_t)->pRowKeys + (size_t)(_j) * (_t)->keyLen)
+
+static FORCE_INLINE uint64_t groupKeyHashMix(uint64_t h, uint64_t v) {
+  h = (h ^ v) * 0xff51afd7ed558ccdULL;
+  return h ^ (h >> 32);
+}
+
+static void destroyGroupKeyTable(SGroupKeyTable* pTable) {
+  if (pTable == NULL) {
+    return;
+  }
+
+  taosMemoryFree(pTable->pBucketHash);
+  taosMemoryFree(pTable->pEntries);
+  taosMemoryFree(pTable->pRowHash);
+  taosMemoryFree(pTable->pRowKeys);
+  taosMemoryFree(pTable->pRowBucket);
+  taosMemoryFree(pTable);
+}
+
+static SGroupKeyTable* createGroupKeyTable(const SArray* pGroupCols) {
+  int32_t numOfCols = taosArrayGetSize(pGroupCols);
+  int32_t keyLen = sizeof(uint64_t) + numOfCols * sizeof(int8_t);
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumn* pCol = taosArrayGet(pGroupCols, i);
+    if (IS_VAR_DATA_TYPE(pCol->type) ||
+        (pCol->bytes != 1 && pCol->bytes != 2 && pCol->bytes != 4 && pCol->bytes != 8)) {
+      return NULL;
+    }
+    keyLen += pCol->bytes;
+  }
+
+  SGroupKeyTable* pTable = taosMemoryCalloc(1, sizeof(SGroupKeyTable));
+  if (pTable == NULL) {
+    return NULL;
+  }
+
+  pTable->numOfCols = numOfCols;
+  pTable->keyLen = keyLen;
+  pTable->entrySize = (int32_t)ALIGN8(sizeof(SResultRowPosition) + keyLen);
+  pTable->capacity = GROUP_KEY_TABLE_INIT_SIZE;
+  pTable->pBucketHash = taosMemoryCalloc(pTable->capacity, sizeof(uint64_t));
+  pTable->pEntries = taosMemoryMalloc((size_t)pTable->capacity * pTable->entrySize);
+  if (pTable->pBucketHash == NULL || pTable->pEntries == NULL) {
+    destroyGroupKeyTable(pTable);
+    return NULL;
+  }
+
+  return pTable;
+}
+
+static int32_t groupKeyTableResize(SGroupKeyTable* pTable, uint32_t capacity) {
+  uint64_t* pBucketHash = taosMemoryCalloc(capacity, sizeof(uint64_t));
+  char*     pEntries = taosMemoryMalloc((size_t)capacity * pTable->entrySize);
+  if (pBucketHash == NULL || pEntries == NULL) {
+    taosMemoryFree(pBucketHash);
+    taosMemoryFree(pEntries);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  uint32_t mask = capacity - 1;
+  for (uint32_t i = 0; i < pTable->capacity; ++i) {
+    uint64_t h = pTable->pBucketHash[i];
+    if (h == 0) {
+      continue;
+    }
+
+    uint32_t idx = h & mask;
+    while (pBucketHash[idx] != 0) {
+      idx = (idx + 1) & mask;
+    }
+
+    pBucketHash[idx] = h;
+    memcpy(pEntries + (size_t)idx * pTable->entrySize, GROUP_KEY_ENTRY(pTable, i), pTable->entrySize);
+  }
+
+  taosMemoryFree(pTable->pBucketHash);
+  taosMemoryFree(pTable->pEntries);
+  pTable->pBucketHash = pBucketHash;
+  pTable->pEntries = pEntries;
+  pTable->capacity = capacity;
+  return TSDB_CODE_SUCCESS;
+}
+
+// make sure all rows of the data block can be inserted without rehashing, the load factor is kept below 0.5
+static int32_t groupKeyTablePrepare(SGroupKeyTable* pTable, int32_t numOfRows) {
+  if (pTable->rowCapacity < numOfRows) {
+    taosMemoryFreeClear(pTable->pRowHash);
+    taosMemoryFreeClear(pTable->pRowKeys);
+    taosMemoryFreeClear(pTable->pRowBucket);
+    pTable->rowCapacity = 0;
+
+    pTable->pRowHash = taosMemoryMalloc(numOfRows * sizeof(uint64_t));
+    pTable->pRowKeys = taosMemoryMalloc((size_t)numOfRows * pTable->keyLen);
+    pTable->pRowBucket = taosMemoryMalloc(numOfRows * sizeof(uint32_t));
+    if (pTable->pRowHash == NULL || pTable->pRowKeys == NULL || pTable->pRowBucket == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pTable->rowCapacity = numOfRows;
+  }
+
+  uint32_t capacity = pTable->capacity;
+  while (((uint64_t)pTable->size + numOfRows) * 2 > capacity) {
+    capacity <<= 1;
+  }
+
+  if (capacity != pTable->capacity) {
+    return groupKeyTableResize(pTable, capacity);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// drop all keys, the result rows they refer to are discarded together with the result buffer
+static void groupKeyTableClear(SGroupKeyTable* pTable) {
+  if (pTable == NULL) {
+    return;
+  }
+
+  memset(pTable->pBucketHash, 0, pTable->capacity * sizeof(uint64_t));
+  pTable->size = 0;
+}
+
+#define GROUP_KEY_HASH_COLUMN(_t, _pTable, _pCol, _hasNull, _offset, _flagOffset, _rows) \
+  do {                                                                                  \
+    const _t* pVal = (const _t*)(_pCol)->pData;                                         \
+    for (int32_t j = 0; j < (_rows); ++j) {                                             \
+      char* pKey = GROUP_KEY_ROW_KEY(_pTable, j);                                       \
+      _t    v = pVal[j];                                                                \
+      bool  isNull = (_hasNull) && colDataIsNull_f((_pCol)->nullbitmap, j);             \
+      if (isNull) {                                                                     \
+        v = 0;                                                                          \
+      }                                                                                 \
+      pKey[_flagOffset] = isNull;                                                       \
+      *(_t*)(pKey + (_offset)) = v;                                                     \
+      (_pTable)->pRowHash[j] =                                                          \
+          groupKeyHashMix((_pTable)->pRowHash[j], isNull ? GROUP_KEY_NULL_HASH : (uint64_t)v); \
+    }                                                                                   \
+  } while (0)
+
+// hash the group columns of all rows and build the packed key of each row, column by column
+static void groupKeyTableHashBlock(SGroupKeyTable* pTable, const SArray* pGroupCols, SSDataBlock* pBlock) {
+  int32_t  rows = pBlock->info.rows;
+  uint64_t groupId = pBlock->info.groupId;
+  uint64_t seed = groupKeyHashMix(0, groupId);
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pTable->pRowHash[j] = seed;
+    memcpy(GROUP_KEY_ROW_KEY(pTable, j), &groupId, sizeof(uint64_t));
+  }
+
+  int32_t offset = sizeof(uint64_t) + pTable->numOfCols * sizeof(int8_t);
+  for (int32_t i = 0; i < pTable->numOfCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    int32_t          flagOffset = sizeof(uint64_t) + i;
+    bool             hasNull = pColInfoData->hasNull;
+
+    switch (pCol->bytes) {
+      case 1:
+        GROUP_KEY_HASH_COLUMN(uint8_t, pTable, pColInfoData, hasNull, offset, flagOffset, rows);
+        break;
+      case 2:
+        GROUP_KEY_HASH_COLUMN(uint16_t, pTable, pColInfoData, hasNull, offset, flagOffset, rows);
+        break;
+      case 4:
+        GROUP_KEY_HASH_COLUMN(uint32_t, pTable, pColInfoData, hasNull, offset, flagOffset, rows);
+        break;
+      default:
+        GROUP_KEY_HASH_COLUMN(uint64_t, pTable, pColInfoData, hasNull, offset, flagOffset, rows);
+        break;
+    }
+
+    offset += pCol->bytes;
+  }
+
+  for (int32_t j = 0; j < rows; ++j) {
+    if (pTable->pRowHash[j] == 0) {
+      pTable->pRowHash[j] = 1;
+    }
+  }
+}
+
+// find the bucket of each row, a new bucket is occupied for a new key with the result row position unassigned
+static void groupKeyTableProbe(SGroupKeyTable* pTable, int32_t rows) {
+  uint32_t mask = pTable->capacity - 1;
+
+  for (int32_t j = 0; j < rows; ++j) {
+    uint64_t h = pTable->pRowHash[j];
+    char*    pKey = GROUP_KEY_ROW_KEY(pTable, j);
+
+    // consecutive rows usually belong to the same group
+    if (j > 0 && h == pTable->pRowHash[j - 1] && memcmp(pKey, GROUP_KEY_ROW_KEY(pTable, j - 1), pTable->keyLen) == 0) {
+      pTable->pRowBucket[j] = pTable->pRowBucket[j - 1];
+      continue;
+    }
+
+    uint32_t idx = h & mask;
+    while (1) {
+      uint64_t bh = pTable->pBucketHash[idx];
+      if (bh == 0) {
+        char* pEntry = GROUP_KEY_ENTRY(pTable, idx);
+        pTable->pBucketHash[idx] = h;
+        *(SResultRowPosition*)pEntry = (SResultRowPosition){.pageId = -1, .offset = -1};
+        memcpy(GROUP_KEY_ENTRY_KEY(pEntry), pKey, pTable->keyLen);
+        pTable->size += 1;
+        break;
+      }
+
+      if (bh == h && memcmp(GROUP_KEY_ENTRY_KEY(GROUP_KEY_ENTRY(pTable, idx)), pKey, pTable->keyLen) == 0) {
+        break;
+      }
+
+      idx = (idx + 1) & mask;
+    }
+
+    pTable->pRowBucket[j] = idx;
+  }
+}
+
+// convert the packed key into the layout produced by buildGroupKeys, which is the key of the result row hash table
+static int32_t buildGroupKeysFromPackedKey(SGroupKeyTable* pTable, const SArray* pGroupCols, const char* pKey,
+                                           char* pBuf) {
+  const char* isNull = pKey + sizeof(uint64_t);
+  const char* pVal = isNull + pTable->numOfCols * sizeof(int8_t);
+  char*       pStart = pBuf + pTable->numOfCols * sizeof(int8_t);
+
+  for (int32_t i = 0; i < pTable->numOfCols; ++i) {
+    SColumn* pCol = taosArrayGet(pGroupCols, i);
+    pBuf[i] = isNull[i];
+    if (!isNull[i]) {
+      memcpy(pStart, pVal, pCol->bytes);
+      pStart += pCol->bytes;
+    }
+    pVal += pCol->bytes;
+  }
+
+  return (int32_t)(pStart - pBuf);
+}
+
+static void setGroupResultOutputBufByPos(SOperatorInfo* pOperator, SOptrBasicInfo* binfo, int32_t numOfCols,
+                                         SResultRowPosition* pPos, SDiskbasedBuf* pBuf) {
+  SResultRowInfo* pResultRowInfo = &binfo->resultRowInfo;
+  SResultRow*     pResultRow = getResultRowByPos(pBuf, pPos, true);
+
+  // close current opened result row
+  if (pResultRowInfo->cur.pageId != -1 && pResultRow->pageId != pResultRowInfo->cur.pageId) {
+    SFilePage* pPage = getBufPage(pBuf, pResultRowInfo->cur.pageId);
+    releaseBufPage(pBuf, pPage);
+  }
+
+  pResultRowInfo->cur = *pPos;
+  setResultRowInitCtx(pResultRow, pOperator->exprSupp.pCtx, numOfCols, pOperator->exprSupp.rowEntryInfoOffset);
+}
+
+static void doHashGroupbyAggBatch(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupKeyTable*       pTable = pInfo->pKeyTable;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+  int32_t               numOfExprs = pOperator->exprSupp.numOfExprs;
+  int32_t               rows = pBlock->info.rows;
+
+  int32_t code = groupKeyTablePrepare(pTable, rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  groupKeyTableHashBlock(pTable, pInfo->pGroupCols, pBlock);
+  groupKeyTableProbe(pTable, rows);
+
+  int32_t start = 0;
+  while (start < rows) {
+    uint32_t bucket = pTable->pRowBucket[start];
+    int32_t  end = start + 1;
+    while (end < rows && pTable->pRowBucket[end] == bucket) {
+      end += 1;
+    }
+
+    char*               pEntry = GROUP_KEY_ENTRY(pTable, bucket);
+    SResultRowPosition* pPos = (SResultRowPosition*)pEntry;
+    if (pPos->pageId == -1) {
+      int32_t len = buildGroupKeysFromPackedKey(pTable, pInfo->pGroupCols, GROUP_KEY_ENTRY_KEY(pEntry), pInfo->keyBuf);
+      int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), numOfExprs, pInfo->keyBuf, len,
+                                            pBlock->info.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+      if (ret != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_APP_ERROR);
+      }
+      *pPos = pInfo->binfo.resultRowInfo.cur;
+    } else {
+      setGroupResultOutputBufByPos(pOperator, &(pInfo->binfo), numOfExprs, pPos, pInfo->aggSup.pResultBuf);
+    }
+
+    doApplyFunctions(pTaskInfo, pCtx, NULL, start, end - start, rows, numOfExprs);
+    doAssignGroupKeys(pCtx, numOfExprs, rows, start);
+    start = end;
+  }
+}
+
 static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
+  // the null flags are only reliable in the bitmap when the block sma is not provided
+  if (pInfo->pKeyTable != NULL && pBlock->pBlockAgg == NULL) {
+    doHashGroupbyAggBatch(pOperator, pBlock);
+    return;
+  }
+
   SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
   int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
   //  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
@@ -304,6 +641,443 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   }
 }
 
+/*
+ * When the groups do not fit in the memory budget (queryGroupMemMB), the rows of the groups that are not in memory yet
+ * are hash partitioned into spill partitions, which are kept in the pages of a disk based buffer. Once the groups in
+ * memory are returned, the spill partitions are processed one by one as the input of the operator. A spill partition
+ * that still does not fit in memory is split again with the next bits of the hash value of the group keys.
+ */
+#define GROUP_SPILL_PARTITION_BITS 4
+#define GROUP_SPILL_PARTITIONS     (1 << GROUP_SPILL_PARTITION_BITS)
+#define GROUP_SPILL_MAX_LEVEL      (32 / GROUP_SPILL_PARTITION_BITS)
+#define GROUP_SPILL_PAGE_SIZE      (64 * 1024)
+
+typedef struct SGroupSpillPage {
+  int32_t  pageId;
+  uint64_t groupId;
+} SGroupSpillPage;
+
+typedef struct SGroupSpillPart {
+  int32_t level;
+  SArray* pPageList;  // SArray<SGroupSpillPage>
+} SGroupSpillPart;
+
+struct SGroupSpiller {
+  SDiskbasedBuf*  pBuf;
+  int32_t         rowCapacity;
+  bool            active;      // rows of the groups not in memory are spilled
+  int32_t         level;       // level of the input being processed, 0 is the input of the operator
+  SSDataBlock*    pStage[GROUP_SPILL_PARTITIONS];     // rows of each spill partition not yet written into page
+  SArray*         pPageList[GROUP_SPILL_PARTITIONS];  // pages of each spill partition being written
+  SArray*         pRowIndex[GROUP_SPILL_PARTITIONS];  // SArray<int32_t>, rows of the input block for each partition
+  SArray*         pPending;    // SArray<SGroupSpillPart>, spill partitions to be processed
+  SGroupSpillPart cur;         // spill partition being processed
+  int32_t         pageIndex;
+  SSDataBlock*    pBlock;      // data block loaded from the page of current spill partition
+  _hash_fn_t      hashFn;
+  int64_t         numOfRows;
+  int32_t         numOfPages;
+};
+
+static void destroyGroupSpiller(SGroupSpiller* pSpiller) {
+  if (pSpiller == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+    blockDataDestroy(pSpiller->pStage[i]);
+    taosArrayDestroy(pSpiller->pPageList[i]);
+    taosArrayDestroy(pSpiller->pRowIndex[i]);
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pSpiller->pPending); ++i) {
+    SGroupSpillPart* pPart = taosArrayGet(pSpiller->pPending, i);
+    taosArrayDestroy(pPart->pPageList);
+  }
+
+  taosArrayDestroy(pSpiller->pPending);
+  taosArrayDestroy(pSpiller->cur.pPageList);
+  blockDataDestroy(pSpiller->pBlock);
+  destroyDiskbasedBuf(pSpiller->pBuf);
+  taosMemoryFree(pSpiller);
+}
+
+static bool groupSpillEnabled(const SGroupSpiller* pSpiller) {
+  return tsQueryGroupMemMB > 0 && (pSpiller == NULL || pSpiller->level < GROUP_SPILL_MAX_LEVEL);
+}
+
+static bool groupSpillActive(const SGroupSpiller* pSpiller) { return pSpiller != NULL && pSpiller->active; }
+
+// start to spill the rows of new groups, the spiller is created with the first data block as the template
+static int32_t startGroupSpill(SGroupSpiller** ppSpiller, const SSDataBlock* pTemplate, const char* id) {
+  SGroupSpiller* pSpiller = *ppSpiller;
+  if (pSpiller == NULL) {
+    if (!osTempSpaceAvailable()) {
+      qError("%s failed to spill groups since %s", id, tstrerror(TSDB_CODE_NO_AVAIL_DISK));
+      return TSDB_CODE_NO_AVAIL_DISK;
+    }
+
+    pSpiller = taosMemoryCalloc(1, sizeof(SGroupSpiller));
+    if (pSpiller == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    *ppSpiller = pSpiller;
+    pSpiller->hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
+    pSpiller->pPending = taosArrayInit(GROUP_SPILL_PARTITIONS, sizeof(SGroupSpillPart));
+    if (pSpiller->pPending == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+      pSpiller->pStage[i] = createOneDataBlock(pTemplate, false);
+      pSpiller->pRowIndex[i] = taosArrayInit(16, sizeof(int32_t));
+      if (pSpiller->pStage[i] == NULL || pSpiller->pRowIndex[i] == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    int32_t pgsz = TMAX(getProperSortPageSize(blockDataGetRowSize(pSpiller->pStage[0])), GROUP_SPILL_PAGE_SIZE);
+    int32_t code = createDiskbasedBuf(&pSpiller->pBuf, pgsz, pgsz * 4, id, tsTempDir);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    pSpiller->rowCapacity = blockDataGetCapacityInRow(pSpiller->pStage[0], pgsz);
+    for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+      code = blockDataEnsureCapacity(pSpiller->pStage[i], pSpiller->rowCapacity);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+
+  for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+    if (pSpiller->pPageList[i] == NULL) {
+      pSpiller->pPageList[i] = taosArrayInit(4, sizeof(SGroupSpillPage));
+      if (pSpiller->pPageList[i] == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+  }
+
+  pSpiller->active = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t flushGroupSpillStage(SGroupSpiller* pSpiller, int32_t index) {
+  SSDataBlock* pStage = pSpiller->pStage[index];
+  if (pStage->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SGroupSpillPage page = {.groupId = pStage->info.groupId};
+  void*           pPage = getNewBufPage(pSpiller->pBuf, &page.pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  blockDataToBuf(pPage, pStage);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pSpiller->pBuf, pPage);
+
+  taosArrayPush(pSpiller->pPageList[index], &page);
+  pSpiller->numOfPages += 1;
+  blockDataCleanup(pStage);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t getGroupSpillPartIndex(const SGroupSpiller* pSpiller, const char* pKey, int32_t len) {
+  uint32_t hashVal = pSpiller->hashFn(pKey, len);
+  return (hashVal >> (pSpiller->level * GROUP_SPILL_PARTITION_BITS)) & (GROUP_SPILL_PARTITIONS - 1);
+}
+
+/*
+ * append num rows of the data block to the spill partition index, the rows are pRows[0, num) if pRows is not NULL,
+ * otherwise [start, start + num). The rows are copied column by column, as many as the stage of the partition can hold.
+ */
+static int32_t appendGroupSpillRows(SGroupSpiller* pSpiller, int32_t index, const SSDataBlock* pBlock,
+                                    const int32_t* pRows, int32_t start, int32_t num, uint64_t groupId) {
+  SSDataBlock* pStage = pSpiller->pStage[index];
+  size_t       numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+
+  if (pStage->info.rows > 0 && pStage->info.groupId != groupId) {
+    int32_t code = flushGroupSpillStage(pSpiller, index);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  int32_t k = 0;
+  while (k < num) {
+    if (pStage->info.rows >= pSpiller->rowCapacity) {
+      int32_t code = flushGroupSpillStage(pSpiller, index);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+
+    int32_t n = TMIN(num - k, pSpiller->rowCapacity - pStage->info.rows);
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, i);
+      SColumnInfoData* pDst = taosArrayGet(pStage->pDataBlock, i);
+
+      for (int32_t m = 0; m < n; ++m) {
+        int32_t j = (pRows != NULL) ? pRows[k + m] : start + k + m;
+        bool    isNull = colDataIsNull_s(pSrc, j);
+        int32_t code = colDataAppend(pDst, pStage->info.rows + m, isNull ? NULL : colDataGetData(pSrc, j), isNull);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
+      }
+    }
+
+    pStage->info.rows += n;
+    pStage->info.groupId = groupId;
+    k += n;
+  }
+
+  pSpiller->numOfRows += num;
+  return TSDB_CODE_SUCCESS;
+}
+
+// append the rows of the data block collected for each spill partition, a partition at a time
+static int32_t appendGroupSpillRowIndex(SGroupSpiller* pSpiller, const SSDataBlock* pBlock) {
+  for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+    SArray* pRowIndex = pSpiller->pRowIndex[i];
+    int32_t num = taosArrayGetSize(pRowIndex);
+    if (num == 0) {
+      continue;
+    }
+
+    int32_t code = appendGroupSpillRows(pSpiller, i, pBlock, taosArrayGet(pRowIndex, 0), 0, num, 0);
+    taosArrayClear(pRowIndex);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// write out the rows of all spill partitions, and queue the spill partitions to be processed later
+static int32_t finishGroupSpill(SGroupSpiller* pSpiller) {
+  if (!groupSpillActive(pSpiller)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+    int32_t code = flushGroupSpillStage(pSpiller, i);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    if (taosArrayGetSize(pSpiller->pPageList[i]) > 0) {
+      SGroupSpillPart part = {.level = pSpiller->level + 1, .pPageList = pSpiller->pPageList[i]};
+      taosArrayPush(pSpiller->pPending, &part);
+      pSpiller->pPageList[i] = NULL;
+    }
+  }
+
+  pSpiller->active = false;
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool nextGroupSpillPart(SGroupSpiller* pSpiller) {
+  if (pSpiller == NULL || taosArrayGetSize(pSpiller->pPending) == 0) {
+    return false;
+  }
+
+  taosArrayDestroy(pSpiller->cur.pPageList);
+  pSpiller->cur = *(SGroupSpillPart*)taosArrayPop(pSpiller->pPending);
+  pSpiller->level = pSpiller->cur.level;
+  pSpiller->pageIndex = 0;
+  return true;
+}
+
+// load the next page of current spill partition, the page is recycled once it is loaded
+static int32_t nextGroupSpillBlock(SGroupSpiller* pSpiller, SSDataBlock** ppBlock) {
+  *ppBlock = NULL;
+  if (pSpiller->pageIndex >= taosArrayGetSize(pSpiller->cur.pPageList)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pSpiller->pBlock == NULL) {
+    pSpiller->pBlock = createOneDataBlock(pSpiller->pStage[0], false);
+    if (pSpiller->pBlock == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SGroupSpillPage* pPageInfo = taosArrayGet(pSpiller->cur.pPageList, pSpiller->pageIndex);
+  void*            pPage = getBufPage(pSpiller->pBuf, pPageInfo->pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  SSDataBlock* pBlock = pSpiller->pBlock;
+  blockDataCleanup(pBlock);
+  int32_t code = blockDataFromBuf(pBlock, pPage);
+  dBufSetBufPageRecycled(pSpiller->pBuf, pPage);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // the null flag is not kept in page
+  size_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    pCol->hasNull = true;
+  }
+
+  pBlock->info.groupId = pPageInfo->groupId;
+  pSpiller->pageIndex += 1;
+  *ppBlock = pBlock;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the hash table counts its nodes and buckets, the key and result row position of a group are the node payload
+static int64_t getGroupbyMemSize(const SGroupbyOperatorInfo* pInfo) {
+  const SSHashObj* pHashTable = pInfo->aggSup.pResultRowHashTable;
+  int64_t          entrySize =
+      GET_RES_WINDOW_KEY_LEN(pInfo->groupKeyLen) + sizeof(SResultRowPosition) + pInfo->aggSup.resultRowSize;
+
+  int64_t size = tSimpleHashGetMemSize(pHashTable) + tSimpleHashGetSize(pHashTable) * entrySize;
+  if (pInfo->pKeyTable != NULL) {
+    size += (int64_t)pInfo->pKeyTable->capacity * (pInfo->pKeyTable->entrySize + sizeof(uint64_t));
+  }
+
+  return size;
+}
+
+static void checkGroupbyMemBudget(SOperatorInfo* pOperator, const SSDataBlock* pBlock) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  if (groupSpillActive(pInfo->pSpiller) || !groupSpillEnabled(pInfo->pSpiller) ||
+      getGroupbyMemSize(pInfo) < tsQueryGroupMemMB * 1048576LL) {
+    return;
+  }
+
+  SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
+  int32_t        code = startGroupSpill(&pInfo->pSpiller, pBlock, GET_TASKID(pTaskInfo));
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  qDebug("%s group by spills rows of new groups, groups in memory:%d, level:%d", GET_TASKID(pTaskInfo),
+         tSimpleHashGetSize(pInfo->aggSup.pResultRowHashTable), pInfo->pSpiller->level + 1);
+}
+
+static void applyOrSpillGroupRows(SOperatorInfo* pOperator, SSDataBlock* pBlock, int32_t start, int32_t num) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+  int32_t               numOfExprs = pOperator->exprSupp.numOfExprs;
+
+  int32_t len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+  SET_RES_WINDOW_KEY(pInfo->aggSup.keyBuf, pInfo->keyBuf, len, pBlock->info.groupId);
+  if (tSimpleHashGet(pInfo->aggSup.pResultRowHashTable, pInfo->aggSup.keyBuf, GET_RES_WINDOW_KEY_LEN(len)) == NULL) {
+    int32_t index = getGroupSpillPartIndex(pInfo->pSpiller, pInfo->keyBuf, len);
+    int32_t code = appendGroupSpillRows(pInfo->pSpiller, index, pBlock, NULL, start, num, pBlock->info.groupId);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+    return;
+  }
+
+  int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), numOfExprs, pInfo->keyBuf, len,
+                                        pBlock->info.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+  if (ret != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_APP_ERROR);
+  }
+
+  doApplyFunctions(pTaskInfo, pCtx, NULL, start, num, pBlock->info.rows, numOfExprs);
+  doAssignGroupKeys(pCtx, numOfExprs, pBlock->info.rows, start);
+}
+
+// only the groups already in memory are aggregated, the rows of other groups are spilled
+static void doHashGroupbyAggSpill(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  int32_t               numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
+
+  terrno = TSDB_CODE_SUCCESS;
+  int32_t start = 0;
+  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+    if (j > start) {
+      if (groupKeyCompare(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j, numOfGroupCols)) {
+        continue;
+      }
+
+      applyOrSpillGroupRows(pOperator, pBlock, start, j - start);
+      start = j;
+    }
+
+    recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
+    if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
+      T_LONG_JMP(pTaskInfo->env, terrno);
+    }
+  }
+
+  if (pBlock->info.rows > 0) {
+    applyOrSpillGroupRows(pOperator, pBlock, start, pBlock->info.rows - start);
+  }
+}
+
+static void doHashGroupbyAggOrSpill(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  if (groupSpillActive(pInfo->pSpiller)) {
+    doHashGroupbyAggSpill(pOperator, pBlock);
+  } else {
+    doHashGroupbyAgg(pOperator, pBlock);
+    checkGroupbyMemBudget(pOperator, pBlock);
+  }
+}
+
+// discard the returned groups, and aggregate the next spill partition
+static bool loadGroupbySpillPart(SOperatorInfo* pOperator) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupSpiller*        pSpiller = pInfo->pSpiller;
+
+  if (!nextGroupSpillPart(pSpiller)) {
+    return false;
+  }
+
+  cleanupGroupResInfo(&pInfo->groupResInfo);
+  tSimpleHashClear(pInfo->aggSup.pResultRowHashTable);
+  clearDiskbasedBuf(pInfo->aggSup.pResultBuf);
+  pInfo->aggSup.currentPageId = -1;
+  pInfo->binfo.resultRowInfo.cur.pageId = -1;
+  groupKeyTableClear(pInfo->pKeyTable);
+  pInfo->isInit = false;
+
+  qDebug("%s group by loads spilled partition, level:%d, pages:%d", GET_TASKID(pTaskInfo), pSpiller->level,
+         (int32_t)taosArrayGetSize(pSpiller->cur.pPageList));
+
+  while (1) {
+    SSDataBlock* pBlock = NULL;
+    int32_t      code = nextGroupSpillBlock(pSpiller, &pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    if (pBlock == NULL) {
+      break;
+    }
+
+    setInputDataBlock(pOperator, pOperator->exprSupp.pCtx, pBlock, TSDB_ORDER_ASC, MAIN_SCAN, true);
+    doHashGroupbyAggOrSpill(pOperator, pBlock);
+  }
+
+  int32_t code = finishGroupSpill(pSpiller);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, 0);
+  return true;
+}
+
 static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
@@ -313,8 +1087,10 @@ static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
     doFilter(pInfo->pCondition, pRes, NULL);
 
     if (!hasRemainResults(&pInfo->groupResInfo)) {
-      doSetOperatorCompleted(pOperator);
-      break;
+      if (!loadGroupbySpillPart(pOperator)) {
+        doSetOperatorCompleted(pOperator);
+        break;
+      }
     }
 
     if (pRes->info.rows > 0) {
@@ -368,7 +1144,12 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
       }
     }
 
-    doHashGroupbyAgg(pOperator, pBlock);
+    doHashGroupbyAggOrSpill(pOperator, pBlock);
+  }
+
+  int32_t code = finishGroupSpill(pInfo->pSpiller);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
   }
 
   pOperator->status = OP_RES_TO_RETURN;
@@ -416,6 +1197,9 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SExprInfo* pEx
     goto _error;
   }
 
+  // var-length group keys are handled row by row
+  pInfo->pKeyTable = createGroupKeyTable(pGroupColList);
+
   initResultSizeInfo(&pOperator->resultInfo, 4096);
   code = initAggInfo(&pOperator->exprSupp, &pInfo->aggSup, pExprInfo, numOfCols, pInfo->groupKeyLen, pTaskInfo->id.str);
   if (code != TSDB_CODE_SUCCESS) {
@@ -451,11 +1235,19 @@ static void doHashPartition(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
 //  SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
 
   SPartitionOperatorInfo* pInfo = pOperator->info;
+  bool                    spill = groupSpillActive(pInfo->pSpiller);
 
   for (int32_t j = 0; j < pBlock->info.rows; ++j) {
     recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
     int32_t len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
 
+    // the rows to spill are collected per spill partition, and appended once the whole block is scanned
+    if (spill && taosHashGet(pInfo->pGroupSet, pInfo->keyBuf, len) == NULL) {
+      int32_t index = getGroupSpillPartIndex(pInfo->pSpiller, pInfo->keyBuf, len);
+      taosArrayPush(pInfo->pSpiller->pRowIndex[index], &j);
+      continue;
+    }
+
     SDataGroupInfo* pGroupInfo = NULL;
     void *pPage = getCurrentDataGroupInfo(pInfo, &pGroupInfo, len);
 
@@ -533,6 +1325,13 @@ static void doHashPartition(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
     setBufPageDirty(pPage, true);
     releaseBufPage(pInfo->pBuf, pPage);
   }
+
+  if (spill) {
+    int32_t code = appendGroupSpillRowIndex(pInfo->pSpiller, pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      terrno = code;
+    }
+  }
 }
 
 void* getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, int32_t len) {
@@ -541,7 +1340,7 @@ void* getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInf
   void* pPage = NULL;
   if (p == NULL) { // it is a new group
     SDataGroupInfo gi = {0};
-    gi.pPageList = taosArrayInit(100, sizeof(int32_t));
+    gi.pPageList = taosArrayInit(4, sizeof(int32_t));
     taosHashPut(pInfo->pGroupSet, pInfo->keyBuf, len, &gi, sizeof(SDataGroupInfo));
 
     p = taosHashGet(pInfo->pGroupSet, pInfo->keyBuf, len);
@@ -613,6 +1412,10 @@ static void clearPartitionOperator(SPartitionOperatorInfo* pInfo) {
   while( (ite = taosHashIterate(pInfo->pGroupSet, ite)) != NULL ) {
     taosArrayDestroy( ((SDataGroupInfo *)ite)->pPageList);
   }
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->sortedGroupArray); ++i) {
+    taosArrayDestroy(((SDataGroupInfo*)taosArrayGet(pInfo->sortedGroupArray, i))->pPageList);
+  }
+  taosHashClear(pInfo->pGroupSet);
   taosArrayClear(pInfo->sortedGroupArray);
   clearDiskbasedBuf(pInfo->pBuf);
 }
@@ -629,6 +1432,95 @@ static int compareDataGroupInfo(const void* group1, const void* group2) {
   return (pGroupInfo1->groupId < pGroupInfo2->groupId)? -1:1;
 }
 
+static void sortPartitionGroups(SPartitionOperatorInfo* pInfo) {
+  SArray* groupArray = taosArrayInit(taosHashGetSize(pInfo->pGroupSet), sizeof(SDataGroupInfo));
+
+  void* pGroupIter = taosHashIterate(pInfo->pGroupSet, NULL);
+  while (pGroupIter != NULL) {
+    SDataGroupInfo* pGroupInfo = pGroupIter;
+    taosArrayPush(groupArray, pGroupInfo);
+    pGroupIter = taosHashIterate(pInfo->pGroupSet, pGroupIter);
+  }
+
+  taosArraySort(groupArray, compareDataGroupInfo);
+  taosArrayDestroy(pInfo->sortedGroupArray);
+  pInfo->sortedGroupArray = groupArray;
+  pInfo->groupIndex = -1;
+  taosHashClear(pInfo->pGroupSet);
+}
+
+// each group keeps at least one page of the paged buffer, in memory or on disk
+static int64_t getPartitionMemSize(const SPartitionOperatorInfo* pInfo) {
+  int64_t entrySize = pInfo->groupKeyLen + sizeof(SDataGroupInfo) + getBufPageSize(pInfo->pBuf);
+  return taosHashGetMemSize(pInfo->pGroupSet) + taosHashGetSize(pInfo->pGroupSet) * entrySize;
+}
+
+static void checkPartitionMemBudget(SOperatorInfo* pOperator, const SSDataBlock* pBlock) {
+  SPartitionOperatorInfo* pInfo = pOperator->info;
+  if (groupSpillActive(pInfo->pSpiller) || !groupSpillEnabled(pInfo->pSpiller) ||
+      getPartitionMemSize(pInfo) < tsQueryGroupMemMB * 1048576LL) {
+    return;
+  }
+
+  SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
+  int32_t        code = startGroupSpill(&pInfo->pSpiller, pBlock, GET_TASKID(pTaskInfo));
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  qDebug("%s partition spills rows of new groups, groups in memory:%d, level:%d", GET_TASKID(pTaskInfo),
+         (int32_t)taosHashGetSize(pInfo->pGroupSet), pInfo->pSpiller->level + 1);
+}
+
+static void doHashPartitionBlock(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
+
+  terrno = TSDB_CODE_SUCCESS;
+  doHashPartition(pOperator, pBlock);
+  if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
+    T_LONG_JMP(pTaskInfo->env, terrno);
+  }
+
+  checkPartitionMemBudget(pOperator, pBlock);
+}
+
+// discard the returned groups, and partition the next spill partition
+static bool loadPartitionSpillPart(SOperatorInfo* pOperator) {
+  SExecTaskInfo*          pTaskInfo = pOperator->pTaskInfo;
+  SPartitionOperatorInfo* pInfo = pOperator->info;
+  SGroupSpiller*          pSpiller = pInfo->pSpiller;
+
+  if (!nextGroupSpillPart(pSpiller)) {
+    return false;
+  }
+
+  clearPartitionOperator(pInfo);
+  qDebug("%s partition loads spilled partition, level:%d, pages:%d", GET_TASKID(pTaskInfo), pSpiller->level,
+         (int32_t)taosArrayGetSize(pSpiller->cur.pPageList));
+
+  while (1) {
+    SSDataBlock* pBlock = NULL;
+    int32_t      code = nextGroupSpillBlock(pSpiller, &pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    if (pBlock == NULL) {
+      break;
+    }
+
+    doHashPartitionBlock(pOperator, pBlock);
+  }
+
+  int32_t code = finishGroupSpill(pSpiller);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  sortPartitionGroups(pInfo);
+  return true;
+}
+
 static SSDataBlock* buildPartitionResult(SOperatorInfo* pOperator) {
   SPartitionOperatorInfo* pInfo = pOperator->info;
 
@@ -636,10 +1528,13 @@ static SSDataBlock* buildPartitionResult(SOperatorInfo* pOperator) {
   if (pInfo->groupIndex == -1 || pInfo->pageIndex >= taosArrayGetSize(pGroupInfo->pPageList)) {
     // try next group data
     ++pInfo->groupIndex;
-    if (pInfo->groupIndex >= taosArrayGetSize(pInfo->sortedGroupArray)) {
-      doSetOperatorCompleted(pOperator);
-      clearPartitionOperator(pInfo);
-      return NULL;
+    while (pInfo->groupIndex >= taosArrayGetSize(pInfo->sortedGroupArray)) {
+      if (!loadPartitionSpillPart(pOperator)) {
+        doSetOperatorCompleted(pOperator);
+        clearPartitionOperator(pInfo);
+        return NULL;
+      }
+      ++pInfo->groupIndex;
     }
 
     pGroupInfo = taosArrayGet(pInfo->sortedGroupArray, pInfo->groupIndex);
@@ -694,26 +1589,15 @@ static SSDataBlock* hashPartition(SOperatorInfo* pOperator) {
       }
     }
 
-    terrno = TSDB_CODE_SUCCESS;
-    doHashPartition(pOperator, pBlock);
-    if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-      T_LONG_JMP(pTaskInfo->env, terrno);
-    }
+    doHashPartitionBlock(pOperator, pBlock);
   }
 
-  SArray* groupArray = taosArrayInit(taosHashGetSize(pInfo->pGroupSet), sizeof(SDataGroupInfo));
-
-  void* pGroupIter = taosHashIterate(pInfo->pGroupSet, NULL);
-  while (pGroupIter != NULL) {
-    SDataGroupInfo* pGroupInfo = pGroupIter;
-    taosArrayPush(groupArray, pGroupInfo);
-    pGroupIter = taosHashIterate(pInfo->pGroupSet, pGroupIter);
+  int32_t code = finishGroupSpill(pInfo->pSpiller);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
   }
 
-  taosArraySort(groupArray, compareDataGroupInfo);
-  pInfo->sortedGroupArray = groupArray;
-  pInfo->groupIndex = -1;
-  taosHashClear(pInfo->pGroupSet);
+  sortPartitionGroups(pInfo);
 
   pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
 
@@ -740,6 +1624,7 @@ static void destroyPartitionOperatorInfo(void* param) {
 
   cleanupExprSupp(&pInfo->scalarSup);
   destroyDiskbasedBuf(pInfo->pBuf);
+  destroyGroupSpiller(pInfo->pSpiller);
   taosMemoryFreeClear(param);
 }
 
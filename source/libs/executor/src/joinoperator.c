@@ -19,15 +19,33 @@
 #include "querynodes.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "tmsg.h"
 #include "ttypes.h"
 
+#define HASH_JOIN_PAGE_SIZE (64 * 1024)
+
+typedef struct SHJoinRowRef {
+  int32_t pageId;
+  int32_t rowIndex;
+  int32_t next;  // index of the next row with the same key in pRowRefs, -1 for the end of the list
+} SHJoinRowRef;
+
+typedef struct SHJoinMatch {
+  int32_t probeRow;
+  int32_t pageId;
+  int32_t rowIndex;
+} SHJoinMatch;
+
 static void         setJoinColumnInfo(SColumnInfo* pColumn, const SColumnNode* pColumnNode);
 static SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator);
 static void         destroyMergeJoinOperator(void* param);
 static void         extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                          SSortMergeJoinPhysiNode* pJoinNode);
+static SNode*       createJoinFilterCond(SNode* pOnConditions, SNode* pConditions);
+static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
 
 static void extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                  SSortMergeJoinPhysiNode* pJoinNode) {
@@ -82,20 +100,7 @@ SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t
 
   extractTimeCondition(pInfo, pDownstream, numOfDownstream, pJoinNode);
 
-  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
-    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pInfo->pCondAfterMerge);
-    pLogicCond->pParameterList = nodesMakeList();
-    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->pOnConditions));
-    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->node.pConditions));
-    pLogicCond->condType = LOGIC_COND_TYPE_AND;
-  } else if (pJoinNode->pOnConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesCloneNode(pJoinNode->pOnConditions);
-  } else if (pJoinNode->node.pConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesCloneNode(pJoinNode->node.pConditions);
-  } else {
-    pInfo->pCondAfterMerge = NULL;
-  }
+  pInfo->pCondAfterMerge = createJoinFilterCond(pJoinNode->pOnConditions, pJoinNode->node.pConditions);
 
   pInfo->inputOrder = TSDB_ORDER_ASC;
   if (pJoinNode->inputTsOrder == ORDER_ASC) {
@@ -120,6 +125,25 @@ _error:
   return NULL;
 }
 
+// the on conditions and the where conditions are both evaluated on the joined rows
+static SNode* createJoinFilterCond(SNode* pOnConditions, SNode* pConditions) {
+  if (pOnConditions != NULL && pConditions != NULL) {
+    SNode*               pCond = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
+    pLogicCond->pParameterList = nodesMakeList();
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pOnConditions));
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pConditions));
+    pLogicCond->condType = LOGIC_COND_TYPE_AND;
+    return pCond;
+  } else if (pOnConditions != NULL) {
+    return nodesCloneNode(pOnConditions);
+  } else if (pConditions != NULL) {
+    return nodesCloneNode(pConditions);
+  } else {
+    return NULL;
+  }
+}
+
 void setJoinColumnInfo(SColumnInfo* pColumn, const SColumnNode* pColumnNode) {
   pColumn->slotId = pColumnNode->slotId;
   pColumn->type = pColumnNode->node.resType.type;
@@ -394,3 +418,533 @@ SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator) {
   }
   return (pRes->info.rows > 0) ? pRes : NULL;
 }
+
+static int32_t initHashJoinKeyCols(SArray** ppKeyCols, SNodeList* pKeys, int32_t* pKeyLen) {
+  *ppKeyCols = taosArrayInit(LIST_LENGTH(pKeys), sizeof(SColumnInfo));
+  if (*ppKeyCols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t len = 0;
+  SNode*  pNode = NULL;
+  FOREACH(pNode, pKeys) {
+    SColumnInfo col = {0};
+    setJoinColumnInfo(&col, (SColumnNode*)pNode);
+    taosArrayPush(*ppKeyCols, &col);
+    len += col.bytes + (IS_VAR_DATA_TYPE(col.type) ? VARSTR_HEADER_SIZE : 0);
+  }
+
+  *pKeyLen = TMAX(*pKeyLen, len);
+  return TSDB_CODE_SUCCESS;
+}
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHashJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHashJoinOperatorInfo));
+  SOperatorInfo*         pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  if (pOperator == NULL || pInfo == NULL) {
+    goto _error;
+  }
+
+  int32_t    numOfCols = 0;
+  SExprInfo* pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+
+  pInfo->pRes = createResDataBlock(pJoinNode->node.pOutputDataBlockDesc);
+  pInfo->joinType = pJoinNode->joinType;
+  pInfo->buildIdx = -1;
+
+  int32_t keyLen = 0;
+  if (initHashJoinKeyCols(&pInfo->pKeyCols[0], pJoinNode->pOnLeft, &keyLen) != TSDB_CODE_SUCCESS ||
+      initHashJoinKeyCols(&pInfo->pKeyCols[1], pJoinNode->pOnRight, &keyLen) != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pInfo->keyBuf = taosMemoryMalloc(keyLen);
+  pInfo->pOutputCols = taosMemoryCalloc(numOfCols, sizeof(SHJoinOutputCol));
+  pInfo->pKeyHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  pInfo->pRowRefs = taosArrayInit(1024, sizeof(SHJoinRowRef));
+  pInfo->pMatches = taosArrayInit(pOperator->resultInfo.capacity, sizeof(SHJoinMatch));
+  pInfo->pPageIds[0] = taosArrayInit(4, sizeof(int32_t));
+  pInfo->pPageIds[1] = taosArrayInit(4, sizeof(int32_t));
+  if (pInfo->keyBuf == NULL || pInfo->pOutputCols == NULL || pInfo->pKeyHash == NULL || pInfo->pRowRefs == NULL ||
+      pInfo->pMatches == NULL || pInfo->pPageIds[0] == NULL || pInfo->pPageIds[1] == NULL) {
+    goto _error;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumn* pCol = pExprInfo[i].base.pParam[0].pCol;
+    pInfo->pOutputCols[i].child = (pCol->dataBlockId == pDownstream[0]->resultDataBlockId) ? 0 : 1;
+    pInfo->pOutputCols[i].slotId = pCol->slotId;
+  }
+
+  pInfo->pCondAfterJoin = createJoinFilterCond(pJoinNode->pOnConditions, pJoinNode->node.pConditions);
+
+  pOperator->name = "HashJoinOperator";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN;
+  pOperator->blocking = true;
+  pOperator->status = OP_NOT_OPENED;
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+  pOperator->info = pInfo;
+  pOperator->pTaskInfo = pTaskInfo;
+
+  pOperator->fpSet =
+      createOperatorFpSet(operatorDummyOpenFn, doHashJoin, NULL, NULL, destroyHashJoinOperator, NULL, NULL, NULL);
+  int32_t code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = TSDB_CODE_OUT_OF_MEMORY;
+  return NULL;
+}
+
+static void destroyHashJoinOperator(void* param) {
+  SHashJoinOperatorInfo* pInfo = (SHashJoinOperatorInfo*)param;
+
+  for (int32_t i = 0; i < 2; ++i) {
+    taosArrayDestroy(pInfo->pKeyCols[i]);
+    taosArrayDestroy(pInfo->pPageIds[i]);
+    blockDataDestroy(pInfo->pSchema[i]);
+  }
+
+  nodesDestroyNode(pInfo->pCondAfterJoin);
+  taosHashCleanup(pInfo->pKeyHash);
+  taosArrayDestroy(pInfo->pRowRefs);
+  taosArrayDestroy(pInfo->pMatches);
+  taosArrayDestroy(pInfo->pPageView);  // the columns refer to the buffer pages, nothing to free
+  destroyDiskbasedBuf(pInfo->pBuf);
+  blockDataDestroy(pInfo->pProbeCopy);
+  blockDataDestroy(pInfo->pRes);
+  taosMemoryFree(pInfo->pOutputCols);
+  taosMemoryFree(pInfo->keyBuf);
+  taosMemoryFree(pInfo->pHeads);
+  taosMemoryFreeClear(param);
+}
+
+// the keys of one row are concatenated into buf, -1 is returned if any of them is null, which matches nothing
+static int32_t getHashJoinKey(const SArray* pKeyCols, const SArray* pCols, int32_t row, char* buf) {
+  char* p = buf;
+  for (int32_t i = 0; i < taosArrayGetSize(pKeyCols); ++i) {
+    SColumnInfo*     pKey = taosArrayGet(pKeyCols, i);
+    SColumnInfoData* pCol = taosArrayGet(pCols, pKey->slotId);
+    if (colDataIsNull_s(pCol, row)) {
+      return -1;
+    }
+
+    char*   pData = colDataGetData(pCol, row);
+    int32_t len = IS_VAR_DATA_TYPE(pCol->info.type) ? varDataTLen(pData) : pCol->info.bytes;
+    memcpy(p, pData, len);
+    p += len;
+  }
+
+  return (int32_t)(p - buf);
+}
+
+// The input blocks are kept in the paged buffer in the format of blockDataToBuf, which keeps them in memory until
+// half of tsQueryJoinMemMB is used up and spills the least recently used pages to disk afterwards. The rest of the
+// budget is left to the hash table.
+static int32_t addBlockToHashJoinBuf(SHashJoinOperatorInfo* pInfo, int32_t child, SSDataBlock* pBlock,
+                                     const char* id) {
+  if (pInfo->pBuf == NULL) {
+    pInfo->memLimit = (int64_t)tsQueryJoinMemMB * 1024 * 1024;
+    pInfo->pageSize = TMAX(getProperSortPageSize(blockDataGetRowSize(pBlock)), HASH_JOIN_PAGE_SIZE);
+
+    int32_t inMemSize = (int32_t)TMAX(pInfo->memLimit / 2, pInfo->pageSize);
+    int32_t code = createDiskbasedBuf(&pInfo->pBuf, pInfo->pageSize, inMemSize, id, tsTempDir);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  if (pInfo->pSchema[child] == NULL) {
+    pInfo->pSchema[child] = createOneDataBlock(pBlock, false);
+    if (pInfo->pSchema[child] == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  int32_t start = 0;
+  while (start < pBlock->info.rows) {
+    int32_t stop = 0;
+    blockDataSplitRows(pBlock, pBlock->info.hasVarCol, start, &stop, pInfo->pageSize);
+    SSDataBlock* p = blockDataExtractBlock(pBlock, start, stop - start + 1);
+    if (p == NULL) {
+      return terrno;
+    }
+
+    int32_t pageId = -1;
+    void*   pPage = getNewBufPage(pInfo->pBuf, &pageId);
+    if (pPage == NULL) {
+      blockDataDestroy(p);
+      return terrno;
+    }
+
+    blockDataToBuf(pPage, p);
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pInfo->pBuf, pPage);
+    blockDataDestroy(p);
+
+    taosArrayPush(pInfo->pPageIds[child], &pageId);
+    start = stop + 1;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// set the columns of the page view to the data in the page without copying it, return the number of rows
+static int32_t setHashJoinPageView(SArray* pView, const char* pPage) {
+  int32_t     numOfRows = *(int32_t*)pPage;
+  const char* pStart = pPage + sizeof(int32_t);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pView); ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pView, i);
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      pCol->varmeta.offset = (int32_t*)pStart;
+      pStart += numOfRows * sizeof(int32_t);
+    } else {
+      pCol->nullbitmap = (char*)pStart;
+      pStart += BitmapLen(numOfRows);
+    }
+
+    int32_t len = *(int32_t*)pStart;
+    pStart += sizeof(int32_t);
+    pCol->pData = (char*)pStart;
+    pStart += len;
+  }
+
+  return numOfRows;
+}
+
+// The rows stay in the paged buffer, but the hash table on them is kept in memory. It is charged against the same
+// tsQueryJoinMemMB as the pages the buffer holds in memory, and the build side is not partitioned to disk, so a build
+// side whose hash table does not fit fails the query with TSDB_CODE_QRY_NOT_ENOUGH_BUFFER.
+static int64_t getHashJoinTableSize(const SHashJoinOperatorInfo* pInfo) {
+  return taosHashGetMemSize(pInfo->pKeyHash) + pInfo->keyBytes +
+         (int64_t)taosArrayGetSize(pInfo->pRowRefs) * sizeof(SHJoinRowRef);
+}
+
+static int64_t getHashJoinBufMemSize(const SHashJoinOperatorInfo* pInfo) {
+  return TMIN((int64_t)getTotalBufSize(pInfo->pBuf), (int64_t)getNumOfInMemBufPages(pInfo->pBuf) * pInfo->pageSize);
+}
+
+static int32_t buildHashJoinTable(SHashJoinOperatorInfo* pInfo, const char* id) {
+  int32_t      child = pInfo->buildIdx;
+  SSDataBlock* pSchema = pInfo->pSchema[child];
+
+  pInfo->pPageView = taosArrayInit(taosArrayGetSize(pSchema->pDataBlock), sizeof(SColumnInfoData));
+  if (pInfo->pPageView == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < taosArrayGetSize(pSchema->pDataBlock); ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pSchema->pDataBlock, i);
+    SColumnInfoData  col = {.info = pCol->info, .hasNull = true};
+    taosArrayPush(pInfo->pPageView, &col);
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pPageIds[child]); ++i) {
+    int32_t pageId = *(int32_t*)taosArrayGet(pInfo->pPageIds[child], i);
+    void*   pPage = getBufPage(pInfo->pBuf, pageId);
+    if (pPage == NULL) {
+      return terrno;
+    }
+
+    int32_t numOfRows = setHashJoinPageView(pInfo->pPageView, pPage);
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      int32_t len = getHashJoinKey(pInfo->pKeyCols[child], pInfo->pPageView, j, pInfo->keyBuf);
+      if (len < 0) {
+        continue;
+      }
+
+      int32_t      index = taosArrayGetSize(pInfo->pRowRefs);
+      int32_t*     pHead = taosHashGet(pInfo->pKeyHash, pInfo->keyBuf, len);
+      SHJoinRowRef ref = {.pageId = pageId, .rowIndex = j, .next = (pHead != NULL) ? *pHead : -1};
+      if (taosArrayPush(pInfo->pRowRefs, &ref) == NULL) {
+        releaseBufPage(pInfo->pBuf, pPage);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+
+      if (pHead != NULL) {
+        *pHead = index;
+      } else if (taosHashPut(pInfo->pKeyHash, pInfo->keyBuf, len, &index, sizeof(index)) != 0) {
+        releaseBufPage(pInfo->pBuf, pPage);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      } else {
+        pInfo->keyBytes += len;
+      }
+    }
+
+    releaseBufPage(pInfo->pBuf, pPage);
+
+    int64_t size = getHashJoinTableSize(pInfo);
+    int64_t bufSize = getHashJoinBufMemSize(pInfo);
+    if (size + bufSize > pInfo->memLimit) {
+      qError("%s hash join table of %" PRId64 " bytes and buffered rows of %" PRId64 " bytes exceed limit:%" PRId64,
+             id, size, bufSize, pInfo->memLimit);
+      return TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Both children are read in turn until one of them is exhausted, which is the smaller one and builds the hash table.
+// The blocks read from the other child are probed before the rest of it.
+static int32_t doOpenHashJoinOperator(SOperatorInfo* pOperator) {
+  if (OPTR_IS_OPENED(pOperator)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+  int32_t                code = TSDB_CODE_SUCCESS;
+
+  while (pInfo->buildIdx < 0 && code == TSDB_CODE_SUCCESS) {
+    for (int32_t i = 0; i < 2; ++i) {
+      SOperatorInfo* pChild = pOperator->pDownstream[i];
+      SSDataBlock*   pBlock = pChild->fpSet.getNextFn(pChild);
+      if (pBlock == NULL) {
+        pInfo->buildIdx = i;
+        break;
+      }
+
+      code = addBlockToHashJoinBuf(pInfo, i, pBlock, GET_TASKID(pTaskInfo));
+      if (code != TSDB_CODE_SUCCESS) {
+        break;
+      }
+    }
+  }
+
+  if (code == TSDB_CODE_SUCCESS && pInfo->pSchema[pInfo->buildIdx] != NULL) {
+    code = buildHashJoinTable(pInfo, GET_TASKID(pTaskInfo));
+  } else if (code == TSDB_CODE_SUCCESS) {
+    // nothing to join with
+    doSetOperatorCompleted(pOperator);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  qDebug("%s hash join builds from child %d, %d rows, %d keys", GET_TASKID(pTaskInfo), pInfo->buildIdx,
+         (int32_t)taosArrayGetSize(pInfo->pRowRefs), taosHashGetSize(pInfo->pKeyHash));
+
+  OPTR_SET_OPENED(pOperator);
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* getNextHashJoinProbeBlock(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t                child = 1 - pInfo->buildIdx;
+
+  if (pInfo->probePageIndex < taosArrayGetSize(pInfo->pPageIds[child])) {
+    int32_t pageId = *(int32_t*)taosArrayGet(pInfo->pPageIds[child], pInfo->probePageIndex++);
+    void*   pPage = getBufPage(pInfo->pBuf, pageId);
+    if (pPage == NULL) {
+      T_LONG_JMP(pOperator->pTaskInfo->env, terrno);
+    }
+
+    if (pInfo->pProbeCopy == NULL) {
+      pInfo->pProbeCopy = createOneDataBlock(pInfo->pSchema[child], false);
+    }
+
+    int32_t code = blockDataFromBuf(pInfo->pProbeCopy, pPage);
+    releaseBufPage(pInfo->pBuf, pPage);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pOperator->pTaskInfo->env, code);
+    }
+
+    for (int32_t i = 0; i < taosArrayGetSize(pInfo->pProbeCopy->pDataBlock); ++i) {
+      SColumnInfoData* pCol = taosArrayGet(pInfo->pProbeCopy->pDataBlock, i);
+      pCol->hasNull = true;
+    }
+    return pInfo->pProbeCopy;
+  }
+
+  if (pInfo->probeDone) {
+    return NULL;
+  }
+
+  SOperatorInfo* pChild = pOperator->pDownstream[child];
+  SSDataBlock*   pBlock = pChild->fpSet.getNextFn(pChild);
+  if (pBlock == NULL) {
+    pInfo->probeDone = true;
+  }
+  return pBlock;
+}
+
+// look up the keys of all rows in the probe block at once
+static void prepareHashJoinProbe(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t                numOfRows = pBlock->info.rows;
+
+  if (pInfo->headsCap < numOfRows) {
+    int32_t* p = taosMemoryRealloc(pInfo->pHeads, numOfRows * sizeof(int32_t));
+    if (p == NULL) {
+      T_LONG_JMP(pOperator->pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+    pInfo->pHeads = p;
+    pInfo->headsCap = numOfRows;
+  }
+
+  SArray* pKeyCols = pInfo->pKeyCols[1 - pInfo->buildIdx];
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t len = getHashJoinKey(pKeyCols, pBlock->pDataBlock, i, pInfo->keyBuf);
+    int32_t* pHead = (len < 0) ? NULL : taosHashGet(pInfo->pKeyHash, pInfo->keyBuf, len);
+    pInfo->pHeads[i] = (pHead != NULL) ? *pHead : -1;
+  }
+
+  pInfo->pProbeBlock = pBlock;
+  pInfo->probeRow = 0;
+  pInfo->curRef = (numOfRows > 0) ? pInfo->pHeads[0] : -1;
+}
+
+static void collectHashJoinMatches(SHashJoinOperatorInfo* pInfo, int32_t capacity) {
+  int32_t numOfRows = pInfo->pProbeBlock->info.rows;
+
+  taosArrayClear(pInfo->pMatches);
+  while (pInfo->probeRow < numOfRows) {
+    while (pInfo->curRef >= 0) {
+      if (taosArrayGetSize(pInfo->pMatches) >= capacity) {
+        return;
+      }
+
+      SHJoinRowRef* pRef = taosArrayGet(pInfo->pRowRefs, pInfo->curRef);
+      SHJoinMatch   match = {.probeRow = pInfo->probeRow, .pageId = pRef->pageId, .rowIndex = pRef->rowIndex};
+      taosArrayPush(pInfo->pMatches, &match);
+      pInfo->curRef = pRef->next;
+    }
+
+    pInfo->probeRow += 1;
+    if (pInfo->probeRow < numOfRows) {
+      pInfo->curRef = pInfo->pHeads[pInfo->probeRow];
+    }
+  }
+}
+
+static int32_t hashJoinMatchComparFn(const void* p1, const void* p2) {
+  const SHJoinMatch* pLeft = p1;
+  const SHJoinMatch* pRight = p2;
+  if (pLeft->pageId != pRight->pageId) {
+    return pLeft->pageId < pRight->pageId ? -1 : 1;
+  }
+  if (pLeft->probeRow != pRight->probeRow) {
+    return pLeft->probeRow < pRight->probeRow ? -1 : 1;
+  }
+  return 0;
+}
+
+// the matches are ordered by the build page, so that each page is fetched only once for an output block
+static int32_t outputHashJoinMatches(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SSDataBlock*           pRes = pInfo->pRes;
+  size_t                 numOfMatches = taosArrayGetSize(pInfo->pMatches);
+  int32_t                numOfRows = pRes->info.rows;
+  int32_t                curPageId = -1;
+  void*                  pPage = NULL;
+
+  taosSort(pInfo->pMatches->pData, numOfMatches, sizeof(SHJoinMatch), hashJoinMatchComparFn);
+
+  for (int32_t i = 0; i < numOfMatches; ++i) {
+    SHJoinMatch* pMatch = taosArrayGet(pInfo->pMatches, i);
+    if (pMatch->pageId != curPageId) {
+      if (pPage != NULL) {
+        releaseBufPage(pInfo->pBuf, pPage);
+      }
+      pPage = getBufPage(pInfo->pBuf, pMatch->pageId);
+      if (pPage == NULL) {
+        return terrno;
+      }
+      setHashJoinPageView(pInfo->pPageView, pPage);
+      curPageId = pMatch->pageId;
+    }
+
+    for (int32_t j = 0; j < pOperator->exprSupp.numOfExprs; ++j) {
+      SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, j);
+      SHJoinOutputCol* pOutput = &pInfo->pOutputCols[j];
+      SColumnInfoData* pSrc = NULL;
+      int32_t          rowIndex = -1;
+
+      if (pOutput->child == pInfo->buildIdx) {
+        pSrc = taosArrayGet(pInfo->pPageView, pOutput->slotId);
+        rowIndex = pMatch->rowIndex;
+      } else {
+        pSrc = taosArrayGet(pInfo->pProbeBlock->pDataBlock, pOutput->slotId);
+        rowIndex = pMatch->probeRow;
+      }
+
+      if (colDataIsNull_s(pSrc, rowIndex)) {
+        colDataAppendNULL(pDst, numOfRows);
+      } else {
+        colDataAppend(pDst, numOfRows, colDataGetData(pSrc, rowIndex), false);
+      }
+    }
+    numOfRows += 1;
+  }
+
+  if (pPage != NULL) {
+    releaseBufPage(pInfo->pBuf, pPage);
+  }
+
+  pRes->info.rows = numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+  SSDataBlock*           pRes = pInfo->pRes;
+
+  int32_t code = doOpenHashJoinOperator(pOperator);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  while (pOperator->status != OP_EXEC_DONE) {
+    blockDataCleanup(pRes);
+    code = blockDataEnsureCapacity(pRes, pOperator->resultInfo.threshold);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    while (pRes->info.rows < pOperator->resultInfo.threshold) {
+      if (pInfo->pProbeBlock == NULL || pInfo->probeRow >= pInfo->pProbeBlock->info.rows) {
+        SSDataBlock* pBlock = getNextHashJoinProbeBlock(pOperator);
+        if (pBlock == NULL) {
+          doSetOperatorCompleted(pOperator);
+          break;
+        }
+        prepareHashJoinProbe(pOperator, pBlock);
+        continue;
+      }
+
+      collectHashJoinMatches(pInfo, pOperator->resultInfo.threshold - pRes->info.rows);
+      code = outputHashJoinMatches(pOperator);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
+
+    if (pInfo->pCondAfterJoin != NULL) {
+      doFilter(pInfo->pCondAfterJoin, pRes, NULL);
+    }
+    if (pRes->info.rows > 0) {
+      return pRes;
+    }
+  }
+
+  return NULL;
+}
@@ -2788,6 +2788,75 @@ _error:
   return NULL;
 }
 
+// Read the tags of the next batch of tables from the columnar tag store of meta.
+static int32_t doTagScanFromTagStore(SOperatorInfo* pOperator, int32_t size, int32_t* pCount) {
+  STagScanInfo* pInfo = pOperator->info;
+  SExprInfo*    pExprInfo = &pOperator->exprSupp.pExprInfo[0];
+  SSDataBlock*  pRes = pInfo->pRes;
+  int32_t       code = TSDB_CODE_SUCCESS;
+  SArray*       uidList = NULL;
+
+  if (pInfo->noTagStore || pInfo->pTableList->suid == 0) {
+    return TSDB_CODE_NOT_FOUND;
+  }
+
+  if (pInfo->pTagBlock == NULL) {
+    pInfo->pTagBlock = createDataBlock();
+    if (pInfo->pTagBlock == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    for (int32_t j = 0; j < pOperator->exprSupp.numOfExprs; ++j) {
+      SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pExprInfo[j].base.resSchema.slotId);
+      SColumnInfoData  colInfo = {{0}, 0};
+      colInfo.info = pDst->info;
+      colInfo.info.colId = fmIsScanPseudoColumnFunc(pExprInfo[j].pExpr->_function.functionId)
+                               ? -1
+                               : pExprInfo[j].base.pParam[0].pCol->colId;
+      blockDataAppendColInfo(pInfo->pTagBlock, &colInfo);
+    }
+  }
+
+  int32_t numOfRows = TMIN(size - pInfo->curPos, pOperator->resultInfo.capacity);
+  uidList = taosArrayInit(numOfRows, sizeof(uint64_t));
+  if (uidList == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    STableKeyInfo* item = taosArrayGet(pInfo->pTableList->pTableList, pInfo->curPos + i);
+    taosArrayPush(uidList, &item->uid);
+  }
+
+  blockDataCleanup(pInfo->pTagBlock);
+  code = metaGetTableTagColumns(pInfo->readHandle.meta, pInfo->pTableList->suid, uidList, pInfo->pTagBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    if (code == TSDB_CODE_NOT_FOUND) {
+      pInfo->noTagStore = true;
+    }
+    goto _end;
+  }
+
+  for (int32_t j = 0; j < pOperator->exprSupp.numOfExprs; ++j) {
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pExprInfo[j].base.resSchema.slotId);
+    int16_t          colId = pDst->info.colId;
+    code = colDataAssign(pDst, taosArrayGet(pInfo->pTagBlock->pDataBlock, j), numOfRows, &pInfo->pTagBlock->info);
+    pDst->info.colId = colId;
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _end;
+    }
+  }
+
+  *pCount = numOfRows;
+  pInfo->curPos += numOfRows;
+  if (pInfo->curPos >= size) {
+    doSetOperatorCompleted(pOperator);
+  }
+
+_end:
+  taosArrayDestroy(uidList);
+  return code;
+}
+
 static SSDataBlock* doTagScan(SOperatorInfo* pOperator) {
   if (pOperator->status == OP_EXEC_DONE) {
     return NULL;
@@ -2808,9 +2877,16 @@ static SSDataBlock* doTagScan(SOperatorInfo* pOperator) {
   char        str[512] = {0};
   int32_t     count = 0;
   SMetaReader mr = {0};
+
+  int32_t ret = doTagScanFromTagStore(pOperator, size, &count);
+  if (ret != TSDB_CODE_SUCCESS && ret != TSDB_CODE_NOT_FOUND) {
+    qError("failed to get table tags, code:%s, %s", tstrerror(ret), GET_TASKID(pTaskInfo));
+    T_LONG_JMP(pTaskInfo->env, ret);
+  }
+
   metaReaderInit(&mr, pInfo->readHandle.meta, 0);
 
-  while (pInfo->curPos < size && count < pOperator->resultInfo.capacity) {
+  while (ret == TSDB_CODE_NOT_FOUND && pInfo->curPos < size && count < pOperator->resultInfo.capacity) {
     STableKeyInfo* item = taosArrayGet(pInfo->pTableList->pTableList, pInfo->curPos);
     int32_t        code = metaGetTableEntryByUid(&mr, item->uid);
     tDecoderClear(&mr.coder);
@@ -2871,6 +2947,7 @@ static SSDataBlock* doTagScan(SOperatorInfo* pOperator) {
 static void destroyTagScanOperatorInfo(void* param) {
   STagScanInfo* pInfo = (STagScanInfo*)param;
   pInfo->pRes = blockDataDestroy(pInfo->pRes);
+  pInfo->pTagBlock = blockDataDestroy(pInfo->pTagBlock);
   taosArrayDestroy(pInfo->pColMatchInfo);
   taosMemoryFreeClear(param);
 }
@@ -22,7 +22,6 @@ static int32_t      getExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain
 
 static void destroyOrderOperatorInfo(void* param);
 
-// todo add limit/offset impl
 SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode, SExecTaskInfo* pTaskInfo) {
   SSortOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SSortOperatorInfo));
   SOperatorInfo*     pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
@@ -176,6 +175,12 @@ int32_t doOpenSortOperator(SOperatorInfo* pOperator) {
 
   tsortSetFetchRawDataFp(pInfo->pSortHandle, loadNextDataBlock, applyScalarFunction, pOperator);
 
+  // rows are filtered after being sorted, so only the top-n rows are needed when there is no filter condition
+  SLimit* pLimit = &pInfo->limitInfo.limit;
+  if (pInfo->pCondition == NULL && pLimit->limit > 0) {
+    tsortSetMaxRows(pInfo->pSortHandle, pLimit->limit + TMAX(pLimit->offset, 0));
+  }
+
   SSortSource* ps = taosMemoryCalloc(1, sizeof(SSortSource));
   ps->param = pOperator->pDownstream[0];
   tsortAddSource(pInfo->pSortHandle, ps);
@@ -51,6 +51,8 @@ struct SSortHandle {
   const char       *idStr;
   bool              inMemSort;
   bool              needAdjust;
+  int64_t           maxRows;     // only the first maxRows tuples are required, 0 for all of them
+  bool              boundedSort; // keep the best maxRows tuples in memory instead of sorting all of them
   STupleHandle      tupleHandle;
   void             *param;
   void (*beforeFp)(SSDataBlock* pBlock, void* param);
@@ -578,6 +580,86 @@ int32_t getProperSortPageSize(size_t rowSize) {
   return pgSize;
 }
 
+static int32_t doBoundedSort(SSortHandle* pHandle) {
+  SSDataBlock* pDataBlock = pHandle->pDataBlock;
+
+  int64_t p = taosGetTimestampUs();
+  int32_t code = blockDataSort(pDataBlock, pHandle->pSortInfo);
+  if (code != 0) {
+    return code;
+  }
+  pHandle->sortElapsed += (taosGetTimestampUs() - p);
+
+  return blockDataKeepFirstNRows(pDataBlock, pHandle->maxRows);
+}
+
+/*
+ * The first maxRows rows of pHandle->pDataBlock are sorted once the buffer is full, and the last one of them is the bar
+ * that an input tuple has to beat, so most of the input is dropped by a single comparison. The accepted tuples are
+ * appended behind, and the buffer is sorted and cut back to maxRows rows once it holds twice as many.
+ */
+static int32_t appendToBoundedSortBuf(SSortHandle* pHandle, SSDataBlock* pBlock) {
+  SSDataBlock* pDataBlock = pHandle->pDataBlock;
+  int32_t      code = 0;
+
+  int32_t start = 0;
+  if (pDataBlock->info.rows < pHandle->maxRows) {
+    start = TMIN(pHandle->maxRows - pDataBlock->info.rows, pBlock->info.rows);
+    if (start == pBlock->info.rows) {
+      code = blockDataMerge(pDataBlock, pBlock);
+    } else {
+      SSDataBlock* p = blockDataExtractBlock(pBlock, 0, start);
+      if (p == NULL) {
+        return terrno;
+      }
+      code = blockDataMerge(pDataBlock, p);
+      blockDataDestroy(p);
+    }
+    if (code != 0) {
+      return code;
+    }
+
+    if (pDataBlock->info.rows < pHandle->maxRows) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    code = doBoundedSort(pHandle);
+    if (code != 0) {
+      return code;
+    }
+  }
+
+  code = blockDataEnsureCapacity(pDataBlock, (uint32_t)(pHandle->maxRows * 2));
+  if (code != 0) {
+    return code;
+  }
+
+  SSortSource  bar = {.src.pBlock = pDataBlock, .src.rowIndex = pHandle->maxRows - 1};
+  SSortSource  input = {.src.pBlock = pBlock, .src.rowIndex = start};
+  SSortSource* pSources[2] = {&bar, &input};
+
+  SMsortComparParam param = {.pSources = (void**)pSources, .numOfSources = 2, .orderInfo = pHandle->pSortInfo};
+  int32_t           barIndex = 0;
+  int32_t           inputIndex = 1;
+
+  while (input.src.rowIndex < pBlock->info.rows) {
+    if (msortComparFn(&barIndex, &inputIndex, &param) <= 0) {
+      input.src.rowIndex += 1;
+      continue;
+    }
+
+    appendOneRowToDataBlock(pDataBlock, pBlock, &input.src.rowIndex);
+    if (pDataBlock->info.rows >= pHandle->maxRows * 2) {
+      code = doBoundedSort(pHandle);
+      if (code != 0) {
+        return code;
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t createInitialSources(SSortHandle* pHandle) {
   size_t sortBufSize = pHandle->numOfPages * pHandle->pageSize;
 
@@ -598,12 +680,24 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         pHandle->numOfPages = 1024;
         sortBufSize = pHandle->numOfPages * pHandle->pageSize;
         pHandle->pDataBlock = createOneDataBlock(pBlock, false);
+
+        // the top-n buffer holds up to twice maxRows rows, it has to fit in the sort buffer
+        pHandle->boundedSort =
+            pHandle->maxRows > 0 && pHandle->maxRows <= sortBufSize / (2 * blockDataGetRowSize(pBlock));
       }
 
       if (pHandle->beforeFp != NULL) {
         pHandle->beforeFp(pBlock, pHandle->param);
       }
 
+      if (pHandle->boundedSort) {
+        int32_t code = appendToBoundedSortBuf(pHandle, pBlock);
+        if (code != 0) {
+          return code;
+        }
+        continue;
+      }
+
       int32_t code = blockDataMerge(pHandle->pDataBlock, pBlock);
       if (code != 0) {
         return code;
@@ -639,6 +733,10 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       int64_t el = taosGetTimestampUs() - p;
       pHandle->sortElapsed += el;
 
+      if (pHandle->boundedSort) {
+        blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->maxRows);
+      }
+
       // All sorted data can fit in memory, external memory sort is not needed. Return to directly
       if (size <= sortBufSize && pHandle->pBuf == NULL) {
         pHandle->cmpParam.numOfSources = 1;
@@ -713,6 +811,12 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp) {
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows) {
+  // a bound beyond the rows a data block can hold is never reached in memory, all tuples are sorted instead
+  pHandle->maxRows = (maxRows > 0 && maxRows <= INT32_MAX / 2) ? maxRows : 0;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId) {
   pHandle->cmpParam.cmpGroupId = compareGroupId;
   return TSDB_CODE_SUCCESS;
@@ -786,7 +890,7 @@ SSortExecInfo tsortGetSortExecInfo(SSortHandle* pHandle) {
   SSortExecInfo info = {0};
 
   info.sortBuffer = pHandle->pageSize * pHandle->numOfPages;
-  info.sortMethod = pHandle->inMemSort? SORT_QSORT_T:SORT_SPILLED_MERGE_SORT_T;
+  info.sortMethod = pHandle->boundedSort? SORT_TOPN_T:(pHandle->inMemSort? SORT_QSORT_T:SORT_SPILLED_MERGE_SORT_T);
   info.loops  = pHandle->loops;
 
   if (pHandle->pBuf != NULL) {
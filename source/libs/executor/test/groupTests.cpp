@@ -0,0 +1,675 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <tglobal.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "nodes.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "tdef.h"
+
+namespace {
+
+const int16_t INPUT_BLOCK_ID = 1;
+const int16_t OUTPUT_BLOCK_ID = 2;
+const int32_t INPUT_BLOCK_ROWS = 4000;
+const int32_t NUM_OF_ROUNDS = 3;
+
+typedef struct SGroupInputInfo {
+  std::vector<SSDataBlock*> blocks;
+  size_t                    index;
+} SGroupInputInfo;
+
+typedef std::map<int32_t, std::pair<int64_t, int64_t>> SGroupRes;  // key -> (count, sum)
+
+// every group key appears once in each round, in an order that never puts two rows of a group next to each other,
+// the value of the row is key * NUM_OF_ROUNDS + round
+std::vector<std::pair<int32_t, int32_t>> createGroupInputRows(int32_t numOfGroups) {
+  std::vector<std::pair<int32_t, int32_t>> rows;
+  for (int32_t r = 0; r < NUM_OF_ROUNDS; ++r) {
+    for (int32_t i = 0; i < numOfGroups; ++i) {
+      int32_t key = (int32_t)(((int64_t)i * 7919) % numOfGroups);
+      rows.emplace_back(key, key * NUM_OF_ROUNDS + r);
+    }
+  }
+  return rows;
+}
+
+SGroupRes expectGroupRes(int32_t numOfGroups) {
+  SGroupRes res;
+  for (int32_t key = 0; key < numOfGroups; ++key) {
+    int64_t sum = 0;
+    for (int32_t r = 0; r < NUM_OF_ROUNDS; ++r) {
+      sum += key * NUM_OF_ROUNDS + r;
+    }
+    res[key] = std::make_pair(NUM_OF_ROUNDS, sum);
+  }
+  return res;
+}
+
+SSDataBlock* getGroupInputBlock(SOperatorInfo* pOperator) {
+  SGroupInputInfo* pInfo = static_cast<SGroupInputInfo*>(pOperator->info);
+  if (pInfo->index >= pInfo->blocks.size()) {
+    return NULL;
+  }
+  return pInfo->blocks[pInfo->index++];
+}
+
+// the (key, val) rows of int columns are cut into blocks of INPUT_BLOCK_ROWS rows
+SOperatorInfo* createGroupInputOperator(const std::vector<std::pair<int32_t, int32_t>>& rows) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  pOperator->name = "groupInputOperator4Test";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_EXCHANGE;
+  pOperator->resultDataBlockId = INPUT_BLOCK_ID;
+  pOperator->fpSet.getNextFn = getGroupInputBlock;
+
+  SGroupInputInfo* pInfo = new SGroupInputInfo();
+  for (int32_t start = 0; start < rows.size(); start += INPUT_BLOCK_ROWS) {
+    int32_t num = std::min<int32_t>(INPUT_BLOCK_ROWS, rows.size() - start);
+
+    SSDataBlock* pBlock = createDataBlock();
+    for (int16_t i = 0; i < 2; ++i) {
+      SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), i + 1);
+      blockDataAppendColInfo(pBlock, &colInfo);
+    }
+    blockDataEnsureCapacity(pBlock, num);
+
+    SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+    SColumnInfoData* pVal = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+    for (int32_t i = 0; i < num; ++i) {
+      colDataAppend(pKey, i, (const char*)&rows[start + i].first, false);
+      colDataAppend(pVal, i, (const char*)&rows[start + i].second, false);
+    }
+
+    pBlock->info.rows = num;
+    pBlock->info.blockId = INPUT_BLOCK_ID;
+    pInfo->blocks.push_back(pBlock);
+  }
+  pInfo->index = 0;
+  pOperator->info = pInfo;
+  return pOperator;
+}
+
+void destroyGroupInputOperator(SOperatorInfo* pOperator) {
+  SGroupInputInfo* pInfo = static_cast<SGroupInputInfo*>(pOperator->info);
+  for (auto pBlock : pInfo->blocks) {
+    blockDataDestroy(pBlock);
+  }
+  delete pInfo;
+  taosMemoryFree(pOperator);
+}
+
+SColumnNode* createGroupColumn(int16_t slotId) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = TSDB_DATA_TYPE_INT;
+  pCol->node.resType.bytes = sizeof(int32_t);
+  pCol->dataBlockId = INPUT_BLOCK_ID;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  return pCol;
+}
+
+STargetNode* createGroupTarget(int16_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = OUTPUT_BLOCK_ID;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return pTarget;
+}
+
+SNode* createGroupFunc(const char* name, int16_t slotId) {
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  strcpy(pFunc->functionName, name);
+  nodesListMakeAppend(&pFunc->pParameterList, (SNode*)createGroupColumn(slotId));
+
+  char msg[128] = {0};
+  EXPECT_EQ(fmGetFuncInfo(pFunc, msg, sizeof(msg)), TSDB_CODE_SUCCESS);
+  return (SNode*)pFunc;
+}
+
+SExecTaskInfo* createGroupTaskInfo() {
+  static char    id[] = "group spill test";
+  SExecTaskInfo* pTaskInfo = static_cast<SExecTaskInfo*>(taosMemoryCalloc(1, sizeof(SExecTaskInfo)));
+  pTaskInfo->id.str = id;
+  return pTaskInfo;
+}
+
+void destroyGroupOperator(SOperatorInfo* pOperator) {
+  pOperator->fpSet.closeFn(pOperator->info);
+  taosMemoryFree(pOperator->pDownstream);
+  taosMemoryFree(pOperator);
+}
+
+// select count(val), sum(val), key from input group by key
+SGroupRes runGroupby(int32_t numOfGroups, bool* pSpilled) {
+  SExecTaskInfo* pTaskInfo = createGroupTaskInfo();
+  SOperatorInfo* pDownstream = createGroupInputOperator(createGroupInputRows(numOfGroups));
+
+  SNodeList* pFuncs = NULL;
+  nodesListMakeAppend(&pFuncs, (SNode*)createGroupTarget(0, createGroupFunc("count", 1)));
+  nodesListMakeAppend(&pFuncs, (SNode*)createGroupTarget(1, createGroupFunc("sum", 1)));
+  nodesListMakeAppend(&pFuncs, (SNode*)createGroupTarget(2, createGroupFunc("_group_key", 0)));
+
+  int32_t    numOfExprs = 0;
+  SExprInfo* pExprInfo = createExprInfo(pFuncs, NULL, &numOfExprs);
+
+  SSDataBlock* pResBlock = createDataBlock();
+  SColumnInfoData count = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  SColumnInfoData sum = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  SColumnInfoData key = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 3);
+  blockDataAppendColInfo(pResBlock, &count);
+  blockDataAppendColInfo(pResBlock, &sum);
+  blockDataAppendColInfo(pResBlock, &key);
+  pResBlock->info.blockId = OUTPUT_BLOCK_ID;
+
+  SArray* pGroupCols = taosArrayInit(1, sizeof(SColumn));
+  SColumn c = {0};
+  c.slotId = 0;
+  c.colId = 1;
+  c.type = TSDB_DATA_TYPE_INT;
+  c.bytes = sizeof(int32_t);
+  taosArrayPush(pGroupCols, &c);
+
+  SOperatorInfo* pOperator = createGroupOperatorInfo(pDownstream, pExprInfo, numOfExprs, pResBlock, pGroupCols, NULL,
+                                                     NULL, 0, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+
+  SGroupRes res;
+  while (pOperator != NULL) {
+    SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+    if (pRes == NULL) {
+      break;
+    }
+
+    SColumnInfoData* pCount = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+    SColumnInfoData* pSum = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+    SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 2));
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      int32_t k = *(int32_t*)colDataGetData(pKey, i);
+      EXPECT_EQ(res.count(k), 0) << "group " << k << " returned twice";
+      res[k] = std::make_pair(*(int64_t*)colDataGetData(pCount, i), *(int64_t*)colDataGetData(pSum, i));
+    }
+  }
+
+  if (pOperator != NULL) {
+    *pSpilled = static_cast<SGroupbyOperatorInfo*>(pOperator->info)->pSpiller != NULL;
+    destroyGroupOperator(pOperator);
+  }
+  nodesDestroyList(pFuncs);
+  destroyGroupInputOperator(pDownstream);
+  taosMemoryFree(pTaskInfo);
+  return res;
+}
+
+SPartitionPhysiNode* createPartitionNode() {
+  SPartitionPhysiNode* pPart = (SPartitionPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_PARTITION);
+  nodesListMakeAppend(&pPart->pPartitionKeys, (SNode*)createGroupColumn(0));
+
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = OUTPUT_BLOCK_ID;
+  for (int16_t i = 0; i < 2; ++i) {
+    nodesListMakeAppend(&pPart->pTargets, (SNode*)createGroupTarget(i, (SNode*)createGroupColumn(i)));
+
+    SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+    pSlot->slotId = i;
+    pSlot->dataType.type = TSDB_DATA_TYPE_INT;
+    pSlot->dataType.bytes = sizeof(int32_t);
+    pSlot->output = true;
+    nodesListMakeAppend(&pDesc->pSlots, (SNode*)pSlot);
+    pDesc->totalRowSize += sizeof(int32_t);
+    pDesc->outputRowSize += sizeof(int32_t);
+  }
+  pPart->node.pOutputDataBlockDesc = pDesc;
+  return pPart;
+}
+
+// partition by key, the rows of each returned group are aggregated here
+SGroupRes runPartition(int32_t numOfGroups, bool* pSpilled) {
+  SExecTaskInfo* pTaskInfo = createGroupTaskInfo();
+  SOperatorInfo* pDownstream = createGroupInputOperator(createGroupInputRows(numOfGroups));
+
+  SPartitionPhysiNode* pPart = createPartitionNode();
+  SOperatorInfo*       pOperator = createPartitionOperatorInfo(pDownstream, pPart, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+
+  SGroupRes                   res;
+  std::map<uint64_t, int32_t> groupKeys;
+  while (pOperator != NULL) {
+    SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+    if (pRes == NULL) {
+      break;
+    }
+
+    SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+    SColumnInfoData* pVal = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      int32_t k = *(int32_t*)colDataGetData(pKey, i);
+      auto    it = groupKeys.emplace(pRes->info.groupId, k).first;
+      EXPECT_EQ(it->second, k) << "group " << pRes->info.groupId << " mixes keys";
+
+      res[k].first += 1;
+      res[k].second += *(int32_t*)colDataGetData(pVal, i);
+    }
+  }
+
+  if (pOperator != NULL) {
+    *pSpilled = static_cast<SPartitionOperatorInfo*>(pOperator->info)->pSpiller != NULL;
+    destroyGroupOperator(pOperator);
+  }
+  nodesDestroyNode((SNode*)pPart);
+  destroyGroupInputOperator(pDownstream);
+  taosMemoryFree(pTaskInfo);
+  return res;
+}
+
+class GroupSpillTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_EQ(fmFuncMgtInit(), TSDB_CODE_SUCCESS); }
+
+  void SetUp() override { groupMemMB = tsQueryGroupMemMB; }
+  void TearDown() override { tsQueryGroupMemMB = groupMemMB; }
+
+ private:
+  int32_t groupMemMB;
+};
+
+
+// a group key value of a typed key column, the value is taken from v or s by the column type
+typedef struct SGroupKeyVal {
+  bool        isNull;
+  int64_t     v;
+  std::string s;
+} SGroupKeyVal;
+
+typedef struct SGroupKeyRow {
+  std::vector<SGroupKeyVal> keys;
+  int32_t                   val;
+} SGroupKeyRow;
+
+typedef std::map<std::string, std::pair<int64_t, int64_t>> SGroupKeyRes;  // printed key -> (count, sum)
+
+std::string printGroupKey(const std::vector<SGroupKeyVal>& keys) {
+  std::string str;
+  for (const auto& k : keys) {
+    str += k.isNull ? "null" : (k.s.empty() ? std::to_string(k.v) : "'" + k.s + "'");
+    str += "|";
+  }
+  return str;
+}
+
+SGroupKeyRes expectGroupKeyRes(const std::vector<SGroupKeyRow>& rows) {
+  SGroupKeyRes res;
+  for (const auto& row : rows) {
+    auto& r = res[printGroupKey(row.keys)];
+    r.first += 1;
+    r.second += row.val;
+  }
+  return res;
+}
+
+SGroupKeyVal getGroupKeyVal(SColumnInfoData* pCol, int32_t row) {
+  SGroupKeyVal k = {0};
+  if (colDataIsNull_s(pCol, row)) {
+    k.isNull = true;
+    return k;
+  }
+
+  const char* p = colDataGetData(pCol, row);
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      k.v = *(int8_t*)p;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      k.v = *(int16_t*)p;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      k.v = *(int32_t*)p;
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+      k.v = *(int64_t*)p;
+      break;
+    default:
+      k.s.assign(varDataVal(p), varDataLen(p));
+      break;
+  }
+  return k;
+}
+
+void setGroupKeyVal(SColumnInfoData* pCol, int32_t row, const SGroupKeyVal& k) {
+  char buf[256] = {0};
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      *(int8_t*)buf = (int8_t)k.v;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      *(int16_t*)buf = (int16_t)k.v;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      *(int32_t*)buf = (int32_t)k.v;
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+      *(int64_t*)buf = k.v;
+      break;
+    default:
+      varDataSetLen(buf, k.s.size());
+      memcpy(varDataVal(buf), k.s.data(), k.s.size());
+      break;
+  }
+  colDataAppend(pCol, row, buf, k.isNull);
+}
+
+// the key columns of aType come first, the int value column after them
+SOperatorInfo* createGroupKeyInputOperator(const std::vector<SDataType>& aType, const std::vector<SGroupKeyRow>& rows) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  pOperator->name = "groupKeyInputOperator4Test";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_EXCHANGE;
+  pOperator->resultDataBlockId = INPUT_BLOCK_ID;
+  pOperator->fpSet.getNextFn = getGroupInputBlock;
+
+  int16_t          numOfKeys = aType.size();
+  SGroupInputInfo* pInfo = new SGroupInputInfo();
+  for (int32_t start = 0; start < rows.size(); start += INPUT_BLOCK_ROWS) {
+    int32_t num = std::min<int32_t>(INPUT_BLOCK_ROWS, rows.size() - start);
+
+    SSDataBlock* pBlock = createDataBlock();
+    for (int16_t i = 0; i < numOfKeys; ++i) {
+      SColumnInfoData colInfo = createColumnInfoData(aType[i].type, aType[i].bytes, i + 1);
+      blockDataAppendColInfo(pBlock, &colInfo);
+    }
+    SColumnInfoData valInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), numOfKeys + 1);
+    blockDataAppendColInfo(pBlock, &valInfo);
+    blockDataEnsureCapacity(pBlock, num);
+
+    SColumnInfoData* pVal = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, numOfKeys));
+    for (int32_t i = 0; i < num; ++i) {
+      for (int16_t c = 0; c < numOfKeys; ++c) {
+        SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, c));
+        setGroupKeyVal(pKey, i, rows[start + i].keys[c]);
+      }
+      colDataAppend(pVal, i, (const char*)&rows[start + i].val, false);
+    }
+
+    pBlock->info.rows = num;
+    pBlock->info.blockId = INPUT_BLOCK_ID;
+    pInfo->blocks.push_back(pBlock);
+  }
+  pInfo->index = 0;
+  pOperator->info = pInfo;
+  return pOperator;
+}
+
+SColumnNode* createGroupKeyColumn(int16_t slotId, const SDataType& dt) {
+  SColumnNode* pCol = createGroupColumn(slotId);
+  pCol->node.resType = dt;
+  return pCol;
+}
+
+// select count(val), sum(val), key1, key2 ... from input group by key1, key2 ..., the rows are aggregated a block at a
+// time through the key table when batch is set, and row by row otherwise
+SGroupKeyRes runGroupbyKeys(const std::vector<SDataType>& aType, const std::vector<SGroupKeyRow>& rows, bool batch,
+                            bool* pBatch) {
+  SExecTaskInfo* pTaskInfo = createGroupTaskInfo();
+  SOperatorInfo* pDownstream = createGroupKeyInputOperator(aType, rows);
+  int16_t        numOfKeys = aType.size();
+
+  SNodeList* pFuncs = NULL;
+  nodesListMakeAppend(&pFuncs, (SNode*)createGroupTarget(0, createGroupFunc("count", numOfKeys)));
+  nodesListMakeAppend(&pFuncs, (SNode*)createGroupTarget(1, createGroupFunc("sum", numOfKeys)));
+  for (int16_t i = 0; i < numOfKeys; ++i) {
+    SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+    strcpy(pFunc->functionName, "_group_key");
+    nodesListMakeAppend(&pFunc->pParameterList, (SNode*)createGroupKeyColumn(i, aType[i]));
+
+    char msg[128] = {0};
+    EXPECT_EQ(fmGetFuncInfo(pFunc, msg, sizeof(msg)), TSDB_CODE_SUCCESS);
+    nodesListMakeAppend(&pFuncs, (SNode*)createGroupTarget(2 + i, (SNode*)pFunc));
+  }
+
+  int32_t    numOfExprs = 0;
+  SExprInfo* pExprInfo = createExprInfo(pFuncs, NULL, &numOfExprs);
+
+  SSDataBlock*    pResBlock = createDataBlock();
+  SColumnInfoData count = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  SColumnInfoData sum = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  blockDataAppendColInfo(pResBlock, &count);
+  blockDataAppendColInfo(pResBlock, &sum);
+  for (int16_t i = 0; i < numOfKeys; ++i) {
+    SColumnInfoData key = createColumnInfoData(aType[i].type, aType[i].bytes, 3 + i);
+    blockDataAppendColInfo(pResBlock, &key);
+  }
+  pResBlock->info.blockId = OUTPUT_BLOCK_ID;
+
+  SArray* pGroupCols = taosArrayInit(numOfKeys, sizeof(SColumn));
+  for (int16_t i = 0; i < numOfKeys; ++i) {
+    SColumn c = {0};
+    c.slotId = i;
+    c.colId = i + 1;
+    c.type = aType[i].type;
+    c.bytes = aType[i].bytes;
+    taosArrayPush(pGroupCols, &c);
+  }
+
+  SOperatorInfo* pOperator = createGroupOperatorInfo(pDownstream, pExprInfo, numOfExprs, pResBlock, pGroupCols, NULL,
+                                                     NULL, 0, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+
+  SGroupKeyRes    res;
+  SGroupKeyTable* pKeyTable = NULL;
+  if (pOperator != NULL) {
+    SGroupbyOperatorInfo* pInfo = static_cast<SGroupbyOperatorInfo*>(pOperator->info);
+    *pBatch = pInfo->pKeyTable != NULL;
+    if (!batch) {
+      // put back before the operator is destroyed
+      pKeyTable = pInfo->pKeyTable;
+      pInfo->pKeyTable = NULL;
+    }
+  }
+
+  while (pOperator != NULL) {
+    SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+    if (pRes == NULL) {
+      break;
+    }
+
+    SColumnInfoData* pCount = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+    SColumnInfoData* pSum = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      std::vector<SGroupKeyVal> keys;
+      for (int16_t c = 0; c < numOfKeys; ++c) {
+        keys.push_back(getGroupKeyVal(static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 2 + c)), i));
+      }
+
+      std::string k = printGroupKey(keys);
+      EXPECT_EQ(res.count(k), 0) << "group " << k << " returned twice";
+      res[k] = std::make_pair(*(int64_t*)colDataGetData(pCount, i), *(int64_t*)colDataGetData(pSum, i));
+    }
+  }
+
+  if (pOperator != NULL) {
+    if (!batch) {
+      static_cast<SGroupbyOperatorInfo*>(pOperator->info)->pKeyTable = pKeyTable;
+    }
+    destroyGroupOperator(pOperator);
+  }
+  nodesDestroyList(pFuncs);
+  destroyGroupInputOperator(pDownstream);
+  taosMemoryFree(pTaskInfo);
+  return res;
+}
+
+SGroupKeyVal groupKeyNull() {
+  SGroupKeyVal k = {0};
+  k.isNull = true;
+  return k;
+}
+
+SGroupKeyVal groupKeyInt(int64_t v) {
+  SGroupKeyVal k = {0};
+  k.v = v;
+  return k;
+}
+
+SGroupKeyVal groupKeyStr(const std::string& s) {
+  SGroupKeyVal k = {0};
+  k.s = s;
+  return k;
+}
+
+// every key appears in each round, the rounds scatter the rows of a group over several blocks
+std::vector<SGroupKeyRow> createGroupKeyRows(const std::vector<std::vector<SGroupKeyVal>>& aKeys) {
+  std::vector<SGroupKeyRow> rows;
+  int32_t                   n = aKeys.size();
+  for (int32_t r = 0; r < NUM_OF_ROUNDS; ++r) {
+    for (int32_t i = 0; i < n; ++i) {
+      int32_t      idx = (int32_t)(((int64_t)i * 7919 + r) % n);
+      SGroupKeyRow row;
+      row.keys = aKeys[idx];
+      row.val = idx * NUM_OF_ROUNDS + r;
+      rows.push_back(row);
+    }
+  }
+  return rows;
+}
+
+class GroupBatchTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_EQ(fmFuncMgtInit(), TSDB_CODE_SUCCESS); }
+
+  // the key table path and the row by row path agree with each other and with the input
+  void checkBatchAgainstRows(const std::vector<SDataType>& aType, const std::vector<SGroupKeyRow>& rows) {
+    bool         batch = false;
+    SGroupKeyRes expect = expectGroupKeyRes(rows);
+
+    SGroupKeyRes resBatch = runGroupbyKeys(aType, rows, true, &batch);
+    ASSERT_TRUE(batch);
+    SGroupKeyRes resRow = runGroupbyKeys(aType, rows, false, &batch);
+
+    ASSERT_EQ(resBatch.size(), expect.size());
+    ASSERT_EQ(resBatch, resRow);
+    ASSERT_EQ(resBatch, expect);
+  }
+};
+
+}  // namespace
+
+TEST_F(GroupSpillTest, groupbyInMemory) {
+  tsQueryGroupMemMB = 256;
+
+  bool      spilled = false;
+  SGroupRes res = runGroupby(1000, &spilled);
+  ASSERT_FALSE(spilled);
+  ASSERT_EQ(res, expectGroupRes(1000));
+}
+
+TEST_F(GroupSpillTest, groupbySpill) {
+  // far more groups than 1MB holds, the groups not in memory are spilled and aggregated when reloaded
+  tsQueryGroupMemMB = 1;
+
+  bool      spilled = false;
+  SGroupRes res = runGroupby(50000, &spilled);
+  ASSERT_TRUE(spilled);
+  ASSERT_EQ(res, expectGroupRes(50000));
+}
+
+TEST_F(GroupSpillTest, partitionSpill) {
+  // each group keeps a page, the rows of the groups over the budget are spilled by partition and reloaded
+  tsQueryGroupMemMB = 1;
+
+  bool      spilled = false;
+  SGroupRes res = runPartition(2000, &spilled);
+  ASSERT_TRUE(spilled);
+  ASSERT_EQ(res, expectGroupRes(2000));
+}
+
+TEST_F(GroupBatchTest, nullKeys) {
+  // NULL keys group together per column, apart from the zero value and from each other
+  SDataType aType[] = {{.type = TSDB_DATA_TYPE_BIGINT, .bytes = sizeof(int64_t)},
+                       {.type = TSDB_DATA_TYPE_SMALLINT, .bytes = sizeof(int16_t)}};
+
+  std::vector<std::vector<SGroupKeyVal>> aKeys;
+  for (int32_t i = 0; i < 3000; ++i) {
+    SGroupKeyVal k1 = (i % 7 == 0) ? groupKeyNull() : groupKeyInt(i / 3);
+    SGroupKeyVal k2 = (i % 5 == 0) ? groupKeyNull() : groupKeyInt(i % 3);
+    aKeys.push_back({k1, k2});
+  }
+  aKeys.push_back({groupKeyInt(0), groupKeyInt(0)});
+  aKeys.push_back({groupKeyNull(), groupKeyNull()});
+
+  // dedup, each key is listed once per round
+  std::sort(aKeys.begin(), aKeys.end(), [](const std::vector<SGroupKeyVal>& a, const std::vector<SGroupKeyVal>& b) {
+    return printGroupKey(a) < printGroupKey(b);
+  });
+  aKeys.erase(std::unique(aKeys.begin(), aKeys.end(),
+                          [](const std::vector<SGroupKeyVal>& a, const std::vector<SGroupKeyVal>& b) {
+                            return printGroupKey(a) == printGroupKey(b);
+                          }),
+              aKeys.end());
+
+  checkBatchAgainstRows({aType[0], aType[1]}, createGroupKeyRows(aKeys));
+}
+
+TEST_F(GroupBatchTest, hashCollision) {
+  // a NULL key is hashed as 0x9E3779B97F4A7C15, the same value as a key hashes the same and only the null flag of
+  // the packed key tells them apart
+  SDataType aType[] = {{.type = TSDB_DATA_TYPE_BIGINT, .bytes = sizeof(int64_t)}};
+
+  std::vector<std::vector<SGroupKeyVal>> aKeys;
+  aKeys.push_back({groupKeyNull()});
+  aKeys.push_back({groupKeyInt((int64_t)0x9E3779B97F4A7C15ULL)});
+
+  // keys differing in the high bits only fill long probe chains and grow the table a few times
+  for (int64_t i = 1; i <= 20000; ++i) {
+    aKeys.push_back({groupKeyInt(i << 32)});
+  }
+
+  checkBatchAgainstRows({aType[0]}, createGroupKeyRows(aKeys));
+}
+
+TEST_F(GroupBatchTest, varKeysRowPath) {
+  // var-length keys are not packed into the key table, the rows are grouped one by one
+  SDataType aType[] = {{.type = TSDB_DATA_TYPE_VARCHAR, .bytes = 32 + VARSTR_HEADER_SIZE},
+                       {.type = TSDB_DATA_TYPE_INT, .bytes = sizeof(int32_t)}};
+
+  std::vector<std::vector<SGroupKeyVal>> aKeys;
+  aKeys.push_back({groupKeyNull(), groupKeyInt(1)});
+  aKeys.push_back({groupKeyNull(), groupKeyNull()});
+  for (int32_t i = 0; i < 1000; ++i) {
+    aKeys.push_back({groupKeyStr("key_" + std::to_string(i)), (i % 9 == 0) ? groupKeyNull() : groupKeyInt(i % 4)});
+  }
+
+  std::vector<SGroupKeyRow> rows = createGroupKeyRows(aKeys);
+  bool                      batch = true;
+  SGroupKeyRes              res = runGroupbyKeys({aType[0], aType[1]}, rows, true, &batch);
+  ASSERT_FALSE(batch);
+  ASSERT_EQ(res, expectGroupKeyRes(rows));
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <tglobal.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "nodes.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "tdef.h"
+
+namespace {
+
+const int32_t NULL_KEY = INT32_MIN;
+
+typedef struct SJoinInputInfo {
+  std::vector<SSDataBlock*> blocks;
+  size_t                    index;
+} SJoinInputInfo;
+
+// every row is a (key, val) pair of int columns, NULL_KEY is a null key
+SSDataBlock* createJoinInputBlock(int16_t blockId, const std::vector<std::pair<int32_t, int32_t>>& rows) {
+  SSDataBlock* pBlock = createDataBlock();
+  for (int16_t i = 0; i < 2; ++i) {
+    SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), i + 1);
+    blockDataAppendColInfo(pBlock, &colInfo);
+  }
+  blockDataEnsureCapacity(pBlock, rows.size());
+
+  SColumnInfoData* pKey = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  SColumnInfoData* pVal = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+  for (int32_t i = 0; i < rows.size(); ++i) {
+    if (rows[i].first == NULL_KEY) {
+      colDataAppendNULL(pKey, i);
+    } else {
+      colDataAppend(pKey, i, (const char*)&rows[i].first, false);
+    }
+    colDataAppend(pVal, i, (const char*)&rows[i].second, false);
+  }
+
+  pBlock->info.rows = rows.size();
+  pBlock->info.blockId = blockId;
+  return pBlock;
+}
+
+SSDataBlock* getJoinInputBlock(SOperatorInfo* pOperator) {
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(pOperator->info);
+  if (pInfo->index >= pInfo->blocks.size()) {
+    return NULL;
+  }
+  return pInfo->blocks[pInfo->index++];
+}
+
+SOperatorInfo* createJoinInputOperator(int16_t                                                   blockId,
+                                       const std::vector<std::vector<std::pair<int32_t, int32_t>>>& blocks) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  pOperator->name = "joinInputOperator4Test";
+  pOperator->resultDataBlockId = blockId;
+  pOperator->fpSet.getNextFn = getJoinInputBlock;
+
+  SJoinInputInfo* pInfo = new SJoinInputInfo();
+  for (const auto& rows : blocks) {
+    pInfo->blocks.push_back(createJoinInputBlock(blockId, rows));
+  }
+  pInfo->index = 0;
+  pOperator->info = pInfo;
+  return pOperator;
+}
+
+void destroyJoinInputOperator(SOperatorInfo* pOperator) {
+  SJoinInputInfo* pInfo = static_cast<SJoinInputInfo*>(pOperator->info);
+  for (auto pBlock : pInfo->blocks) {
+    blockDataDestroy(pBlock);
+  }
+  delete pInfo;
+  taosMemoryFree(pOperator);
+}
+
+SColumnNode* createJoinColumn(int16_t blockId, int16_t slotId) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = TSDB_DATA_TYPE_INT;
+  pCol->node.resType.bytes = sizeof(int32_t);
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  return pCol;
+}
+
+// left.key = right.key, the output is (left.val, right.val)
+SHashJoinPhysiNode* createHashJoinNode(int16_t leftId, int16_t rightId) {
+  const int16_t       outputId = 3;
+  SHashJoinPhysiNode* pJoin = (SHashJoinPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  pJoin->joinType = JOIN_TYPE_INNER;
+  nodesListMakeAppend(&pJoin->pOnLeft, (SNode*)createJoinColumn(leftId, 0));
+  nodesListMakeAppend(&pJoin->pOnRight, (SNode*)createJoinColumn(rightId, 0));
+
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = outputId;
+  int16_t children[2] = {leftId, rightId};
+  for (int16_t i = 0; i < 2; ++i) {
+    STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+    pTarget->dataBlockId = outputId;
+    pTarget->slotId = i;
+    pTarget->pExpr = (SNode*)createJoinColumn(children[i], 1);
+    nodesListMakeAppend(&pJoin->pTargets, (SNode*)pTarget);
+
+    SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+    pSlot->slotId = i;
+    pSlot->dataType.type = TSDB_DATA_TYPE_INT;
+    pSlot->dataType.bytes = sizeof(int32_t);
+    pSlot->output = true;
+    nodesListMakeAppend(&pDesc->pSlots, (SNode*)pSlot);
+    pDesc->totalRowSize += sizeof(int32_t);
+    pDesc->outputRowSize += sizeof(int32_t);
+  }
+  pJoin->node.pOutputDataBlockDesc = pDesc;
+  return pJoin;
+}
+
+// run the hash join of the two inputs and return the sorted (left.val, right.val) pairs
+std::vector<std::pair<int32_t, int32_t>> runHashJoin(
+    const std::vector<std::vector<std::pair<int32_t, int32_t>>>& left,
+    const std::vector<std::vector<std::pair<int32_t, int32_t>>>& right) {
+  SExecTaskInfo* pTaskInfo = static_cast<SExecTaskInfo*>(taosMemoryCalloc(1, sizeof(SExecTaskInfo)));
+  char           id[] = "hash join test";
+  pTaskInfo->id.str = id;
+
+  SOperatorInfo* pDownstream[2] = {createJoinInputOperator(1, left), createJoinInputOperator(2, right)};
+
+  SHashJoinPhysiNode* pJoin = createHashJoinNode(1, 2);
+  SOperatorInfo*      pOperator = createHashJoinOperatorInfo(pDownstream, 2, pJoin, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+
+  std::vector<std::pair<int32_t, int32_t>> res;
+  while (pOperator != NULL) {
+    SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+    if (pRes == NULL) {
+      break;
+    }
+
+    SColumnInfoData* pLeft = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+    SColumnInfoData* pRight = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      res.emplace_back(*(int32_t*)colDataGetData(pLeft, i), *(int32_t*)colDataGetData(pRight, i));
+    }
+  }
+  std::sort(res.begin(), res.end());
+
+  if (pOperator != NULL) {
+    pOperator->fpSet.closeFn(pOperator->info);
+    taosMemoryFree(pOperator->pDownstream);
+    taosMemoryFree(pOperator);
+  }
+  nodesDestroyNode((SNode*)pJoin);
+  destroyJoinInputOperator(pDownstream[0]);
+  destroyJoinInputOperator(pDownstream[1]);
+  taosMemoryFree(pTaskInfo);
+  return res;
+}
+
+}  // namespace
+
+TEST(hashJoinTest, duplicateKeys) {
+  // key 2 appears twice on both sides and in different blocks, each pair of them is joined
+  std::vector<std::pair<int32_t, int32_t>> res =
+      runHashJoin({{{1, 10}, {2, 20}}, {{2, 21}, {3, 30}}}, {{{2, 100}, {3, 101}}, {{2, 102}, {4, 103}}});
+
+  std::vector<std::pair<int32_t, int32_t>> expect = {{20, 100}, {20, 102}, {21, 100}, {21, 102}, {30, 101}};
+  ASSERT_EQ(res, expect);
+}
+
+TEST(hashJoinTest, nullKeys) {
+  // null keys match nothing, including the null keys of the other side
+  std::vector<std::pair<int32_t, int32_t>> res = runHashJoin({{{NULL_KEY, 10}, {1, 11}, {NULL_KEY, 12}}},
+                                                             {{{NULL_KEY, 100}, {1, 101}}, {{NULL_KEY, 102}}});
+
+  std::vector<std::pair<int32_t, int32_t>> expect = {{11, 101}};
+  ASSERT_EQ(res, expect);
+}
+
+TEST(hashJoinTest, emptyBuildSide) {
+  // the right child is exhausted first and builds an empty hash table
+  std::vector<std::pair<int32_t, int32_t>> res = runHashJoin({{{1, 10}, {2, 20}}, {{3, 30}}}, {});
+  ASSERT_TRUE(res.empty());
+
+  res = runHashJoin({}, {{{1, 100}}});
+  ASSERT_TRUE(res.empty());
+}
+
+#pragma GCC diagnostic pop
@@ -14,6 +14,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <vector>
 #include <tglobal.h>
 #include <tsort.h>
 #include <iostream>
@@ -393,4 +394,100 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+namespace {
+
+typedef struct SBoundedSortInput {
+  int32_t      numOfRows;
+  int32_t      blockRows;
+  int32_t      index;
+  SSDataBlock* pBlock;
+} SBoundedSortInput;
+
+// the values 1..numOfRows in a scrambled order, the data block is reused for each call
+SSDataBlock* getBoundedSortInputBlock(void* param) {
+  SBoundedSortInput* pInput = static_cast<SBoundedSortInput*>(param);
+  if (pInput->index >= pInput->numOfRows) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInput->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, pInput->blockRows);
+
+  SColumnInfoData* pCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  int32_t          rows = 0;
+  for (; rows < pInput->blockRows && pInput->index < pInput->numOfRows; ++rows, ++pInput->index) {
+    int32_t v = (int32_t)(((int64_t)pInput->index * 7919) % pInput->numOfRows) + 1;
+    colDataAppend(pCol, rows, reinterpret_cast<const char*>(&v), false);
+  }
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+// sort numOfRows scrambled values with the bound maxRows, and return the values in output order
+std::vector<int32_t> runBoundedSort(int32_t numOfRows, int64_t maxRows) {
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_ASC;
+  oi.slotId = 0;
+  SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi);
+
+  SBoundedSortInput input = {.numOfRows = numOfRows, .blockRows = 1000, .index = 0, .pBlock = createDataBlock()};
+  SColumnInfoData   colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  blockDataAppendColInfo(input.pBlock, &colInfo);
+
+  SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, 1024, 5, NULL, "bounded_sort");
+  tsortSetFetchRawDataFp(phandle, getBoundedSortInputBlock, NULL, NULL);
+  tsortSetMaxRows(phandle, maxRows);
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &input;
+  tsortAddSource(phandle, ps);
+
+  int32_t code = tsortOpen(phandle);
+  EXPECT_EQ(code, TSDB_CODE_SUCCESS);
+  taosMemoryFreeClear(ps);
+
+  std::vector<int32_t> res;
+  while (code == TSDB_CODE_SUCCESS) {
+    STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+    if (pTupleHandle == NULL) {
+      break;
+    }
+    res.push_back(*(int32_t*)tsortGetValue(pTupleHandle, 0));
+  }
+
+  tsortDestroySortHandle(phandle);
+  taosArrayDestroy(orderInfo);
+  blockDataDestroy(input.pBlock);
+  return res;
+}
+
+std::vector<int32_t> firstValues(int32_t num) {
+  std::vector<int32_t> res;
+  for (int32_t i = 1; i <= num; ++i) {
+    res.push_back(i);
+  }
+  return res;
+}
+
+}  // namespace
+
+TEST(testCase, bounded_sort_Test) {
+  // the bound is smaller than a block, a block, and cut across blocks
+  ASSERT_EQ(runBoundedSort(10000, 10), firstValues(10));
+  ASSERT_EQ(runBoundedSort(10000, 1000), firstValues(1000));
+  ASSERT_EQ(runBoundedSort(10000, 2500), firstValues(2500));
+
+  // a bound over the input keeps all rows
+  ASSERT_EQ(runBoundedSort(100, 1000), firstValues(100));
+
+  // 0 and the bounds too large to be held in memory sort all tuples without overflowing the buffer size
+  ASSERT_EQ(runBoundedSort(5000, 0), firstValues(5000));
+  ASSERT_EQ(runBoundedSort(5000, 100000000), firstValues(5000));
+  ASSERT_EQ(runBoundedSort(5000, INT32_MAX), firstValues(5000));
+  ASSERT_EQ(runBoundedSort(5000, INT64_MAX), firstValues(5000));
+  ASSERT_EQ(runBoundedSort(5000, (int64_t)INT32_MAX * 4 + 10), firstValues(5000));
+}
+
 #pragma GCC diagnostic pop
@@ -34,8 +34,31 @@ enum {
   TSDB_UDF_CALL_SCALA_PROC,
 };
 
+// position of a column placed in the shared memory of a udf session
+typedef struct SUdfShmColumn {
+  int8_t  type;
+  uint8_t precision;
+  uint8_t scale;
+  int32_t bytes;
+  int8_t  hasNull;
+  int32_t numOfRows;
+  int32_t metaOffset;  // null bitmap of fixed length column or offsets of var length column
+  int32_t metaLen;
+  int32_t dataOffset;
+  int32_t dataLen;
+} SUdfShmColumn;
+
+typedef struct SUdfShmBlock {
+  int32_t        numOfRows;
+  int32_t        numOfCols;
+  int32_t        len;  // bytes used in the shared memory
+  SUdfShmColumn *cols;
+} SUdfShmBlock;
+
 typedef struct SUdfSetupRequest {
   char udfName[TSDB_FUNC_NAME_LEN];
+  int32_t shmId;
+  int32_t shmSize;
 } SUdfSetupRequest;
 
 typedef struct SUdfSetupResponse {
@@ -43,13 +66,16 @@ typedef struct SUdfSetupResponse {
   int8_t outputType;
   int32_t outputLen;
   int32_t bufSize;
+  int32_t shmSize;  // 0 if udfd can not attach the shared memory
 } SUdfSetupResponse;
 
 typedef struct SUdfCallRequest {
   int64_t udfHandle;
   int8_t callType;
 
+  int8_t shmData;  // the input block is in the shared memory, only shmBlock is sent
   SSDataBlock block;
+  SUdfShmBlock shmBlock;
   SUdfInterBuf interBuf;
   SUdfInterBuf interBuf2;
   int8_t initFirst;
@@ -57,7 +83,9 @@ typedef struct SUdfCallRequest {
 
 typedef struct SUdfCallResponse {
   int8_t callType;
+  int8_t shmData;  // the result column is in the shared memory, only shmResult is sent
   SSDataBlock resultData;
+  SUdfShmColumn shmResult;
   SUdfInterBuf resultBuf;
 } SUdfCallResponse;
 
@@ -111,6 +139,18 @@ void freeUdfDataDataBlock(SUdfDataBlock *block);
 int32_t convertDataBlockToUdfDataBlock(SSDataBlock *block, SUdfDataBlock *udfBlock);
 int32_t convertUdfColumnToDataBlock(SUdfColumn *udfCol, SSDataBlock *block);
 
+int32_t encodeUdfShmColumn(void **buf, const SUdfShmColumn *col);
+void*   decodeUdfShmColumn(const void* buf, SUdfShmColumn *col);
+int32_t encodeUdfShmBlock(void **buf, const SUdfShmBlock *block);
+void*   decodeUdfShmBlock(const void* buf, SUdfShmBlock *block);
+
+int32_t copyDataBlockToUdfShm(SSDataBlock *block, SShm *shm, SUdfShmBlock *shmBlock);
+int8_t  prepareUdfShmBlock(SSDataBlock *block, SShm *shm, uv_mutex_t *shmLock, SUdfShmBlock *shmBlock);
+int32_t convertUdfShmBlockToUdfDataBlock(const SUdfShmBlock *shmBlock, SShm *shm, SUdfDataBlock *udfBlock);
+void    freeUdfShmDataBlock(SUdfDataBlock *block);
+int32_t copyUdfColumnToUdfShm(SUdfColumn *udfCol, SShm *shm, int32_t offset, SUdfShmColumn *shmCol);
+int32_t convertUdfShmColumnToDataBlock(const SUdfShmColumn *shmCol, SShm *shm, SSDataBlock *block);
+
 int32_t getUdfdPipeName(char* pipeName, int32_t size);
 #ifdef __cplusplus
 }
@@ -368,6 +368,9 @@ typedef struct SUdfcUvSession {
   int32_t outputLen;
   int32_t bufSize;
 
+  SShm       shm;      // column buffers shared with udfd
+  uv_mutex_t shmLock;  // held by the call using the shared memory, the others go through the pipe
+
   char udfName[TSDB_FUNC_NAME_LEN];
 } SUdfcUvSession;
 
@@ -482,11 +485,15 @@ int32_t getUdfdPipeName(char* pipeName, int32_t size) {
 int32_t encodeUdfSetupRequest(void **buf, const SUdfSetupRequest *setup) {
   int32_t len = 0;
   len += taosEncodeBinary(buf, setup->udfName, TSDB_FUNC_NAME_LEN);
+  len += taosEncodeFixedI32(buf, setup->shmId);
+  len += taosEncodeFixedI32(buf, setup->shmSize);
   return len;
 }
 
 void* decodeUdfSetupRequest(const void* buf, SUdfSetupRequest *request) {
   buf = taosDecodeBinaryTo(buf, request->udfName, TSDB_FUNC_NAME_LEN);
+  buf = taosDecodeFixedI32(buf, &request->shmId);
+  buf = taosDecodeFixedI32(buf, &request->shmSize);
   return (void*)buf;
 }
 
@@ -505,16 +512,71 @@ void* decodeUdfInterBuf(const void* buf, SUdfInterBuf* state) {
   return (void*)buf;
 }
 
+int32_t encodeUdfShmColumn(void **buf, const SUdfShmColumn *col) {
+  int32_t len = 0;
+  len += taosEncodeFixedI8(buf, col->type);
+  len += taosEncodeFixedU8(buf, col->precision);
+  len += taosEncodeFixedU8(buf, col->scale);
+  len += taosEncodeFixedI32(buf, col->bytes);
+  len += taosEncodeFixedI8(buf, col->hasNull);
+  len += taosEncodeFixedI32(buf, col->numOfRows);
+  len += taosEncodeFixedI32(buf, col->metaOffset);
+  len += taosEncodeFixedI32(buf, col->metaLen);
+  len += taosEncodeFixedI32(buf, col->dataOffset);
+  len += taosEncodeFixedI32(buf, col->dataLen);
+  return len;
+}
+
+void* decodeUdfShmColumn(const void* buf, SUdfShmColumn *col) {
+  buf = taosDecodeFixedI8(buf, &col->type);
+  buf = taosDecodeFixedU8(buf, &col->precision);
+  buf = taosDecodeFixedU8(buf, &col->scale);
+  buf = taosDecodeFixedI32(buf, &col->bytes);
+  buf = taosDecodeFixedI8(buf, &col->hasNull);
+  buf = taosDecodeFixedI32(buf, &col->numOfRows);
+  buf = taosDecodeFixedI32(buf, &col->metaOffset);
+  buf = taosDecodeFixedI32(buf, &col->metaLen);
+  buf = taosDecodeFixedI32(buf, &col->dataOffset);
+  buf = taosDecodeFixedI32(buf, &col->dataLen);
+  return (void*)buf;
+}
+
+int32_t encodeUdfShmBlock(void **buf, const SUdfShmBlock *block) {
+  int32_t len = 0;
+  len += taosEncodeFixedI32(buf, block->numOfRows);
+  len += taosEncodeFixedI32(buf, block->numOfCols);
+  len += taosEncodeFixedI32(buf, block->len);
+  for (int32_t i = 0; i < block->numOfCols; ++i) {
+    len += encodeUdfShmColumn(buf, &block->cols[i]);
+  }
+  return len;
+}
+
+void* decodeUdfShmBlock(const void* buf, SUdfShmBlock *block) {
+  buf = taosDecodeFixedI32(buf, &block->numOfRows);
+  buf = taosDecodeFixedI32(buf, &block->numOfCols);
+  buf = taosDecodeFixedI32(buf, &block->len);
+  block->cols = (block->numOfCols > 0) ? taosMemoryCalloc(block->numOfCols, sizeof(SUdfShmColumn)) : NULL;
+  // the columns are still consumed without memory for them, the block is then rejected when it is converted
+  SUdfShmColumn col = {0};
+  for (int32_t i = 0; i < block->numOfCols; ++i) {
+    buf = decodeUdfShmColumn(buf, (block->cols != NULL) ? &block->cols[i] : &col);
+  }
+  return (void*)buf;
+}
+
 int32_t encodeUdfCallRequest(void **buf, const SUdfCallRequest *call) {
   int32_t len = 0;
   len += taosEncodeFixedI64(buf, call->udfHandle);
   len += taosEncodeFixedI8(buf, call->callType);
   if (call->callType == TSDB_UDF_CALL_SCALA_PROC) {
-    len += tEncodeDataBlock(buf, &call->block);
+    len += taosEncodeFixedI8(buf, call->shmData);
+    len += call->shmData ? encodeUdfShmBlock(buf, &call->shmBlock) : tEncodeDataBlock(buf, &call->block);
   } else if (call->callType == TSDB_UDF_CALL_AGG_INIT) {
     len += taosEncodeFixedI8(buf, call->initFirst);
   } else if (call->callType == TSDB_UDF_CALL_AGG_PROC) {
-    len += tEncodeDataBlock(buf, &call->block);
+    len += taosEncodeFixedI8(buf, call->shmData);
+    len += call->shmData ? encodeUdfShmBlock(buf, &call->shmBlock) : tEncodeDataBlock(buf, &call->block);
     len += encodeUdfInterBuf(buf, &call->interBuf);
   } else if (call->callType == TSDB_UDF_CALL_AGG_MERGE) {
     len += encodeUdfInterBuf(buf, &call->interBuf);
@@ -530,13 +592,15 @@ void* decodeUdfCallRequest(const void* buf, SUdfCallRequest* call) {
   buf = taosDecodeFixedI8(buf, &call->callType);
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      buf = tDecodeDataBlock(buf, &call->block);
+      buf = taosDecodeFixedI8(buf, &call->shmData);
+      buf = call->shmData ? decodeUdfShmBlock(buf, &call->shmBlock) : tDecodeDataBlock(buf, &call->block);
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       buf = taosDecodeFixedI8(buf, &call->initFirst);
       break;
     case TSDB_UDF_CALL_AGG_PROC:
-      buf = tDecodeDataBlock(buf, &call->block);
+      buf = taosDecodeFixedI8(buf, &call->shmData);
+      buf = call->shmData ? decodeUdfShmBlock(buf, &call->shmBlock) : tDecodeDataBlock(buf, &call->block);
       buf = decodeUdfInterBuf(buf, &call->interBuf);
       break;
     case TSDB_UDF_CALL_AGG_MERGE:
@@ -604,6 +668,7 @@ int32_t encodeUdfSetupResponse(void **buf, const SUdfSetupResponse *setupRsp) {
   len += taosEncodeFixedI8(buf, setupRsp->outputType);
   len += taosEncodeFixedI32(buf, setupRsp->outputLen);
   len += taosEncodeFixedI32(buf, setupRsp->bufSize);
+  len += taosEncodeFixedI32(buf, setupRsp->shmSize);
   return len;
 }
 
@@ -612,6 +677,7 @@ void* decodeUdfSetupResponse(const void* buf, SUdfSetupResponse* setupRsp) {
   buf = taosDecodeFixedI8(buf, &setupRsp->outputType);
   buf = taosDecodeFixedI32(buf, &setupRsp->outputLen);
   buf = taosDecodeFixedI32(buf, &setupRsp->bufSize);
+  buf = taosDecodeFixedI32(buf, &setupRsp->shmSize);
   return (void*)buf;
 }
 
@@ -620,7 +686,9 @@ int32_t encodeUdfCallResponse(void **buf, const SUdfCallResponse *callRsp) {
   len += taosEncodeFixedI8(buf, callRsp->callType);
   switch (callRsp->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      len += tEncodeDataBlock(buf, &callRsp->resultData);
+      len += taosEncodeFixedI8(buf, callRsp->shmData);
+      len += callRsp->shmData ? encodeUdfShmColumn(buf, &callRsp->shmResult)
+                              : tEncodeDataBlock(buf, &callRsp->resultData);
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       len += encodeUdfInterBuf(buf, &callRsp->resultBuf);
@@ -642,7 +710,9 @@ void* decodeUdfCallResponse(const void* buf, SUdfCallResponse* callRsp) {
   buf = taosDecodeFixedI8(buf, &callRsp->callType);
   switch (callRsp->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      buf = tDecodeDataBlock(buf, &callRsp->resultData);
+      buf = taosDecodeFixedI8(buf, &callRsp->shmData);
+      buf = callRsp->shmData ? decodeUdfShmColumn(buf, &callRsp->shmResult)
+                             : tDecodeDataBlock(buf, &callRsp->resultData);
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       buf = decodeUdfInterBuf(buf, &callRsp->resultBuf);
@@ -831,6 +901,277 @@ int32_t convertUdfColumnToDataBlock(SUdfColumn *udfCol, SSDataBlock *block) {
   return 0;
 }
 
+#define UDF_SHM_ALIGN(len) (((len) + 7) & ~7)
+
+// The columns of the block are placed in the shared memory of the udf session once, udfd reads them in place and
+// only their positions are sent through the pipe. -1 is returned if the block does not fit in the shared memory.
+int32_t copyDataBlockToUdfShm(SSDataBlock *block, SShm *shm, SUdfShmBlock *shmBlock) {
+  int32_t numOfRows = block->info.rows;
+  int32_t numOfCols = taosArrayGetSize(block->pDataBlock);
+
+  int64_t total = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData *col = (SColumnInfoData *)taosArrayGet(block->pDataBlock, i);
+    int32_t metaLen = IS_VAR_DATA_TYPE(col->info.type) ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+    total += UDF_SHM_ALIGN(metaLen) + UDF_SHM_ALIGN(colDataGetLength(col, numOfRows));
+  }
+  if (shm->ptr == NULL || total > shm->size) {
+    return -1;
+  }
+
+  shmBlock->cols = taosMemoryCalloc(numOfCols, sizeof(SUdfShmColumn));
+  if (shmBlock->cols == NULL) {
+    return -1;
+  }
+  shmBlock->numOfRows = numOfRows;
+  shmBlock->numOfCols = numOfCols;
+
+  int32_t offset = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData *col = (SColumnInfoData *)taosArrayGet(block->pDataBlock, i);
+    SUdfShmColumn   *shmCol = &shmBlock->cols[i];
+    shmCol->type = col->info.type;
+    shmCol->bytes = col->info.bytes;
+    shmCol->precision = col->info.precision;
+    shmCol->scale = col->info.scale;
+    shmCol->hasNull = col->hasNull;
+    shmCol->numOfRows = numOfRows;
+
+    char *meta = NULL;
+    if (IS_VAR_DATA_TYPE(col->info.type)) {
+      meta = (char *)col->varmeta.offset;
+      shmCol->metaLen = sizeof(int32_t) * numOfRows;
+    } else {
+      meta = col->nullbitmap;
+      shmCol->metaLen = BitmapLen(numOfRows);
+    }
+    shmCol->metaOffset = offset;
+    if (meta != NULL) {
+      memcpy((char *)shm->ptr + offset, meta, shmCol->metaLen);
+    } else {
+      memset((char *)shm->ptr + offset, 0, shmCol->metaLen);
+    }
+    offset += UDF_SHM_ALIGN(shmCol->metaLen);
+
+    shmCol->dataLen = colDataGetLength(col, numOfRows);
+    shmCol->dataOffset = offset;
+    if (shmCol->dataLen > 0) {
+      memcpy((char *)shm->ptr + offset, col->pData, shmCol->dataLen);
+    }
+    offset += UDF_SHM_ALIGN(shmCol->dataLen);
+  }
+
+  shmBlock->len = offset;
+  return 0;
+}
+
+static bool udfShmRangeValid(const SShm *shm, int32_t offset, int32_t len) {
+  return offset >= 0 && len >= 0 && (int64_t)offset + len <= shm->size;
+}
+
+// The positions come from the other process, every byte the column refers to must lie in the shared memory.
+static bool udfShmColumnValid(const SUdfShmColumn *shmCol, const SShm *shm) {
+  int32_t numOfRows = shmCol->numOfRows;
+  if (numOfRows < 0 || !udfShmRangeValid(shm, shmCol->metaOffset, shmCol->metaLen) ||
+      !udfShmRangeValid(shm, shmCol->dataOffset, shmCol->dataLen)) {
+    return false;
+  }
+
+  if (!IS_VAR_DATA_TYPE(shmCol->type)) {
+    return shmCol->metaLen >= BitmapLen(numOfRows) &&
+           (shmCol->dataLen == 0 || (int64_t)shmCol->bytes * numOfRows <= shmCol->dataLen);
+  }
+
+  if ((int64_t)sizeof(int32_t) * numOfRows > shmCol->metaLen) {
+    return false;
+  }
+  const int32_t *varOffsets = (const int32_t *)((const char *)shm->ptr + shmCol->metaOffset);
+  const char    *payload = (const char *)shm->ptr + shmCol->dataOffset;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t offset = varOffsets[i];
+    if (offset == -1) {
+      continue;
+    }
+    if (offset < 0 || (int64_t)offset + VARSTR_HEADER_SIZE > shmCol->dataLen ||
+        (int64_t)offset + varDataTLen(payload + offset) > shmCol->dataLen) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns 1 with shmLock held if the block is placed in the shared memory. Another call of the session owning the
+// shared memory, or a block that does not fit, leaves the block to the pipe.
+int8_t prepareUdfShmBlock(SSDataBlock *block, SShm *shm, uv_mutex_t *shmLock, SUdfShmBlock *shmBlock) {
+  if (shm->ptr == NULL || uv_mutex_trylock(shmLock) != 0) {
+    return 0;
+  }
+  if (copyDataBlockToUdfShm(block, shm, shmBlock) != 0) {
+    uv_mutex_unlock(shmLock);
+    return 0;
+  }
+  return 1;
+}
+
+// the columns of udfBlock refer to the shared memory, release it by freeUdfShmDataBlock
+int32_t convertUdfShmBlockToUdfDataBlock(const SUdfShmBlock *shmBlock, SShm *shm, SUdfDataBlock *udfBlock) {
+  if (shm->ptr == NULL || shmBlock->len < 0 || shmBlock->len > shm->size || shmBlock->numOfRows < 0 ||
+      shmBlock->numOfCols < 0) {
+    fnError("udf shared memory block out of range. len: %d, shm size: %d", shmBlock->len, shm->size);
+    return TSDB_CODE_UDF_INVALID_INPUT;
+  }
+  if (shmBlock->numOfCols > 0 && shmBlock->cols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < shmBlock->numOfCols; ++i) {
+    const SUdfShmColumn *shmCol = &shmBlock->cols[i];
+    if (shmCol->numOfRows != shmBlock->numOfRows || !udfShmColumnValid(shmCol, shm)) {
+      fnError("udf shared memory column %d out of range. meta: %d/%d, data: %d/%d, shm size: %d", i,
+              shmCol->metaOffset, shmCol->metaLen, shmCol->dataOffset, shmCol->dataLen, shm->size);
+      return TSDB_CODE_UDF_INVALID_INPUT;
+    }
+  }
+
+  udfBlock->numOfRows = shmBlock->numOfRows;
+  udfBlock->numOfCols = shmBlock->numOfCols;
+  udfBlock->udfCols = taosMemoryCalloc(shmBlock->numOfCols, sizeof(SUdfColumn*));
+  if (udfBlock->udfCols == NULL && shmBlock->numOfCols > 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < udfBlock->numOfCols; ++i) {
+    udfBlock->udfCols[i] = taosMemoryCalloc(1, sizeof(SUdfColumn));
+    if (udfBlock->udfCols[i] == NULL) {
+      freeUdfShmDataBlock(udfBlock);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    const SUdfShmColumn *shmCol = &shmBlock->cols[i];
+    SUdfColumn          *udfCol = udfBlock->udfCols[i];
+    udfCol->colMeta.type = shmCol->type;
+    udfCol->colMeta.bytes = shmCol->bytes;
+    udfCol->colMeta.scale = shmCol->scale;
+    udfCol->colMeta.precision = shmCol->precision;
+    udfCol->colData.numOfRows = shmCol->numOfRows;
+    udfCol->hasNull = shmCol->hasNull;
+    if (IS_VAR_DATA_TYPE(shmCol->type)) {
+      udfCol->colData.varLenCol.varOffsetsLen = shmCol->metaLen;
+      udfCol->colData.varLenCol.varOffsets = (int32_t *)((char *)shm->ptr + shmCol->metaOffset);
+      udfCol->colData.varLenCol.payloadLen = shmCol->dataLen;
+      udfCol->colData.varLenCol.payload = (char *)shm->ptr + shmCol->dataOffset;
+    } else {
+      udfCol->colData.fixLenCol.nullBitmapLen = shmCol->metaLen;
+      udfCol->colData.fixLenCol.nullBitmap = (char *)shm->ptr + shmCol->metaOffset;
+      udfCol->colData.fixLenCol.dataLen = shmCol->dataLen;
+      udfCol->colData.fixLenCol.data = (char *)shm->ptr + shmCol->dataOffset;
+    }
+  }
+  return 0;
+}
+
+void freeUdfShmDataBlock(SUdfDataBlock *block) {
+  for (int32_t i = 0; i < block->numOfCols && block->udfCols != NULL; ++i) {
+    taosMemoryFree(block->udfCols[i]);
+    block->udfCols[i] = NULL;
+  }
+  taosMemoryFree(block->udfCols);
+  block->udfCols = NULL;
+}
+
+// udfd writes the result column behind the input block, -1 is returned if it does not fit
+int32_t copyUdfColumnToUdfShm(SUdfColumn *udfCol, SShm *shm, int32_t offset, SUdfShmColumn *shmCol) {
+  SUdfColumnMeta *meta = &udfCol->colMeta;
+  SUdfColumnData *data = &udfCol->colData;
+  int32_t         numOfRows = data->numOfRows;
+
+  char   *pMeta = NULL;
+  char   *pData = NULL;
+  int32_t metaLen = 0;
+  int32_t dataLen = 0;
+  if (IS_VAR_DATA_TYPE(meta->type)) {
+    pMeta = (char *)data->varLenCol.varOffsets;
+    metaLen = sizeof(int32_t) * numOfRows;
+    pData = data->varLenCol.payload;
+    dataLen = data->varLenCol.payloadLen;
+  } else {
+    pMeta = data->fixLenCol.nullBitmap;
+    metaLen = BitmapLen(numOfRows);
+    pData = data->fixLenCol.data;
+    dataLen = (pData != NULL) ? meta->bytes * numOfRows : 0;
+  }
+
+  offset = UDF_SHM_ALIGN(offset);
+  if (shm->ptr == NULL || (int64_t)offset + UDF_SHM_ALIGN(metaLen) + dataLen > shm->size) {
+    return -1;
+  }
+
+  shmCol->type = meta->type;
+  shmCol->bytes = meta->bytes;
+  shmCol->precision = meta->precision;
+  shmCol->scale = meta->scale;
+  shmCol->hasNull = udfCol->hasNull;
+  shmCol->numOfRows = numOfRows;
+
+  shmCol->metaOffset = offset;
+  shmCol->metaLen = metaLen;
+  if (pMeta != NULL) {
+    memcpy((char *)shm->ptr + offset, pMeta, metaLen);
+  } else {
+    memset((char *)shm->ptr + offset, 0, metaLen);
+  }
+  offset += UDF_SHM_ALIGN(metaLen);
+
+  shmCol->dataOffset = offset;
+  shmCol->dataLen = dataLen;
+  if (dataLen > 0) {
+    memcpy((char *)shm->ptr + offset, pData, dataLen);
+  }
+  return 0;
+}
+
+int32_t convertUdfShmColumnToDataBlock(const SUdfShmColumn *shmCol, SShm *shm, SSDataBlock *block) {
+  if (shm->ptr == NULL || !udfShmColumnValid(shmCol, shm)) {
+    fnError("udf shared memory result out of range. meta: %d/%d, data: %d/%d, shm size: %d", shmCol->metaOffset,
+            shmCol->metaLen, shmCol->dataOffset, shmCol->dataLen, shm->size);
+    return TSDB_CODE_UDF_INVALID_OUTPUT_TYPE;
+  }
+
+  block->info.rows = shmCol->numOfRows;
+  block->info.hasVarCol = IS_VAR_DATA_TYPE(shmCol->type);
+
+  block->pDataBlock = taosArrayInit(1, sizeof(SColumnInfoData));
+  if (block->pDataBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosArraySetSize(block->pDataBlock, 1);
+  SColumnInfoData *col = taosArrayGet(block->pDataBlock, 0);
+  memset(col, 0, sizeof(SColumnInfoData));
+  col->info.type = shmCol->type;
+  col->info.bytes = shmCol->bytes;
+  col->info.precision = shmCol->precision;
+  col->info.scale = shmCol->scale;
+  col->hasNull = shmCol->hasNull;
+
+  const char *pMeta = (char *)shm->ptr + shmCol->metaOffset;
+  char       *pCopy = taosMemoryMalloc(shmCol->metaLen);
+  col->pData = taosMemoryMalloc(shmCol->dataLen);
+  if (pCopy == NULL || col->pData == NULL) {
+    taosMemoryFree(pCopy);
+    taosMemoryFreeClear(col->pData);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  memcpy(pCopy, pMeta, shmCol->metaLen);
+  if (IS_VAR_DATA_TYPE(shmCol->type)) {
+    col->varmeta.offset = (int32_t *)pCopy;
+    col->varmeta.length = shmCol->dataLen;
+    col->varmeta.allocLen = shmCol->dataLen;
+  } else {
+    col->nullbitmap = pCopy;
+  }
+  memcpy(col->pData, (char *)shm->ptr + shmCol->dataOffset, shmCol->dataLen);
+  return 0;
+}
+
 int32_t convertScalarParamToDataBlock(SScalarParam *input, int32_t numOfCols, SSDataBlock *output) {
   output->info.rows = input->numOfRows;
   output->pDataBlock = taosArrayInit(numOfCols, sizeof(SColumnInfoData));
@@ -1647,6 +1988,8 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
   task->errCode = 0;
   task->session = taosMemoryCalloc(1, sizeof(SUdfcUvSession));
   task->session->udfc = &gUdfdProxy;
+  task->session->shm.id = -1;
+  uv_mutex_init(&task->session->shmLock);
   task->type = UDF_TASK_SETUP;
 
   SUdfSetupRequest *req = &task->_setup.req;
@@ -1658,6 +2001,13 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
     return TSDB_CODE_UDF_PIPE_CONNECT_ERR;
   }
 
+#ifndef WINDOWS
+  if (tsUdfShmSize > 0 && taosCreateShm(&task->session->shm, 0, tsUdfShmSize * 1024 * 1024) == 0) {
+    req->shmId = task->session->shm.id;
+    req->shmSize = task->session->shm.size;
+  }
+#endif
+
   udfcRunUdfUvTask(task, UV_TASK_REQ_RSP);
 
   SUdfSetupResponse *rsp = &task->_setup.rsp;
@@ -1666,6 +2016,10 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
   task->session->outputLen = rsp->outputLen;
   task->session->bufSize = rsp->bufSize;
   strcpy(task->session->udfName, udfName);
+  if (task->session->shm.ptr != NULL && (task->errCode != 0 || rsp->shmSize != task->session->shm.size)) {
+    fnInfo("udfd does not share memory with udf session. udfName: %s", udfName);
+    taosDropShm(&task->session->shm);
+  }
   if (task->errCode != 0) {
     fnError("failed to setup udf. udfname: %s, err: %d", udfName, task->errCode)
   } else {
@@ -1719,6 +2073,10 @@ int32_t callUdf(UdfcFuncHandle handle, int8_t callType, SSDataBlock *input, SUdf
     }
   }
 
+  if (callType == TSDB_UDF_CALL_SCALA_PROC || callType == TSDB_UDF_CALL_AGG_PROC) {
+    req->shmData = prepareUdfShmBlock(input, &session->shm, &session->shmLock, &req->shmBlock);
+  }
+
   udfcRunUdfUvTask(task, UV_TASK_REQ_RSP);
 
   if (task->errCode != 0) {
@@ -1743,11 +2101,19 @@ int32_t callUdf(UdfcFuncHandle handle, int8_t callType, SSDataBlock *input, SUdf
         break;
       }
       case TSDB_UDF_CALL_SCALA_PROC: {
-        *output = rsp->resultData;
+        if (rsp->shmData) {
+          task->errCode = convertUdfShmColumnToDataBlock(&rsp->shmResult, &session->shm, output);
+        } else {
+          *output = rsp->resultData;
+        }
         break;
       }
     }
   };
+  if (req->shmData) {
+    taosMemoryFree(req->shmBlock.cols);
+    uv_mutex_unlock(&session->shmLock);
+  }
   int err = task->errCode;
   taosMemoryFree(task);
   return err;
@@ -1805,6 +2171,10 @@ int32_t doTeardownUdf(UdfcFuncHandle handle) {
 
   if (session->udfUvPipe == NULL) {
     fnError("tear down udf. pipe to udfd does not exist. udf name: %s", session->udfName);
+    if (session->shm.ptr != NULL) {
+      taosDropShm(&session->shm);
+    }
+    uv_mutex_destroy(&session->shmLock);
     taosMemoryFree(session);
     return TSDB_CODE_UDF_PIPE_NO_PIPE;
   }
@@ -1829,6 +2199,10 @@ int32_t doTeardownUdf(UdfcFuncHandle handle) {
     SClientUvConn *conn = session->udfUvPipe->data;
     conn->session = NULL;
   }
+  if (session->shm.ptr != NULL) {
+    taosDropShm(&session->shm);
+  }
+  uv_mutex_destroy(&session->shmLock);
   taosMemoryFree(session);
   taosMemoryFree(task);
 
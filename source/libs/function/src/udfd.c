@@ -93,6 +93,7 @@ typedef struct SUdf {
 // TODO: add private udf structure.
 typedef struct SUdfcFuncHandle {
   SUdf *udf;
+  SShm  shm;  // shared with the udf session of taosd
 } SUdfcFuncHandle;
 
 typedef enum EUdfdRpcReqRspType {
@@ -209,8 +210,21 @@ void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
     }
     uv_mutex_unlock(&udf->lock);
   }
-  SUdfcFuncHandle *handle = taosMemoryMalloc(sizeof(SUdfcFuncHandle));
+  SUdfcFuncHandle *handle = taosMemoryCalloc(1, sizeof(SUdfcFuncHandle));
   handle->udf = udf;
+  handle->shm.id = -1;
+  if (setup->shmSize > 0) {
+    handle->shm.id = setup->shmId;
+    handle->shm.size = setup->shmSize;
+    int32_t err = taosAttachShm(&handle->shm);
+    if (err != 0 || handle->shm.ptr == NULL) {
+      fnError("udfd failed to attach shared memory %d since %s, udf name: %s", setup->shmId, strerror(err),
+              setup->udfName);
+      handle->shm.id = -1;
+      handle->shm.size = 0;
+      handle->shm.ptr = NULL;
+    }
+  }
 
   SUdfResponse rsp;
   rsp.seqNum = request->seqNum;
@@ -220,6 +234,7 @@ void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   rsp.setupRsp.outputType = udf->outputType;
   rsp.setupRsp.outputLen = udf->outputLen;
   rsp.setupRsp.bufSize = udf->bufSize;
+  rsp.setupRsp.shmSize = (handle->shm.ptr != NULL) ? handle->shm.size : 0;
 
   int32_t len = encodeUdfResponse(NULL, &rsp);
   rsp.msgLen = len;
@@ -248,10 +263,27 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
       SUdfColumn output = {0};
 
       SUdfDataBlock input = {0};
-      convertDataBlockToUdfDataBlock(&call->block, &input);
-      code = udf->scalarProcFunc(&input, &output);
-      freeUdfDataDataBlock(&input);
-      convertUdfColumnToDataBlock(&output, &response.callRsp.resultData);
+      if (call->shmData) {
+        code = convertUdfShmBlockToUdfDataBlock(&call->shmBlock, &handle->shm, &input);
+      } else {
+        convertDataBlockToUdfDataBlock(&call->block, &input);
+      }
+      if (code == TSDB_CODE_SUCCESS) {
+        code = udf->scalarProcFunc(&input, &output);
+      }
+      if (call->shmData) {
+        freeUdfShmDataBlock(&input);
+      } else {
+        freeUdfDataDataBlock(&input);
+      }
+
+      // the result is written behind the input in the shared memory if it fits
+      if (call->shmData &&
+          copyUdfColumnToUdfShm(&output, &handle->shm, call->shmBlock.len, &subRsp->shmResult) == 0) {
+        subRsp->shmData = 1;
+      } else {
+        convertUdfColumnToDataBlock(&output, &response.callRsp.resultData);
+      }
       freeUdfColumn(&output);
       break;
     }
@@ -263,11 +295,21 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
     }
     case TSDB_UDF_CALL_AGG_PROC: {
       SUdfDataBlock input = {0};
-      convertDataBlockToUdfDataBlock(&call->block, &input);
+      if (call->shmData) {
+        code = convertUdfShmBlockToUdfDataBlock(&call->shmBlock, &handle->shm, &input);
+      } else {
+        convertDataBlockToUdfDataBlock(&call->block, &input);
+      }
       SUdfInterBuf outBuf = {.buf = taosMemoryMalloc(udf->bufSize), .bufLen = udf->bufSize, .numOfResult = 0};
-      code = udf->aggProcFunc(&input, &call->interBuf, &outBuf);
+      if (code == TSDB_CODE_SUCCESS) {
+        code = udf->aggProcFunc(&input, &call->interBuf, &outBuf);
+      }
       freeUdfInterBuf(&call->interBuf);
-      freeUdfDataDataBlock(&input);
+      if (call->shmData) {
+        freeUdfShmDataBlock(&input);
+      } else {
+        freeUdfDataDataBlock(&input);
+      }
       subRsp->resultBuf = outBuf;
 
       break;
@@ -304,6 +346,10 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   encodeUdfResponse(&buf, rsp);
   uvUdf->output = uv_buf_init(bufBegin, len);
 
+  if (call->shmData) {
+    taosMemoryFree(call->shmBlock.cols);
+  }
+
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC: {
       blockDataFreeRes(&call->block);
@@ -359,6 +405,9 @@ void udfdProcessTeardownRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
     uv_dlclose(&udf->lib);
     taosMemoryFree(udf);
   }
+  if (handle->shm.ptr != NULL) {
+    taosDropShm(&handle->shm);
+  }
   taosMemoryFree(handle);
 
   SUdfResponse  response;
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "uv.h"
+#include "os.h"
+#include "taoserror.h"
+#include "tdatablock.h"
+#include "tudf.h"
+#include "tudfInt.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+const int32_t TEST_ROWS = 10;
+const int32_t TEST_SHM_SIZE = 64 * 1024;
+const int32_t NULL_ROW = 3;
+
+// an int column and a varchar column, NULL_ROW is null in both
+SSDataBlock *createTestBlock() {
+  SSDataBlock *pBlock = createDataBlock();
+
+  SColumnInfoData intCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  blockDataAppendColInfo(pBlock, &intCol);
+  SColumnInfoData varCol = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 32 + VARSTR_HEADER_SIZE, 2);
+  blockDataAppendColInfo(pBlock, &varCol);
+  blockDataEnsureCapacity(pBlock, TEST_ROWS);
+
+  SColumnInfoData *pIntCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData *pVarCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+  for (int32_t i = 0; i < TEST_ROWS; ++i) {
+    char str[32 + VARSTR_HEADER_SIZE] = {0};
+    int32_t len = snprintf(varDataVal(str), 32, "row%d", i);
+    varDataSetLen(str, len);
+
+    colDataAppend(pIntCol, i, (const char *)&i, i == NULL_ROW);
+    colDataAppend(pVarCol, i, str, i == NULL_ROW);
+  }
+  pBlock->info.rows = TEST_ROWS;
+  return pBlock;
+}
+
+class UdfShmTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    shm.id = -1;
+    shm.size = TEST_SHM_SIZE;
+    shm.ptr = taosMemoryCalloc(1, TEST_SHM_SIZE);
+    ASSERT_NE(shm.ptr, nullptr);
+    pBlock = createTestBlock();
+  }
+
+  void TearDown() override {
+    taosMemoryFree(shmBlock.cols);
+    blockDataDestroy(pBlock);
+    taosMemoryFree(shm.ptr);
+  }
+
+  // the block as udfd sees it after the positions went through the pipe
+  void encodeAndDecode(SUdfShmBlock *pDecoded) {
+    int32_t len = encodeUdfShmBlock(NULL, &shmBlock);
+    void   *buf = taosMemoryMalloc(len);
+    void   *pBuf = buf;
+    ASSERT_EQ(encodeUdfShmBlock(&pBuf, &shmBlock), len);
+    ASSERT_EQ((char *)decodeUdfShmBlock(buf, pDecoded) - (char *)buf, len);
+    taosMemoryFree(buf);
+  }
+
+  void checkUdfBlock(SUdfDataBlock *udfBlock) {
+    ASSERT_EQ(udfBlock->numOfRows, TEST_ROWS);
+    ASSERT_EQ(udfBlock->numOfCols, 2);
+    SUdfColumn *intCol = udfBlock->udfCols[0];
+    SUdfColumn *varCol = udfBlock->udfCols[1];
+    ASSERT_EQ(intCol->colMeta.type, TSDB_DATA_TYPE_INT);
+    ASSERT_EQ(varCol->colMeta.type, TSDB_DATA_TYPE_VARCHAR);
+    ASSERT_TRUE(intCol->hasNull);
+    for (int32_t i = 0; i < TEST_ROWS; ++i) {
+      ASSERT_EQ(udfColDataIsNull(intCol, i), i == NULL_ROW);
+      ASSERT_EQ(udfColDataIsNull(varCol, i), i == NULL_ROW);
+      if (i == NULL_ROW) continue;
+
+      ASSERT_EQ(*(int32_t *)udfColDataGetData(intCol, i), i);
+      char expect[32] = {0};
+      snprintf(expect, sizeof(expect), "row%d", i);
+      char *str = udfColDataGetData(varCol, i);
+      ASSERT_EQ(std::string(varDataVal(str), varDataLen(str)), std::string(expect));
+    }
+  }
+
+  SShm          shm;
+  SSDataBlock  *pBlock = NULL;
+  SUdfShmBlock  shmBlock = {0};
+};
+
+}  // namespace
+
+TEST_F(UdfShmTest, encodeDecode) {
+  ASSERT_EQ(copyDataBlockToUdfShm(pBlock, &shm, &shmBlock), 0);
+
+  SUdfShmBlock decoded = {0};
+  encodeAndDecode(&decoded);
+  ASSERT_EQ(decoded.numOfRows, shmBlock.numOfRows);
+  ASSERT_EQ(decoded.numOfCols, shmBlock.numOfCols);
+  ASSERT_EQ(decoded.len, shmBlock.len);
+  for (int32_t i = 0; i < decoded.numOfCols; ++i) {
+    ASSERT_EQ(memcmp(&decoded.cols[i], &shmBlock.cols[i], sizeof(SUdfShmColumn)), 0);
+  }
+  taosMemoryFree(decoded.cols);
+
+  SUdfShmColumn col = shmBlock.cols[1];
+  int32_t       len = encodeUdfShmColumn(NULL, &col);
+  char          buf[128];
+  void         *pBuf = buf;
+  ASSERT_EQ(encodeUdfShmColumn(&pBuf, &col), len);
+  SUdfShmColumn decodedCol = {0};
+  ASSERT_EQ((char *)decodeUdfShmColumn(buf, &decodedCol) - buf, len);
+  ASSERT_EQ(memcmp(&decodedCol, &col, sizeof(SUdfShmColumn)), 0);
+}
+
+TEST_F(UdfShmTest, blockRoundTrip) {
+  ASSERT_EQ(copyDataBlockToUdfShm(pBlock, &shm, &shmBlock), 0);
+  ASSERT_LE(shmBlock.len, shm.size);
+
+  SUdfShmBlock decoded = {0};
+  encodeAndDecode(&decoded);
+  SUdfDataBlock udfBlock = {0};
+  ASSERT_EQ(convertUdfShmBlockToUdfDataBlock(&decoded, &shm, &udfBlock), 0);
+  checkUdfBlock(&udfBlock);
+
+  // the int column goes back as the result, written behind the input
+  SUdfShmColumn result = {0};
+  ASSERT_EQ(copyUdfColumnToUdfShm(udfBlock.udfCols[0], &shm, decoded.len, &result), 0);
+  ASSERT_GE(result.metaOffset, decoded.len);
+  freeUdfShmDataBlock(&udfBlock);
+  taosMemoryFree(decoded.cols);
+
+  SSDataBlock output = {0};
+  ASSERT_EQ(convertUdfShmColumnToDataBlock(&result, &shm, &output), 0);
+  ASSERT_EQ(output.info.rows, TEST_ROWS);
+  SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(output.pDataBlock, 0);
+  for (int32_t i = 0; i < TEST_ROWS; ++i) {
+    ASSERT_EQ(colDataIsNull_s(pCol, i), i == NULL_ROW);
+    if (i != NULL_ROW) {
+      ASSERT_EQ(*(int32_t *)colDataGetData(pCol, i), i);
+    }
+  }
+  blockDataFreeRes(&output);
+}
+
+TEST_F(UdfShmTest, outOfRange) {
+  ASSERT_EQ(copyDataBlockToUdfShm(pBlock, &shm, &shmBlock), 0);
+  SUdfShmColumn intCol = shmBlock.cols[0];
+  SUdfShmColumn varCol = shmBlock.cols[1];
+
+  auto rejected = [&]() {
+    SUdfDataBlock udfBlock = {0};
+    int32_t       code = convertUdfShmBlockToUdfDataBlock(&shmBlock, &shm, &udfBlock);
+    freeUdfShmDataBlock(&udfBlock);
+    shmBlock.cols[0] = intCol;
+    shmBlock.cols[1] = varCol;
+    return code == TSDB_CODE_UDF_INVALID_INPUT;
+  };
+
+  shmBlock.cols[0].dataOffset = shm.size - 4;
+  ASSERT_TRUE(rejected());
+  shmBlock.cols[0].metaOffset = -8;
+  ASSERT_TRUE(rejected());
+  shmBlock.cols[0].dataLen = -1;
+  ASSERT_TRUE(rejected());
+  shmBlock.cols[0].metaLen = 0;
+  ASSERT_TRUE(rejected());
+  shmBlock.cols[1].dataOffset = INT32_MAX - 4;
+  ASSERT_TRUE(rejected());
+  shmBlock.cols[1].numOfRows = TEST_ROWS + 1;
+  ASSERT_TRUE(rejected());
+
+  // a var offset pointing behind the payload
+  int32_t *varOffsets = (int32_t *)((char *)shm.ptr + varCol.metaOffset);
+  int32_t  saved = varOffsets[0];
+  varOffsets[0] = varCol.dataLen;
+  ASSERT_TRUE(rejected());
+  varOffsets[0] = saved;
+
+  SUdfDataBlock udfBlock = {0};
+  ASSERT_EQ(convertUdfShmBlockToUdfDataBlock(&shmBlock, &shm, &udfBlock), 0);
+  freeUdfShmDataBlock(&udfBlock);
+
+  // a result column out of range is rejected by taosd as well
+  SUdfShmColumn result = intCol;
+  result.dataOffset = shm.size;
+  SSDataBlock output = {0};
+  ASSERT_NE(convertUdfShmColumnToDataBlock(&result, &shm, &output), 0);
+}
+
+TEST_F(UdfShmTest, fallbackToPipe) {
+  uv_mutex_t shmLock;
+  ASSERT_EQ(uv_mutex_init(&shmLock), 0);
+
+  // another call of the session holds the shared memory
+  uv_mutex_lock(&shmLock);
+  ASSERT_EQ(prepareUdfShmBlock(pBlock, &shm, &shmLock, &shmBlock), 0);
+  ASSERT_EQ(shmBlock.cols, nullptr);
+  uv_mutex_unlock(&shmLock);
+
+  // the block does not fit, the lock is released
+  SShm small = {.id = -1, .size = 64, .ptr = shm.ptr};
+  ASSERT_EQ(prepareUdfShmBlock(pBlock, &small, &shmLock, &shmBlock), 0);
+  ASSERT_EQ(shmBlock.cols, nullptr);
+  ASSERT_EQ(uv_mutex_trylock(&shmLock), 0);
+  uv_mutex_unlock(&shmLock);
+
+  // no shared memory for the session
+  SShm none = {.id = -1, .size = 0, .ptr = NULL};
+  ASSERT_EQ(prepareUdfShmBlock(pBlock, &none, &shmLock, &shmBlock), 0);
+
+  // the block is placed and the lock stays held until the call is done
+  ASSERT_EQ(prepareUdfShmBlock(pBlock, &shm, &shmLock, &shmBlock), 1);
+  ASSERT_NE(shmBlock.cols, nullptr);
+  ASSERT_NE(uv_mutex_trylock(&shmLock), 0);
+  uv_mutex_unlock(&shmLock);
+
+  uv_mutex_destroy(&shmLock);
+}
+
+#pragma GCC diagnostic pop
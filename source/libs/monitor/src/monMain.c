@@ -396,6 +396,9 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "req_insert_batch_success", pStat->numOfBatchInsertSuccessReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_rate", req_insert_batch_rate);
   tjsonAddDoubleToObject(pJson, "errors", pStat->errors);
+  tjsonAddDoubleToObject(pJson, "page_cache_hit", pStat->pgCacheHit);
+  tjsonAddDoubleToObject(pJson, "page_cache_miss", pStat->pgCacheMiss);
+  tjsonAddDoubleToObject(pJson, "page_cache_usage", pStat->pgCacheUsage);
   tjsonAddDoubleToObject(pJson, "vnodes_num", pStat->totalVnodes);
   tjsonAddDoubleToObject(pJson, "masters", pStat->masterNum);
   tjsonAddDoubleToObject(pJson, "has_mnode", pInfo->has_mnode);
@@ -350,6 +350,9 @@ int32_t tEncodeSVnodesStat(SEncoder *encoder, const SVnodesStat *pStat) {
   if (tEncodeI64(encoder, pStat->numOfBatchInsertReqs) < 0) return -1;
   if (tEncodeI64(encoder, pStat->numOfBatchInsertSuccessReqs) < 0) return -1;
   if (tEncodeI64(encoder, pStat->errors) < 0) return -1;
+  if (tEncodeI64(encoder, pStat->pgCacheHit) < 0) return -1;
+  if (tEncodeI64(encoder, pStat->pgCacheMiss) < 0) return -1;
+  if (tEncodeI64(encoder, pStat->pgCacheUsage) < 0) return -1;
   return 0;
 }
 
@@ -363,6 +366,9 @@ static int32_t tDecodeSVnodesStat(SDecoder *decoder, SVnodesStat *pStat) {
   if (tDecodeI64(decoder, &pStat->numOfBatchInsertReqs) < 0) return -1;
   if (tDecodeI64(decoder, &pStat->numOfBatchInsertSuccessReqs) < 0) return -1;
   if (tDecodeI64(decoder, &pStat->errors) < 0) return -1;
+  if (tDecodeI64(decoder, &pStat->pgCacheHit) < 0) return -1;
+  if (tDecodeI64(decoder, &pStat->pgCacheMiss) < 0) return -1;
+  if (tDecodeI64(decoder, &pStat->pgCacheUsage) < 0) return -1;
   return 0;
 }
 
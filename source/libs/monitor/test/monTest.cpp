@@ -174,6 +174,9 @@ void MonitorTest::GetVnodeStat(SVnodesStat *pInfo) {
   pInfo->numOfBatchInsertReqs = 11;
   pInfo->numOfBatchInsertSuccessReqs = 12;
   pInfo->errors = 4;
+  pInfo->pgCacheHit = 13;
+  pInfo->pgCacheMiss = 14;
+  pInfo->pgCacheUsage = 15;
   pInfo->totalVnodes = 5;
   pInfo->masterNum = 6;
 }
@@ -20,6 +20,7 @@
 #include "parUtil.h"
 #include "query.h"
 #include "tglobal.h"
+#include "tlrucache.h"
 #include "ttime.h"
 #include "ttypes.h"
 
@@ -49,6 +50,8 @@
     pSql += sToken.n;                         \
   } while (TK_NK_SPACE == sToken.type)
 
+#define INSERT_TMPL_KEY_LEN 1024
+
 typedef struct SInsertParseBaseContext {
   SParseContext* pComCxt;
   char*          pSql;
@@ -76,6 +79,9 @@ typedef struct SInsertParseContext {
   char               tmpTokenBuf[TSDB_MAX_BYTES_PER_ROW];
   int64_t            memElapsed;
   int64_t            parRowElapsed;
+  bool               tmplOnly;                      // resolve tables by the cached templates only
+  int32_t            tmplKeyLen;                    // each table
+  char               tmplKey[INSERT_TMPL_KEY_LEN];  // each table
 } SInsertParseContext;
 
 typedef struct SInsertParseSyntaxCxt {
@@ -1454,6 +1460,215 @@ static int32_t parseTableName(SInsertParseContext* pCxt, SToken* pTbnameToken, S
   return code;
 }
 
+/*
+ * Applications often send INSERT statements of the same shape over and over with only the values changed. The parsed
+ * table part of each "tb_name [(field1_name, ...)] VALUES" clause is kept as a template, keyed by the clause text, the
+ * user and the current db. A template holds the resolved table meta, vgroup and bound columns, so that a statement whose
+ * clauses all have templates is parsed in one pass over its values, without resolving the tables through the catalog.
+ * Templates are stamped with the catalog cache epoch and ignored once any cached meta changes.
+ */
+typedef struct SInsertTemplate {
+  int64_t            epoch;
+  SName              name;
+  char               dbFName[TSDB_DB_FNAME_LEN];
+  char               tbFName[TSDB_TABLE_FNAME_LEN];
+  SVgroupInfo        vg;
+  STableMeta*        pTableMeta;
+  bool               hasBoundCols;
+  SParsedDataColInfo boundColumnInfo;
+  int32_t            payloadSize;  // size of the data block last time, to pre-size the next one
+} SInsertTemplate;
+
+static TdThreadOnce insertTmplCacheInit = PTHREAD_ONCE_INIT;
+static SLRUCache*   insertTmplCache = NULL;
+
+static void initInsertTmplCache() {
+  insertTmplCache = taosLRUCacheInit((size_t)TMAX(tsInsertTemplateCacheSize, 1) * 1024 * 1024, -1, .5);
+  if (NULL != insertTmplCache) {
+    taosLRUCacheSetStrictCapacity(insertTmplCache, false);
+  }
+}
+
+static SLRUCache* getInsertTmplCache() {
+  taosThreadOnce(&insertTmplCacheInit, initInsertTmplCache);
+  return insertTmplCache;
+}
+
+void cleanupInsertTemplates() {
+  if (NULL != insertTmplCache) {
+    taosLRUCacheEraseUnrefEntries(insertTmplCache);
+    taosLRUCacheCleanup(insertTmplCache);
+    insertTmplCache = NULL;
+  }
+}
+
+static bool insertTmplEnabled(SInsertParseContext* pCxt) {
+  return tsInsertTemplateCacheSize > 0 && NULL == pCxt->pStmtCb;
+}
+
+static int32_t cloneBoundColumnInfo(SParsedDataColInfo* pDst, const SParsedDataColInfo* pSrc) {
+  destroyBoundColumnInfo(pDst);
+  *pDst = *pSrc;
+  pDst->boundColumns = taosMemoryMalloc(sizeof(col_id_t) * pSrc->numOfCols);
+  pDst->cols = taosMemoryMalloc(sizeof(SBoundColumn) * pSrc->numOfCols);
+  pDst->colIdxInfo = NULL;
+  if (NULL != pSrc->colIdxInfo) {
+    pDst->colIdxInfo = taosMemoryMalloc(sizeof(SBoundIdxInfo) * pSrc->numOfBound);
+  }
+  if (NULL == pDst->boundColumns || NULL == pDst->cols || (NULL != pSrc->colIdxInfo && NULL == pDst->colIdxInfo)) {
+    destroyBoundColumnInfo(pDst);
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+  memcpy(pDst->boundColumns, pSrc->boundColumns, sizeof(col_id_t) * pSrc->numOfCols);
+  memcpy(pDst->cols, pSrc->cols, sizeof(SBoundColumn) * pSrc->numOfCols);
+  if (NULL != pSrc->colIdxInfo) {
+    memcpy(pDst->colIdxInfo, pSrc->colIdxInfo, sizeof(SBoundIdxInfo) * pSrc->numOfBound);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// enough for the rows of the last time, allocateMemIfNeed() keeps room for 5 more rows
+static int32_t getTmplPayloadSize(STableDataBlocks* dataBuf) {
+  return dataBuf->size + getExtendedRowSize(dataBuf) * 6;
+}
+
+static void destroyInsertTemplate(const void* key, size_t keyLen, void* value) {
+  SInsertTemplate* pTmpl = (SInsertTemplate*)value;
+  taosMemoryFree(pTmpl->pTableMeta);
+  destroyBoundColumnInfo(&pTmpl->boundColumnInfo);
+  taosMemoryFree(pTmpl);
+}
+
+// key: "acctId.db.user|tb_name [(field1_name, ...)] "
+static void buildInsertTmplKey(SInsertParseContext* pCxt, const char* pStart, const char* pEnd) {
+  SParseContext* pComCxt = pCxt->pComCxt;
+  int32_t        len = snprintf(pCxt->tmplKey, sizeof(pCxt->tmplKey), "%d.%s.%s|", pComCxt->acctId,
+                                pComCxt->db ? pComCxt->db : "", pComCxt->pUser ? pComCxt->pUser : "");
+  pCxt->tmplKeyLen = 0;
+  if (len + (pEnd - pStart) < sizeof(pCxt->tmplKey)) {
+    memcpy(pCxt->tmplKey + len, pStart, pEnd - pStart);
+    pCxt->tmplKeyLen = len + (pEnd - pStart);
+  }
+}
+
+static int32_t parseValuesByTemplate(SInsertParseContext* pCxt, SInsertTemplate* pTmpl) {
+  CHECK_CODE(taosHashPut(pCxt->pTableNameHashObj, pTmpl->tbFName, strlen(pTmpl->tbFName), &pTmpl->name, sizeof(SName)));
+  CHECK_CODE(taosHashPut(pCxt->pDbFNameHashObj, pTmpl->dbFName, strlen(pTmpl->dbFName), pTmpl->dbFName,
+                         TSDB_DB_FNAME_LEN));
+  CHECK_CODE(taosHashPut(pCxt->pVgroupsHashObj, (const char*)&pTmpl->vg.vgId, sizeof(pTmpl->vg.vgId),
+                         (char*)&pTmpl->vg, sizeof(pTmpl->vg)));
+
+  STableMeta*       pTableMeta = pTmpl->pTableMeta;
+  int32_t           payloadSize = TMAX(atomic_load_32(&pTmpl->payloadSize), TSDB_DEFAULT_PAYLOAD_SIZE);
+  STableDataBlocks* dataBuf = NULL;
+  if (pCxt->pComCxt->async) {
+    CHECK_CODE(getDataBlockFromList(pCxt->pTableBlockHashObj, &pTableMeta->uid, sizeof(pTableMeta->uid), payloadSize,
+                                    sizeof(SSubmitBlk), getTableInfo(pTableMeta).rowSize, pTableMeta, &dataBuf, NULL,
+                                    NULL));
+  } else {
+    CHECK_CODE(getDataBlockFromList(pCxt->pTableBlockHashObj, pTmpl->tbFName, strlen(pTmpl->tbFName), payloadSize,
+                                    sizeof(SSubmitBlk), getTableInfo(pTableMeta).rowSize, pTableMeta, &dataBuf, NULL,
+                                    NULL));
+  }
+
+  if (pTmpl->hasBoundCols) {
+    CHECK_CODE(cloneBoundColumnInfo(&dataBuf->boundColumnInfo, &pTmpl->boundColumnInfo));
+  }
+
+  CHECK_CODE(parseValuesClause(pCxt, dataBuf));
+  TSDB_QUERY_SET_TYPE(pCxt->pOutput->insertType, TSDB_QUERY_TYPE_INSERT);
+  atomic_store_32(&pTmpl->payloadSize, getTmplPayloadSize(dataBuf));
+  return TSDB_CODE_SUCCESS;
+}
+
+// pSql -> [(field1_name, ...)] VALUES (field1_value, ...) ...
+static int32_t parseTableByTemplate(SInsertParseContext* pCxt, SToken* pTbnameToken, bool* pHit) {
+  *pHit = false;
+  pCxt->tmplKeyLen = 0;
+  if (!insertTmplEnabled(pCxt) || TK_NK_QUESTION == pTbnameToken->type) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char*  pSql = pCxt->pSql;
+  SToken sToken;
+  NEXT_TOKEN(pCxt->pSql, sToken);
+  if (TK_NK_LP == sToken.type) {
+    CHECK_CODE(ignoreBoundColumns(pCxt));
+    NEXT_TOKEN(pCxt->pSql, sToken);
+  }
+  if (TK_VALUES == sToken.type) {
+    buildInsertTmplKey(pCxt, pTbnameToken->z, sToken.z);
+  }
+
+  // templates are only used in the syntax phase, the other phases resolve the tables and refresh the templates
+  SLRUCache* pCache = pCxt->tmplOnly && pCxt->tmplKeyLen > 0 ? getInsertTmplCache() : NULL;
+  LRUHandle* h = NULL == pCache ? NULL : taosLRUCacheLookup(pCache, pCxt->tmplKey, pCxt->tmplKeyLen);
+  if (NULL == h) {
+    pCxt->pSql = pSql;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SInsertTemplate* pTmpl = (SInsertTemplate*)taosLRUCacheValue(pCache, h);
+  int32_t          code = TSDB_CODE_SUCCESS;
+  if (pTmpl->epoch == catalogGetCacheEpoch()) {
+    code = parseValuesByTemplate(pCxt, pTmpl);
+    *pHit = (TSDB_CODE_SUCCESS == code);
+  } else {
+    pCxt->pSql = pSql;
+  }
+  taosLRUCacheRelease(pCache, h, false);
+  return code;
+}
+
+static void saveInsertTemplate(SInsertParseContext* pCxt, SToken* pTbnameToken, STableDataBlocks* dataBuf,
+                               bool hasBoundCols) {
+  // only "tb_name [(field1_name, ...)] VALUES" clauses have the key built
+  if (0 == pCxt->tmplKeyLen) {
+    return;
+  }
+  SLRUCache* pCache = getInsertTmplCache();
+  if (NULL == pCache) {
+    return;
+  }
+
+  int32_t      vgId = dataBuf->pTableMeta->vgId;
+  SVgroupInfo* pVg = taosHashGet(pCxt->pVgroupsHashObj, &vgId, sizeof(vgId));
+  if (NULL == pVg) {
+    return;
+  }
+
+  SInsertTemplate* pTmpl = taosMemoryCalloc(1, sizeof(SInsertTemplate));
+  if (NULL == pTmpl) {
+    return;
+  }
+  pTmpl->epoch = pCxt->pComCxt->catalogEpoch;
+  pTmpl->vg = *pVg;
+  pTmpl->hasBoundCols = hasBoundCols;
+  pTmpl->payloadSize = getTmplPayloadSize(dataBuf);
+
+  int32_t code = createSName(&pTmpl->name, pTbnameToken, pCxt->pComCxt->acctId, pCxt->pComCxt->db, &pCxt->msg);
+  if (TSDB_CODE_SUCCESS == code) {
+    tNameExtractFullName(&pTmpl->name, pTmpl->tbFName);
+    tNameGetFullDbName(&pTmpl->name, pTmpl->dbFName);
+    code = cloneTableMeta(dataBuf->pTableMeta, &pTmpl->pTableMeta);
+  }
+  if (TSDB_CODE_SUCCESS == code && hasBoundCols) {
+    code = cloneBoundColumnInfo(&pTmpl->boundColumnInfo, &dataBuf->boundColumnInfo);
+  }
+  if (TSDB_CODE_SUCCESS != code) {
+    destroyInsertTemplate(NULL, 0, pTmpl);
+    return;
+  }
+
+  size_t charge = sizeof(SInsertTemplate) + TABLE_META_SIZE(pTmpl->pTableMeta) +
+                  pTmpl->boundColumnInfo.numOfCols * (sizeof(col_id_t) + sizeof(SBoundColumn));
+  LRUStatus status = taosLRUCacheInsert(pCache, pCxt->tmplKey, pCxt->tmplKeyLen, pTmpl, charge, destroyInsertTemplate,
+                                        NULL, TAOS_LRU_PRIORITY_LOW);
+  if (TAOS_LRU_STATUS_FAIL == status) {
+    destroyInsertTemplate(NULL, 0, pTmpl);
+  }
+}
+
 //   tb_name
 //       [USING stb_name [(tag1_name, ...)] TAGS (tag1_value, ...)]
 //       [(field1_name, ...)]
@@ -1504,6 +1719,17 @@ static int32_t parseInsertBody(SInsertParseContext* pCxt) {
     }
 
     SToken tbnameToken = sToken;
+
+    bool hit = false;
+    CHECK_CODE(parseTableByTemplate(pCxt, &tbnameToken, &hit));
+    if (hit) {
+      tbNum++;
+      continue;
+    }
+    if (pCxt->tmplOnly) {
+      return TSDB_CODE_FAILED;
+    }
+
     NEXT_TOKEN(pCxt->pSql, sToken);
 
     if (!pCxt->pComCxt->async || TK_USING == sToken.type) {
@@ -1561,6 +1787,7 @@ static int32_t parseInsertBody(SInsertParseContext* pCxt) {
       // pSql -> (field1_value, ...) [(field1_value2, ...) ...]
       CHECK_CODE(parseValuesClause(pCxt, dataBuf));
       TSDB_QUERY_SET_TYPE(pCxt->pOutput->insertType, TSDB_QUERY_TYPE_INSERT);
+      saveInsertTemplate(pCxt, &tbnameToken, dataBuf, NULL != pBoundColsStart);
 
       tbNum++;
       continue;
@@ -1614,7 +1841,8 @@ static int32_t parseInsertBody(SInsertParseContext* pCxt) {
 //       [(field1_name, ...)]
 //       VALUES (field1_value, ...) [(field1_value2, ...) ...] | FILE csv_file_path
 //   [...];
-int32_t parseInsertSql(SParseContext* pContext, SQuery** pQuery, SParseMetaCache* pMetaCache) {
+static int32_t parseInsertSqlImpl(SParseContext* pContext, SQuery** pQuery, SParseMetaCache* pMetaCache,
+                                  bool tmplOnly) {
   SInsertParseContext context = {
       .pComCxt = pContext,
       .pSql = (char*)pContext->pSql,
@@ -1629,7 +1857,8 @@ int32_t parseInsertSql(SParseContext* pContext, SQuery** pQuery, SParseMetaCache
       .pStmtCb = pContext->pStmtCb,
       .pMetaCache = pMetaCache,
       .memElapsed = 0,
-      .parRowElapsed = 0};
+      .parRowElapsed = 0,
+      .tmplOnly = tmplOnly};
 
   if (pContext->pStmtCb && *pQuery) {
     (*pContext->pStmtCb->getExecInfoFn)(pContext->pStmtCb->pStmt, &context.pVgroupsHashObj,
@@ -1712,6 +1941,32 @@ int32_t parseInsertSql(SParseContext* pContext, SQuery** pQuery, SParseMetaCache
   return code;
 }
 
+int32_t parseInsertSql(SParseContext* pContext, SQuery** pQuery, SParseMetaCache* pMetaCache) {
+  if (!pContext->async) {
+    pContext->catalogEpoch = catalogGetCacheEpoch();
+  }
+  return parseInsertSqlImpl(pContext, pQuery, pMetaCache, false);
+}
+
+// parse the whole statement if all of its tables have templates, then no meta is needed by the semantic phase
+static bool parseInsertSqlByTemplate(SParseContext* pContext, SQuery** pQuery) {
+  if (tsInsertTemplateCacheSize <= 0 || NULL != pContext->pStmtCb) {
+    return false;
+  }
+
+  int32_t code = parseInsertSqlImpl(pContext, pQuery, NULL, true);
+  if (TSDB_CODE_SUCCESS != code) {
+    // the statement is parsed again as usual, which reports the error if any
+    nodesDestroyNode((SNode*)*pQuery);
+    *pQuery = NULL;
+    if (pContext->msgLen > 0) {
+      pContext->pMsg[0] = '\0';
+    }
+    return false;
+  }
+  return true;
+}
+
 // pSql -> (field1_value, ...) [(field1_value2, ...) ...]
 static int32_t skipValuesClause(SInsertParseSyntaxCxt* pCxt) {
   int32_t numOfRows = 0;
@@ -1877,7 +2132,12 @@ static int32_t parseInsertBodySyntax(SInsertParseSyntaxCxt* pCxt) {
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t parseInsertSyntax(SParseContext* pContext, SQuery** pQuery, SParseMetaCache* pMetaCache) {
+int32_t parseInsertSyntax(SParseContext* pContext, SQuery** pQuery, SParseMetaCache* pMetaCache, bool useTemplate) {
+  pContext->catalogEpoch = catalogGetCacheEpoch();
+  if (useTemplate && parseInsertSqlByTemplate(pContext, pQuery)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
   SInsertParseSyntaxCxt context = {.pComCxt = pContext,
                                    .pSql = (char*)pContext->pSql,
                                    .msg = {.buf = pContext->pMsg, .len = pContext->msgLen},
@@ -2048,6 +2308,87 @@ end:
   return code;
 }
 
+// Fill the STpRows of a batch column by column. Every column of an STpRow has a fixed place in the row, so each bound
+// column is checked once and its values are copied from the application's array by a tight loop, instead of going
+// through the row builder cell by cell.
+static int32_t bindStmtColsValueByCol(STableDataBlocks* pDataBlock, TAOS_MULTI_BIND* bind, SMsgBuf* pBuf) {
+  SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
+  int32_t             extendedRowSize = getExtendedRowSize(pDataBlock);
+  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
+  SRowBuilder*        pBuilder = &pDataBlock->rowBuilder;
+  SMemParam           param = {.rb = pBuilder};
+  int32_t             rowNum = bind->num;
+  char*               pStart = pDataBlock->pData + pDataBlock->size;
+  int32_t             bitmapOffset = POINTER_DISTANCE(tdGetBitmapAddrTp((STSRow*)pStart, pBuilder->flen), pStart);
+
+  for (int32_t r = 0; r < rowNum; ++r) {
+    STSRow* row = (STSRow*)(pStart + (int64_t)extendedRowSize * r);
+    tdSRowResetBuf(pBuilder, row);
+    // the columns that are not bound are left as none
+    if (spd->numOfBound < spd->numOfCols) {
+      row->statis = 1;
+    }
+  }
+
+  for (int32_t c = 0; c < spd->numOfBound; ++c) {
+    TAOS_MULTI_BIND* pBind = bind + c;
+    SSchema*         pColSchema = &pSchema[spd->boundColumns[c]];
+    bool             isTs = (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId);
+    bool             typeMatch = (pBind->buffer_type == pColSchema->type);
+    int32_t          toffset = 0;
+    col_id_t         colIdx = 0;
+
+    if (pBind->num != rowNum) {
+      return buildInvalidOperationMsg(pBuf, "row number in each bind param should be the same");
+    }
+
+    param.schema = pColSchema;
+    getSTSRowAppendInfo(TD_ROW_TP, spd, c, &toffset, &colIdx);
+    param.toffset = toffset;
+    param.colIdx = colIdx;
+
+    const char* pVal = (const char*)pBind->buffer;
+    for (int32_t r = 0; r < rowNum; ++r, pVal += pBind->buffer_length) {
+      STSRow* row = (STSRow*)(pStart + (int64_t)extendedRowSize * r);
+      void*   pBitmap = POINTER_SHIFT(row, bitmapOffset);
+
+      if (pBind->is_null && pBind->is_null[r]) {
+        if (isTs) {
+          return buildInvalidOperationMsg(pBuf, "primary timestamp should not be NULL");
+        }
+        tdSetBitmapValType(pBitmap, colIdx - 1, TD_VTYPE_NULL, 0);
+        row->statis = 1;
+        continue;
+      }
+
+      if (!typeMatch) {
+        return buildInvalidOperationMsg(pBuf, "column type mis-match with buffer type");
+      }
+
+      if (isTs) {
+        TD_ROW_KEY(row) = *(TSKEY*)pVal;
+        checkTimestamp(pDataBlock, pVal);
+      } else if (IS_VAR_DATA_TYPE(pColSchema->type)) {
+        pBuilder->pBuf = row;
+        pBuilder->pBitmap = pBitmap;
+        CHECK_CODE(MemRowAppend(pBuf, pVal, pBind->length[r], &param));
+      } else {
+        tdSetBitmapValType(pBitmap, colIdx - 1, TD_VTYPE_NORM, 0);
+        memcpy(POINTER_SHIFT(TD_ROW_DATA(row), toffset - sizeof(TSKEY)), pVal, TYPE_BYTES[pColSchema->type]);
+      }
+    }
+  }
+
+  pDataBlock->size += extendedRowSize * rowNum;
+
+  SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
+  if (TSDB_CODE_SUCCESS != setBlockInfo(pBlocks, pDataBlock, rowNum)) {
+    return buildInvalidOperationMsg(pBuf, "too many rows in sql, total number of rows should be less than INT32_MAX");
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen) {
   STableDataBlocks*   pDataBlock = (STableDataBlocks*)pBlock;
   SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
@@ -2062,6 +2403,10 @@ int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, in
 
   CHECK_CODE(allocateMemForSize(pDataBlock, extendedRowSize * bind->num));
 
+  if (TD_IS_TP_ROW_T(pBuilder->rowType)) {
+    return bindStmtColsValueByCol(pDataBlock, bind, &pBuf);
+  }
+
   for (int32_t r = 0; r < bind->num; ++r) {
     STSRow* row = (STSRow*)(pDataBlock->pData + pDataBlock->size);  // skip the SSubmitBlk header
     tdSRowResetBuf(pBuilder, row);
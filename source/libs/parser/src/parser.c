@@ -179,7 +179,7 @@ int32_t qParseSqlSyntax(SParseContext* pCxt, SQuery** pQuery, struct SCatalogReq
   SParseMetaCache metaCache = {0};
   int32_t         code = TSDB_CODE_SUCCESS;
   if (qIsInsertValuesSql(pCxt->pSql, pCxt->sqlLen)) {
-    code = parseInsertSyntax(pCxt, pQuery, &metaCache);
+    code = parseInsertSyntax(pCxt, pQuery, &metaCache, !pCatalogReq->forceUpdate);
   } else {
     code = parseSqlSyntax(pCxt, pQuery, &metaCache);
   }
@@ -193,6 +193,11 @@ int32_t qParseSqlSyntax(SParseContext* pCxt, SQuery** pQuery, struct SCatalogReq
 
 int32_t qAnalyseSqlSemantic(SParseContext* pCxt, const struct SCatalogReq* pCatalogReq,
                             const struct SMetaData* pMetaData, SQuery* pQuery) {
+  if (NULL != pQuery->pRoot && QUERY_NODE_VNODE_MODIF_STMT == nodeType(pQuery->pRoot)) {
+    // the insert has been parsed with the cached templates in the syntax phase
+    return TSDB_CODE_SUCCESS;
+  }
+
   SParseMetaCache metaCache = {0};
   int32_t         code = putMetaDataToCache(pCatalogReq, pMetaData, &metaCache, NULL == pQuery->pRoot);
   if (TSDB_CODE_SUCCESS == code) {
@@ -227,6 +232,8 @@ int32_t qSetSTableIdForRsma(SNode* pStmt, int64_t uid) {
 
 void qCleanupKeywordsTable() { taosCleanupKeywordsTable(); }
 
+void qCleanupInsertTemplates() { cleanupInsertTemplates(); }
+
 int32_t qStmtBindParams(SQuery* pQuery, TAOS_MULTI_BIND* pParams, int32_t colIdx) {
   int32_t code = TSDB_CODE_SUCCESS;
 
@@ -84,4 +84,56 @@ TEST_F(ParserInsertTest, autoCreateTableTest) {
       "st1s2 (ts, c1, c2) USING st1 TAGS(2, 'abc', now) VALUES (now+1s, 2, 'shanghai')");
 }
 
+// counts the statements whose syntax phase is done with the insert templates, so no meta is requested
+class ParserInsertTmplTest : public ParserInsertTest {
+ public:
+  virtual void checkInsertSyntax(const SQuery* pQuery) {
+    if (nullptr != pQuery->pRoot) {
+      ++hit_;
+    } else {
+      ++miss_;
+    }
+  }
+
+  void runAndCount(const string& sql, int32_t expectHit, int32_t expectMiss) {
+    hit_ = miss_ = 0;
+    run(sql);
+    if (g_testAsyncApis) {
+      // the internal and the api async runs, after the sync runs have saved the templates
+      ASSERT_EQ(hit_, expectHit * 2);
+      ASSERT_EQ(miss_, expectMiss * 2);
+    }
+  }
+
+ private:
+  int32_t hit_ = 0;
+  int32_t miss_ = 0;
+};
+
+// the sync runs of each statement save the templates, the async runs parse it with them in the syntax phase
+TEST_F(ParserInsertTmplTest, insertTemplateTest) {
+  useDb("root", "test");
+
+  for (int32_t i = 0; i < 2; ++i) {
+    runAndCount("INSERT INTO t1 VALUES (now, 1, 'beijing', 3, 4, 5)(now+1s, 2, 'shanghai', 6, 7, 8)", 1, 0);
+
+    runAndCount("INSERT INTO t1 (ts, c2, c1) VALUES (now, 'beijing', 1)(now+1s, 'shanghai', 2)", 1, 0);
+
+    runAndCount(
+        "INSERT INTO st1s1 (ts, c1) VALUES (now, 1) st1s2 VALUES (now, 10, '131028') st1s1 VALUES (now+1s, 2, 'abc')",
+        1, 0);
+  }
+
+  // clauses with USING never have templates
+  runAndCount("INSERT INTO st1s1 USING st1 TAGS(1, 'wxy', now) VALUES (now, 1, 'beijing')", 0, 1);
+  runAndCount("INSERT INTO st1s2 VALUES (now, 10, '131028') st1s1 USING st1 TAGS(1, 'wxy', now) VALUES (now, 1, 'a')",
+              0, 1);
+
+  // templates are not used once the cache is disabled
+  int32_t cacheSize = tsInsertTemplateCacheSize;
+  tsInsertTemplateCacheSize = 0;
+  runAndCount("INSERT INTO t1 VALUES (now, 1, 'beijing', 3, 4, 5)", 0, 1);
+  tsInsertTemplateCacheSize = cacheSize;
+}
+
 }  // namespace ParserTest
@@ -281,8 +281,9 @@ class ParserTestBaseImpl {
   }
 
   void doParseInsertSyntax(SParseContext* pCxt, SQuery** pQuery, SParseMetaCache* pMetaCache) {
-    DO_WITH_THROW(parseInsertSyntax, pCxt, pQuery, pMetaCache);
+    DO_WITH_THROW(parseInsertSyntax, pCxt, pQuery, pMetaCache, true);
     ASSERT_NE(*pQuery, nullptr);
+    pBase_->checkInsertSyntax(*pQuery);
   }
 
   string toString(const SNode* pRoot) {
@@ -371,6 +372,14 @@ class ParserTestBaseImpl {
 
       SQuery* pQuery = *(query.get());
 
+      // all tables of the statement are parsed with the insert templates, no meta is needed
+      if (isInsertValues && nullptr != pQuery->pRoot) {
+        if (g_dump) {
+          dump();
+        }
+        return;
+      }
+
       unique_ptr<SCatalogReq, void (*)(SCatalogReq*)> catalogReq(new SCatalogReq(),
                                                                  MockCatalogService::destoryCatalogReq);
       doBuildCatalogReq(&cxt, metaCache.get(), catalogReq.get());
@@ -431,6 +440,9 @@ class ParserTestBaseImpl {
       unique_ptr<SQuery*, void (*)(SQuery**)> query((SQuery**)taosMemoryCalloc(1, sizeof(SQuery*)), _destroyQuery);
       doParseSqlSyntax(&cxt, query.get(), catalogReq.get());
       SQuery* pQuery = *(query.get());
+      if (qIsInsertValuesSql(cxt.pSql, cxt.sqlLen)) {
+        pBase_->checkInsertSyntax(pQuery);
+      }
 
       string err;
       thread t1([&]() {
@@ -486,4 +498,6 @@ void ParserTestBase::run(const std::string& sql, int32_t expect, ParserStage che
 
 void ParserTestBase::checkDdl(const SQuery* pQuery, ParserStage stage) { return; }
 
+void ParserTestBase::checkInsertSyntax(const SQuery* pQuery) { return; }
+
 }  // namespace ParserTest
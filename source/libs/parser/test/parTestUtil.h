@@ -42,6 +42,7 @@ class ParserTestBase : public testing::Test {
   void run(const std::string& sql, int32_t expect = TSDB_CODE_SUCCESS, ParserStage checkStage = PARSER_STAGE_TRANSLATE);
 
   virtual void checkDdl(const SQuery* pQuery, ParserStage stage);
+  virtual void checkInsertSyntax(const SQuery* pQuery);
 
  private:
   std::unique_ptr<ParserTestBaseImpl> impl_;
@@ -64,6 +65,7 @@ class ParserDdlTest : public ParserTestBase {
 };
 
 extern bool g_dump;
+extern bool g_testAsyncApis;
 
 extern void    setAsyncFlag(const char* pFlag);
 extern void    setLogLevel(const char* pLogLevel);
@@ -643,31 +643,66 @@ static bool pushDownCondOptIsPriKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond
   return false;
 }
 
-static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+// 'left.col = right.col' of the same type, which can be used as the key of hash join
+static bool pushDownCondOptIsColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (OP_TYPE_EQUAL != pOper->opType || QUERY_NODE_COLUMN != nodeType(pOper->pLeft) ||
+      QUERY_NODE_COLUMN != nodeType(pOper->pRight)) {
+    return false;
+  }
+
+  uint8_t leftType = ((SColumnNode*)pOper->pLeft)->node.resType.type;
+  uint8_t rightType = ((SColumnNode*)pOper->pRight)->node.resType.type;
+  if (leftType != rightType || TSDB_DATA_TYPE_JSON == leftType) {
+    return false;
+  }
+
+  SNodeList* pLeftCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 0))->pTargets;
+  SNodeList* pRightCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 1))->pTargets;
+  if (pushDownCondOptBelongThisTable(pOper->pLeft, pLeftCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pRightCols);
+  } else if (pushDownCondOptBelongThisTable(pOper->pLeft, pRightCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pLeftCols);
+  }
+  return false;
+}
+
+static bool pushDownCondOptContainEqualCond(SJoinLogicNode* pJoin, SNode* pCond,
+                                            bool (*isEqualCond)(SJoinLogicNode*, SNode*)) {
   if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond)) {
     SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
     if (LOGIC_COND_TYPE_AND != pLogicCond->condType) {
       return false;
     }
-    bool   hasPrimaryKeyEqualCond = false;
+    bool   hasEqualCond = false;
     SNode* pCond = NULL;
     FOREACH(pCond, pLogicCond->pParameterList) {
-      if (pushDownCondOptContainPriKeyEqualCond(pJoin, pCond)) {
-        hasPrimaryKeyEqualCond = true;
+      if (pushDownCondOptContainEqualCond(pJoin, pCond, isEqualCond)) {
+        hasEqualCond = true;
         break;
       }
     }
-    return hasPrimaryKeyEqualCond;
+    return hasEqualCond;
   } else {
-    return pushDownCondOptIsPriKeyEqualCond(pJoin, pCond);
+    return isEqualCond(pJoin, pCond);
   }
 }
 
+static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  return pushDownCondOptContainEqualCond(pJoin, pCond, pushDownCondOptIsPriKeyEqualCond);
+}
+
 static int32_t pushDownCondOptCheckJoinOnCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   if (NULL == pJoin->pOnConditions) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_NOT_SUPPORT_CROSS_JOIN);
   }
-  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+  // without the timestamp equal condition, the column equal conditions allow a hash join
+  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions) &&
+      !pushDownCondOptContainEqualCond(pJoin, pJoin->pOnConditions, pushDownCondOptIsColEqualCond)) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
   }
   return TSDB_CODE_SUCCESS;
@@ -705,6 +740,14 @@ static int32_t pushDownCondOptPartJoinOnCondLogicCond(SJoinLogicNode* pJoin, SNo
 }
 
 static int32_t pushDownCondOptPartJoinOnCond(SJoinLogicNode* pJoin, SNode** ppMergeCond, SNode** ppOnCond) {
+  // no merge condition means a hash join, which takes its keys from the on conditions
+  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+    *ppMergeCond = NULL;
+    *ppOnCond = pJoin->pOnConditions;
+    pJoin->pOnConditions = NULL;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (QUERY_NODE_LOGIC_CONDITION == nodeType(pJoin->pOnConditions) &&
       LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)(pJoin->pOnConditions))->condType) {
     return pushDownCondOptPartJoinOnCondLogicCond(pJoin, ppMergeCond, ppOnCond);
@@ -2391,6 +2434,45 @@ static int32_t tagScanOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubp
   return TSDB_CODE_SUCCESS;
 }
 
+static bool pushDownLimitOptMayBeOptimized(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_PROJECT != nodeType(pNode) || 1 != LIST_LENGTH(pNode->pChildren) ||
+      NULL == pNode->pLimit || NULL != pNode->pSlimit || NULL != pNode->pConditions) {
+    return false;
+  }
+
+  // the sort keeps 'limit + offset' rows in memory, which is bounded to the row count of a data block
+  SLimitNode* pLimit = (SLimitNode*)pNode->pLimit;
+  if (pLimit->limit <= 0 || pLimit->limit > INT32_MAX || TMAX(pLimit->offset, 0) > INT32_MAX - pLimit->limit) {
+    return false;
+  }
+
+  SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pNode->pChildren, 0);
+  return QUERY_NODE_LOGIC_PLAN_SORT == nodeType(pChild) && !((SSortLogicNode*)pChild)->groupSort &&
+         NULL == pChild->pLimit && NULL == pChild->pSlimit && NULL == pChild->pConditions;
+}
+
+// The sort only needs to output the first 'limit + offset' rows for 'order by ... limit', which allows the sort
+// operator, including the partial sorts on the vnodes after the super table split, to keep the top n rows only.
+static int32_t pushDownLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan) {
+  SLogicNode* pProject = optFindPossibleNode(pLogicSubplan->pNode, pushDownLimitOptMayBeOptimized);
+  if (NULL == pProject) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SLimitNode* pLimit = (SLimitNode*)pProject->pLimit;
+  SLimitNode* pSortLimit = (SLimitNode*)nodesMakeNode(QUERY_NODE_LIMIT);
+  if (NULL == pSortLimit) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pSortLimit->limit = pLimit->limit + TMAX(pLimit->offset, 0);
+  pSortLimit->offset = 0;
+
+  SLogicNode* pSort = (SLogicNode*)nodesListGetNode(pProject->pChildren, 0);
+  pSort->pLimit = (SNode*)pSortLimit;
+  pCxt->optimized = true;
+  return TSDB_CODE_SUCCESS;
+}
+
 // clang-format off
 static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "ScanPath",                   .optimizeFunc = scanPathOptimize},
@@ -2404,7 +2486,8 @@ static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "RewriteTail",                .optimizeFunc = rewriteTailOptimize},
   {.pName = "RewriteUnique",              .optimizeFunc = rewriteUniqueOptimize},
   {.pName = "LastRowScan",               .optimizeFunc = lastRowScanOptimize},
-  {.pName = "TagScan",                   .optimizeFunc = tagScanOptimize}
+  {.pName = "TagScan",                   .optimizeFunc = tagScanOptimize},
+  {.pName = "PushDownLimit",             .optimizeFunc = pushDownLimitOptimize}
 };
 // clang-format on
 
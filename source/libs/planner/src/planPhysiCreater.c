@@ -629,8 +629,129 @@ static int32_t createScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubplan,
   return TSDB_CODE_FAILED;
 }
 
+static bool isHashJoinKeyCond(SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  return OP_TYPE_EQUAL == pOper->opType && QUERY_NODE_COLUMN == nodeType(pOper->pLeft) &&
+         QUERY_NODE_COLUMN == nodeType(pOper->pRight) &&
+         ((SColumnNode*)pOper->pLeft)->node.resType.type == ((SColumnNode*)pOper->pRight)->node.resType.type &&
+         TSDB_DATA_TYPE_JSON != ((SColumnNode*)pOper->pLeft)->node.resType.type;
+}
+
+// The 'left.col = right.col' conditions become the keys of the hash join, and the others are kept in pOtherConds.
+static int32_t createHashJoinKeys(SPhysiPlanContext* pCxt, int16_t leftDataBlockId, int16_t rightDataBlockId,
+                                  SNode* pCond, SHashJoinPhysiNode* pJoin, SNodeList** pOtherConds) {
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond) &&
+      LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)pCond)->condType) {
+    int32_t code = TSDB_CODE_SUCCESS;
+    SNode*  pSubCond = NULL;
+    FOREACH(pSubCond, ((SLogicConditionNode*)pCond)->pParameterList) {
+      code = createHashJoinKeys(pCxt, leftDataBlockId, rightDataBlockId, pSubCond, pJoin, pOtherConds);
+      if (TSDB_CODE_SUCCESS != code) {
+        break;
+      }
+    }
+    return code;
+  }
+
+  if (isHashJoinKeyCond(pCond)) {
+    SOperatorNode* pOper = NULL;
+    int32_t        code = setNodeSlotId(pCxt, leftDataBlockId, rightDataBlockId, pCond, (SNode**)&pOper);
+    if (TSDB_CODE_SUCCESS != code) {
+      return code;
+    }
+
+    SColumnNode* pLeft = (SColumnNode*)pOper->pLeft;
+    SColumnNode* pRight = (SColumnNode*)pOper->pRight;
+    if (pLeft->dataBlockId == rightDataBlockId && pRight->dataBlockId == leftDataBlockId) {
+      TSWAP(pLeft, pRight);
+    }
+    if (pLeft->dataBlockId == leftDataBlockId && pRight->dataBlockId == rightDataBlockId) {
+      code = nodesListMakeStrictAppend(&pJoin->pOnLeft, (SNode*)pLeft);
+      if (TSDB_CODE_SUCCESS == code) {
+        code = nodesListMakeStrictAppend(&pJoin->pOnRight, (SNode*)pRight);
+      } else {
+        nodesDestroyNode((SNode*)pRight);
+      }
+      pOper->pLeft = NULL;
+      pOper->pRight = NULL;
+      nodesDestroyNode((SNode*)pOper);
+      return code;
+    }
+    nodesDestroyNode((SNode*)pOper);
+  }
+
+  return nodesListMakeStrictAppend(pOtherConds, nodesCloneNode(pCond));
+}
+
+static int32_t createHashJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                       SPhysiNode** pPhyNode) {
+  SHashJoinPhysiNode* pJoin =
+      (SHashJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  if (NULL == pJoin) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SDataBlockDescNode* pLeftDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 0))->pOutputDataBlockDesc;
+  SDataBlockDescNode* pRightDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 1))->pOutputDataBlockDesc;
+  SNodeList*          pOtherConds = NULL;
+  SNode*              pOnCond = NULL;
+
+  pJoin->joinType = pJoinLogicNode->joinType;
+  int32_t code = createHashJoinKeys(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId,
+                                    pJoinLogicNode->pOnConditions, pJoin, &pOtherConds);
+  if (TSDB_CODE_SUCCESS == code && NULL == pJoin->pOnLeft) {
+    code = TSDB_CODE_PLAN_INTERNAL_ERROR;
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesMergeConds(&pOnCond, &pOtherConds);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setListSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->node.pTargets,
+                         &pJoin->pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, pJoin->pTargets, pJoin->node.pOutputDataBlockDesc);
+  }
+
+  // the remaining on conditions are evaluated on the joined rows, like the merge join does
+  SNodeList* condCols = nodesMakeList();
+  if (TSDB_CODE_SUCCESS == code && NULL != pOnCond) {
+    code = nodesCollectColumnsFromNode(pOnCond, NULL, COLLECT_COL_TYPE_ALL, &condCols);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, condCols, pJoin->node.pOutputDataBlockDesc);
+  }
+  nodesDestroyList(condCols);
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOnCond) {
+    code = setNodeSlotId(pCxt, ((SPhysiNode*)pJoin)->pOutputDataBlockDesc->dataBlockId, -1, pOnCond,
+                         &pJoin->pOnConditions);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setConditionsSlotId(pCxt, (const SLogicNode*)pJoinLogicNode, (SPhysiNode*)pJoin);
+  }
+
+  nodesDestroyList(pOtherConds);
+  nodesDestroyNode(pOnCond);
+  if (TSDB_CODE_SUCCESS == code) {
+    *pPhyNode = (SPhysiNode*)pJoin;
+  } else {
+    nodesDestroyNode((SNode*)pJoin);
+  }
+
+  return code;
+}
+
 static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
                                    SPhysiNode** pPhyNode) {
+  if (NULL == pJoinLogicNode->pMergeCondition) {
+    return createHashJoinPhysiNode(pCxt, pChildren, pJoinLogicNode, pPhyNode);
+  }
+
   SSortMergeJoinPhysiNode* pJoin =
       (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN);
   if (NULL == pJoin) {
@@ -57,6 +57,16 @@ TEST_F(PlanJoinTest, multiJoin) {
   run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts JOIN st1s3 t3 ON t1.ts = t3.ts");
 }
 
+TEST_F(PlanJoinTest, hashJoin) {
+  useDb("root", "test");
+
+  run("SELECT t1.c1, t2.c2 FROM st1s1 t1 JOIN t1 t2 ON t1.c1 = t2.c1");
+
+  run("SELECT t1.c1, t2.c2 FROM st1 t1 JOIN st1s2 t2 ON t1.tag1 = t2.c1 AND t1.c2 = t2.c2 AND t1.ts > t2.ts");
+
+  run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts AND t1.c1 = t2.c1");
+}
+
 TEST_F(PlanJoinTest, stable) {
   useDb("root", "test");
 
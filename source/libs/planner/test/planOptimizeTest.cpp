@@ -115,4 +115,53 @@ TEST_F(PlanOptimizeTest, tagScan) {
   run("select tag1 from st1 group by tag1");
   run("select distinct tag1 from st1");
   run("select tag1*tag1 from st1 group by tag1*tag1");
-}
\ No newline at end of file
+}
+namespace {
+
+const SSortLogicNode* findSortNode(const SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_SORT == nodeType(pNode)) {
+    return (const SSortLogicNode*)pNode;
+  }
+  SNode* pChild = NULL;
+  FOREACH(pChild, pNode->pChildren) {
+    const SSortLogicNode* pSort = findSortNode((const SLogicNode*)pChild);
+    if (NULL != pSort) {
+      return pSort;
+    }
+  }
+  return NULL;
+}
+
+// -1 means the sort has no limit
+int64_t getSortLimit(const SLogicSubplan* pSubplan) {
+  const SSortLogicNode* pSort = findSortNode(pSubplan->pNode);
+  EXPECT_NE(pSort, nullptr);
+  if (NULL == pSort || NULL == pSort->node.pLimit) {
+    return -1;
+  }
+  const SLimitNode* pLimit = (const SLimitNode*)pSort->node.pLimit;
+  EXPECT_EQ(pLimit->offset, 0);
+  return pLimit->limit;
+}
+
+}  // namespace
+
+TEST_F(PlanOptimizeTest, pushDownLimit) {
+  useDb("root", "test");
+
+  int64_t expect = 0;
+  setCheckOptimizeFunc([&expect](const SLogicSubplan* pSubplan) { ASSERT_EQ(getSortLimit(pSubplan), expect); });
+
+  expect = 10;
+  run("SELECT c1 FROM t1 ORDER BY c1 DESC LIMIT 10");
+  expect = 15;
+  run("SELECT * FROM st1 ORDER BY c1 LIMIT 5 OFFSET 10");
+  expect = 5;
+  run("SELECT c1 FROM st1 PARTITION BY tag1 ORDER BY c1 LIMIT 5");
+
+  // the top n rows have to fit in a data block
+  expect = -1;
+  run("SELECT c1 FROM t1 ORDER BY c1 LIMIT 3000000000");
+  run("SELECT c1 FROM t1 ORDER BY c1 LIMIT 10 OFFSET 2147483640");
+  run("SELECT c1 FROM st1 PARTITION BY tag1 ORDER BY c1 SLIMIT 2 LIMIT 5");
+}
@@ -158,6 +158,8 @@ class PlannerTestBaseImpl {
     }
   }
 
+  void setCheckOptimizeFunc(const std::function<void(const SLogicSubplan*)>& func) { checkOptimize_ = func; }
+
   void prepare(const string& sql) {
     if (caseEnv_.numOfSkipSql_ > 0) {
       return;
@@ -386,6 +388,9 @@ class PlannerTestBaseImpl {
   void doOptimizeLogicPlan(SPlanContext* pCxt, SLogicSubplan* pLogicSubplan) {
     DO_WITH_THROW(optimizeLogicPlan, pCxt, pLogicSubplan);
     res_.optimizedLogicPlan_ = toString((SNode*)pLogicSubplan);
+    if (checkOptimize_) {
+      checkOptimize_(pLogicSubplan);
+    }
   }
 
   void doSplitLogicPlan(SPlanContext* pCxt, SLogicSubplan* pLogicSubplan) {
@@ -452,11 +457,12 @@ class PlannerTestBaseImpl {
     return str;
   }
 
-  caseEnv caseEnv_;
-  stmtEnv stmtEnv_;
-  stmtRes res_;
-  int32_t sqlNo_;
-  int32_t sqlNum_;
+  caseEnv                                   caseEnv_;
+  stmtEnv                                   stmtEnv_;
+  stmtRes                                   res_;
+  int32_t                                   sqlNo_;
+  int32_t                                   sqlNum_;
+  std::function<void(const SLogicSubplan*)> checkOptimize_;
 };
 
 PlannerTestBase::PlannerTestBase() : impl_(new PlannerTestBaseImpl()) {}
@@ -474,3 +480,7 @@ void PlannerTestBase::bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx) {
 }
 
 void PlannerTestBase::exec() { return impl_->exec(); }
+
+void PlannerTestBase::setCheckOptimizeFunc(const std::function<void(const SLogicSubplan*)>& func) {
+  impl_->setCheckOptimizeFunc(func);
+}
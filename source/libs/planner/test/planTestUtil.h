@@ -17,6 +17,7 @@
 #define PLAN_TEST_UTIL_H
 
 #include <gtest/gtest.h>
+#include <functional>
 
 #define ALLOW_FORBID_FUNC
 
@@ -36,6 +37,8 @@ class PlannerTestBase : public testing::Test {
   void prepare(const std::string& sql);
   void bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx);
   void exec();
+  // called with the optimized logic plan of each sql run afterwards
+  void setCheckOptimizeFunc(const std::function<void(const SLogicSubplan*)>& func);
 
  private:
   std::unique_ptr<PlannerTestBaseImpl> impl_;
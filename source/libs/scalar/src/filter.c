@@ -3127,6 +3127,120 @@ static FORCE_INLINE bool filterExecuteImplNotNull(void *pinfo, int32_t numOfRows
   return all;
 }
 
+#define FLT_TEST_NUM(_fn, _a, _op, _b) ((_a) _op (_b))
+#define FLT_TEST_FLT(_fn, _a, _op, _b) (_fn(&(_a), &(_b)) _op 0)
+
+// the index of the range function in gRangeCompare decides which bounds are checked and how
+#define FLT_RANGE_LOOP(_type, _test, _fn)                                                               \
+  do {                                                                                                  \
+    const _type *v = (const _type *)pData->pData;                                                       \
+    _type        lo = pMin ? *(const _type *)pMin : 0;                                                  \
+    _type        hi = pMax ? *(const _type *)pMax : 0;                                                  \
+    switch (rfunc) {                                                                                    \
+      case 0:                                                                                           \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], >, lo) & _test(_fn, v[j], <, hi);   \
+        break;                                                                                          \
+      case 1:                                                                                           \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], >, lo) & _test(_fn, v[j], <=, hi);  \
+        break;                                                                                          \
+      case 2:                                                                                           \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], >=, lo) & _test(_fn, v[j], <, hi);  \
+        break;                                                                                          \
+      case 3:                                                                                           \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], >=, lo) & _test(_fn, v[j], <=, hi); \
+        break;                                                                                          \
+      case 4:                                                                                           \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], >, lo);                         \
+        break;                                                                                          \
+      case 5:                                                                                           \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], >=, lo);                        \
+        break;                                                                                          \
+      case 6:                                                                                           \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], <, hi);                         \
+        break;                                                                                          \
+      default:                                                                                          \
+        for (int32_t j = 0; j < numOfRows; ++j) p[j] = _test(_fn, v[j], <=, hi);                        \
+        break;                                                                                          \
+    }                                                                                                   \
+  } while (0)
+
+/*
+ * Range filter over a fixed-width column with the bounds compared inline, so the loop has no per-row function call.
+ * Return false if the column type is not supported and the generic path should be used.
+ */
+static bool filterExecuteImplRangeTyped(SFilterInfo *info, int32_t numOfRows, int8_t *p, bool *all) {
+  SFilterComUnit  *cunit = &info->cunits[0];
+  SColumnInfoData *pData = cunit->colData;
+  int32_t          type = pData->info.type;
+  int8_t           rfunc = cunit->rfunc;
+  void            *pMin = cunit->valData;
+  void            *pMax = cunit->valData2;
+
+  if (IS_VAR_DATA_TYPE(type) || type != cunit->dataType || cunit->func != filterGetCompFuncIdx(type, OP_TYPE_LOWER_THAN)) {
+    return false;
+  }
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      FLT_RANGE_LOOP(int8_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      FLT_RANGE_LOOP(uint8_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      FLT_RANGE_LOOP(int16_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      FLT_RANGE_LOOP(uint16_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      FLT_RANGE_LOOP(int32_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      FLT_RANGE_LOOP(uint32_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      FLT_RANGE_LOOP(int64_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      FLT_RANGE_LOOP(uint64_t, FLT_TEST_NUM, NULL);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      FLT_RANGE_LOOP(float, FLT_TEST_FLT, compareFloatVal);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      FLT_RANGE_LOOP(double, FLT_TEST_FLT, compareDoubleVal);
+      break;
+    default:
+      return false;
+  }
+
+  // null rows never pass, walk the bitmap a word at a time
+  if (pData->hasNull && pData->nullbitmap) {
+    int32_t len = BitmapLen(numOfRows);
+    for (int32_t pos = 0; pos < len; pos += sizeof(uint64_t)) {
+      int32_t  n = TMIN(len - pos, (int32_t)sizeof(uint64_t));
+      uint64_t w = 0;
+      memcpy(&w, pData->nullbitmap + pos, n);
+      if (w == 0) continue;
+
+      for (int32_t i = pos * 8; i < (pos + n) * 8 && i < numOfRows; ++i) {
+        if (colDataIsNull_f(pData->nullbitmap, i)) p[i] = 0;
+      }
+    }
+  }
+
+  int32_t nPass = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    nPass += (p[i] != 0);
+  }
+  *all = (nPass == numOfRows);
+
+  return true;
+}
+
 bool filterExecuteImplRange(void *pinfo, int32_t numOfRows, int8_t** p, SColumnDataAgg *statis, int16_t numOfCols) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
   bool all = true;
@@ -3144,6 +3258,10 @@ bool filterExecuteImplRange(void *pinfo, int32_t numOfRows, int8_t** p, SColumnD
     *p = taosMemoryCalloc(numOfRows, sizeof(int8_t));
   }
 
+  if (filterExecuteImplRangeTyped(info, numOfRows, *p, &all)) {
+    return all;
+  }
+
   for (int32_t i = 0; i < numOfRows; ++i) {
     void *colData = colDataGetData((SColumnInfoData *)info->cunits[0].colData, i);
     SColumnInfoData* pData = info->cunits[0].colData;
@@ -1034,6 +1034,327 @@ static int32_t doConvertHelper(SScalarParam* pDest, int32_t* convert, const SSca
   return TSDB_CODE_SUCCESS;
 }
 
+// Typed kernels for two fixed-width columns of the same type, scanned in ascending order. Values are computed for
+// every row in a tight loop the compiler can vectorize, and nulls are applied afterwards from the bitmaps.
+static FORCE_INLINE bool vectorIsTypedKernelType(int32_t type) {
+  return IS_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_TIMESTAMP || type == TSDB_DATA_TYPE_BOOL;
+}
+
+// null bitmaps of the column sides, a constant side never contributes one
+static FORCE_INLINE void vectorGetNullBitmaps(const SColumnInfoData *pLeftCol, int32_t nLeft,
+                                              const SColumnInfoData *pRightCol, int32_t nRight, int32_t numOfRows,
+                                              const char **pLeftBm, const char **pRightBm) {
+  *pLeftBm = (nLeft == numOfRows && pLeftCol->hasNull) ? pLeftCol->nullbitmap : NULL;
+  *pRightBm = (nRight == numOfRows && pRightCol->hasNull) ? pRightCol->nullbitmap : NULL;
+}
+
+static FORCE_INLINE uint64_t vectorGetNullWord(const char *pLeftBm, const char *pRightBm, int32_t pos, int32_t len) {
+  uint64_t w = 0;
+  uint64_t t = 0;
+
+  if (pLeftBm) {
+    memcpy(&t, pLeftBm + pos, len);
+    w |= t;
+  }
+  if (pRightBm) {
+    t = 0;
+    memcpy(&t, pRightBm + pos, len);
+    w |= t;
+  }
+  return w;
+}
+
+// the last bitmap byte may carry bits beyond numOfRows
+static FORCE_INLINE uint8_t vectorTailNullMask(int32_t numOfRows) {
+  return (numOfRows % 8 == 0) ? 0xFF : (uint8_t)(0xFF << (8 - numOfRows % 8));
+}
+
+static void vectorMergeNullBitmap(SColumnInfoData *pOutputCol, const SColumnInfoData *pLeftCol, int32_t nLeft,
+                                  const SColumnInfoData *pRightCol, int32_t nRight, int32_t numOfRows) {
+  const char *pLeftBm = NULL;
+  const char *pRightBm = NULL;
+  int32_t     len = BitmapLen(numOfRows);
+  bool        hasNull = false;
+
+  vectorGetNullBitmaps(pLeftCol, nLeft, pRightCol, nRight, numOfRows, &pLeftBm, &pRightBm);
+  if (pLeftBm == NULL && pRightBm == NULL) {
+    return;
+  }
+
+  for (int32_t pos = 0; pos < len; pos += sizeof(uint64_t)) {
+    int32_t  n = TMIN(len - pos, (int32_t)sizeof(uint64_t));
+    uint64_t w = vectorGetNullWord(pLeftBm, pRightBm, pos, n);
+    if (pos + n == len) {
+      ((uint8_t *)&w)[n - 1] &= vectorTailNullMask(numOfRows);
+    }
+    if (w == 0) continue;
+
+    uint64_t t = 0;
+    memcpy(&t, pOutputCol->nullbitmap + pos, n);
+    t |= w;
+    memcpy(pOutputCol->nullbitmap + pos, &t, n);
+    hasNull = true;
+  }
+
+  if (hasNull) {
+    pOutputCol->hasNull = true;
+  }
+}
+
+// a comparison with null is false
+static void vectorClearNullResult(int8_t *pRes, const SColumnInfoData *pLeftCol, int32_t nLeft,
+                                  const SColumnInfoData *pRightCol, int32_t nRight, int32_t numOfRows) {
+  const char *pLeftBm = NULL;
+  const char *pRightBm = NULL;
+  int32_t     len = BitmapLen(numOfRows);
+
+  vectorGetNullBitmaps(pLeftCol, nLeft, pRightCol, nRight, numOfRows, &pLeftBm, &pRightBm);
+  if (pLeftBm == NULL && pRightBm == NULL) {
+    return;
+  }
+
+  for (int32_t pos = 0; pos < len; pos += sizeof(uint64_t)) {
+    int32_t  n = TMIN(len - pos, (int32_t)sizeof(uint64_t));
+    uint64_t w = vectorGetNullWord(pLeftBm, pRightBm, pos, n);
+    if (w == 0) continue;
+
+    for (int32_t b = 0; b < n; b++) {
+      uint8_t byte = ((uint8_t *)&w)[b];
+      for (int32_t k = 0; byte && k < 8; k++) {
+        int32_t row = (pos + b) * 8 + k;
+        if ((byte & (1u << (7u - k))) && row < numOfRows) {
+          pRes[row] = 0;
+        }
+      }
+    }
+  }
+}
+
+#define VEC_MATH_LOOP(_type, _expr)                                                      \
+  do {                                                                                   \
+    const _type *l = (const _type *)pLeftCol->pData;                                     \
+    const _type *r = (const _type *)pRightCol->pData;                                    \
+    if (nLeft == nRight) {                                                               \
+      for (int32_t j = 0; j < numOfRows; ++j) output[j] = _expr((double)l[j], (double)r[j]); \
+    } else if (nRight == 1) {                                                            \
+      double v = (double)r[0];                                                           \
+      for (int32_t j = 0; j < numOfRows; ++j) output[j] = _expr((double)l[j], v);       \
+    } else {                                                                             \
+      double v = (double)l[0];                                                           \
+      for (int32_t j = 0; j < numOfRows; ++j) output[j] = _expr(v, (double)r[j]);       \
+    }                                                                                    \
+  } while (0)
+
+#define VEC_MATH_TYPES(_expr)                                  \
+  do {                                                         \
+    switch (pLeftCol->info.type) {                             \
+      case TSDB_DATA_TYPE_TINYINT:                             \
+        VEC_MATH_LOOP(int8_t, _expr);                          \
+        break;                                                 \
+      case TSDB_DATA_TYPE_UTINYINT:                            \
+        VEC_MATH_LOOP(uint8_t, _expr);                         \
+        break;                                                 \
+      case TSDB_DATA_TYPE_SMALLINT:                            \
+        VEC_MATH_LOOP(int16_t, _expr);                         \
+        break;                                                 \
+      case TSDB_DATA_TYPE_USMALLINT:                           \
+        VEC_MATH_LOOP(uint16_t, _expr);                        \
+        break;                                                 \
+      case TSDB_DATA_TYPE_INT:                                 \
+        VEC_MATH_LOOP(int32_t, _expr);                         \
+        break;                                                 \
+      case TSDB_DATA_TYPE_UINT:                                \
+        VEC_MATH_LOOP(uint32_t, _expr);                        \
+        break;                                                 \
+      case TSDB_DATA_TYPE_BIGINT:                              \
+      case TSDB_DATA_TYPE_TIMESTAMP:                           \
+        VEC_MATH_LOOP(int64_t, _expr);                         \
+        break;                                                 \
+      case TSDB_DATA_TYPE_UBIGINT:                             \
+        VEC_MATH_LOOP(uint64_t, _expr);                        \
+        break;                                                 \
+      case TSDB_DATA_TYPE_FLOAT:                               \
+        VEC_MATH_LOOP(float, _expr);                           \
+        break;                                                 \
+      case TSDB_DATA_TYPE_DOUBLE:                              \
+        VEC_MATH_LOOP(double, _expr);                          \
+        break;                                                 \
+      default:                                                 \
+        ASSERT(0);                                             \
+        break;                                                 \
+    }                                                          \
+  } while (0)
+
+#define VEC_MATH_ADD(a, b)     ((a) + (b))
+#define VEC_MATH_SUB(a, b)     ((a) - (b))
+#define VEC_MATH_SUB_REV(a, b) (((b) - (a)) * -1)
+#define VEC_MATH_MULTI(a, b)   ((a) * (b))
+
+// result type is double, as the per-row path produces
+static bool vectorMathTypedKernel(SColumnInfoData *pLeftCol, int32_t nLeft, SColumnInfoData *pRightCol, int32_t nRight,
+                                  SColumnInfoData *pOutputCol, int32_t numOfRows, int32_t optr, int32_t _ord) {
+  int32_t type = pLeftCol->info.type;
+  double *output = (double *)pOutputCol->pData;
+
+  if (_ord != TSDB_ORDER_ASC || type != pRightCol->info.type || type == TSDB_DATA_TYPE_BOOL ||
+      !vectorIsTypedKernelType(type) || (nLeft != nRight && nLeft != 1 && nRight != 1)) {
+    return false;
+  }
+
+  // a null constant makes every row null
+  if ((nLeft != nRight && nRight == 1 && colDataIsNull_s(pRightCol, 0)) ||
+      (nLeft != nRight && nLeft == 1 && colDataIsNull_s(pLeftCol, 0))) {
+    colDataAppendNNULL(pOutputCol, 0, numOfRows);
+    return true;
+  }
+
+  switch (optr) {
+    case OP_TYPE_ADD:
+      VEC_MATH_TYPES(VEC_MATH_ADD);
+      break;
+    case OP_TYPE_SUB:
+      // keep the sign of a zero result the same as the per-row path, which negates (right - left)
+      if (nLeft != nRight && nLeft == 1) {
+        VEC_MATH_TYPES(VEC_MATH_SUB_REV);
+      } else {
+        VEC_MATH_TYPES(VEC_MATH_SUB);
+      }
+      break;
+    case OP_TYPE_MULTI:
+      VEC_MATH_TYPES(VEC_MATH_MULTI);
+      break;
+    default:
+      return false;
+  }
+
+  vectorMergeNullBitmap(pOutputCol, pLeftCol, nLeft, pRightCol, nRight, numOfRows);
+  return true;
+}
+
+#define VEC_CMP_LOOP(_type, _op)                                                           \
+  do {                                                                                     \
+    const _type *l = (const _type *)pLeftCol->pData;                                       \
+    const _type *r = (const _type *)pRightCol->pData;                                      \
+    if (nLeft == nRight) {                                                                 \
+      for (int32_t j = 0; j < numOfRows; ++j) pRes[j] = (l[j] _op r[j]);                   \
+    } else if (nRight == 1) {                                                              \
+      _type v = r[0];                                                                      \
+      for (int32_t j = 0; j < numOfRows; ++j) pRes[j] = (l[j] _op v);                      \
+    } else {                                                                               \
+      _type v = l[0];                                                                      \
+      for (int32_t j = 0; j < numOfRows; ++j) pRes[j] = (v _op r[j]);                      \
+    }                                                                                      \
+  } while (0)
+
+// float and double compare with a tolerance and order nan first, same as compareFloatVal()/compareDoubleVal()
+#define VEC_CMP_FLT_LOOP(_type, _cmpFn, _op)                                                \
+  do {                                                                                     \
+    const _type *l = (const _type *)pLeftCol->pData;                                       \
+    const _type *r = (const _type *)pRightCol->pData;                                      \
+    int32_t      li = (nLeft == numOfRows) ? 1 : 0;                                        \
+    int32_t      ri = (nRight == numOfRows) ? 1 : 0;                                       \
+    for (int32_t j = 0; j < numOfRows; ++j) pRes[j] = (_cmpFn(&l[j * li], &r[j * ri]) _op 0); \
+  } while (0)
+
+#define VEC_CMP_TYPES(_op)                                          \
+  do {                                                              \
+    switch (pLeftCol->info.type) {                                  \
+      case TSDB_DATA_TYPE_BOOL:                                     \
+      case TSDB_DATA_TYPE_TINYINT:                                  \
+        VEC_CMP_LOOP(int8_t, _op);                                  \
+        break;                                                      \
+      case TSDB_DATA_TYPE_UTINYINT:                                 \
+        VEC_CMP_LOOP(uint8_t, _op);                                 \
+        break;                                                      \
+      case TSDB_DATA_TYPE_SMALLINT:                                 \
+        VEC_CMP_LOOP(int16_t, _op);                                 \
+        break;                                                      \
+      case TSDB_DATA_TYPE_USMALLINT:                                \
+        VEC_CMP_LOOP(uint16_t, _op);                                \
+        break;                                                      \
+      case TSDB_DATA_TYPE_INT:                                      \
+        VEC_CMP_LOOP(int32_t, _op);                                 \
+        break;                                                      \
+      case TSDB_DATA_TYPE_UINT:                                     \
+        VEC_CMP_LOOP(uint32_t, _op);                                \
+        break;                                                      \
+      case TSDB_DATA_TYPE_BIGINT:                                   \
+      case TSDB_DATA_TYPE_TIMESTAMP:                                \
+        VEC_CMP_LOOP(int64_t, _op);                                 \
+        break;                                                      \
+      case TSDB_DATA_TYPE_UBIGINT:                                  \
+        VEC_CMP_LOOP(uint64_t, _op);                                \
+        break;                                                      \
+      case TSDB_DATA_TYPE_FLOAT:                                    \
+        VEC_CMP_FLT_LOOP(float, compareFloatVal, _op);              \
+        break;                                                      \
+      case TSDB_DATA_TYPE_DOUBLE:                                   \
+        VEC_CMP_FLT_LOOP(double, compareDoubleVal, _op);            \
+        break;                                                      \
+      default:                                                      \
+        ASSERT(0);                                                  \
+        break;                                                      \
+    }                                                               \
+  } while (0)
+
+static bool vectorCompareTypedKernel(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t _ord,
+                                     int32_t optr) {
+  SColumnInfoData *pLeftCol = pLeft->columnData;
+  SColumnInfoData *pRightCol = pRight->columnData;
+  int32_t          nLeft = pLeft->numOfRows;
+  int32_t          nRight = pRight->numOfRows;
+  int32_t          numOfRows = TMAX(nLeft, nRight);
+  int32_t          type = pLeftCol->info.type;
+  int8_t          *pRes = (int8_t *)pOut->columnData->pData;
+
+  if (_ord != TSDB_ORDER_ASC || type != pRightCol->info.type || !vectorIsTypedKernelType(type) ||
+      (nLeft != nRight && nLeft != 1 && nRight != 1)) {
+    return false;
+  }
+
+  switch (optr) {
+    case OP_TYPE_GREATER_THAN:
+    case OP_TYPE_GREATER_EQUAL:
+    case OP_TYPE_LOWER_THAN:
+    case OP_TYPE_LOWER_EQUAL:
+    case OP_TYPE_EQUAL:
+    case OP_TYPE_NOT_EQUAL:
+      break;
+    default:
+      return false;
+  }
+
+  if ((nLeft != nRight && nRight == 1 && colDataIsNull_s(pRightCol, 0)) ||
+      (nLeft != nRight && nLeft == 1 && colDataIsNull_s(pLeftCol, 0))) {
+    memset(pRes, 0, numOfRows);
+    return true;
+  }
+
+  switch (optr) {
+    case OP_TYPE_GREATER_THAN:
+      VEC_CMP_TYPES(>);
+      break;
+    case OP_TYPE_GREATER_EQUAL:
+      VEC_CMP_TYPES(>=);
+      break;
+    case OP_TYPE_LOWER_THAN:
+      VEC_CMP_TYPES(<);
+      break;
+    case OP_TYPE_LOWER_EQUAL:
+      VEC_CMP_TYPES(<=);
+      break;
+    case OP_TYPE_EQUAL:
+      VEC_CMP_TYPES(==);
+      break;
+    default:
+      VEC_CMP_TYPES(!=);
+      break;
+  }
+
+  vectorClearNullResult(pRes, pLeftCol, nLeft, pRightCol, nRight, numOfRows);
+  return true;
+}
+
 // TODO not correct for descending order scan
 static void vectorMathAddHelper(SColumnInfoData* pLeftCol, SColumnInfoData* pRightCol, SColumnInfoData* pOutputCol, int32_t numOfRows, int32_t step, int32_t i) {
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
@@ -1142,7 +1463,10 @@ void vectorMathAdd(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
-    if (pLeft->numOfRows == pRight->numOfRows) {
+    if (vectorMathTypedKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, pOut->numOfRows,
+                              OP_TYPE_ADD, _ord)) {
+      // done
+    } else if (pLeft->numOfRows == pRight->numOfRows) {
       for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
         if (IS_NULL){
           colDataAppendNULL(pOutputCol, i);
@@ -1241,7 +1565,10 @@ void vectorMathSub(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
-    if (pLeft->numOfRows == pRight->numOfRows) {
+    if (vectorMathTypedKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, pOut->numOfRows,
+                              OP_TYPE_SUB, _ord)) {
+      // done
+    } else if (pLeft->numOfRows == pRight->numOfRows) {
       for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
         if (IS_NULL) {
           colDataAppendNULL(pOutputCol, i);
@@ -1295,7 +1622,10 @@ void vectorMathMultiply(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
   double *output = (double *)pOutputCol->pData;
-  if (pLeft->numOfRows == pRight->numOfRows) {
+  if (vectorMathTypedKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, pOut->numOfRows,
+                            OP_TYPE_MULTI, _ord)) {
+    // done
+  } else if (pLeft->numOfRows == pRight->numOfRows) {
     for (; i < pRight->numOfRows && i >= 0; i += step, output += 1) {
       if (IS_NULL) {
         colDataAppendNULL(pOutputCol, i);
@@ -1708,6 +2038,10 @@ void vectorCompareImpl(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *
     return;
   }
 
+  if (vectorCompareTypedKernel(pLeft, pRight, pOut, _ord, optr)) {
+    return;
+  }
+
   if (pLeft->numOfRows == pRight->numOfRows) {
     VEC_COM_INNER(pLeft, i, i)
   } else if (pRight->numOfRows == 1) {
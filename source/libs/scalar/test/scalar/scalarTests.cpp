@@ -42,7 +42,9 @@
 #include "nodes.h"
 #include "tlog.h"
 #include "parUtil.h"
+#include "filter.h"
 #include "filterInt.h"
+#include "sclvector.h"
 
 #define _DEBUG_PRINT_ 0
 
@@ -3639,6 +3641,240 @@ TEST(ScalarFunctionTest, powFunction_column) {
  taosMemoryFree(pInput);
 }
 
+namespace {
+
+const int32_t scltTypedTypes[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,
+                                  TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_FLOAT,     TSDB_DATA_TYPE_DOUBLE,
+                                  TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT,
+                                  TSDB_DATA_TYPE_UBIGINT};
+
+// values are small integers, exact in every numeric type, so the typed and the generic path must agree bit for bit
+int64_t scltTypedValue(int32_t type, int32_t row, int32_t seed) {
+ int64_t v = (row * seed + 7) % 100;
+ return IS_UNSIGNED_NUMERIC_TYPE(type) ? v : v - 50;
+}
+
+void scltSetTypedValue(char *p, int32_t type, int64_t v) {
+ switch (type) {
+   case TSDB_DATA_TYPE_TINYINT: *(int8_t *)p = v; break;
+   case TSDB_DATA_TYPE_SMALLINT: *(int16_t *)p = v; break;
+   case TSDB_DATA_TYPE_INT: *(int32_t *)p = v; break;
+   case TSDB_DATA_TYPE_BIGINT: *(int64_t *)p = v; break;
+   case TSDB_DATA_TYPE_FLOAT: *(float *)p = v; break;
+   case TSDB_DATA_TYPE_DOUBLE: *(double *)p = v; break;
+   case TSDB_DATA_TYPE_UTINYINT: *(uint8_t *)p = v; break;
+   case TSDB_DATA_TYPE_USMALLINT: *(uint16_t *)p = v; break;
+   case TSDB_DATA_TYPE_UINT: *(uint32_t *)p = v; break;
+   case TSDB_DATA_TYPE_UBIGINT: *(uint64_t *)p = v; break;
+   default: ASSERT(0); break;
+ }
+}
+
+// a column of type holding the values of valueType, every row with row % nullMod == 1 is null
+SScalarParam *scltMakeTypedParam(int32_t type, int32_t valueType, int32_t rows, int32_t seed, int32_t nullMod) {
+ SScalarParam *param = (SScalarParam *)taosMemoryCalloc(1, sizeof(SScalarParam));
+ param->columnData = (SColumnInfoData *)taosMemoryCalloc(1, sizeof(SColumnInfoData));
+ param->columnData->info = createColumnInfo(0, type, tDataTypes[type].bytes);
+ param->numOfRows = rows;
+ colInfoDataEnsureCapacity(param->columnData, rows);
+
+ for (int32_t i = 0; i < rows; ++i) {
+   char buf[sizeof(int64_t)] = {0};
+   scltSetTypedValue(buf, type, scltTypedValue(valueType, i, seed));
+   colDataAppend(param->columnData, i, buf, nullMod > 0 && i % nullMod == 1);
+ }
+ return param;
+}
+
+SScalarParam *scltMakeOutputParam(int32_t type, int32_t rows) {
+ SScalarParam *param = (SScalarParam *)taosMemoryCalloc(1, sizeof(SScalarParam));
+ param->columnData = (SColumnInfoData *)taosMemoryCalloc(1, sizeof(SColumnInfoData));
+ param->columnData->info = createColumnInfo(0, type, tDataTypes[type].bytes);
+ colInfoDataEnsureCapacity(param->columnData, rows);
+ return param;
+}
+
+// the generic path is taken when the column types differ, so the same values in another type serve as reference
+int32_t scltGenericRefType(int32_t type) {
+ return (type == TSDB_DATA_TYPE_DOUBLE) ? TSDB_DATA_TYPE_BIGINT : TSDB_DATA_TYPE_DOUBLE;
+}
+
+enum { SCLT_COL_COL, SCLT_COL_CONST, SCLT_CONST_COL, SCLT_COL_NULL_CONST };
+
+void scltCheckTypedKernel(int32_t type, EOperatorType op, int32_t shape, int32_t rows) {
+ int32_t resType = (op == OP_TYPE_ADD || op == OP_TYPE_SUB || op == OP_TYPE_MULTI) ? TSDB_DATA_TYPE_DOUBLE
+                                                                                   : TSDB_DATA_TYPE_BOOL;
+ int32_t refType = scltGenericRefType(type);
+ int32_t nLeft = (shape == SCLT_CONST_COL) ? 1 : rows;
+ int32_t nRight = (shape == SCLT_COL_CONST || shape == SCLT_COL_NULL_CONST) ? 1 : rows;
+ int32_t rightNull = (shape == SCLT_COL_NULL_CONST) ? 1 : 5;
+
+ SScalarParam *left = scltMakeTypedParam(type, type, nLeft, 3, 7);
+ SScalarParam *right = scltMakeTypedParam(type, type, nRight, 11, rightNull);
+ SScalarParam *refRight = scltMakeTypedParam(refType, type, nRight, 11, rightNull);
+ if (shape == SCLT_COL_NULL_CONST) {
+   colDataAppendNULL(right->columnData, 0);
+   colDataAppendNULL(refRight->columnData, 0);
+ }
+ SScalarParam *typedOut = scltMakeOutputParam(resType, rows);
+ SScalarParam *genericOut = scltMakeOutputParam(resType, rows);
+
+ _bin_scalar_fn_t fn = getBinScalarOperatorFn(op);
+ fn(left, right, typedOut, TSDB_ORDER_ASC);
+ fn(left, refRight, genericOut, TSDB_ORDER_ASC);
+
+ ASSERT_EQ(typedOut->numOfRows, rows);
+ ASSERT_EQ(genericOut->numOfRows, rows);
+ SColumnInfoData *pTyped = typedOut->columnData;
+ SColumnInfoData *pGeneric = genericOut->columnData;
+ for (int32_t i = 0; i < rows; ++i) {
+   if (resType == TSDB_DATA_TYPE_DOUBLE) {
+     ASSERT_EQ(colDataIsNull_s(pTyped, i), colDataIsNull_s(pGeneric, i)) << "type " << type << " op " << op << " row " << i;
+     if (!colDataIsNull_s(pTyped, i)) {
+       ASSERT_EQ(((double *)pTyped->pData)[i], ((double *)pGeneric->pData)[i]) << "type " << type << " op " << op << " row " << i;
+     }
+   } else {
+     ASSERT_EQ(((int8_t *)pTyped->pData)[i], ((int8_t *)pGeneric->pData)[i]) << "type " << type << " op " << op << " row " << i;
+   }
+ }
+
+ scltDestroyDataBlock(left);
+ scltDestroyDataBlock(right);
+ scltDestroyDataBlock(refRight);
+ scltDestroyDataBlock(typedOut);
+ scltDestroyDataBlock(genericOut);
+}
+
+}  // namespace
+
+TEST(typedKernelTest, math_same_type_vs_mixed_type) {
+ EOperatorType ops[] = {OP_TYPE_ADD, OP_TYPE_SUB, OP_TYPE_MULTI};
+ int32_t       shapes[] = {SCLT_COL_COL, SCLT_COL_CONST, SCLT_CONST_COL, SCLT_COL_NULL_CONST};
+ for (int32_t type : scltTypedTypes) {
+   for (EOperatorType op : ops) {
+     for (int32_t shape : shapes) {
+       // 37 rows leave a partial byte at the end of the null bitmaps
+       scltCheckTypedKernel(type, op, shape, 37);
+       scltCheckTypedKernel(type, op, shape, 200);
+     }
+   }
+ }
+}
+
+TEST(typedKernelTest, compare_same_type_vs_mixed_type) {
+ EOperatorType ops[] = {OP_TYPE_GREATER_THAN, OP_TYPE_GREATER_EQUAL, OP_TYPE_LOWER_THAN,
+                        OP_TYPE_LOWER_EQUAL,  OP_TYPE_EQUAL,         OP_TYPE_NOT_EQUAL};
+ int32_t       shapes[] = {SCLT_COL_COL, SCLT_COL_CONST, SCLT_CONST_COL, SCLT_COL_NULL_CONST};
+ for (int32_t type : scltTypedTypes) {
+   for (EOperatorType op : ops) {
+     for (int32_t shape : shapes) {
+       scltCheckTypedKernel(type, op, shape, 37);
+       scltCheckTypedKernel(type, op, shape, 200);
+     }
+   }
+ }
+}
+
+namespace {
+
+SNode *scltMakeBoundNode(int32_t type, double v) {
+ SNode *pNode = NULL;
+ char   buf[sizeof(int64_t)] = {0};
+ if (type == TSDB_DATA_TYPE_DOUBLE) {
+   *(double *)buf = v;
+ } else {
+   scltSetTypedValue(buf, type, (int64_t)v);
+ }
+ scltMakeValueNode(&pNode, type, buf);
+ return pNode;
+}
+
+const int32_t SCLT_NO_BOUND = 0;
+
+// the range filter lo < col < hi, with either bound left out when its operator is SCLT_NO_BOUND
+void scltCheckRangeFilter(int32_t type, int32_t boundType, int32_t loOp, double lo, int32_t hiOp, double hi) {
+ const int32_t rows = 45;
+ int32_t       bytes = tDataTypes[type].bytes;
+ char         *values = (char *)taosMemoryCalloc(rows, bytes);
+ for (int32_t i = 0; i < rows; ++i) {
+   scltSetTypedValue(values + i * bytes, type, scltTypedValue(type, i, 13));
+ }
+
+ SSDataBlock *src = NULL;
+ SNode       *pCol = NULL;
+ scltMakeColumnNode(&pCol, &src, type, bytes, rows, values);
+ SColumnInfoData *pData = (SColumnInfoData *)taosArrayGetLast(src->pDataBlock);
+ for (int32_t i = 0; i < rows; i += 6) {
+   colDataAppendNULL(pData, i);
+ }
+
+ SNode  *conds[2] = {0};
+ int32_t nCond = 0;
+ if (loOp != SCLT_NO_BOUND) {
+   scltMakeOpNode(&conds[nCond++], (EOperatorType)loOp, TSDB_DATA_TYPE_BOOL, nodesCloneNode(pCol), scltMakeBoundNode(boundType, lo));
+ }
+ if (hiOp != SCLT_NO_BOUND) {
+   scltMakeOpNode(&conds[nCond++], (EOperatorType)hiOp, TSDB_DATA_TYPE_BOOL, nodesCloneNode(pCol), scltMakeBoundNode(boundType, hi));
+ }
+ SNode *pCond = conds[0];
+ if (nCond == 2) {
+   scltMakeLogicNode(&pCond, LOGIC_COND_TYPE_AND, conds, nCond);
+ }
+
+ SFilterInfo *filter = NULL;
+ ASSERT_EQ(filterInitFromNode(pCond, &filter, 0), 0);
+ SFilterColumnParam param = {(int32_t)taosArrayGetSize(src->pDataBlock), src->pDataBlock};
+ ASSERT_EQ(filterSetDataFromSlotId(filter, &param), 0);
+ // a single range unit, run by filterExecuteImplRange
+ ASSERT_EQ(filter->unitNum, 1);
+ ASSERT_GE(filter->cunits[0].rfunc, 0);
+
+ int8_t *typedRes = NULL;
+ bool    typedAll = filterExecute(filter, src, &typedRes, NULL, (int16_t)taosArrayGetSize(src->pDataBlock));
+
+ // a unit type other than the column type sends the range filter to the per-row path
+ uint8_t dataType = filter->cunits[0].dataType;
+ filter->cunits[0].dataType = TSDB_DATA_TYPE_NULL;
+ int8_t *genericRes = NULL;
+ bool    genericAll = filterExecute(filter, src, &genericRes, NULL, (int16_t)taosArrayGetSize(src->pDataBlock));
+ filter->cunits[0].dataType = dataType;
+
+ ASSERT_EQ(typedAll, genericAll);
+ for (int32_t i = 0; i < rows; ++i) {
+   ASSERT_EQ(typedRes[i] != 0, genericRes[i] != 0) << "type " << type << " row " << i;
+   if (i % 6 == 0) {
+     ASSERT_EQ(typedRes[i], 0);
+   }
+ }
+
+ taosMemoryFree(typedRes);
+ taosMemoryFree(genericRes);
+ taosMemoryFree(values);
+ filterFreeInfo(filter);
+ nodesDestroyNode(pCond);
+ nodesDestroyNode(pCol);
+ blockDataDestroy(src);
+}
+
+}  // namespace
+
+TEST(typedKernelTest, range_filter_typed_vs_generic) {
+ int32_t loOps[] = {OP_TYPE_GREATER_THAN, OP_TYPE_GREATER_EQUAL, SCLT_NO_BOUND};
+ int32_t hiOps[] = {OP_TYPE_LOWER_THAN, OP_TYPE_LOWER_EQUAL, SCLT_NO_BOUND};
+ for (int32_t type : scltTypedTypes) {
+   double lo = IS_UNSIGNED_NUMERIC_TYPE(type) ? 20 : -20;
+   double hi = IS_UNSIGNED_NUMERIC_TYPE(type) ? 70 : 20;
+   for (int32_t loOp : loOps) {
+     for (int32_t hiOp : hiOps) {
+       if (loOp == SCLT_NO_BOUND && hiOp == SCLT_NO_BOUND) continue;
+       scltCheckRangeFilter(type, type, loOp, lo, hiOp, hi);
+       // bounds of another type are converted to the column type first
+       scltCheckRangeFilter(type, TSDB_DATA_TYPE_DOUBLE, loOp, lo + 0.5, hiOp, hi + 0.5);
+     }
+   }
+ }
+}
+
 int main(int argc, char** argv) {
  taosSeedRand(taosGetTimestampSec());
  testing::InitGoogleTest(&argc, argv);
@@ -60,6 +60,19 @@ typedef struct SSyncSnapshotReceiver  SSyncSnapshotReceiver;
 
 extern bool gRaftDetailLog;
 
+// AppendEntries sent to one peer and not replied yet, in sending order
+typedef struct SSyncInflight {
+  SRaftId   destId;
+  int32_t   head;
+  int32_t   num;
+  int32_t   entries;
+  int64_t   bytes;
+  SyncIndex lastIndex[SYNC_PIPELINE_MAX_MSGS];
+  int32_t   count[SYNC_PIPELINE_MAX_MSGS];
+  int32_t   size[SYNC_PIPELINE_MAX_MSGS];
+  int64_t   sendTime[SYNC_PIPELINE_MAX_MSGS];
+} SSyncInflight;
+
 typedef struct SSyncNode {
   // init by SSyncInfo
   SyncGroupId vgId;
@@ -105,6 +118,15 @@ typedef struct SSyncNode {
   SSyncIndexMgr* pNextIndex;
   SSyncIndexMgr* pMatchIndex;
 
+  // replication pipeline
+  int32_t       pipelineEntries;
+  int32_t       pipelineBytes;
+  SSyncInflight inflights[TSDB_MAX_REPLICA];
+
+  // log entry cache
+  int32_t       logCacheEntries;
+  int64_t       logCacheBytes;
+
   // tla+ log vars
   SSyncLogStore* pLogStore;
   SyncIndex      commitIndex;
@@ -109,6 +109,25 @@ void   raftEntryCachePrint2(char* s, SRaftEntryCache* pObj);
 void   raftEntryCacheLog(SRaftEntryCache* pObj);
 void   raftEntryCacheLog2(char* s, SRaftEntryCache* pObj);
 
+//-----------------------------------
+// ring of the latest contiguous entries [beginIndex, endIndex), slot = index % capacity
+typedef struct SRaftEntryRing {
+  SSyncRaftEntry** entries;
+  int32_t          capacity;
+  int64_t          bytes;
+  int64_t          maxBytes;
+  SyncIndex        beginIndex;
+  SyncIndex        endIndex;
+  TdThreadMutex    mutex;
+  SSyncNode*       pSyncNode;
+} SRaftEntryRing;
+
+SRaftEntryRing* raftEntryRingCreate(SSyncNode* pSyncNode, int32_t capacity, int64_t maxBytes);
+void            raftEntryRingDestroy(SRaftEntryRing* pRing);
+int32_t         raftEntryRingAppend(SRaftEntryRing* pRing, const SSyncRaftEntry* pEntry);
+int32_t         raftEntryRingGetEntry(SRaftEntryRing* pRing, SyncIndex index, SSyncRaftEntry** ppEntry);
+void            raftEntryRingTruncate(SRaftEntryRing* pRing, SyncIndex fromIndex);
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,6 +35,9 @@ typedef struct SSyncLogStoreData {
   TdThreadMutex mutex;
   SWalReader*   pWalHandle;
 
+  // the latest entries written, replication and commit read them without touching wal
+  SRaftEntryRing* pEntryRing;
+
   // SyncIndex       beginIndex;  // valid begin index, default 0, may be set beginIndex > 0
 } SSyncLogStoreData;
 
@@ -57,6 +57,13 @@ int32_t syncNodeAppendEntriesPeersSnapshot2(SSyncNode* pSyncNode);
 
 int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex);
 
+SSyncInflight* syncNodeGetInflight(SSyncNode* pSyncNode, const SRaftId* pDestId);
+void           syncInflightReset(SSyncInflight* pInflight);
+void           syncInflightAck(SSyncInflight* pInflight, SyncIndex matchIndex);
+void           syncInflightPush(SSyncInflight* pInflight, SyncIndex lastIndex, int32_t count, int32_t size,
+                                int64_t sendTime);
+bool           syncInflightReject(SSyncInflight* pInflight, SyncIndex lastSendIndex, SyncIndex* pFirstIndex);
+
 int32_t syncNodeReplicate(SSyncNode* pSyncNode, bool isTimer);
 int32_t syncNodeAppendEntries(SSyncNode* pSyncNode, const SRaftId* destRaftId, const SyncAppendEntries* pMsg);
 int32_t syncNodeAppendEntriesBatch(SSyncNode* pSyncNode, const SRaftId* destRaftId, const SyncAppendEntriesBatch* pMsg);
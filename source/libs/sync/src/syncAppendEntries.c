@@ -504,6 +504,48 @@ static bool syncNodeOnAppendEntriesLogOK(SSyncNode* pSyncNode, SyncAppendEntries
   return false;
 }
 
+// Append the entries of a batch after prevLogIndex. With a pipelined leader a batch may be sent more than once, so the
+// entries already in log with the same term are kept, and the log is only truncated from the first entry in conflict.
+static int32_t syncNodeAppendEntriesBatchToLog(SSyncNode* ths, SyncAppendEntriesBatch* pMsg) {
+  int32_t            code = 0;
+  SOffsetAndContLen* metaTableArr = syncAppendEntriesBatchMetaTableArray(pMsg);
+  SyncIndex          myLastIndex = ths->pLogStore->syncLogLastIndex(ths->pLogStore);
+
+  for (int32_t i = 0; i < pMsg->dataCount; ++i) {
+    SSyncRaftEntry* pAppendEntry = (SSyncRaftEntry*)(pMsg->data + metaTableArr[i].offset);
+
+    if (pAppendEntry->index <= myLastIndex) {
+      SSyncRaftEntry* pMyEntry = NULL;
+      code = ths->pLogStore->syncLogGetEntry(ths->pLogStore, pAppendEntry->index, &pMyEntry);
+      if (code != 0) {
+        // already in snapshot
+        continue;
+      }
+
+      bool same = pMyEntry->term == pAppendEntry->term;
+      syncEntryDestory(pMyEntry);
+      if (same) {
+        continue;
+      }
+
+      // make log same, rollback deleted entries
+      int32_t pass = syncNodeDoMakeLogSame(ths, pAppendEntry->index);
+      ASSERT(pass >= 0);
+      myLastIndex = pAppendEntry->index - 1;
+    }
+
+    code = ths->pLogStore->syncLogAppendEntry(ths->pLogStore, pAppendEntry);
+    if (code != 0) {
+      return -1;
+    }
+
+    code = syncNodePreCommit(ths, pAppendEntry, 0);
+    ASSERT(code == 0);
+  }
+
+  return 0;
+}
+
 int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatch* pMsg) {
   int32_t ret = 0;
   int32_t code = 0;
@@ -554,39 +596,14 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
     if (condition) {
       syncLogRecvAppendEntriesBatch(ths, pMsg, "fake match");
 
-      SyncIndex          matchIndex = ths->commitIndex;
-      bool               hasAppendEntries = pMsg->dataLen > 0;
-      SOffsetAndContLen* metaTableArr = syncAppendEntriesBatchMetaTableArray(pMsg);
-
-      if (hasAppendEntries && pMsg->prevLogIndex == ths->commitIndex) {
-        int32_t   pass = 0;
-        SyncIndex logLastIndex = ths->pLogStore->syncLogLastIndex(ths->pLogStore);
-        bool      hasExtraEntries = logLastIndex > pMsg->prevLogIndex;
-
-        // make log same
-        if (hasExtraEntries) {
-          // make log same, rollback deleted entries
-          pass = syncNodeDoMakeLogSame(ths, pMsg->prevLogIndex + 1);
-          ASSERT(pass >= 0);
-        }
-
-        // append entry batch
-        if (pass == 0) {
-          // assert! no batch
-          ASSERT(pMsg->dataCount <= 1);
-
-          for (int32_t i = 0; i < pMsg->dataCount; ++i) {
-            SSyncRaftEntry* pAppendEntry = (SSyncRaftEntry*)(pMsg->data + metaTableArr[i].offset);
-            code = ths->pLogStore->syncLogAppendEntry(ths->pLogStore, pAppendEntry);
-            if (code != 0) {
-              return -1;
-            }
-
-            code = syncNodePreCommit(ths, pAppendEntry, 0);
-            ASSERT(code == 0);
+      SyncIndex matchIndex = ths->commitIndex;
+      bool      hasAppendEntries = pMsg->dataLen > 0;
 
-            // syncEntryDestory(pAppendEntry);
-          }
+      // the entries up to my commit index are the same with the leader's, append the ones after it
+      if (hasAppendEntries && pMsg->prevLogIndex + pMsg->dataCount > ths->commitIndex) {
+        code = syncNodeAppendEntriesBatchToLog(ths, pMsg);
+        if (code != 0) {
+          return -1;
         }
 
         // fsync once
@@ -607,6 +624,7 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->success = true;
       pReply->matchIndex = matchIndex;
       pReply->startTime = ths->startTime;
+      pReply->lastSendIndex = pMsg->prevLogIndex + pMsg->dataCount;
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -656,6 +674,7 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->success = false;
       pReply->matchIndex = ths->commitIndex;
       pReply->startTime = ths->startTime;
+      pReply->lastSendIndex = pMsg->prevLogIndex + pMsg->dataCount;
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -681,43 +700,16 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
   do {
     bool condition = (pMsg->term == ths->pRaftStore->currentTerm) && (ths->state == TAOS_SYNC_STATE_FOLLOWER) && logOK;
     if (condition) {
-      // has extra entries (> preIndex) in local log
-      SyncIndex myLastIndex = syncNodeGetLastIndex(ths);
-      bool      hasExtraEntries = myLastIndex > pMsg->prevLogIndex;
-
       // has entries in SyncAppendEntries msg
-      bool               hasAppendEntries = pMsg->dataLen > 0;
-      SOffsetAndContLen* metaTableArr = syncAppendEntriesBatchMetaTableArray(pMsg);
+      bool hasAppendEntries = pMsg->dataLen > 0;
 
       syncLogRecvAppendEntriesBatch(ths, pMsg, "really match");
 
-      int32_t pass = 0;
-
-      if (hasExtraEntries) {
-        // make log same, rollback deleted entries
-        pass = syncNodeDoMakeLogSame(ths, pMsg->prevLogIndex + 1);
-        ASSERT(pass >= 0);
-      }
-
       if (hasAppendEntries) {
         // append entry batch
-        if (pass == 0) {
-          // assert! no batch
-          ASSERT(pMsg->dataCount <= 1);
-
-          // append entry batch
-          for (int32_t i = 0; i < pMsg->dataCount; ++i) {
-            SSyncRaftEntry* pAppendEntry = (SSyncRaftEntry*)(pMsg->data + metaTableArr[i].offset);
-            code = ths->pLogStore->syncLogAppendEntry(ths->pLogStore, pAppendEntry);
-            if (code != 0) {
-              return -1;
-            }
-
-            code = syncNodePreCommit(ths, pAppendEntry, 0);
-            ASSERT(code == 0);
-
-            // syncEntryDestory(pAppendEntry);
-          }
+        code = syncNodeAppendEntriesBatchToLog(ths, pMsg);
+        if (code != 0) {
+          return -1;
         }
 
         // fsync once
@@ -735,6 +727,10 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->success = true;
       pReply->matchIndex = hasAppendEntries ? pMsg->prevLogIndex + pMsg->dataCount : pMsg->prevLogIndex;
       pReply->startTime = ths->startTime;
+      pReply->lastSendIndex = pMsg->prevLogIndex + pMsg->dataCount;
+
+      // the entries after it may be kept from an old term, they are not known to match the leader's
+      SyncIndex matchIndex = pReply->matchIndex;
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -747,7 +743,7 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
 
       // maybe update commit index, leader notice me
       if (pMsg->commitIndex > ths->commitIndex) {
-        SyncIndex lastIndex = ths->pLogStore->syncLogLastIndex(ths->pLogStore);
+        SyncIndex lastIndex = matchIndex;
 
         SyncIndex beginIndex = 0;
         SyncIndex endIndex = -1;
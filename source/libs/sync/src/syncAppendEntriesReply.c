@@ -20,6 +20,7 @@
 #include "syncRaftCfg.h"
 #include "syncRaftLog.h"
 #include "syncRaftStore.h"
+#include "syncReplication.h"
 #include "syncSnapshot.h"
 #include "syncUtil.h"
 #include "syncVoteMgr.h"
@@ -185,6 +186,15 @@ int32_t syncNodeOnAppendEntriesReplySnapshot2Cb(SSyncNode* ths, SyncAppendEntrie
     SyncIndex newNextIndex = pMsg->matchIndex + 1;
     SyncIndex newMatchIndex = pMsg->matchIndex;
 
+    // the replies of the earlier messages in the pipeline do not move the indexes back
+    syncInflightAck(syncNodeGetInflight(ths, &(pMsg->srcId)), pMsg->matchIndex);
+    if (newNextIndex < beforeNextIndex) {
+      newNextIndex = beforeNextIndex;
+    }
+    if (newMatchIndex < beforeMatchIndex) {
+      newMatchIndex = beforeMatchIndex;
+    }
+
     bool needStartSnapshot = false;
     if (newMatchIndex >= SYNC_INDEX_BEGIN && !ths->pLogStore->syncLogExist(ths->pLogStore, newMatchIndex)) {
       needStartSnapshot = true;
@@ -227,7 +237,21 @@ int32_t syncNodeOnAppendEntriesReplySnapshot2Cb(SSyncNode* ths, SyncAppendEntrie
     } while (0);
 
   } else {
-    SyncIndex nextIndex = syncIndexMgrGetIndex(ths->pNextIndex, &(pMsg->srcId));
+    SyncIndex      nextIndex = syncIndexMgrGetIndex(ths->pNextIndex, &(pMsg->srcId));
+    SSyncInflight* pInflight = syncNodeGetInflight(ths, &(pMsg->srcId));
+    SyncIndex      firstIndex = SYNC_INDEX_INVALID;
+
+    if (pMsg->bytes < sizeof(SyncAppendEntriesReply)) {
+      // the reply does not tell which message it answers
+      syncInflightReset(pInflight);
+    } else if (syncInflightReject(pInflight, pMsg->lastSendIndex, &firstIndex)) {
+      // next-index was advanced past the messages in flight, step back from the rejected one only
+      nextIndex = firstIndex;
+    } else if (pInflight != NULL && (pInflight->num > 0 || pMsg->lastSendIndex != nextIndex - 1)) {
+      // the message was acked or dropped from the window by an earlier reject
+      syncLogRecvAppendEntriesReply(ths, pMsg, "drop reject out of window");
+      return 0;
+    }
 
     if (nextIndex > SYNC_INDEX_BEGIN) {
       --nextIndex;
@@ -806,10 +806,6 @@ int32_t syncNodeProposeBatch(SSyncNode* pSyncNode, SRpcMsg** pMsgPArr, bool* pIs
   SyncClientRequestBatch* pSyncMsg = syncClientRequestBatchBuild(pMsgPArr, raftArr, arrSize, pSyncNode->vgId);
   ASSERT(pSyncMsg != NULL);
 
-  SRpcMsg rpcMsg;
-  syncClientRequestBatch2RpcMsg(pSyncMsg, &rpcMsg);
-  taosMemoryFree(pSyncMsg);  // only free msg body, do not free rpc msg content
-
   if (pSyncNode->replicaNum == 1 && pSyncNode->vgId != 1) {
     int32_t code = syncNodeOnClientRequestBatchCb(pSyncNode, pSyncMsg);
     if (code == 0) {
@@ -821,22 +817,32 @@ int32_t syncNodeProposeBatch(SSyncNode* pSyncNode, SRpcMsg** pMsgPArr, bool* pIs
         syncRespMgrDel(pSyncNode->pSyncRespMgr, raftArr[i].seqNum);
       }
 
-      rpcFreeCont(rpcMsg.pCont);
+      syncClientRequestBatchDestroy(pSyncMsg);  // the msg contents are still the caller's
       terrno = 0;
       return 1;
 
     } else {
+      syncClientRequestBatchDestroy(pSyncMsg);
       terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
       return -1;
     }
 
   } else {
+    SRpcMsg rpcMsg;
+    syncClientRequestBatch2RpcMsg(pSyncMsg, &rpcMsg);
+    syncClientRequestBatchDestroy(pSyncMsg);
+
     if (pSyncNode->FpEqMsg != NULL && (*pSyncNode->FpEqMsg)(pSyncNode->msgcb, &rpcMsg) == 0) {
-      // enqueue msg ok
+      // enqueue msg ok, the queued batch owns the msg contents and frees them once processed
+      for (int i = 0; i < arrSize; ++i) {
+        pMsgPArr[i]->pCont = NULL;
+        pMsgPArr[i]->contLen = 0;
+      }
       return 0;
 
     } else {
       sError("vgId:%d, enqueue msg error, FpEqMsg is NULL", pSyncNode->vgId);
+      rpcFreeCont(rpcMsg.pCont);
       terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
       return -1;
     }
@@ -985,6 +991,10 @@ SSyncNode* syncNodeOpen(const SSyncInfo* pOldSyncInfo) {
   pSyncNode->msgcb = pSyncInfo->msgcb;
   pSyncNode->FpSendMsg = pSyncInfo->FpSendMsg;
   pSyncNode->FpEqMsg = pSyncInfo->FpEqMsg;
+  pSyncNode->pipelineEntries = pSyncInfo->pipelineEntries > 0 ? pSyncInfo->pipelineEntries : SYNC_PIPELINE_ENTRIES;
+  pSyncNode->pipelineBytes = pSyncInfo->pipelineBytes > 0 ? pSyncInfo->pipelineBytes : SYNC_PIPELINE_BYTES;
+  pSyncNode->logCacheEntries = pSyncInfo->logCacheEntries;
+  pSyncNode->logCacheBytes = pSyncInfo->logCacheBytes;
 
   // init raft config
   pSyncNode->pRaftCfg = raftCfgOpen(pSyncNode->configPath);
@@ -2170,6 +2180,11 @@ void syncNodeBecomeLeader(SSyncNode* pSyncNode, const char* debugStr) {
     pSyncNode->pMatchIndex->index[i] = SYNC_INDEX_INVALID;
   }
 
+  // nothing in flight
+  for (int i = 0; i < TSDB_MAX_REPLICA; ++i) {
+    syncInflightReset(&(pSyncNode->inflights[i]));
+  }
+
   // update sender private term
   SSyncSnapshotSender* pMySender = syncNodeGetSnapshotSender(pSyncNode, &(pSyncNode->myRaftId));
   if (pMySender != NULL) {
@@ -2704,6 +2719,9 @@ int32_t syncNodeOnClientRequestBatchCb(SSyncNode* ths, SyncClientRequestBatch* p
   int32_t    rpcArrayLen = sizeof(SRpcMsg) * pMsg->dataCount;
   SRaftMeta* raftMetaArr = (SRaftMeta*)(pMsg->data);
   SRpcMsg*   msgArr = (SRpcMsg*)((char*)(pMsg->data) + raftMetaArrayLen);
+
+  SSyncRaftEntry** entryArr = taosMemoryCalloc(pMsg->dataCount, sizeof(SSyncRaftEntry*));
+  ASSERT(entryArr != NULL);
   for (int32_t i = 0; i < pMsg->dataCount; ++i) {
     SSyncRaftEntry* pEntry = syncEntryBuild(msgArr[i].contLen);
     ASSERT(pEntry != NULL);
@@ -2712,20 +2730,26 @@ int32_t syncNodeOnClientRequestBatchCb(SSyncNode* ths, SyncClientRequestBatch* p
     pEntry->seqNum = raftMetaArr[i].seqNum;
     pEntry->isWeak = raftMetaArr[i].isWeak;
     pEntry->term = term;
-    pEntry->index = index;
+    pEntry->index = index + i;
     memcpy(pEntry->data, msgArr[i].pCont, msgArr[i].contLen);
     ASSERT(msgArr[i].contLen == pEntry->dataLen);
+    entryArr[i] = pEntry;
+  }
 
-    code = ths->pLogStore->syncLogAppendEntry(ths->pLogStore, pEntry);
-    if (code != 0) {
-      // del resp mgr, call FpCommitCb
-      ASSERT(0);
-      return -1;
-    }
+  // group commit, the whole batch goes to wal with one vectored write
+  code = ths->pLogStore->syncLogAppendEntryBatch(ths->pLogStore, entryArr, pMsg->dataCount);
+  if (code != 0) {
+    // del resp mgr, call FpCommitCb
+    ASSERT(0);
+    return -1;
+  }
 
+  for (int32_t i = 0; i < pMsg->dataCount; ++i) {
     // update rpc msg conn apply.index
-    msgArr[i].info.conn.applyIndex = pEntry->index;
+    msgArr[i].info.conn.applyIndex = entryArr[i]->index;
+    syncEntryDestory(entryArr[i]);
   }
+  taosMemoryFree(entryArr);
 
   // fsync once
   SSyncLogStoreData* pData = ths->pLogStore->data;
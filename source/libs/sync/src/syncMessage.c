@@ -963,6 +963,7 @@ void syncClientRequestLog2(char* s, const SyncClientRequest* pMsg) {
 // block2: SRaftMeta array
 // block3: rpc msg array (with pCont)
 
+// the batch refers to the msg contents of rpcMsgPArr, they move to the batch only when it is enqueued
 SyncClientRequestBatch* syncClientRequestBatchBuild(SRpcMsg** rpcMsgPArr, SRaftMeta* raftArr, int32_t arrSize,
                                                     int32_t vgId) {
   ASSERT(rpcMsgPArr != NULL);
@@ -1874,8 +1875,9 @@ char* syncAppendEntriesReplySerialize2(const SyncAppendEntriesReply* pMsg, uint3
 }
 
 SyncAppendEntriesReply* syncAppendEntriesReplyDeserialize2(const char* buf, uint32_t len) {
-  uint32_t                bytes = *((uint32_t*)buf);
-  SyncAppendEntriesReply* pMsg = taosMemoryMalloc(bytes);
+  uint32_t bytes = *((uint32_t*)buf);
+  // the reply of an older version has no lastSendIndex
+  SyncAppendEntriesReply* pMsg = taosMemoryCalloc(1, TMAX(bytes, sizeof(SyncAppendEntriesReply)));
   ASSERT(pMsg != NULL);
   syncAppendEntriesReplyDeserialize(buf, len, pMsg);
   ASSERT(len == pMsg->bytes);
@@ -1949,6 +1951,8 @@ cJSON* syncAppendEntriesReply2Json(const SyncAppendEntriesReply* pMsg) {
     cJSON_AddStringToObject(pRoot, "matchIndex", u64buf);
     snprintf(u64buf, sizeof(u64buf), "%" PRId64, pMsg->startTime);
     cJSON_AddStringToObject(pRoot, "startTime", u64buf);
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, pMsg->lastSendIndex);
+    cJSON_AddStringToObject(pRoot, "lastSendIndex", u64buf);
   }
 
   cJSON* pJson = cJSON_CreateObject();
@@ -701,4 +701,131 @@ void raftEntryCacheLog2(char* s, SRaftEntryCache* pObj) {
     sTraceLong("raftEntryCacheLog2 | len:%" PRIu64 " | %s | %s", strlen(serialized), s, serialized);
     taosMemoryFree(serialized);
   }
-}
\ No newline at end of file
+}
+
+//-----------------------------------
+SRaftEntryRing* raftEntryRingCreate(SSyncNode* pSyncNode, int32_t capacity, int64_t maxBytes) {
+  SRaftEntryRing* pRing = taosMemoryCalloc(1, sizeof(SRaftEntryRing));
+  if (pRing == NULL) {
+    sError("vgId:%d, raft entry ring create error", pSyncNode->vgId);
+    return NULL;
+  }
+
+  pRing->entries = taosMemoryCalloc(capacity, sizeof(SSyncRaftEntry*));
+  if (pRing->entries == NULL) {
+    sError("vgId:%d, raft entry ring create error, capacity:%d", pSyncNode->vgId, capacity);
+    taosMemoryFree(pRing);
+    return NULL;
+  }
+
+  taosThreadMutexInit(&(pRing->mutex), NULL);
+  pRing->capacity = capacity;
+  pRing->maxBytes = maxBytes;
+  pRing->bytes = 0;
+  pRing->beginIndex = SYNC_INDEX_BEGIN;
+  pRing->endIndex = SYNC_INDEX_BEGIN;
+  pRing->pSyncNode = pSyncNode;
+
+  return pRing;
+}
+
+static void raftEntryRingPopFront(SRaftEntryRing* pRing) {
+  SSyncRaftEntry** ppSlot = &(pRing->entries[pRing->beginIndex % pRing->capacity]);
+  pRing->bytes -= (*ppSlot)->bytes;
+  syncEntryDestory(*ppSlot);
+  *ppSlot = NULL;
+  ++(pRing->beginIndex);
+}
+
+static void raftEntryRingPopBack(SRaftEntryRing* pRing) {
+  --(pRing->endIndex);
+  SSyncRaftEntry** ppSlot = &(pRing->entries[pRing->endIndex % pRing->capacity]);
+  pRing->bytes -= (*ppSlot)->bytes;
+  syncEntryDestory(*ppSlot);
+  *ppSlot = NULL;
+}
+
+void raftEntryRingDestroy(SRaftEntryRing* pRing) {
+  if (pRing != NULL) {
+    raftEntryRingTruncate(pRing, SYNC_INDEX_BEGIN);
+    taosThreadMutexDestroy(&(pRing->mutex));
+    taosMemoryFree(pRing->entries);
+    taosMemoryFree(pRing);
+  }
+}
+
+// keep a copy of an entry just written into the log, evict the oldest ones when the ring is full
+// success, return 0
+// error, return -1
+int32_t raftEntryRingAppend(SRaftEntryRing* pRing, const SSyncRaftEntry* pEntry) {
+  if (pEntry->bytes > pRing->maxBytes) {
+    return 0;
+  }
+
+  SSyncRaftEntry* pCopy = taosMemoryMalloc(pEntry->bytes);
+  if (pCopy == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  memcpy(pCopy, pEntry, pEntry->bytes);
+  // the same as the entry read from wal
+  pCopy->msgType = TDMT_SYNC_CLIENT_REQUEST;
+  pCopy->rid = -1;
+
+  taosThreadMutexLock(&(pRing->mutex));
+
+  // not contiguous with the cached entries, e.g. restored from snapshot, start over
+  if (pEntry->index != pRing->endIndex) {
+    while (pRing->endIndex > pRing->beginIndex) {
+      raftEntryRingPopBack(pRing);
+    }
+    pRing->beginIndex = pEntry->index;
+    pRing->endIndex = pEntry->index;
+  }
+
+  while (pRing->endIndex - pRing->beginIndex >= pRing->capacity ||
+         (pRing->endIndex > pRing->beginIndex && pRing->bytes + pCopy->bytes > pRing->maxBytes)) {
+    raftEntryRingPopFront(pRing);
+  }
+
+  pRing->entries[pRing->endIndex % pRing->capacity] = pCopy;
+  pRing->bytes += pCopy->bytes;
+  ++(pRing->endIndex);
+
+  taosThreadMutexUnlock(&(pRing->mutex));
+  return 0;
+}
+
+// find one, return 1, *ppEntry is a copy owned by the caller
+// not found, return 0
+int32_t raftEntryRingGetEntry(SRaftEntryRing* pRing, SyncIndex index, SSyncRaftEntry** ppEntry) {
+  int32_t code = 0;
+  *ppEntry = NULL;
+
+  taosThreadMutexLock(&(pRing->mutex));
+  if (index >= pRing->beginIndex && index < pRing->endIndex) {
+    SSyncRaftEntry* pEntry = pRing->entries[index % pRing->capacity];
+    ASSERT(pEntry != NULL && pEntry->index == index);
+
+    *ppEntry = taosMemoryMalloc(pEntry->bytes);
+    if (*ppEntry != NULL) {
+      memcpy(*ppEntry, pEntry, pEntry->bytes);
+      code = 1;
+    }
+  }
+  taosThreadMutexUnlock(&(pRing->mutex));
+
+  return code;
+}
+
+// drop the entries [fromIndex, endIndex)
+void raftEntryRingTruncate(SRaftEntryRing* pRing, SyncIndex fromIndex) {
+  taosThreadMutexLock(&(pRing->mutex));
+  while (pRing->endIndex > pRing->beginIndex && pRing->endIndex > fromIndex) {
+    raftEntryRingPopBack(pRing);
+  }
+  if (pRing->endIndex == pRing->beginIndex) {
+    pRing->beginIndex = pRing->endIndex = SYNC_INDEX_BEGIN;
+  }
+  taosThreadMutexUnlock(&(pRing->mutex));
+}
@@ -30,6 +30,7 @@ static int32_t   raftLogEntryCount(struct SSyncLogStore* pLogStore);
 static SyncIndex raftLogLastIndex(struct SSyncLogStore* pLogStore);
 static SyncTerm  raftLogLastTerm(struct SSyncLogStore* pLogStore);
 static int32_t   raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry);
+static int32_t   raftLogAppendEntryBatch(struct SSyncLogStore* pLogStore, SSyncRaftEntry** aEntry, int32_t nEntry);
 static int32_t   raftLogGetEntry(struct SSyncLogStore* pLogStore, SyncIndex index, SSyncRaftEntry** ppEntry);
 static int32_t   raftLogTruncate(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
 static bool      raftLogExist(struct SSyncLogStore* pLogStore, SyncIndex index);
@@ -65,6 +66,11 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
   pData->pWalHandle = walOpenReader(pData->pWal, NULL);
   ASSERT(pData->pWalHandle != NULL);
 
+  int32_t cacheEntries = pSyncNode->logCacheEntries > 0 ? pSyncNode->logCacheEntries : SYNC_LOG_CACHE_COUNT;
+  int64_t cacheBytes = pSyncNode->logCacheBytes > 0 ? pSyncNode->logCacheBytes : SYNC_LOG_CACHE_BYTES;
+  pData->pEntryRing = raftEntryRingCreate(pSyncNode, cacheEntries, cacheBytes);
+  ASSERT(pData->pEntryRing != NULL);
+
   pLogStore->appendEntry = logStoreAppendEntry;
   pLogStore->getEntry = logStoreGetEntry;
   pLogStore->truncate = logStoreTruncate;
@@ -81,6 +87,7 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
   pLogStore->syncLogLastIndex = raftLogLastIndex;
   pLogStore->syncLogLastTerm = raftLogLastTerm;
   pLogStore->syncLogAppendEntry = raftLogAppendEntry;
+  pLogStore->syncLogAppendEntryBatch = raftLogAppendEntryBatch;
   pLogStore->syncLogGetEntry = raftLogGetEntry;
   pLogStore->syncLogTruncate = raftLogTruncate;
   pLogStore->syncLogWriteIndex = raftLogWriteIndex;
@@ -101,6 +108,9 @@ void logStoreDestory(SSyncLogStore* pLogStore) {
     taosThreadMutexUnlock(&(pData->mutex));
     taosThreadMutexDestroy(&(pData->mutex));
 
+    raftEntryRingDestroy(pData->pEntryRing);
+    pData->pEntryRing = NULL;
+
     taosMemoryFree(pLogStore->data);
     taosMemoryFree(pLogStore);
   }
@@ -114,6 +124,7 @@ static int32_t raftLogRestoreFromSnapshot(struct SSyncLogStore* pLogStore, SyncI
   SSyncLogStoreData* pData = pLogStore->data;
   SWal*              pWal = pData->pWal;
   int32_t            code = walRestoreFromSnapshot(pWal, snapshotIndex);
+  raftEntryRingTruncate(pData->pEntryRing, SYNC_INDEX_BEGIN);
   if (code != 0) {
     int32_t     err = terrno;
     const char* errStr = tstrerror(err);
@@ -226,6 +237,7 @@ static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntr
     return -1;
   }
   pEntry->index = index;
+  raftEntryRingAppend(pData->pEntryRing, pEntry);
 
   do {
     char eventLog[128];
@@ -237,6 +249,57 @@ static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntr
   return 0;
 }
 
+static int32_t raftLogAppendEntryBatch(struct SSyncLogStore* pLogStore, SSyncRaftEntry** aEntry, int32_t nEntry) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  SWal*              pWal = pData->pWal;
+
+  SWalAppendItem* aItem = taosMemoryMalloc(sizeof(SWalAppendItem) * nEntry);
+  if (aItem == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < nEntry; ++i) {
+    SSyncRaftEntry* pEntry = aEntry[i];
+    aItem[i].msgType = pEntry->originalRpcType;
+    aItem[i].syncMeta.isWeek = pEntry->isWeak;
+    aItem[i].syncMeta.seqNum = pEntry->seqNum;
+    aItem[i].syncMeta.term = pEntry->term;
+    aItem[i].body = pEntry->data;
+    aItem[i].bodyLen = pEntry->dataLen;
+  }
+
+  SyncIndex index = walAppendLogBatch(pWal, aItem, nEntry);
+  taosMemoryFree(aItem);
+  if (index < 0) {
+    int32_t     err = terrno;
+    const char* errStr = tstrerror(err);
+    int32_t     sysErr = errno;
+    const char* sysErrStr = strerror(errno);
+
+    char logBuf[128];
+    snprintf(logBuf, sizeof(logBuf), "wal batch write error, count:%d, err:%d %X, msg:%s, syserr:%d, sysmsg:%s",
+             nEntry, err, err, errStr, sysErr, sysErrStr);
+    syncNodeErrorLog(pData->pSyncNode, logBuf);
+
+    ASSERT(0);
+    return -1;
+  }
+
+  for (int32_t i = 0; i < nEntry; ++i) {
+    aEntry[i]->index = index + i;
+    raftEntryRingAppend(pData->pEntryRing, aEntry[i]);
+  }
+
+  do {
+    char eventLog[128];
+    snprintf(eventLog, sizeof(eventLog), "write batch index:%" PRId64 "-%" PRId64, index, index + nEntry - 1);
+    syncNodeEventLog(pData->pSyncNode, eventLog);
+  } while (0);
+
+  return 0;
+}
+
 // entry found, return 0
 // entry not found, return -1, terrno = TSDB_CODE_WAL_LOG_NOT_EXIST
 // other error, return -1
@@ -247,6 +310,11 @@ static int32_t raftLogGetEntry(struct SSyncLogStore* pLogStore, SyncIndex index,
 
   *ppEntry = NULL;
 
+  // the entries already removed from wal are not served from the ring either
+  if (index >= walGetFirstVer(pWal) && raftEntryRingGetEntry(pData->pEntryRing, index, ppEntry) == 1) {
+    return 0;
+  }
+
   // SWalReadHandle* pWalHandle = walOpenReadHandle(pWal);
   SWalReader* pWalHandle = pData->pWalHandle;
   if (pWalHandle == NULL) {
@@ -316,6 +384,7 @@ static int32_t raftLogTruncate(struct SSyncLogStore* pLogStore, SyncIndex fromIn
     return 0;
   }
 
+  raftEntryRingTruncate(pData->pEntryRing, fromIndex);
   int32_t code = walRollback(pWal, fromIndex);
   if (code != 0) {
     int32_t     err = terrno;
@@ -389,6 +458,7 @@ int32_t logStoreAppendEntry(SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry) {
     return -1;
   }
   pEntry->index = index;
+  raftEntryRingAppend(pData->pEntryRing, pEntry);
 
   do {
     char eventLog[128];
@@ -405,6 +475,11 @@ SSyncRaftEntry* logStoreGetEntry(SSyncLogStore* pLogStore, SyncIndex index) {
   SWal*              pWal = pData->pWal;
 
   if (index >= SYNC_INDEX_BEGIN && index <= logStoreLastIndex(pLogStore)) {
+    SSyncRaftEntry* pEntry = NULL;
+    if (index >= walGetFirstVer(pWal) && raftEntryRingGetEntry(pData->pEntryRing, index, &pEntry) == 1) {
+      return pEntry;
+    }
+
     taosThreadMutexLock(&(pData->mutex));
 
     // SWalReadHandle* pWalHandle = walOpenReadHandle(pWal);
@@ -432,7 +507,7 @@ SSyncRaftEntry* logStoreGetEntry(SSyncLogStore* pLogStore, SyncIndex index) {
       ASSERT(0);
     }
 
-    SSyncRaftEntry* pEntry = syncEntryBuild(pWalHandle->pHead->head.bodyLen);
+    pEntry = syncEntryBuild(pWalHandle->pHead->head.bodyLen);
     ASSERT(pEntry != NULL);
 
     pEntry->msgType = TDMT_SYNC_CLIENT_REQUEST;
@@ -462,6 +537,7 @@ int32_t logStoreTruncate(SSyncLogStore* pLogStore, SyncIndex fromIndex) {
   SSyncLogStoreData* pData = pLogStore->data;
   SWal*              pWal = pData->pWal;
   // ASSERT(walRollback(pWal, fromIndex) == 0);
+  raftEntryRingTruncate(pData->pEntryRing, fromIndex);
   int32_t code = walRollback(pWal, fromIndex);
   if (code != 0) {
     int32_t     err = terrno;
@@ -116,98 +116,207 @@ int32_t syncNodeAppendEntriesPeers(SSyncNode* pSyncNode) {
   return ret;
 }
 
-int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex) {
-  int32_t ret = 0;
+SSyncInflight* syncNodeGetInflight(SSyncNode* pSyncNode, const SRaftId* pDestId) {
+  for (int32_t i = 0; i < pSyncNode->peersNum; ++i) {
+    if (syncUtilSameId(&(pSyncNode->peersId[i]), pDestId)) {
+      SSyncInflight* pInflight = &(pSyncNode->inflights[i]);
+      // peers changed
+      if (!syncUtilSameId(&(pInflight->destId), pDestId)) {
+        syncInflightReset(pInflight);
+        pInflight->destId = *pDestId;
+      }
+      return pInflight;
+    }
+  }
+  return NULL;
+}
 
-  // pre index, pre term
-  SyncIndex preLogIndex = syncNodeGetPreIndex(pSyncNode, nextIndex);
-  SyncTerm  preLogTerm = syncNodeGetPreTerm(pSyncNode, nextIndex);
-  if (preLogTerm == SYNC_TERM_INVALID) {
-    SyncIndex newNextIndex = syncNodeGetLastIndex(pSyncNode) + 1;
-    // SyncIndex newNextIndex = nextIndex + 1;
-
-    syncIndexMgrSetIndex(pSyncNode->pNextIndex, pDestId, newNextIndex);
-    syncIndexMgrSetIndex(pSyncNode->pMatchIndex, pDestId, SYNC_INDEX_INVALID);
-    sError("vgId:%d, sync get pre term error, nextIndex:%" PRId64 ", update next-index:%" PRId64
-           ", match-index:%d, raftid:%" PRId64,
-           pSyncNode->vgId, nextIndex, newNextIndex, SYNC_INDEX_INVALID, pDestId->addr);
-    return -1;
+void syncInflightReset(SSyncInflight* pInflight) {
+  if (pInflight != NULL) {
+    pInflight->head = 0;
+    pInflight->num = 0;
+    pInflight->entries = 0;
+    pInflight->bytes = 0;
   }
+}
 
-  // entry pointer array
-  SSyncRaftEntry* entryPArr[SYNC_MAX_BATCH_SIZE];
-  memset(entryPArr, 0, sizeof(entryPArr));
+// the messages whose entries are all matched are replied
+void syncInflightAck(SSyncInflight* pInflight, SyncIndex matchIndex) {
+  if (pInflight == NULL) {
+    return;
+  }
+
+  while (pInflight->num > 0 && pInflight->lastIndex[pInflight->head] <= matchIndex) {
+    pInflight->entries -= pInflight->count[pInflight->head];
+    pInflight->bytes -= pInflight->size[pInflight->head];
+    pInflight->head = (pInflight->head + 1) % SYNC_PIPELINE_MAX_MSGS;
+    --(pInflight->num);
+  }
+}
+
+void syncInflightPush(SSyncInflight* pInflight, SyncIndex lastIndex, int32_t count, int32_t size, int64_t sendTime) {
+  int32_t tail = (pInflight->head + pInflight->num) % SYNC_PIPELINE_MAX_MSGS;
+  pInflight->lastIndex[tail] = lastIndex;
+  pInflight->count[tail] = count;
+  pInflight->size[tail] = size;
+  pInflight->sendTime[tail] = sendTime;
+  pInflight->entries += count;
+  pInflight->bytes += size;
+  ++(pInflight->num);
+}
+
+// A reject answers the message in flight whose last index is lastSendIndex. It and the messages sent after it are
+// dropped from the window, the later ones follow the rejected entries and are rejected too. The first index of the
+// rejected message is returned, false is returned if no message in flight ends at lastSendIndex.
+bool syncInflightReject(SSyncInflight* pInflight, SyncIndex lastSendIndex, SyncIndex* pFirstIndex) {
+  if (pInflight == NULL) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < pInflight->num; ++i) {
+    int32_t pos = (pInflight->head + i) % SYNC_PIPELINE_MAX_MSGS;
+    if (pInflight->lastIndex[pos] != lastSendIndex) {
+      continue;
+    }
+
+    *pFirstIndex = pInflight->lastIndex[pos] - pInflight->count[pos] + 1;
+    for (int32_t j = i; j < pInflight->num; ++j) {
+      pos = (pInflight->head + j) % SYNC_PIPELINE_MAX_MSGS;
+      pInflight->entries -= pInflight->count[pos];
+      pInflight->bytes -= pInflight->size[pos];
+    }
+    pInflight->num = i;
+    return true;
+  }
+
+  return false;
+}
+
+// Send the entries from next-index to a peer as a pipeline: each message carries a batch of entries, next-index is
+// advanced as soon as a message is sent, and more messages are sent without waiting for the replies as long as the
+// entries and bytes in flight are within the window. A rejected reply resets the window and moves next-index back.
+int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex) {
+  int32_t        ret = 0;
+  bool           sent = false;
+  int64_t        timeNow = taosGetTimestampMs();
+  SSyncInflight* pInflight = syncNodeGetInflight(pSyncNode, pDestId);
+  ASSERT(pInflight != NULL);
+
+  if (pInflight->num > 0) {
+    int32_t tail = (pInflight->head + pInflight->num - 1) % SYNC_PIPELINE_MAX_MSGS;
+    if (pInflight->lastIndex[tail] != nextIndex - 1) {
+      // next-index is moved by a reply or a snapshot
+      syncInflightReset(pInflight);
+
+    } else if (timeNow - pInflight->sendTime[pInflight->head] > pSyncNode->hbBaseLine * 2) {
+      // no reply for too long, the messages may be lost, send them again
+      nextIndex = pInflight->lastIndex[pInflight->head] - pInflight->count[pInflight->head] + 1;
+      syncIndexMgrSetIndex(pSyncNode->pNextIndex, pDestId, nextIndex);
+      syncInflightReset(pInflight);
+    }
+  }
+
+  while (pInflight->num < SYNC_PIPELINE_MAX_MSGS && pInflight->entries < pSyncNode->pipelineEntries &&
+         pInflight->bytes < pSyncNode->pipelineBytes) {
+    // pre index, pre term
+    SyncIndex preLogIndex = syncNodeGetPreIndex(pSyncNode, nextIndex);
+    SyncTerm  preLogTerm = syncNodeGetPreTerm(pSyncNode, nextIndex);
+    if (preLogTerm == SYNC_TERM_INVALID) {
+      SyncIndex newNextIndex = syncNodeGetLastIndex(pSyncNode) + 1;
+      // SyncIndex newNextIndex = nextIndex + 1;
+
+      syncIndexMgrSetIndex(pSyncNode->pNextIndex, pDestId, newNextIndex);
+      syncIndexMgrSetIndex(pSyncNode->pMatchIndex, pDestId, SYNC_INDEX_INVALID);
+      syncInflightReset(pInflight);
+      sError("vgId:%d, sync get pre term error, nextIndex:%" PRId64 ", update next-index:%" PRId64
+             ", match-index:%d, raftid:%" PRId64,
+             pSyncNode->vgId, nextIndex, newNextIndex, SYNC_INDEX_INVALID, pDestId->addr);
+      return -1;
+    }
+
+    // entry pointer array
+    SSyncRaftEntry* entryPArr[SYNC_APPEND_BATCH_MAX_COUNT];
+    memset(entryPArr, 0, sizeof(entryPArr));
+
+    // get entry batch
+    int32_t   getCount = 0;
+    int32_t   getBytes = 0;
+    SyncIndex getEntryIndex = nextIndex;
+    while (getCount < SYNC_APPEND_BATCH_MAX_COUNT && pInflight->entries + getCount < pSyncNode->pipelineEntries) {
+      SSyncRaftEntry* pEntry = NULL;
+      int32_t         code = pSyncNode->pLogStore->syncLogGetEntry(pSyncNode->pLogStore, getEntryIndex, &pEntry);
+      if (code != 0) {
+        break;
+      }
 
-  // get entry batch
-  int32_t   getCount = 0;
-  SyncIndex getEntryIndex = nextIndex;
-  for (int32_t i = 0; i < pSyncNode->pRaftCfg->batchSize; ++i) {
-    SSyncRaftEntry* pEntry = NULL;
-    int32_t         code = pSyncNode->pLogStore->syncLogGetEntry(pSyncNode->pLogStore, getEntryIndex, &pEntry);
-    if (code == 0) {
       ASSERT(pEntry != NULL);
-      entryPArr[i] = pEntry;
+      if (getCount > 0 && getBytes + pEntry->bytes > SYNC_APPEND_BATCH_MAX_BYTES) {
+        syncEntryDestory(pEntry);
+        break;
+      }
+
+      entryPArr[getCount] = pEntry;
+      getBytes += pEntry->bytes;
       getCount++;
       getEntryIndex++;
+    }
 
-    } else {
+    // nothing new to send, the messages in flight or the one sent just now work as heartbeat
+    if (getCount == 0 && (sent || pInflight->num > 0)) {
       break;
     }
-  }
 
-  // event log
-  do {
-    char     logBuf[128];
-    char     host[64];
-    uint16_t port;
-    syncUtilU642Addr(pDestId->addr, host, sizeof(host), &port);
-    snprintf(logBuf, sizeof(logBuf), "build batch:%d for %s:%d", getCount, host, port);
-    syncNodeEventLog(pSyncNode, logBuf);
-  } while (0);
-
-  // build msg
-  SyncAppendEntriesBatch* pMsg = syncAppendEntriesBatchBuild(entryPArr, getCount, pSyncNode->vgId);
-  ASSERT(pMsg != NULL);
-
-  // free entries
-  for (int32_t i = 0; i < pSyncNode->pRaftCfg->batchSize; ++i) {
-    SSyncRaftEntry* pEntry = entryPArr[i];
-    if (pEntry != NULL) {
-      syncEntryDestory(pEntry);
+    // event log
+    do {
+      char     logBuf[128];
+      char     host[64];
+      uint16_t port;
+      syncUtilU642Addr(pDestId->addr, host, sizeof(host), &port);
+      snprintf(logBuf, sizeof(logBuf), "build batch:%d for %s:%d, in flight:%d", getCount, host, port,
+               pInflight->entries);
+      syncNodeEventLog(pSyncNode, logBuf);
+    } while (0);
+
+    // build msg
+    SyncAppendEntriesBatch* pMsg = syncAppendEntriesBatchBuild(entryPArr, getCount, pSyncNode->vgId);
+    ASSERT(pMsg != NULL);
+
+    // free entries
+    for (int32_t i = 0; i < getCount; ++i) {
+      syncEntryDestory(entryPArr[i]);
       entryPArr[i] = NULL;
     }
-  }
 
-  // prepare msg
-  pMsg->srcId = pSyncNode->myRaftId;
-  pMsg->destId = *pDestId;
-  pMsg->term = pSyncNode->pRaftStore->currentTerm;
-  pMsg->prevLogIndex = preLogIndex;
-  pMsg->prevLogTerm = preLogTerm;
-  pMsg->commitIndex = pSyncNode->commitIndex;
-  pMsg->privateTerm = 0;
-  pMsg->dataCount = getCount;
+    // prepare msg
+    pMsg->srcId = pSyncNode->myRaftId;
+    pMsg->destId = *pDestId;
+    pMsg->term = pSyncNode->pRaftStore->currentTerm;
+    pMsg->prevLogIndex = preLogIndex;
+    pMsg->prevLogTerm = preLogTerm;
+    pMsg->commitIndex = pSyncNode->commitIndex;
+    pMsg->privateTerm = 0;
+    pMsg->dataCount = getCount;
+
+    // send msg
+    syncNodeAppendEntriesBatch(pSyncNode, pDestId, pMsg);
 
-  // send msg
-  syncNodeAppendEntriesBatch(pSyncNode, pDestId, pMsg);
+    // speed up
+    if (!sent && pMsg->dataCount > 0 && pSyncNode->commitIndex - pMsg->prevLogIndex > SYNC_SLOW_DOWN_RANGE) {
+      ret = 1;
+    }
 
-  // speed up
-  if (pMsg->dataCount > 0 && pSyncNode->commitIndex - pMsg->prevLogIndex > SYNC_SLOW_DOWN_RANGE) {
-    ret = 1;
+    syncAppendEntriesBatchDestroy(pMsg);
+    sent = true;
 
-#if 0
-      do {
-        char     logBuf[128];
-        char     host[64];
-        uint16_t port;
-        syncUtilU642Addr(pDestId->addr, host, sizeof(host), &port);
-        snprintf(logBuf, sizeof(logBuf), "maybe speed up for %s:%d, pre-index:%ld", host, port, pMsg->prevLogIndex);
-        syncNodeEventLog(pSyncNode, logBuf);
-      } while (0);
-#endif
-  }
+    if (getCount == 0) {
+      break;
+    }
 
-  syncAppendEntriesBatchDestroy(pMsg);
+    // advance next-index without waiting for the reply
+    syncInflightPush(pInflight, nextIndex + getCount - 1, getCount, getBytes, timeNow);
+    nextIndex += getCount;
+    syncIndexMgrSetIndex(pSyncNode->pNextIndex, pDestId, nextIndex);
+  }
 
   return ret;
 }
@@ -173,6 +173,47 @@ void test5() {
   }
 }
 
+void test6() {
+  SSyncNode*      pSyncNode = createFakeNode();
+  SRaftEntryRing* pRing = raftEntryRingCreate(pSyncNode, 5, 1024 * 1024);
+  ASSERT(pRing != NULL);
+
+  for (int i = 0; i < 10; ++i) {
+    SSyncRaftEntry* pEntry = createEntry(i);
+    raftEntryRingAppend(pRing, pEntry);
+    syncEntryDestory(pEntry);
+  }
+
+  // only the latest 5 entries are kept
+  for (int i = 0; i < 10; ++i) {
+    SSyncRaftEntry* pEntry = NULL;
+    int32_t         code = raftEntryRingGetEntry(pRing, i, &pEntry);
+    ASSERT(code == (i >= 5 ? 1 : 0));
+    if (code == 1) {
+      ASSERT(pEntry->index == i && pEntry->term == 100 + i);
+      syncEntryLog2((char*)"==test6 get entry==", pEntry);
+      syncEntryDestory(pEntry);
+    }
+  }
+
+  raftEntryRingTruncate(pRing, 8);
+  SSyncRaftEntry* pEntry = NULL;
+  ASSERT(raftEntryRingGetEntry(pRing, 8, &pEntry) == 0);
+  ASSERT(raftEntryRingGetEntry(pRing, 7, &pEntry) == 1);
+  syncEntryDestory(pEntry);
+
+  // not contiguous, start over
+  pEntry = createEntry(20);
+  raftEntryRingAppend(pRing, pEntry);
+  syncEntryDestory(pEntry);
+  ASSERT(raftEntryRingGetEntry(pRing, 7, &pEntry) == 0);
+  ASSERT(raftEntryRingGetEntry(pRing, 20, &pEntry) == 1);
+  syncEntryDestory(pEntry);
+
+  raftEntryRingDestroy(pRing);
+  taosMemoryFree(pSyncNode);
+}
+
 int main(int argc, char** argv) {
   gRaftDetailLog = true;
   tsAsyncLog = 0;
@@ -185,6 +226,7 @@ int main(int argc, char** argv) {
   */
   test4();
   // test5();
+  test6();
 
   return 0;
 }
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "syncIO.h"
+#include "syncInt.h"
+#include "syncReplication.h"
+#include "syncUtil.h"
+
+void logTest() {
+  sTrace("--- sync log test: trace");
+  sDebug("--- sync log test: debug");
+  sInfo("--- sync log test: info");
+  sWarn("--- sync log test: warn");
+  sError("--- sync log test: error");
+  sFatal("--- sync log test: fatal");
+}
+
+// messages of 10 entries and 100 bytes each, covering [start, start + 10 * num)
+void pushMsgs(SSyncInflight* pInflight, SyncIndex start, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    syncInflightPush(pInflight, start + 10 * (i + 1) - 1, 10, 100, taosGetTimestampMs());
+  }
+}
+
+void test1() {
+  // window
+  SSyncInflight inflight = {0};
+  pushMsgs(&inflight, 0, 4);
+  assert(inflight.num == 4);
+  assert(inflight.entries == 40);
+  assert(inflight.bytes == 400);
+
+  // a reply in the middle of a message acks the ones before it only
+  syncInflightAck(&inflight, 15);
+  assert(inflight.num == 3);
+  assert(inflight.entries == 30);
+  assert(inflight.lastIndex[inflight.head] == 19);
+
+  syncInflightAck(&inflight, 29);
+  assert(inflight.num == 1);
+  assert(inflight.bytes == 100);
+
+  // wrap around the ring
+  pushMsgs(&inflight, 40, SYNC_PIPELINE_MAX_MSGS - 1);
+  assert(inflight.num == SYNC_PIPELINE_MAX_MSGS);
+  assert(inflight.entries == 10 * SYNC_PIPELINE_MAX_MSGS);
+  syncInflightAck(&inflight, 10 * SYNC_PIPELINE_MAX_MSGS + 29);
+  assert(inflight.num == 0);
+  assert(inflight.entries == 0);
+  assert(inflight.bytes == 0);
+}
+
+void test2() {
+  // reject
+  SSyncInflight inflight = {0};
+  SyncIndex     firstIndex = SYNC_INDEX_INVALID;
+  pushMsgs(&inflight, 100, 5);
+
+  // not the last index of any message in flight
+  assert(!syncInflightReject(&inflight, 115, &firstIndex));
+  assert(!syncInflightReject(&inflight, 99, &firstIndex));
+  assert(inflight.num == 5);
+
+  // the rejected message and the ones after it leave the window
+  assert(syncInflightReject(&inflight, 129, &firstIndex));
+  assert(firstIndex == 120);
+  assert(inflight.num == 2);
+  assert(inflight.entries == 20);
+  assert(inflight.bytes == 200);
+
+  // the replies of the dropped messages are out of the window now
+  assert(!syncInflightReject(&inflight, 139, &firstIndex));
+  assert(!syncInflightReject(&inflight, 149, &firstIndex));
+
+  assert(syncInflightReject(&inflight, 109, &firstIndex));
+  assert(firstIndex == 100);
+  assert(inflight.num == 0);
+  assert(inflight.entries == 0);
+}
+
+void test3() {
+  // reset
+  SSyncInflight inflight = {0};
+  SyncIndex     firstIndex = SYNC_INDEX_INVALID;
+  pushMsgs(&inflight, 0, 3);
+  syncInflightAck(&inflight, 9);
+
+  syncInflightReset(&inflight);
+  assert(inflight.num == 0);
+  assert(inflight.entries == 0);
+  assert(inflight.bytes == 0);
+  assert(!syncInflightReject(&inflight, 19, &firstIndex));
+
+  // sent again from where it was reset
+  pushMsgs(&inflight, 10, 2);
+  assert(inflight.num == 2);
+  assert(inflight.lastIndex[inflight.head] == 19);
+  assert(syncInflightReject(&inflight, 29, &firstIndex));
+  assert(firstIndex == 20);
+  assert(inflight.num == 1);
+}
+
+void test4() {
+  // reply carries the message it answers
+  SyncAppendEntriesReply* pMsg = syncAppendEntriesReplyBuild(1000);
+  pMsg->success = false;
+  pMsg->matchIndex = 10;
+  pMsg->lastSendIndex = 129;
+
+  uint32_t                len;
+  char*                   serialized = syncAppendEntriesReplySerialize2(pMsg, &len);
+  SyncAppendEntriesReply* pMsg2 = syncAppendEntriesReplyDeserialize2(serialized, len);
+  assert(pMsg2->lastSendIndex == 129);
+  assert(pMsg2->bytes == sizeof(SyncAppendEntriesReply));
+  syncAppendEntriesReplyDestroy(pMsg2);
+
+  // a reply of an older version is shorter
+  uint32_t oldLen = sizeof(SyncAppendEntriesReply) - sizeof(SyncIndex);
+  *(uint32_t*)serialized = oldLen;
+  pMsg2 = syncAppendEntriesReplyDeserialize2(serialized, oldLen);
+  assert(pMsg2->bytes < sizeof(SyncAppendEntriesReply));
+  assert(pMsg2->lastSendIndex == 0);
+  syncAppendEntriesReplyDestroy(pMsg2);
+
+  taosMemoryFree(serialized);
+  syncAppendEntriesReplyDestroy(pMsg);
+}
+
+int main() {
+  tsAsyncLog = 0;
+  sDebugFlag = DEBUG_TRACE + DEBUG_SCREEN + DEBUG_FILE;
+  logTest();
+
+  test1();
+  test2();
+  test3();
+  test4();
+
+  return 0;
+}
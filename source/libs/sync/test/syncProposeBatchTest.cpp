@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "syncIO.h"
+#include "syncInt.h"
+#include "syncMessage.h"
+#include "syncRaftCfg.h"
+#include "syncRespMgr.h"
+#include "syncUtil.h"
+
+void logTest() {
+  sTrace("--- sync log test: trace");
+  sDebug("--- sync log test: debug");
+  sInfo("--- sync log test: info");
+  sWarn("--- sync log test: warn");
+  sError("--- sync log test: error");
+  sFatal("--- sync log test: fatal");
+}
+
+#define BATCH_SIZE 5
+#define DATA_LEN   20
+
+SRpcMsg gQueued;
+int32_t gQueuedNum = 0;
+
+int32_t fakeEqMsg(const SMsgCb *msgcb, SRpcMsg *pMsg) {
+  gQueued = *pMsg;
+  gQueuedNum++;
+  return 0;
+}
+
+int32_t failEqMsg(const SMsgCb *msgcb, SRpcMsg *pMsg) { return -1; }
+
+// a leader of a 3 replica group, proposes go through the sync queue
+SSyncNode *createLeader(int32_t (*fpEqMsg)(const SMsgCb *, SRpcMsg *)) {
+  SSyncNode *pSyncNode = (SSyncNode *)taosMemoryCalloc(1, sizeof(SSyncNode));
+  assert(pSyncNode != NULL);
+  pSyncNode->vgId = 2;
+  pSyncNode->state = TAOS_SYNC_STATE_LEADER;
+  pSyncNode->replicaNum = 3;
+  pSyncNode->pRaftCfg = (SRaftCfg *)taosMemoryCalloc(1, sizeof(SRaftCfg));
+  pSyncNode->pSyncRespMgr = syncRespMgrCreate(pSyncNode, 0);
+  pSyncNode->FpEqMsg = fpEqMsg;
+  return pSyncNode;
+}
+
+void destroyLeader(SSyncNode *pSyncNode) {
+  syncRespMgrDestroy(pSyncNode->pSyncRespMgr);
+  taosMemoryFree(pSyncNode->pRaftCfg);
+  taosMemoryFree(pSyncNode);
+}
+
+SRpcMsg *createRpcMsg(int32_t i) {
+  SRpcMsg *pRpcMsg = (SRpcMsg *)taosMemoryCalloc(1, sizeof(SRpcMsg));
+  pRpcMsg->msgType = TDMT_VND_SUBMIT;
+  pRpcMsg->contLen = DATA_LEN;
+  pRpcMsg->pCont = rpcMallocCont(DATA_LEN);
+  snprintf((char *)pRpcMsg->pCont, DATA_LEN, "value_%d", i);
+  return pRpcMsg;
+}
+
+// what vnodeProposeBatchMsg does with the msgs once the propose returns
+void freeRpcMsgs(SRpcMsg **pMsgArr) {
+  for (int32_t i = 0; i < BATCH_SIZE; ++i) {
+    rpcFreeCont(pMsgArr[i]->pCont);
+    taosMemoryFree(pMsgArr[i]);
+  }
+}
+
+void test1() {
+  // enqueued, the batch owns the msg contents
+  SSyncNode *pSyncNode = createLeader(fakeEqMsg);
+  SRpcMsg   *pMsgArr[BATCH_SIZE];
+  bool       isWeakArr[BATCH_SIZE] = {0};
+  for (int32_t i = 0; i < BATCH_SIZE; ++i) {
+    pMsgArr[i] = createRpcMsg(i);
+  }
+
+  gQueuedNum = 0;
+  int32_t code = syncNodeProposeBatch(pSyncNode, pMsgArr, isWeakArr, BATCH_SIZE);
+  assert(code == 0);
+  assert(gQueuedNum == 1);
+  for (int32_t i = 0; i < BATCH_SIZE; ++i) {
+    assert(pMsgArr[i]->pCont == NULL);
+  }
+  freeRpcMsgs(pMsgArr);
+
+  // the sync queue reads the contents after the caller is done with its msgs
+  SyncClientRequestBatch *pBatch = syncClientRequestBatchFromRpcMsg(&gQueued);
+  assert(pBatch->dataCount == BATCH_SIZE);
+  SRpcMsg *msgArr = syncClientRequestBatchRpcMsgArr(pBatch);
+  for (int32_t i = 0; i < BATCH_SIZE; ++i) {
+    char expect[DATA_LEN];
+    snprintf(expect, DATA_LEN, "value_%d", i);
+    assert(msgArr[i].contLen == DATA_LEN);
+    assert(strcmp((char *)msgArr[i].pCont, expect) == 0);
+  }
+  syncClientRequestBatchDestroyDeep(pBatch);
+  rpcFreeCont(gQueued.pCont);
+
+  destroyLeader(pSyncNode);
+}
+
+void test2() {
+  // not enqueued, the contents stay with the caller
+  SSyncNode *pSyncNode = createLeader(failEqMsg);
+  SRpcMsg   *pMsgArr[BATCH_SIZE];
+  bool       isWeakArr[BATCH_SIZE] = {0};
+  for (int32_t i = 0; i < BATCH_SIZE; ++i) {
+    pMsgArr[i] = createRpcMsg(i);
+  }
+
+  int32_t code = syncNodeProposeBatch(pSyncNode, pMsgArr, isWeakArr, BATCH_SIZE);
+  assert(code == -1);
+  for (int32_t i = 0; i < BATCH_SIZE; ++i) {
+    char expect[DATA_LEN];
+    snprintf(expect, DATA_LEN, "value_%d", i);
+    assert(pMsgArr[i]->pCont != NULL);
+    assert(strcmp((char *)pMsgArr[i]->pCont, expect) == 0);
+  }
+  freeRpcMsgs(pMsgArr);
+
+  destroyLeader(pSyncNode);
+}
+
+int main() {
+  gRaftDetailLog = true;
+  tsAsyncLog = 0;
+  sDebugFlag = DEBUG_DEBUG + DEBUG_TRACE + DEBUG_SCREEN + DEBUG_FILE;
+  logTest();
+
+  test1();
+  test2();
+
+  return 0;
+}
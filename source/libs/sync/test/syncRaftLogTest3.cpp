@@ -370,6 +370,89 @@ void test5() {
   cleanup();
 }
 
+void test6() {
+  // no snapshot
+  // log appended one by one and in batches
+
+  taosRemoveDir(pWalPath);
+
+  init();
+  pLogStore = logStoreCreate(pSyncNode);
+  assert(pLogStore);
+  pSyncNode->pLogStore = pLogStore;
+  logStoreLog2((char*)"\n\n\ntest6 ----- ", pLogStore);
+
+  int32_t         dataLen = 10;
+  SSyncRaftEntry* entryArr[4];
+  for (int i = 0; i <= 10;) {
+    int32_t count = (i < 3) ? 1 : 4;
+    for (int j = 0; j < count; ++j, ++i) {
+      SSyncRaftEntry* pEntry = syncEntryBuild(dataLen);
+      assert(pEntry != NULL);
+      pEntry->msgType = 1;
+      pEntry->originalRpcType = 2;
+      pEntry->seqNum = 3;
+      pEntry->isWeak = true;
+      pEntry->term = 100 + i;
+      pEntry->index = pLogStore->syncLogWriteIndex(pLogStore) + j;
+      snprintf(pEntry->data, dataLen, "value%d", i);
+      entryArr[j] = pEntry;
+    }
+
+    if (count == 1) {
+      pLogStore->syncLogAppendEntry(pLogStore, entryArr[0]);
+    } else {
+      int32_t code = pLogStore->syncLogAppendEntryBatch(pLogStore, entryArr, count);
+      if (gAssert) {
+        assert(code == 0);
+      }
+    }
+    for (int j = 0; j < count; ++j) {
+      syncEntryDestory(entryArr[j]);
+    }
+  }
+  logStoreLog2((char*)"test6 after appendEntry", pLogStore);
+
+  gSnapshotLastApplyIndex = -1;
+  gSnapshotLastApplyTerm = 0;
+
+  SyncIndex lastIndex = syncNodeGetLastIndex(pSyncNode);
+  SyncTerm  lastTerm = syncNodeGetLastTerm(pSyncNode);
+  SyncIndex syncStartIndex = syncNodeSyncStartIndex(pSyncNode);
+
+  sTrace("test6");
+  sTrace("lastIndex: %" PRId64, lastIndex);
+  sTrace("lastTerm: %" PRIu64, lastTerm);
+  sTrace("syncStartIndex: %" PRId64, syncStartIndex);
+
+  if (gAssert) {
+    assert(lastIndex == 10);
+    assert(lastTerm == 110);
+    assert(syncStartIndex == 11);
+  }
+
+  for (SyncIndex i = 0; i <= 10; ++i) {
+    SSyncRaftEntry* pEntry = NULL;
+    int32_t         code = pLogStore->syncLogGetEntry(pLogStore, i, &pEntry);
+
+    char value[10];
+    snprintf(value, sizeof(value), "value%" PRId64, i);
+    sTrace("%" PRId64 "'s entry: %s", i, (code == 0) ? pEntry->data : "null");
+
+    if (gAssert) {
+      assert(code == 0);
+      assert(pEntry->index == i);
+      assert(pEntry->term == 100 + i);
+      assert(pEntry->originalRpcType == 2);
+      assert(strcmp(pEntry->data, value) == 0);
+    }
+    syncEntryDestory(pEntry);
+  }
+
+  logStoreDestory(pLogStore);
+  cleanup();
+}
+
 int main(int argc, char** argv) {
   tsAsyncLog = 0;
   sDebugFlag = DEBUG_TRACE + DEBUG_INFO + DEBUG_SCREEN + DEBUG_FILE;
@@ -385,6 +468,7 @@ int main(int argc, char** argv) {
   test3();
   test4();
   test5();
+  test6();
 
   return 0;
 }
@@ -98,6 +98,7 @@ typedef void* queue[2];
 #define TRANS_RETRY_INTERVAL    15    // retry interval (ms)
 #define TRANS_CONN_TIMEOUT      3     // connect timeout (s)
 #define TRANS_READ_TIMEOUT      3000  // read timeout  (ms)
+#define TRANS_WRITE_BATCH_SIZE  64    // max msgs gathered into one vectored write
 #define TRANS_PACKET_LIMIT      1024 * 1024 * 512
 
 #define TRANS_MAGIC_NUM 0x5f375a86
@@ -216,6 +217,7 @@ typedef struct SConnBuffer {
   int   left;
   int   total;
   int   invalid;
+  int   offset;  // start of the unconsumed data, compacted before the next read
 } SConnBuffer;
 
 typedef void (*AsyncCB)(uv_async_t* handle);
@@ -46,6 +46,7 @@ typedef struct {
   int      sessions;      // number of sessions allowed
   int      numOfThreads;  // number of threads to process incoming messages
   int      idleTime;      // milliseconds;
+  int      batchDelay;    // milliseconds;
   uint16_t localPort;
   int8_t   connType;
   char     label[TSDB_LABEL_LEN];
@@ -45,6 +45,9 @@ typedef struct SCliConn {
 
   SDelayTask* task;
 
+  queue pendq;    // linked into SCliThrd::pendConns while it has sends deferred to the end of a batch
+  bool  writing;  // a write is in flight, msgs queued meanwhile go out in the next one
+
   // debug and log info
   char src[32];
   char dst[32];
@@ -83,6 +86,9 @@ typedef struct SCliThrd {
 
   SCliMsg* stopMsg;
 
+  queue       pendConns;  // conns with deferred sends, flushed once per batch of app msgs
+  uv_timer_t* pendTimer;  // holds the flush for STrans::batchDelay ms if configured
+
   bool quit;
 } SCliThrd;
 
@@ -127,6 +133,10 @@ static SCliConn* cliCreateConn(SCliThrd* thrd);
 static void      cliDestroyConn(SCliConn* pConn, bool clear /*clear tcp handle or not*/);
 static void      cliDestroy(uv_handle_t* handle);
 static void      cliSend(SCliConn* pConn);
+static void      cliPendSend(SCliThrd* pThrd, SCliConn* pConn);
+static void      cliFlushPendConns(SCliThrd* pThrd);
+static void      cliMayFlushPendConns(SCliThrd* pThrd);
+static void      cliPendTimeoutCb(uv_timer_t* handle);
 static void      cliDestroyConnMsgs(SCliConn* conn, bool destroy);
 
 // cli util func
@@ -213,20 +223,6 @@ static void cliReleaseUnfinishedMsg(SCliConn* conn) {
       tDebug("msg found, %" PRIu64 "", ahandle);                                          \
     }                                                                                     \
   } while (0)
-#define CONN_GET_NEXT_SENDMSG(conn)                 \
-  do {                                              \
-    int i = 0;                                      \
-    do {                                            \
-      pCliMsg = transQueueGet(&conn->cliMsgs, i++); \
-      if (pCliMsg && 0 == pCliMsg->sent) {          \
-        break;                                      \
-      }                                             \
-    } while (pCliMsg != NULL);                      \
-    if (pCliMsg == NULL) {                          \
-      goto _RETURN;                                 \
-    }                                               \
-  } while (0)
-
 #define CONN_HANDLE_THREAD_QUIT(thrd) \
   do {                                \
     if (thrd->quit) {                 \
@@ -286,14 +282,14 @@ static void cliReleaseUnfinishedMsg(SCliConn* conn) {
 static void* cliWorkThread(void* arg);
 
 bool cliMaySendCachedMsg(SCliConn* conn) {
-  if (!transQueueEmpty(&conn->cliMsgs)) {
-    SCliMsg* pCliMsg = NULL;
-    CONN_GET_NEXT_SENDMSG(conn);
-    cliSend(conn);
+  for (int i = 0; i < transQueueSize(&conn->cliMsgs); i++) {
+    SCliMsg* pCliMsg = transQueueGet(&conn->cliMsgs, i);
+    if (pCliMsg->sent == 0) {
+      cliSend(conn);
+      return true;
+    }
   }
   return false;
-_RETURN:
-  return false;
 }
 void cliHandleResp(SCliConn* conn) {
   SCliThrd* pThrd = conn->hostThrd;
@@ -630,6 +626,7 @@ static SCliConn* cliCreateConn(SCliThrd* pThrd) {
 
   transInitBuffer(&conn->readBuf);
   QUEUE_INIT(&conn->q);
+  QUEUE_INIT(&conn->pendq);
   conn->hostThrd = pThrd;
   conn->status = ConnNormal;
   conn->broken = 0;
@@ -644,6 +641,8 @@ static void cliDestroyConn(SCliConn* conn, bool clear) {
   tTrace("%s conn %p remove from conn pool", CONN_GET_INST_LABEL(conn), conn);
   QUEUE_REMOVE(&conn->q);
   QUEUE_INIT(&conn->q);
+  QUEUE_REMOVE(&conn->pendq);
+  QUEUE_INIT(&conn->pendq);
   transRemoveExHandle(transGetRefMgt(), conn->refId);
   conn->refId = -1;
 
@@ -678,6 +677,7 @@ static void cliDestroy(uv_handle_t* handle) {
     conn->timer = NULL;
   }
 
+  QUEUE_REMOVE(&conn->pendq);
   transRemoveExHandle(transGetRefMgt(), conn->refId);
   taosMemoryFree(conn->ip);
   taosMemoryFree(conn->stream);
@@ -691,18 +691,20 @@ static void cliDestroy(uv_handle_t* handle) {
 }
 static bool cliHandleNoResp(SCliConn* conn) {
   bool res = false;
-  if (!transQueueEmpty(&conn->cliMsgs)) {
+  // one write may carry several no-resp msgs, release all of them
+  while (!transQueueEmpty(&conn->cliMsgs)) {
     SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, 0);
-    if (REQUEST_NO_RESP(&pMsg->msg)) {
-      transQueuePop(&conn->cliMsgs);
-      destroyCmsg(pMsg);
-      res = true;
+    if (pMsg->sent == 0 || !REQUEST_NO_RESP(&pMsg->msg)) {
+      break;
     }
-    if (res == true) {
-      if (cliMaySendCachedMsg(conn) == false) {
-        SCliThrd* thrd = conn->hostThrd;
-        addConnToPool(thrd->pool, conn);
-      }
+    transQueuePop(&conn->cliMsgs);
+    destroyCmsg(pMsg);
+    res = true;
+  }
+  if (res == true) {
+    if (cliMaySendCachedMsg(conn) == false) {
+      SCliThrd* thrd = conn->hostThrd;
+      addConnToPool(thrd->pool, conn);
     }
   }
   return res;
@@ -710,6 +712,7 @@ static bool cliHandleNoResp(SCliConn* conn) {
 static void cliSendCb(uv_write_t* req, int status) {
   SCliConn* pConn = transReqQueueRemove(req);
   if (pConn == NULL) return;
+  pConn->writing = false;
 
   if (status == 0) {
     tTrace("%s conn %p data already was written out", CONN_GET_INST_LABEL(pConn), pConn);
@@ -722,14 +725,11 @@ static void cliSendCb(uv_write_t* req, int status) {
     tTrace("%s conn %p no resp required", CONN_GET_INST_LABEL(pConn), pConn);
     return;
   }
+  cliMaySendCachedMsg(pConn);
   uv_read_start((uv_stream_t*)pConn->stream, cliAllocRecvBufferCb, cliRecvCb);
 }
 
-void cliSend(SCliConn* pConn) {
-  assert(!transQueueEmpty(&pConn->cliMsgs));
-
-  SCliMsg* pCliMsg = NULL;
-  CONN_GET_NEXT_SENDMSG(pConn);
+static void cliPrepareSendData(SCliConn* pConn, SCliMsg* pCliMsg, uv_buf_t* wb) {
   pCliMsg->sent = 1;
 
   STransConnCtx* pCtx = pCliMsg->ctx;
@@ -764,25 +764,117 @@ void cliSend(SCliConn* pConn) {
   }
 
   if (pTransInst->startTimer != NULL && pTransInst->startTimer(0, pMsg->msgType)) {
-    uv_timer_t* timer = taosArrayGetSize(pThrd->timerList) > 0 ? *(uv_timer_t**)taosArrayPop(pThrd->timerList) : NULL;
-    if (timer == NULL) {
-      tDebug("no avaiable timer, create");
-      timer = taosMemoryCalloc(1, sizeof(uv_timer_t));
-      uv_timer_init(pThrd->loop, timer);
+    if (pConn->timer == NULL) {
+      uv_timer_t* timer =
+          taosArrayGetSize(pThrd->timerList) > 0 ? *(uv_timer_t**)taosArrayPop(pThrd->timerList) : NULL;
+      if (timer == NULL) {
+        tDebug("no avaiable timer, create");
+        timer = taosMemoryCalloc(1, sizeof(uv_timer_t));
+        uv_timer_init(pThrd->loop, timer);
+      }
+      timer->data = pConn;
+      pConn->timer = timer;
     }
-    timer->data = pConn;
-    pConn->timer = timer;
 
     tGTrace("%s conn %p start timer for msg:%s", CONN_GET_INST_LABEL(pConn), pConn, TMSG_INFO(pMsg->msgType));
     uv_timer_start((uv_timer_t*)pConn->timer, cliReadTimeoutCb, TRANS_READ_TIMEOUT, 0);
   }
 
-  uv_buf_t    wb = uv_buf_init((char*)pHead, msgLen);
+  *wb = uv_buf_init((char*)pHead, msgLen);
+}
+
+void cliSend(SCliConn* pConn) {
+  assert(!transQueueEmpty(&pConn->cliMsgs));
+  if (pConn->writing) {
+    // cliSendCb picks up whatever is queued meanwhile
+    return;
+  }
+
+  // gather all unsent msgs of the conn into one vectored write
+  uv_buf_t wb[TRANS_WRITE_BATCH_SIZE];
+  int32_t  nBuf = 0;
+  for (int i = 0; i < transQueueSize(&pConn->cliMsgs) && nBuf < TRANS_WRITE_BATCH_SIZE; i++) {
+    SCliMsg* pCliMsg = transQueueGet(&pConn->cliMsgs, i);
+    if (pCliMsg->sent == 1) {
+      continue;
+    }
+    cliPrepareSendData(pConn, pCliMsg, &wb[nBuf++]);
+  }
+  if (nBuf == 0) {
+    return;
+  }
+
+  pConn->writing = true;
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
-  uv_write(req, (uv_stream_t*)pConn->stream, &wb, 1, cliSendCb);
-  return;
-_RETURN:
-  return;
+  uv_write(req, (uv_stream_t*)pConn->stream, wb, nBuf, cliSendCb);
+}
+
+static void cliPendSend(SCliThrd* pThrd, SCliConn* pConn) {
+  if (QUEUE_IS_EMPTY(&pConn->pendq)) {
+    QUEUE_PUSH(&pThrd->pendConns, &pConn->pendq);
+  }
+}
+static void cliFlushPendConns(SCliThrd* pThrd) {
+  while (!QUEUE_IS_EMPTY(&pThrd->pendConns)) {
+    queue* h = QUEUE_HEAD(&pThrd->pendConns);
+    QUEUE_REMOVE(h);
+    QUEUE_INIT(h);
+
+    SCliConn* conn = QUEUE_DATA(h, SCliConn, pendq);
+    if (transQueueEmpty(&conn->cliMsgs) || uv_is_closing((uv_handle_t*)conn->stream)) {
+      continue;
+    }
+    cliSend(conn);
+  }
+}
+static void cliMayFlushPendConns(SCliThrd* pThrd) {
+  if (QUEUE_IS_EMPTY(&pThrd->pendConns)) {
+    return;
+  }
+  STrans* pTransInst = pThrd->pTransInst;
+  if (pTransInst->batchDelay <= 0 || pThrd->quit) {
+    cliFlushPendConns(pThrd);
+  } else if (!uv_is_active((uv_handle_t*)pThrd->pendTimer)) {
+    uv_timer_start(pThrd->pendTimer, cliPendTimeoutCb, pTransInst->batchDelay, 0);
+  }
+}
+static void cliPendTimeoutCb(uv_timer_t* handle) {
+  SCliThrd* pThrd = handle->data;
+  cliFlushPendConns(pThrd);
+}
+// a no-resp msg may ride on a conn that already carries deferred no-resp msgs to the same ep,
+// instead of taking another conn out of the pool while that one is busy
+static SCliConn* cliGetPendConn(SCliMsg* pMsg, SCliThrd* pThrd) {
+  if (pMsg->msg.info.handle != 0 || !REQUEST_NO_RESP(&pMsg->msg)) {
+    return NULL;
+  }
+  STransConnCtx* pCtx = pMsg->ctx;
+  char*          ip = EPSET_GET_INUSE_IP(&pCtx->epSet);
+  uint32_t       port = EPSET_GET_INUSE_PORT(&pCtx->epSet);
+
+  queue* h = NULL;
+  QUEUE_FOREACH(h, &pThrd->pendConns) {
+    SCliConn* conn = QUEUE_DATA(h, SCliConn, pendq);
+    if (conn->port != port || conn->ip == NULL || strcmp(conn->ip, ip) != 0) {
+      continue;
+    }
+    if (!CONN_NO_PERSIST_BY_APP(conn) || transQueueSize(&conn->cliMsgs) >= TRANS_WRITE_BATCH_SIZE) {
+      continue;
+    }
+    bool noResp = true;
+    for (int i = 0; i < transQueueSize(&conn->cliMsgs); i++) {
+      SCliMsg* cmsg = transQueueGet(&conn->cliMsgs, i);
+      if (!REQUEST_NO_RESP(&cmsg->msg)) {
+        noResp = false;
+        break;
+      }
+    }
+    if (noResp) {
+      tTrace("%s conn %p shared by deferred no-resp msgs", CONN_GET_INST_LABEL(conn), conn);
+      return conn;
+    }
+  }
+  return NULL;
 }
 
 void cliConnCb(uv_connect_t* req, int status) {
@@ -923,7 +1015,10 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
   }
 
   bool      ignore = false;
-  SCliConn* conn = cliGetConn(pMsg, pThrd, &ignore);
+  SCliConn* conn = cliGetPendConn(pMsg, pThrd);
+  if (conn == NULL) {
+    conn = cliGetConn(pMsg, pThrd, &ignore);
+  }
   if (ignore == true) {
     // persist conn already release by server
     STransMsg resp;
@@ -936,7 +1031,7 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
   if (conn != NULL) {
     transCtxMerge(&conn->ctx, &pCtx->appCtx);
     transQueuePush(&conn->cliMsgs, pMsg);
-    cliSend(conn);
+    cliPendSend(pThrd, conn);
   } else {
     conn = cliCreateConn(pThrd);
 
@@ -1000,6 +1095,7 @@ static void cliAsyncCb(uv_async_t* handle) {
   if (count >= 2) {
     tTrace("cli process batch size:%d", count);
   }
+  cliMayFlushPendConns(pThrd);
   // if (!uv_is_active((uv_handle_t*)pThrd->prepare)) uv_prepare_start(pThrd->prepare, cliPrepareCb);
 
   if (pThrd->stopMsg != NULL) cliHandleQuit(pThrd->stopMsg, pThrd);
@@ -1031,6 +1127,7 @@ static void cliPrepareCb(uv_prepare_t* handle) {
       count++;
     }
   }
+  cliMayFlushPendConns(thrd);
   tTrace("prepare work end");
   if (thrd->stopMsg != NULL) cliHandleQuit(thrd->stopMsg, thrd);
 }
@@ -1158,6 +1255,11 @@ static SCliThrd* createThrdObj() {
   pThrd->prepare->data = pThrd;
   // uv_prepare_start(pThrd->prepare, cliPrepareCb);
 
+  QUEUE_INIT(&pThrd->pendConns);
+  pThrd->pendTimer = taosMemoryCalloc(1, sizeof(uv_timer_t));
+  uv_timer_init(pThrd->loop, pThrd->pendTimer);
+  pThrd->pendTimer->data = pThrd;
+
   int32_t timerSize = 512;
   pThrd->timerList = taosArrayInit(timerSize, sizeof(void*));
   for (int i = 0; i < timerSize; i++) {
@@ -1193,6 +1295,7 @@ static void destroyThrdObj(SCliThrd* pThrd) {
     taosMemoryFree(timer);
   }
   taosArrayDestroy(pThrd->timerList);
+  taosMemoryFree(pThrd->pendTimer);
   taosMemoryFree(pThrd->prepare);
   taosMemoryFree(pThrd->loop);
   taosMemoryFree(pThrd);
@@ -1234,6 +1337,8 @@ static FORCE_INLINE void doDelayTask(void* param) {
   taosMemoryFree(arg);
 
   cliHandleReq(pMsg, pThrd);
+  // the retry runs from the delay timer, not from an async batch that flushes the deferred sends afterwards
+  cliMayFlushPendConns(pThrd);
 }
 
 static void doCloseIdleConn(void* param) {
@@ -92,6 +92,7 @@ int transInitBuffer(SConnBuffer* buf) {
   buf->len = 0;
   buf->total = 0;
   buf->invalid = 0;
+  buf->offset = 0;
   return 0;
 }
 int transDestroyBuffer(SConnBuffer* p) {
@@ -110,6 +111,7 @@ int transClearBuffer(SConnBuffer* buf) {
   p->len = 0;
   p->total = 0;
   p->invalid = 0;
+  p->offset = 0;
   return 0;
 }
 
@@ -123,7 +125,7 @@ int transDumpFromBuffer(SConnBuffer* connBuf, char** buf) {
   int total = connBuf->total;
   if (total >= HEADSIZE && !p->invalid) {
     *buf = taosMemoryCalloc(1, total);
-    memcpy(*buf, p->buf, total);
+    memcpy(*buf, p->buf + p->offset, total);
     transResetBuffer(connBuf);
   } else {
     total = -1;
@@ -133,16 +135,17 @@ int transDumpFromBuffer(SConnBuffer* connBuf, char** buf) {
 
 int transResetBuffer(SConnBuffer* connBuf) {
   SConnBuffer* p = connBuf;
-  if (p->total < p->len) {
-    int left = p->len - p->total;
-    memmove(p->buf, p->buf + p->total, left);
+  // several packets may arrive in one read, only skip over the consumed one here and
+  // leave the compaction to transAllocBuffer, so that the rest is not moved once per packet
+  if (p->total < p->len - p->offset) {
+    p->offset += p->total;
     p->left = -1;
     p->total = 0;
-    p->len = left;
-  } else if (p->total == p->len) {
+  } else if (p->total == p->len - p->offset) {
     p->left = -1;
     p->total = 0;
     p->len = 0;
+    p->offset = 0;
   } else {
     assert(0);
   }
@@ -156,6 +159,11 @@ int transAllocBuffer(SConnBuffer* connBuf, uv_buf_t* uvBuf) {
    * info--->|
    */
   SConnBuffer* p = connBuf;
+  if (p->offset > 0) {
+    memmove(p->buf, p->buf + p->offset, p->len - p->offset);
+    p->len -= p->offset;
+    p->offset = 0;
+  }
   uvBuf->base = p->buf + p->len;
   if (p->left == -1) {
     uvBuf->len = p->cap - p->len;
@@ -174,16 +182,17 @@ int transAllocBuffer(SConnBuffer* connBuf, uv_buf_t* uvBuf) {
 // check whether already read complete
 bool transReadComplete(SConnBuffer* connBuf) {
   SConnBuffer* p = connBuf;
-  if (p->len >= sizeof(STransMsgHead)) {
+  int          len = p->len - p->offset;
+  if (len >= sizeof(STransMsgHead)) {
     if (p->left == -1) {
       STransMsgHead head;
-      memcpy((char*)&head, connBuf->buf, sizeof(head));
+      memcpy((char*)&head, connBuf->buf + p->offset, sizeof(head));
       int32_t msgLen = (int32_t)htonl(head.msgLen);
       p->total = msgLen;
       p->invalid = TRANS_NOVALID_PACKET(htonl(head.magicNum));
     }
-    if (p->total >= p->len) {
-      p->left = p->total - p->len;
+    if (p->total >= len) {
+      p->left = p->total - len;
     } else {
       p->left = 0;
     }
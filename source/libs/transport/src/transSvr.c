@@ -39,6 +39,7 @@ typedef struct SSvrConn {
   void*       ahandle;     //
   void*       hostThrd;
   STransQueue srvMsgs;
+  int32_t     nSending;  // msgs at the head of srvMsgs covered by the write in flight
 
   SSvrRegArg regArg;
   bool       broken;  // conn broken;
@@ -323,11 +324,16 @@ void uvOnSendCb(uv_write_t* req, int status) {
   SSvrConn* conn = transReqQueueRemove(req);
   if (conn == NULL) return;
 
+  int32_t nSent = conn->nSending;
+  conn->nSending = 0;
   if (status == 0) {
-    tTrace("conn %p data already was written on stream", conn);
+    tTrace("conn %p data already was written on stream, msgs:%d", conn, nSent);
     if (!transQueueEmpty(&conn->srvMsgs)) {
-      SSvrMsg* msg = transQueuePop(&conn->srvMsgs);
-      destroySmsg(msg);
+      SSvrMsg* msg = NULL;
+      for (int32_t i = 0; i < nSent && !transQueueEmpty(&conn->srvMsgs); i++) {
+        msg = transQueuePop(&conn->srvMsgs);
+        destroySmsg(msg);
+      }
       // send cached data
       if (!transQueueEmpty(&conn->srvMsgs)) {
         msg = (SSvrMsg*)transQueueGet(&conn->srvMsgs, 0);
@@ -419,12 +425,26 @@ static FORCE_INLINE void uvStartSendRespImpl(SSvrMsg* smsg) {
     return;
   }
 
-  uv_buf_t wb;
-  uvPrepareSendData(smsg, &wb);
+  // smsg is the head of srvMsgs, gather it and the resps queued behind it into one
+  // vectored write, stop at a queued register msg since it is handled once the write is done
+  uv_buf_t wb[TRANS_WRITE_BATCH_SIZE];
+  int32_t  nBuf = 0;
+  int32_t  size = transQueueSize(&pConn->srvMsgs);
+  for (int32_t i = 0; i < size && nBuf < TRANS_WRITE_BATCH_SIZE; i++) {
+    SSvrMsg* pMsg = transQueueGet(&pConn->srvMsgs, i);
+    if (pMsg->type == Register && nBuf > 0) {
+      break;
+    }
+    uvPrepareSendData(pMsg, &wb[nBuf++]);
+  }
+  if (nBuf == 0) {
+    return;
+  }
+  pConn->nSending = nBuf;
 
   transRefSrvHandle(pConn);
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
-  uv_write(req, (uv_stream_t*)pConn->pTcp, &wb, 1, uvOnSendCb);
+  uv_write(req, (uv_stream_t*)pConn->pTcp, wb, nBuf, uvOnSendCb);
 }
 static void uvStartSendResp(SSvrMsg* smsg) {
   // impl
@@ -38,8 +38,10 @@ static void processContinueSend(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReleaseHandleCb(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processRegisterFailure(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processRetryReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 // client process;
 static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processRetryResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 class Client {
  public:
   void Init(int nThread) {
@@ -66,6 +68,12 @@ class Client {
     rpcInit_.cfp = cb;
     this->transCli = rpcOpen(&rpcInit_);
   }
+  void SetRetry(CB cb, RpcRfp rfp) {
+    rpcClose(this->transCli);
+    rpcInit_.cfp = cb;
+    rpcInit_.rfp = rfp;
+    this->transCli = rpcOpen(&rpcInit_);
+  }
   void Stop() {
     rpcClose(this->transCli);
     this->transCli = NULL;
@@ -80,6 +88,13 @@ class Client {
     SemWait();
     *resp = this->resp;
   }
+  void Send(SRpcMsg *req) {
+    SEpSet epSet = {0};
+    epSet.inUse = 0;
+    addEpIntoEpSet(&epSet, "127.0.0.1", 7000);
+
+    rpcSendRequest(this->transCli, &epSet, req, NULL);
+  }
   void SendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) {
     if (req->info.handle != NULL) {
       rpcReleaseHandle(req->info.handle, TAOS_CONN_CLIENT);
@@ -157,6 +172,22 @@ static void processReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   rpcSendResponse(&rpcMsg);
 }
 
+// the first req is answered with a retryable error, the rest as usual
+static int32_t retryReqCnt = 0;
+
+static void processRetryReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  SRpcMsg rpcMsg = {0};
+  rpcMsg.info = pMsg->info;
+  if (atomic_fetch_add_32(&retryReqCnt, 1) == 0) {
+    rpcMsg.code = TSDB_CODE_SYN_NOT_LEADER;
+  } else {
+    rpcMsg.pCont = rpcMallocCont(100);
+    rpcMsg.contLen = 100;
+    rpcMsg.code = 0;
+  }
+  rpcSendResponse(&rpcMsg);
+}
+
 static void processContinueSend(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   for (int i = 0; i < 10; i++) {
     SRpcMsg rpcMsg = {0};
@@ -203,6 +234,16 @@ static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   tDebug("received resp");
 }
 
+static int32_t retryRespCnt = 0;
+static int32_t retryRespCode = -1;
+
+static void processRetryResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  atomic_store_32(&retryRespCode, pMsg->code);
+  atomic_add_fetch_32(&retryRespCnt, 1);
+  rpcFreeCont(pMsg->pCont);
+}
+static bool retryNotLeader(int32_t code, tmsg_t msgType) { return code == TSDB_CODE_SYN_NOT_LEADER; }
+
 static void initEnv() {
   dDebugFlag = 143;
   vDebugFlag = 0;
@@ -243,6 +284,8 @@ class TransObj {
     //
     cli->Restart(cb);
   }
+  void SetCliRetry(CB cb, RpcRfp rfp) { cli->SetRetry(cb, rfp); }
+  void SetSrvSend(CB cb) { srv->SetSrvSend(cb); }
   void StopSrv() {
     //
     srv->Stop();
@@ -258,6 +301,7 @@ class TransObj {
     cli->Stop();
   }
   void cliSendAndRecv(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecv(req, resp); }
+  void cliSend(SRpcMsg *req) { cli->Send(req); }
   void cliSendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecvNoHandle(req, resp); }
 
   ~TransObj() {
@@ -498,3 +542,21 @@ TEST_F(TransEnv, noResp) {
 
   // no resp
 }
+TEST_F(TransEnv, retryReq) {
+  tr->SetSrvSend(processRetryReq);
+  tr->SetCliRetry(processRetryResp, retryNotLeader);
+
+  SRpcMsg req = {0};
+  req.msgType = 1;
+  req.pCont = rpcMallocCont(10);
+  req.contLen = 10;
+  tr->cliSend(&req);
+
+  // the retry is resent from the delay queue without any other msg to wake the client thread up
+  for (int i = 0; i < 100 && atomic_load_32(&retryRespCnt) == 0; i++) {
+    taosMsleep(50);
+  }
+  EXPECT_EQ(atomic_load_32(&retryRespCnt), 1);
+  EXPECT_EQ(atomic_load_32(&retryRespCode), 0);
+  EXPECT_EQ(atomic_load_32(&retryReqCnt), 2);
+}
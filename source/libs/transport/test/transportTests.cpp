@@ -232,4 +232,62 @@ int32_t cloneVal(void *src, void **dst) {
 //  skey = (char *)transCtxDumpVal(ctx, 2);
 //  EXPECT_EQ(0, strcmp(skey, val.c_str()));
 //}
+static int32_t fillPacket(char *buf, int32_t contLen, int8_t tag) {
+  int32_t        msgLen = transMsgLenFromCont(contLen);
+  STransMsgHead *pHead = (STransMsgHead *)buf;
+  memset(buf, tag, msgLen);
+  pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
+  pHead->magicNum = htonl(TRANS_MAGIC_NUM);
+  return msgLen;
+}
+
+TEST(TransBufferTest, multiPacketOneRead) {
+  SConnBuffer connBuf;
+  transInitBuffer(&connBuf);
+
+  // three packets and the head of a fourth arrive in one read
+  int32_t  contLens[] = {16, 1, 100, 40};
+  int32_t  msgLens[4] = {0};
+  uv_buf_t uvBuf;
+  transAllocBuffer(&connBuf, &uvBuf);
+
+  char   *data = (char *)taosMemoryCalloc(1, 1024);
+  int32_t len = 0;
+  for (int i = 0; i < 4; i++) {
+    msgLens[i] = fillPacket(data + len, contLens[i], i + 1);
+    len += msgLens[i];
+  }
+  int32_t nread = len - msgLens[3] + sizeof(STransMsgHead) + 8;
+  ASSERT_LE(nread, (int32_t)uvBuf.len);
+  memcpy(uvBuf.base, data, nread);
+  connBuf.len += nread;
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(transReadComplete(&connBuf));
+    char   *pkt = NULL;
+    int32_t total = transDumpFromBuffer(&connBuf, &pkt);
+    ASSERT_EQ(total, msgLens[i]);
+    EXPECT_EQ(pkt[total - 1], i + 1);
+    taosMemoryFree(pkt);
+  }
+  ASSERT_FALSE(transReadComplete(&connBuf));
+
+  // the rest of the fourth packet
+  transAllocBuffer(&connBuf, &uvBuf);
+  int32_t rest = len - nread;
+  ASSERT_EQ((int32_t)uvBuf.len, rest);
+  memcpy(uvBuf.base, data + nread, rest);
+  connBuf.len += rest;
+
+  ASSERT_TRUE(transReadComplete(&connBuf));
+  char   *pkt = NULL;
+  int32_t total = transDumpFromBuffer(&connBuf, &pkt);
+  ASSERT_EQ(total, msgLens[3]);
+  EXPECT_EQ(pkt[total - 1], 4);
+  taosMemoryFree(pkt);
+  EXPECT_EQ(connBuf.len, 0);
+
+  taosMemoryFree(data);
+  transDestroyBuffer(&connBuf);
+}
 #endif
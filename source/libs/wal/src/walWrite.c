@@ -391,9 +391,9 @@ END:
 
 static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
   SWalIdxEntry entry = {.ver = ver, .offset = offset};
-  int64_t      idxOffset = taosLSeekFile(pWal->pIdxFile, 0, SEEK_END);
+  // the index file is opened for append, its offset follows from the version
   wDebug("vgId:%d, write index, index:%" PRId64 ", offset:%" PRId64 ", at %" PRId64, pWal->cfg.vgId, ver, offset,
-         idxOffset);
+         walGetVerIdxOffset(pWal, ver));
   int64_t size = taosWriteFile(pWal->pIdxFile, &entry, sizeof(SWalIdxEntry));
   if (size != sizeof(SWalIdxEntry)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
@@ -423,16 +423,9 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
 
   wDebug("vgId:%d, wal write log %ld, msgType: %s", pWal->cfg.vgId, index, TMSG_INFO(msgType));
 
-  if (taosWriteFile(pWal->pLogFile, &pWal->writeHead, sizeof(SWalCkHead)) != sizeof(SWalCkHead)) {
-    // TODO ftruncate
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
-           strerror(errno));
-    code = -1;
-    goto END;
-  }
-
-  if (taosWriteFile(pWal->pLogFile, (char *)body, bodyLen) != bodyLen) {
+  // head and body in one syscall
+  TdFileVec aVec[2] = {{.buf = &pWal->writeHead, .len = sizeof(SWalCkHead)}, {.buf = body, .len = bodyLen}};
+  if (taosWritevFile(pWal->pLogFile, aVec, 2) != sizeof(SWalCkHead) + bodyLen) {
     // TODO ftruncate
     terrno = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
@@ -490,6 +483,109 @@ int64_t walAppendLog(SWal *pWal, tmsg_t msgType, SWalSyncInfo syncMeta, const vo
   return index;
 }
 
+// group commit of a batch of logs: all heads and bodies go to the log file with one vectored write and all index
+// entries with one write, so the caller pays one fsync and a couple of syscalls for the whole batch
+static int32_t walWriteBatchImpl(SWal *pWal, int64_t index, const SWalAppendItem *aItem, int32_t nItem) {
+  int64_t       offset = walGetCurFileOffset(pWal);
+  int64_t       size = 0;
+  SWalCkHead   *aHead = taosMemoryMalloc(sizeof(SWalCkHead) * nItem);
+  SWalIdxEntry *aIdx = taosMemoryMalloc(sizeof(SWalIdxEntry) * nItem);
+  TdFileVec    *aVec = taosMemoryMalloc(sizeof(TdFileVec) * nItem * 2);
+
+  if (aHead == NULL || aIdx == NULL || aVec == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto END;
+  }
+
+  for (int32_t i = 0; i < nItem; i++) {
+    SWalCkHead *pHead = &aHead[i];
+
+    *pHead = pWal->writeHead;
+    pHead->head.version = index + i;
+    pHead->head.bodyLen = aItem[i].bodyLen;
+    pHead->head.msgType = aItem[i].msgType;
+    pHead->head.ingestTs = 0;
+    pHead->head.syncMeta = aItem[i].syncMeta;
+    pHead->cksumHead = walCalcHeadCksum(pHead);
+    pHead->cksumBody = walCalcBodyCksum(aItem[i].body, aItem[i].bodyLen);
+
+    aIdx[i] = (SWalIdxEntry){.ver = index + i, .offset = offset + size};
+    aVec[2 * i] = (TdFileVec){.buf = pHead, .len = sizeof(SWalCkHead)};
+    aVec[2 * i + 1] = (TdFileVec){.buf = aItem[i].body, .len = aItem[i].bodyLen};
+    size += sizeof(SWalCkHead) + aItem[i].bodyLen;
+  }
+
+  wDebug("vgId:%d, wal write log batch, index:%" PRId64 "-%" PRId64 ", size:%" PRId64, pWal->cfg.vgId, index,
+         index + nItem - 1, size);
+
+  if (taosWritevFile(pWal->pLogFile, aVec, nItem * 2) != size) {
+    // TODO ftruncate
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
+           strerror(errno));
+    goto END;
+  }
+
+  if (taosWriteFile(pWal->pIdxFile, aIdx, sizeof(SWalIdxEntry) * nItem) != sizeof(SWalIdxEntry) * nItem) {
+    // TODO ftruncate
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".idx, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
+           strerror(errno));
+    goto END;
+  }
+
+  // set status
+  if (pWal->vers.firstVer == -1) pWal->vers.firstVer = index;
+  pWal->vers.lastVer = index + nItem - 1;
+  pWal->totSize += size;
+  if (walGetCurFileInfo(pWal)->firstVer == -1) {
+    walGetCurFileInfo(pWal)->firstVer = index;
+  }
+  walGetCurFileInfo(pWal)->lastVer = index + nItem - 1;
+  walGetCurFileInfo(pWal)->fileSize += size;
+
+  taosMemoryFree(aHead);
+  taosMemoryFree(aIdx);
+  taosMemoryFree(aVec);
+  return 0;
+
+END:
+  taosMemoryFree(aHead);
+  taosMemoryFree(aIdx);
+  taosMemoryFree(aVec);
+  return -1;
+}
+
+int64_t walAppendLogBatch(SWal *pWal, const SWalAppendItem *aItem, int32_t nItem) {
+  if (nItem <= 0) return pWal->vers.lastVer + 1;
+
+  taosThreadMutexLock(&pWal->mutex);
+
+  int64_t index = pWal->vers.lastVer + 1;
+
+  if (walCheckAndRoll(pWal) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
+  if (pWal->pLogFile == NULL || pWal->pIdxFile == NULL || pWal->writeCur < 0) {
+    if (walInitWriteFile(pWal) < 0) {
+      taosThreadMutexUnlock(&pWal->mutex);
+      return -1;
+    }
+  }
+
+  ASSERT(pWal->pLogFile != NULL && pWal->pIdxFile != NULL && pWal->writeCur >= 0);
+
+  if (walWriteBatchImpl(pWal, index, aItem, nItem) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
+  taosThreadMutexUnlock(&pWal->mutex);
+  return index;
+}
+
 int32_t walWriteWithSyncInfo(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body,
                              int32_t bodyLen) {
   int32_t code = 0;
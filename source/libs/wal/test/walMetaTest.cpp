@@ -328,6 +328,46 @@ TEST_F(WalKeepEnv, readHandleRead) {
   walCloseReader(pRead);
 }
 
+TEST_F(WalKeepEnv, appendBatchRead) {
+  walResetEnv();
+  int         code;
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+
+  SWalSyncInfo   syncMeta = {.isWeek = -1, .seqNum = UINT64_MAX, .term = UINT64_MAX};
+  SWalAppendItem items[10];
+  char           bodies[100][100];
+  int            i;
+  for (i = 0; i < 100; i++) {
+    sprintf(bodies[i], "%s-%d", ranStr, i);
+  }
+  for (i = 0; i < 100; i += 10) {
+    for (int j = 0; j < 10; j++) {
+      items[j].msgType = 0;
+      items[j].syncMeta = syncMeta;
+      items[j].body = bodies[i + j];
+      items[j].bodyLen = strlen(bodies[i + j]);
+    }
+    int64_t index = walAppendLogBatch(pWal, items, 10);
+    ASSERT_EQ(index, i);
+    ASSERT_EQ(pWal->vers.lastVer, i + 9);
+  }
+  for (int i = 0; i < 1000; i++) {
+    int ver = taosRand() % 100;
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    ASSERT_EQ(pRead->curVersion, ver + 1);
+    int len = strlen(bodies[ver]);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+    for (int j = 0; j < len; j++) {
+      EXPECT_EQ(bodies[ver][j], pRead->pHead->head.body[j]);
+    }
+  }
+  walCloseReader(pRead);
+}
+
 TEST_F(WalRetentionEnv, repairMeta1) {
   walResetEnv();
   int code;
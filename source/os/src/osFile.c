@@ -32,6 +32,7 @@
 #include <sys/sendfile.h>
 #endif
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #define LINUX_FILE_NO_TEXT_OPTION 0
 #define O_TEXT                    LINUX_FILE_NO_TEXT_OPTION
@@ -490,6 +491,60 @@ int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count) {
   return count;
 }
 
+#define _WRITEV_STEP_ 64
+
+int64_t taosWritevFile(TdFilePtr pFile, const TdFileVec *aVec, int32_t nVec) {
+  if (pFile == NULL) {
+    return 0;
+  }
+#if FILE_WITH_LOCK
+  taosThreadRwlockWrlock(&(pFile->rwlock));
+#endif
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+
+  int64_t count = 0;
+  int32_t iVec = 0;
+  int64_t vOffset = 0;  // bytes of aVec[iVec] already written
+
+  while (iVec < nVec) {
+#ifdef WINDOWS
+    int64_t nwritten = write(pFile->fd, (char *)aVec[iVec].buf + vOffset, (uint32_t)(aVec[iVec].len - vOffset));
+#else
+    struct iovec iov[_WRITEV_STEP_];
+    int32_t      nIov = 0;
+    for (int32_t i = iVec; i < nVec && nIov < _WRITEV_STEP_; i++, nIov++) {
+      int64_t skip = (i == iVec) ? vOffset : 0;
+      iov[nIov].iov_base = (char *)aVec[i].buf + skip;
+      iov[nIov].iov_len = aVec[i].len - skip;
+    }
+    int64_t nwritten = writev(pFile->fd, iov, nIov);
+#endif
+    if (nwritten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+#if FILE_WITH_LOCK
+      taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+      return -1;
+    }
+    count += nwritten;
+
+    // skip the buffers fully written, a short write resumes in the middle of one
+    while (iVec < nVec && nwritten >= aVec[iVec].len - vOffset) {
+      nwritten -= aVec[iVec].len - vOffset;
+      vOffset = 0;
+      iVec++;
+    }
+    vOffset += nwritten;
+  }
+
+#if FILE_WITH_LOCK
+  taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+  return count;
+}
+
 int64_t taosLSeekFile(TdFilePtr pFile, int64_t offset, int32_t whence) {
 #if FILE_WITH_LOCK
   taosThreadRwlockRdlock(&(pFile->rwlock));
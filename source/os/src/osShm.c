@@ -54,7 +54,8 @@ int32_t taosCreateShm(SShm* pShm, int32_t key, int32_t shmsize) {
   }
 
   void* shmptr = shmat(shmid, NULL, 0);
-  if (shmptr == NULL) {
+  if (shmptr == NULL || shmptr == (void*)-1) {
+    shmctl(shmid, IPC_RMID, NULL);
     return -1;
   }
 
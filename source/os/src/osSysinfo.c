@@ -441,6 +441,20 @@ int32_t taosGetCpuCores(float *numOfCores) {
 #endif
 }
 
+int32_t taosGetCpuInstructions(char *sse42, char *avx2, char *avx512) {
+  *sse42 = 0;
+  *avx2 = 0;
+  *avx512 = 0;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  // __builtin_cpu_supports() also checks the OS saves the ymm/zmm state
+  __builtin_cpu_init();
+  *sse42 = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+  *avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+  *avx512 = __builtin_cpu_supports("avx512f") ? 1 : 0;
+#endif
+  return 0;
+}
+
 void taosGetCpuUsage(double *cpu_system, double *cpu_engine) {
   static int64_t lastSysUsed = 0;
   static int64_t lastSysTotal = 0;
@@ -48,6 +48,12 @@
  */
 
 #define _DEFAULT_SOURCE
+// the intrinsic headers use malloc/free, so they must come before os.h poisons them
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TD_COMPRESS_X86_SIMD
+#include <immintrin.h>
+#endif
+
 #include "tcompression.h"
 #include "lz4.h"
 #include "tlog.h"
@@ -226,89 +232,223 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
   return opos;
 }
 
-int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
-  int32_t word_length = 0;
+/*
+ * Decompress Integer (Simple8B).
+ *   Each 64-bit word is unpacked into a buffer of int64 values with the running prefix sum applied, then narrowed to
+ *   the column type. The unpacking is done with the widest instruction set the CPU supports, see tsGetSimdLevel().
+ */
+static const char    tsSimple8bBits[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int32_t tsSimple8bElems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+static int8_t tsSimdLevel = -1;
+static int8_t tsSimdLevelMax = -1;
+
+static int8_t tsDetectSimdLevel() {
+  char sse42, avx2, avx512;
+
+  taosGetCpuInstructions(&sse42, &avx2, &avx512);
+  if (avx512) return TD_SIMD_AVX512;
+  if (avx2) return TD_SIMD_AVX2;
+  if (sse42) return TD_SIMD_SSE42;
+  return TD_SIMD_NONE;
+}
+
+int8_t tsGetSimdLevel() {
+  if (tsSimdLevel < 0) {
+    tsSimdLevelMax = tsDetectSimdLevel();
+    tsSimdLevel = tsSimdLevelMax;
+  }
+  return tsSimdLevel;
+}
+
+int8_t tsSetSimdLevel(int8_t level) {
+  tsGetSimdLevel();
+  tsSimdLevel = TMIN(TMAX(level, TD_SIMD_NONE), tsSimdLevelMax);
+  return tsSimdLevel;
+}
+
+static FORCE_INLINE int32_t tsDecompressINTStore(const int64_t *buf, int32_t n, char *const output, int32_t pos,
+                                                 const char type) {
   switch (type) {
     case TSDB_DATA_TYPE_BIGINT:
-      word_length = LONG_BYTES;
+      memcpy((int64_t *)output + pos, buf, n * LONG_BYTES);
       break;
     case TSDB_DATA_TYPE_INT:
-      word_length = INT_BYTES;
+      for (int32_t i = 0; i < n; i++) ((int32_t *)output)[pos + i] = (int32_t)buf[i];
       break;
     case TSDB_DATA_TYPE_SMALLINT:
-      word_length = SHORT_BYTES;
+      for (int32_t i = 0; i < n; i++) ((int16_t *)output)[pos + i] = (int16_t)buf[i];
       break;
     case TSDB_DATA_TYPE_TINYINT:
-      word_length = CHAR_BYTES;
+      for (int32_t i = 0; i < n; i++) ((int8_t *)output)[pos + i] = (int8_t)buf[i];
       break;
     default:
       uError("Invalid decompress integer type:%d", type);
       return -1;
   }
+  return 0;
+}
 
-  // If not compressed.
-  if (input[0] == 1) {
-    memcpy(output, input + 1, nelements * word_length);
-    return nelements * word_length;
-  }
+static int32_t tsDecompressINTScalar(const char *ip, const int32_t nelements, char *const output, const char type) {
+  int64_t buf[240];
+  int64_t prev_value = 0;
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+  for (int32_t count = 0; count < nelements; ip += LONG_BYTES) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
 
-  const char *ip = input + 1;
-  int32_t     count = 0;
-  int32_t     _pos = 0;
-  int64_t     prev_value = 0;
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t bit = tsSimple8bBits[selector];
+    int32_t n = TMIN(tsSimple8bElems[selector], nelements - count);
 
-  while (1) {
-    if (count == nelements) break;
+    for (int32_t i = 0; i < n; i++) {
+      uint64_t zigzag_value = (selector <= 1) ? 0 : ((w >> (4 + bit * i)) & INT64MASK(bit));
+      prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+      buf[i] = prev_value;
+    }
+
+    if (tsDecompressINTStore(buf, n, output, count, type) < 0) return -1;
+    count += n;
+  }
+  return 0;
+}
 
+#ifdef TD_COMPRESS_X86_SIMD
+__attribute__((target("avx2"))) static int32_t tsDecompressINTAvx2(const char *ip, const int32_t nelements,
+                                                                   char *const output, const char type) {
+  int64_t buf[240 + 4];
+  int64_t prev_value = 0;
+  __m256i zero = _mm256_setzero_si256();
+  __m256i one = _mm256_set1_epi64x(1);
+
+  for (int32_t count = 0; count < nelements; ip += LONG_BYTES) {
     uint64_t w = 0;
     memcpy(&w, ip, LONG_BYTES);
 
-    char    selector = (char)(w & INT64MASK(4));       // selector = 4
-    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
-    int32_t elems = selector_to_elems[(int32_t)selector];
-
-    for (int32_t i = 0; i < elems; i++) {
-      uint64_t zigzag_value;
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t bit = tsSimple8bBits[selector];
+    int32_t n = TMIN(tsSimple8bElems[selector], nelements - count);
 
-      if (selector == 0 || selector == 1) {
-        zigzag_value = 0;
-      } else {
-        zigzag_value = ((w >> (4 + bit * i)) & INT64MASK(bit));
+    if (selector <= 1) {
+      for (int32_t i = 0; i < n; i++) buf[i] = prev_value;
+    } else {
+      __m256i vw = _mm256_set1_epi64x((int64_t)w);
+      __m256i vmask = _mm256_set1_epi64x((int64_t)INT64MASK(bit));
+      __m256i vshift = _mm256_setr_epi64x(4, 4 + bit, 4 + bit * 2, 4 + bit * 3);
+      __m256i vstep = _mm256_set1_epi64x(bit * 4);
+      __m256i vprev = _mm256_set1_epi64x(prev_value);
+
+      // shifts past 63 yield zero, so the lanes beyond the word are harmless
+      for (int32_t i = 0; i < n; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_srlv_epi64(vw, vshift), vmask);
+        v = _mm256_xor_si256(_mm256_srli_epi64(v, 1), _mm256_sub_epi64(zero, _mm256_and_si256(v, one)));
+
+        // prefix sum over the 4 lanes
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x90), zero, 0x03));
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, 0x40), zero, 0x0F));
+        v = _mm256_add_epi64(v, vprev);
+
+        _mm256_storeu_si256((__m256i *)(buf + i), v);
+        vprev = _mm256_permute4x64_epi64(v, 0xFF);
+        vshift = _mm256_add_epi64(vshift, vstep);
       }
-      int64_t diff = ZIGZAG_DECODE(int64_t, zigzag_value);
-      int64_t curr_value = diff + prev_value;
-      prev_value = curr_value;
+      prev_value = buf[n - 1];
+    }
 
-      switch (type) {
-        case TSDB_DATA_TYPE_BIGINT:
-          *((int64_t *)output + _pos) = (int64_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_INT:
-          *((int32_t *)output + _pos) = (int32_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          *((int16_t *)output + _pos) = (int16_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_TINYINT:
-          *((int8_t *)output + _pos) = (int8_t)curr_value;
-          _pos++;
-          break;
-        default:
-          perror("Wrong integer types.\n");
-          return -1;
+    if (tsDecompressINTStore(buf, n, output, count, type) < 0) return -1;
+    count += n;
+  }
+  return 0;
+}
+
+__attribute__((target("avx512f"))) static int32_t tsDecompressINTAvx512(const char *ip, const int32_t nelements,
+                                                                        char *const output, const char type) {
+  int64_t buf[240 + 8];
+  int64_t prev_value = 0;
+  __m512i zero = _mm512_setzero_si512();
+  __m512i one = _mm512_set1_epi64(1);
+  __m512i last = _mm512_set1_epi64(7);
+
+  for (int32_t count = 0; count < nelements; ip += LONG_BYTES) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
+
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t bit = tsSimple8bBits[selector];
+    int32_t n = TMIN(tsSimple8bElems[selector], nelements - count);
+
+    if (selector <= 1) {
+      for (int32_t i = 0; i < n; i++) buf[i] = prev_value;
+    } else {
+      __m512i vw = _mm512_set1_epi64((int64_t)w);
+      __m512i vmask = _mm512_set1_epi64((int64_t)INT64MASK(bit));
+      __m512i vshift = _mm512_setr_epi64(4, 4 + bit, 4 + bit * 2, 4 + bit * 3, 4 + bit * 4, 4 + bit * 5, 4 + bit * 6,
+                                         4 + bit * 7);
+      __m512i vstep = _mm512_set1_epi64(bit * 8);
+      __m512i vprev = _mm512_set1_epi64(prev_value);
+
+      for (int32_t i = 0; i < n; i += 8) {
+        __m512i v = _mm512_and_si512(_mm512_srlv_epi64(vw, vshift), vmask);
+        v = _mm512_xor_si512(_mm512_srli_epi64(v, 1), _mm512_sub_epi64(zero, _mm512_and_si512(v, one)));
+
+        // prefix sum over the 8 lanes
+        v = _mm512_add_epi64(v, _mm512_alignr_epi64(v, zero, 7));
+        v = _mm512_add_epi64(v, _mm512_alignr_epi64(v, zero, 6));
+        v = _mm512_add_epi64(v, _mm512_alignr_epi64(v, zero, 4));
+        v = _mm512_add_epi64(v, vprev);
+
+        _mm512_storeu_si512((void *)(buf + i), v);
+        vprev = _mm512_permutexvar_epi64(last, v);
+        vshift = _mm512_add_epi64(vshift, vstep);
       }
-      count++;
-      if (count == nelements) break;
+      prev_value = buf[n - 1];
     }
-    ip += LONG_BYTES;
+
+    if (tsDecompressINTStore(buf, n, output, count, type) < 0) return -1;
+    count += n;
+  }
+  return 0;
+}
+#endif
+
+int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
+  int32_t word_length = 0;
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      word_length = LONG_BYTES;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      word_length = INT_BYTES;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      word_length = SHORT_BYTES;
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      word_length = CHAR_BYTES;
+      break;
+    default:
+      uError("Invalid decompress integer type:%d", type);
+      return -1;
+  }
+
+  // If not compressed.
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * word_length);
+    return nelements * word_length;
+  }
+
+  switch (tsGetSimdLevel()) {
+#ifdef TD_COMPRESS_X86_SIMD
+    case TD_SIMD_AVX512:
+      if (tsDecompressINTAvx512(input + 1, nelements, output, type) < 0) return -1;
+      break;
+    case TD_SIMD_AVX2:
+      if (tsDecompressINTAvx2(input + 1, nelements, output, type) < 0) return -1;
+      break;
+#endif
+    default:
+      if (tsDecompressINTScalar(input + 1, nelements, output, type) < 0) return -1;
+      break;
   }
 
   return nelements * word_length;
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tcompression.h"
+
+namespace {
+
+const int32_t nElems = 100000;
+
+// values of one column with deltas up to 2^range, restarted every 1000 rows
+// computed in unsigned arithmetic, the running sum is allowed to wrap around
+void genIntData(std::vector<int64_t> &data, int32_t range, uint32_t seed) {
+  uint64_t val = 0;
+  for (int32_t i = 0; i < (int32_t)data.size(); i++) {
+    uint64_t r = range ? ((((uint64_t)taosRandR(&seed)) << 31) | taosRandR(&seed)) % ((uint64_t)1 << range) : 0;
+    bool     neg = taosRandR(&seed) % 2;
+    uint64_t step = r >> 3;
+    if (neg) {
+      r = 0 - r;
+      step = 0 - step;
+    }
+    val = (i % 1000 == 0) ? r : val + step;
+    data[i] = (int64_t)val;
+  }
+}
+
+void narrow(const std::vector<int64_t> &data, int8_t type, std::vector<char> &buf) {
+  for (int32_t i = 0; i < (int32_t)data.size(); i++) {
+    switch (type) {
+      case TSDB_DATA_TYPE_BIGINT:
+        ((int64_t *)buf.data())[i] = data[i];
+        break;
+      case TSDB_DATA_TYPE_INT:
+        ((int32_t *)buf.data())[i] = (int32_t)data[i];
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        ((int16_t *)buf.data())[i] = (int16_t)data[i];
+        break;
+      default:
+        ((int8_t *)buf.data())[i] = (int8_t)data[i];
+        break;
+    }
+  }
+}
+
+template <typename F>
+double throughput(int64_t bytes, int32_t loops, F f) {
+  int64_t start = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; i++) f();
+  int64_t elapsed = TMAX(taosGetTimestampUs() - start, 1);
+  return (double)bytes * loops / elapsed;  // MB/s
+}
+
+}  // namespace
+
+TEST(utilTest, compressIntSimdRoundTrip) {
+  int8_t  types[] = {TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_TINYINT};
+  int32_t bytes[] = {LONG_BYTES, INT_BYTES, SHORT_BYTES, CHAR_BYTES};
+
+  std::vector<int64_t> data(nElems);
+  std::vector<char>    input(nElems * LONG_BYTES);
+  std::vector<char>    compressed(nElems * LONG_BYTES + COMP_OVERFLOW_BYTES);
+  std::vector<char>    output(nElems * LONG_BYTES);
+
+  for (int32_t t = 0; t < 4; t++) {
+    for (int32_t range = 0; range < 62; range += 3) {
+      int32_t nelements = nElems - range;
+
+      genIntData(data, range, range + 1);
+      narrow(data, types[t], input);
+      tsCompressINTImp(input.data(), nelements, compressed.data(), types[t]);
+
+      for (int8_t level = TD_SIMD_NONE; level <= TD_SIMD_AVX512; level++) {
+        int8_t inEffect = tsSetSimdLevel(level);
+        std::fill(output.begin(), output.end(), 0);
+        ASSERT_EQ(tsDecompressINTImp(compressed.data(), nelements, output.data(), types[t]), nelements * bytes[t]);
+        ASSERT_EQ(memcmp(input.data(), output.data(), nelements * bytes[t]), 0)
+            << "type:" << (int32_t)types[t] << " range:" << range << " simd:" << (int32_t)inEffect;
+      }
+    }
+  }
+
+  tsSetSimdLevel(TD_SIMD_AVX512);
+}
+
+// a benchmark rather than a check, run it with --gtest_also_run_disabled_tests
+TEST(utilTest, DISABLED_compressDecodeThroughput) {
+  std::vector<int64_t> ts(nElems);
+  std::vector<double>  dval(nElems);
+  std::vector<float>   fval(nElems);
+  std::vector<char>    compressed(nElems * LONG_BYTES + COMP_OVERFLOW_BYTES);
+  std::vector<char>    output(nElems * LONG_BYTES);
+  uint32_t             seed = 1;
+  const int32_t        loops = 50;
+
+  for (int32_t i = 0; i < nElems; i++) {
+    ts[i] = 1600000000000 + i * 10 + taosRandR(&seed) % 4;
+    dval[i] = 20.0 + (taosRandR(&seed) % 1000) / 100.0;
+    fval[i] = (float)dval[i];
+  }
+
+  // integer codec under each instruction set
+  tsCompressINTImp((const char *)ts.data(), nElems, compressed.data(), TSDB_DATA_TYPE_BIGINT);
+  for (int8_t level = TD_SIMD_NONE; level <= TD_SIMD_AVX512; level++) {
+    int8_t inEffect = tsSetSimdLevel(level);
+    if (inEffect != level) continue;
+    double mbps = throughput(nElems * LONG_BYTES, loops, [&]() {
+      tsDecompressINTImp(compressed.data(), nElems, output.data(), TSDB_DATA_TYPE_BIGINT);
+    });
+    printf("bigint   simd:%d decode %.1f MB/s\n", level, mbps);
+  }
+  tsSetSimdLevel(TD_SIMD_AVX512);
+
+  tsCompressTimestampImp((const char *)ts.data(), nElems, compressed.data());
+  printf("ts       decode %.1f MB/s\n", throughput(nElems * LONG_BYTES, loops, [&]() {
+           tsDecompressTimestampImp(compressed.data(), nElems, output.data());
+         }));
+  ASSERT_EQ(memcmp(ts.data(), output.data(), nElems * LONG_BYTES), 0);
+
+  tsCompressDoubleImp((const char *)dval.data(), nElems, compressed.data());
+  printf("double   decode %.1f MB/s\n", throughput(nElems * DOUBLE_BYTES, loops, [&]() {
+           tsDecompressDoubleImp(compressed.data(), nElems, output.data());
+         }));
+  ASSERT_EQ(memcmp(dval.data(), output.data(), nElems * DOUBLE_BYTES), 0);
+
+  tsCompressFloatImp((const char *)fval.data(), nElems, compressed.data());
+  printf("float    decode %.1f MB/s\n", throughput(nElems * FLOAT_BYTES, loops, [&]() {
+           tsDecompressFloatImp(compressed.data(), nElems, output.data());
+         }));
+  ASSERT_EQ(memcmp(fval.data(), output.data(), nElems * FLOAT_BYTES), 0);
+}